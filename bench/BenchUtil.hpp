@@ -0,0 +1,123 @@
+#pragma once
+
+/**
+ * Shared helpers for the native benchmarks: synthetic meshes and timing.
+ */
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace madfam::geom::bench {
+
+/**
+ * @brief Milliseconds elapsed while running fn (best of `repeats` runs)
+ */
+template<typename Func>
+double timeMs(Func&& fn, int repeats = 3) {
+    double best = 1e300;
+    for (int r = 0; r < repeats; ++r) {
+        auto start = std::chrono::high_resolution_clock::now();
+        fn();
+        auto end = std::chrono::high_resolution_clock::now();
+        double ms = std::chrono::duration<double, std::milli>(end - start).count();
+        if (ms < best) best = ms;
+    }
+    return best;
+}
+
+/**
+ * @brief Triangle soup of a closed UV sphere: 9 floats per triangle
+ *
+ * Produces roughly 2 * segments^2 triangles. Pole triangles are emitted
+ * as single triangles so the welded mesh is watertight.
+ */
+inline std::vector<float> makeSphereSoup(int segments, double radius = 10.0) {
+    const double PI = 3.14159265358979323846;
+    std::vector<float> soup;
+    soup.reserve(static_cast<size_t>(segments) * segments * 18);
+
+    auto point = [&](int i, int j, float* out) {
+        double theta = PI * i / segments;
+        double phi = 2.0 * PI * (j % segments) / segments;
+        out[0] = static_cast<float>(radius * std::sin(theta) * std::cos(phi));
+        out[1] = static_cast<float>(radius * std::sin(theta) * std::sin(phi));
+        out[2] = static_cast<float>(radius * std::cos(theta));
+        if (i == 0 || i == segments) {
+            out[0] = 0.0f;
+            out[1] = 0.0f;
+        }
+    };
+
+    for (int i = 0; i < segments; ++i) {
+        for (int j = 0; j < segments; ++j) {
+            float a[3], b[3], c[3], d[3];
+            point(i, j, a);
+            point(i + 1, j, b);
+            point(i + 1, j + 1, c);
+            point(i, j + 1, d);
+            if (i != 0) {
+                soup.insert(soup.end(), {a[0], a[1], a[2], b[0], b[1], b[2], d[0], d[1], d[2]});
+            }
+            if (i != segments - 1) {
+                soup.insert(soup.end(), {d[0], d[1], d[2], b[0], b[1], b[2], c[0], c[1], c[2]});
+            }
+        }
+    }
+    return soup;
+}
+
+/**
+ * @brief Encode a triangle soup as a binary STL file image
+ */
+inline std::string encodeBinarySTL(const std::vector<float>& soup) {
+    uint32_t count = static_cast<uint32_t>(soup.size() / 9);
+    std::string out(84 + static_cast<size_t>(count) * 50, '\0');
+    std::memcpy(&out[80], &count, 4);
+
+    char* ptr = &out[84];
+    for (uint32_t i = 0; i < count; ++i) {
+        ptr += 12;  // zero normal
+        std::memcpy(ptr, &soup[i * 9], 36);
+        ptr += 38;  // vertices + attribute bytes
+    }
+    return out;
+}
+
+/**
+ * @brief Encode a triangle soup as an ASCII STL file image
+ *
+ * Coordinates are printed with 9 significant digits, so parsing them back
+ * yields bit-identical floats (same welded mesh as encodeBinarySTL).
+ */
+inline std::string encodeASCIISTL(const std::vector<float>& soup, const char* name = "bench") {
+    std::string out = std::string("solid ") + name + "\n";
+    out.reserve(soup.size() / 9 * 260);
+
+    char line[128];
+    for (size_t i = 0; i + 9 <= soup.size(); i += 9) {
+        out += "  facet normal 0 0 0\n    outer loop\n";
+        for (int v = 0; v < 3; ++v) {
+            std::snprintf(line, sizeof(line), "      vertex %.9g %.9g %.9g\n",
+                          soup[i + v * 3], soup[i + v * 3 + 1], soup[i + v * 3 + 2]);
+            out += line;
+        }
+        out += "    endloop\n  endfacet\n";
+    }
+    out += std::string("endsolid ") + name + "\n";
+    return out;
+}
+
+/**
+ * @brief Read an integer from argv[index], falling back to a default
+ */
+inline int intArg(int argc, char** argv, int index, int fallback) {
+    return (argc > index) ? std::atoi(argv[index]) : fallback;
+}
+
+} // namespace madfam::geom::bench
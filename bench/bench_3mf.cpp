@@ -0,0 +1,75 @@
+/**
+ * bench_3mf - 3MF import/export vs. binary STL of the same geometry
+ *
+ * Usage: bench_3mf [sphere_segments=1000] [threads=1]
+ *
+ * Loads the same sphere from binary STL (parse + weld) and from 3MF
+ * (inflate + XML scan) into Mesh, and checks both give the same mesh.
+ * With threads > 1 the 3MF inflate runs alongside the XML scan.
+ */
+
+#include "BenchUtil.hpp"
+#include "geom-core/Mesh.hpp"
+#include "geom-core/io/STLIO.hpp"
+#include "geom-core/io/ThreeMFIO.hpp"
+
+#include <iostream>
+#include <iomanip>
+
+using namespace madfam::geom;
+
+int main(int argc, char** argv) {
+    int segments = bench::intArg(argc, argv, 1, 1000);
+    int threads = bench::intArg(argc, argv, 2, 1);
+
+    std::string stl = bench::encodeBinarySTL(bench::makeSphereSoup(segments));
+    Mesh welded;
+    welded.loadFromSTLBuffer(stl.data(), stl.size());
+
+    cad::MeshData data;
+    for (const auto& v : welded.getVertices()) {
+        data.positions.insert(data.positions.end(),
+            {static_cast<float>(v.x), static_cast<float>(v.y), static_cast<float>(v.z)});
+    }
+    for (const auto& f : welded.getFaces()) {
+        data.indices.insert(data.indices.end(),
+            {static_cast<uint32_t>(f.v0), static_cast<uint32_t>(f.v1), static_cast<uint32_t>(f.v2)});
+    }
+
+    cad::Result<std::vector<uint8_t>> package;
+    double writeMs = bench::timeMs([&]() { package = io::write3MFToMemory(data, threads); }, 1);
+    const std::vector<uint8_t>& bytes = package.value;
+
+    Mesh fromSTL, from3MF;
+    double stlMs = bench::timeMs([&]() { fromSTL.loadFromSTLBuffer(stl.data(), stl.size(), 0.0, threads); });
+    double threeMFMs = bench::timeMs([&]() {
+        from3MF.loadFrom3MFBuffer(reinterpret_cast<const char*>(bytes.data()), bytes.size(), threads);
+    });
+
+    double ioSTLMs = bench::timeMs([&]() {
+        io::readSTLFromMemory(reinterpret_cast<const uint8_t*>(stl.data()), stl.size());
+    });
+    double io3MFMs = bench::timeMs([&]() { io::read3MFFromMemory(bytes.data(), bytes.size(), threads); });
+
+    bool identical = from3MF.getVertices().size() == fromSTL.getVertices().size() &&
+                     from3MF.getFaces().size() == fromSTL.getFaces().size() &&
+                     from3MF.getVolume() == fromSTL.getVolume();
+    for (size_t i = 0; identical && i < from3MF.getVertices().size(); ++i) {
+        const Vector3& a = from3MF.getVertices()[i];
+        const Vector3& b = fromSTL.getVertices()[i];
+        identical = a.x == b.x && a.y == b.y && a.z == b.z;
+    }
+
+    std::cout << std::fixed << std::setprecision(1)
+              << "Triangles: " << data.triangleCount()
+              << ", STL: " << stl.size() / (1024.0 * 1024.0) << " MB"
+              << ", 3MF: " << bytes.size() / (1024.0 * 1024.0) << " MB\n"
+              << "write3MFToMemory (" << threads << "t):   " << writeMs << " ms\n"
+              << "Mesh STL load + weld:      " << stlMs << " ms\n"
+              << "Mesh 3MF load:             " << threeMFMs << " ms ("
+              << std::setprecision(2) << stlMs / threeMFMs << "x)\n" << std::setprecision(1)
+              << "io::readSTLFromMemory:     " << ioSTLMs << " ms\n"
+              << "io::read3MFFromMemory:     " << io3MFMs << " ms\n"
+              << "Identical mesh: " << (identical ? "yes" : "NO") << std::endl;
+    return identical ? 0 : 1;
+}
@@ -0,0 +1,305 @@
+/**
+ * bench_bvh - AABBTree build time and ray throughput per builder
+ *
+ * Usage: bench_bvh [sphere_segments=500] [rays=200000] [max_threads=0 (all cores)]
+ *
+ * Scene with uneven triangle sizes, as in CAD exports: a finely tessellated
+ * sphere resting on a large plate made of a few big triangles, plus a fan
+ * of long slivers through the sphere. Builds the tree with the median,
+ * binned SAH and linear (LBVH, with and without treelet passes) builders
+ * and traverses the SAH tree in each node format, casting the same random
+ * rays (one in eight nearly axis-aligned) through every variant and
+ * checking that they report the same hits, then casts them again with
+ * rayCastBatch at 1, 2, 4, ... threads, tests them for occlusion against
+ * rayCast() and queries the closest point to every ray origin. Finally times the SAH and linear builds at as many
+ * threads and checks that every thread count produces the identical tree.
+ */
+
+#include "BenchUtil.hpp"
+#include "Parallel.hpp"
+#include "geom-core/Mesh.hpp"
+#include "geom-core/Spatial.hpp"
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <iomanip>
+#include <limits>
+
+using namespace madfam::geom;
+
+namespace {
+
+void addQuad(std::vector<Vector3>& vertices, std::vector<Triangle>& faces,
+             const Vector3& a, const Vector3& b, const Vector3& c, const Vector3& d) {
+    int base = static_cast<int>(vertices.size());
+    vertices.insert(vertices.end(), {a, b, c, d});
+    faces.emplace_back(base, base + 1, base + 2);
+    faces.emplace_back(base, base + 2, base + 3);
+}
+
+struct Random {
+    uint64_t state = 0x9e3779b97f4a7c15ull;
+    double next() {
+        state = state * 6364136223846793005ull + 1442695040888963407ull;
+        return static_cast<double>(state >> 11) * (1.0 / 9007199254740992.0);
+    }
+};
+
+struct TreeStats {
+    size_t leaves = 0;
+    size_t maxLeaf = 0;
+    int depth = 0;
+};
+
+void collectStats(const std::vector<BVHNode>& nodes, uint32_t index, int depth, TreeStats& stats) {
+    const BVHNode& node = nodes[index];
+    stats.depth = std::max(stats.depth, depth);
+    if (node.isLeaf()) {
+        stats.leaves++;
+        stats.maxLeaf = std::max<size_t>(stats.maxLeaf, node.triangleCount);
+        return;
+    }
+    collectStats(nodes, index + 1, depth + 1, stats);
+    collectStats(nodes, node.offset, depth + 1, stats);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int segments = bench::intArg(argc, argv, 1, 500);
+    int rayCount = bench::intArg(argc, argv, 2, 200000);
+    int maxThreads = parallel::resolveThreadCount(bench::intArg(argc, argv, 3, 0));
+
+    std::string stl = bench::encodeBinarySTL(bench::makeSphereSoup(segments));
+    Mesh sphere;
+    sphere.loadFromSTLBuffer(stl.data(), stl.size());
+    std::vector<Vector3> vertices(sphere.getVertices().begin(), sphere.getVertices().end());
+    std::vector<Triangle> faces(sphere.getFaces().begin(), sphere.getFaces().end());
+
+    // Plate 20x the sphere's size, two triangles per side
+    const double w = 200.0, z0 = -11.0, z1 = -10.0;
+    addQuad(vertices, faces, {-w, -w, z1}, {w, -w, z1}, {w, w, z1}, {-w, w, z1});
+    addQuad(vertices, faces, {-w, -w, z0}, {-w, w, z0}, {w, w, z0}, {w, -w, z0});
+    addQuad(vertices, faces, {-w, -w, z0}, {w, -w, z0}, {w, -w, z1}, {-w, -w, z1});
+    addQuad(vertices, faces, {w, w, z0}, {-w, w, z0}, {-w, w, z1}, {w, w, z1});
+    addQuad(vertices, faces, {-w, w, z0}, {-w, -w, z0}, {-w, -w, z1}, {-w, w, z1});
+    addQuad(vertices, faces, {w, -w, z0}, {w, w, z0}, {w, w, z1}, {w, -w, z1});
+
+    // Slivers: long thin triangles fanning through the sphere
+    for (int i = 0; i < 64; ++i) {
+        double angle = i * 3.14159265358979 / 64;
+        Vector3 dir(std::cos(angle), std::sin(angle), 0.0);
+        int base = static_cast<int>(vertices.size());
+        vertices.push_back(dir * -60.0);
+        vertices.push_back(dir * 60.0);
+        vertices.push_back(dir * 60.0 + Vector3(0, 0, 0.05));
+        faces.emplace_back(base, base + 1, base + 2);
+    }
+
+    // Rays from random points around the sphere in random directions. Every
+    // eighth one runs along an axis, with the other components zero or tiny
+    // of either sign (below the traversal's parallel-axis threshold)
+    Random random;
+    std::vector<Ray> rays(rayCount);
+    const double tinyComponents[] = {0.0, -0.0, 1e-9, -1e-9, 5e-9, -5e-9};
+    for (size_t i = 0; i < rays.size(); ++i) {
+        Vector3 origin(random.next() * 30 - 15, random.next() * 30 - 15, random.next() * 30 - 15);
+        if (i % 8 == 7) {
+            double d[3];
+            for (double& component : d) {
+                component = tinyComponents[static_cast<int>(random.next() * 6)];
+            }
+            const int axis = static_cast<int>(random.next() * 3);
+            d[axis] = random.next() < 0.5 ? -1.0 : 1.0;
+            rays[i] = Ray(origin, Vector3(d[0], d[1], d[2]));
+            continue;
+        }
+        double z = random.next() * 2 - 1;
+        double phi = random.next() * 2 * 3.14159265358979;
+        double r = std::sqrt(1 - z * z);
+        rays[i] = Ray(origin, Vector3(r * std::cos(phi), r * std::sin(phi), z));
+    }
+
+    struct Config {
+        const char* name;
+        BVHBuilder builder;
+        BVHNodeFormat format;
+        int treeletPasses;
+    };
+    const Config configs[] = {
+        {"Median", BVHBuilder::Median, BVHNodeFormat::Binary, 0},
+        {"SAH", BVHBuilder::BinnedSAH, BVHNodeFormat::Binary, 0},
+        {"SAH BVH4", BVHBuilder::BinnedSAH, BVHNodeFormat::Wide4, 0},
+        {"SAH BVH4q", BVHBuilder::BinnedSAH, BVHNodeFormat::Wide4Quantized, 0},
+        {"LBVH", BVHBuilder::Linear, BVHNodeFormat::Binary, 0},
+        {"LBVH+2t", BVHBuilder::Linear, BVHNodeFormat::Binary, 2},
+    };
+    const size_t configCount = sizeof(configs) / sizeof(configs[0]);
+    const size_t nodeBytes[] = {sizeof(BVHNode), sizeof(BVH4Node), sizeof(BVH4QuantizedNode)};
+    std::vector<RayHit> reference;
+    size_t mismatches = 0;
+
+    std::cout << "Triangles: " << faces.size() << ", rays: " << rayCount << "\n";
+    for (size_t k = 0; k < configCount; ++k) {
+        BVHBuildOptions options;
+        options.builder = configs[k].builder;
+        options.nodeFormat = configs[k].format;
+        options.treeletPasses = configs[k].treeletPasses;
+        AABBTree tree;
+        double buildMs = bench::timeMs([&]() { tree.build(vertices, faces, options); });
+
+        std::vector<RayHit> hits(rays.size());
+        double castMs = bench::timeMs([&]() {
+            for (size_t i = 0; i < rays.size(); ++i) {
+                hits[i] = tree.rayCast(rays[i]);
+            }
+        });
+        if (k == 0) {
+            reference = hits;
+        }
+        size_t differing = 0;
+        for (size_t i = 0; i < rays.size(); ++i) {
+            differing += hits[i].hit != reference[i].hit || hits[i].distance != reference[i].distance;
+        }
+        mismatches += differing;
+
+        TreeStats stats;
+        collectStats(tree.getNodes(), 0, 0, stats);
+        const size_t traversalNodes = tree.getTraversalNodeCount();
+        std::cout << std::fixed << std::setprecision(1)
+                  << std::left << std::setw(10) << configs[k].name << std::right
+                  << " build " << std::setw(6) << buildMs << " ms, cast " << std::setw(6) << castMs
+                  << " ms (" << std::setprecision(2) << rays.size() / castMs / 1000.0 << " Mrays/s)"
+                  << ", nodes " << traversalNodes << " (" << std::setprecision(1)
+                  << traversalNodes * nodeBytes[static_cast<int>(tree.getNodeFormat())] / (1024.0 * 1024.0)
+                  << " MB), leaves " << stats.leaves << ", max leaf " << stats.maxLeaf
+                  << ", depth " << stats.depth << ", mismatches " << differing << "\n";
+    }
+
+    // Batched casts of the same rays, reordered for coherence
+    {
+        AABBTree tree;
+        tree.build(vertices, faces);
+        std::vector<RayHit> hits(rays.size());
+        for (int threads = 1; threads <= maxThreads; threads = threads < maxThreads ? std::min(threads * 2, maxThreads)
+                                                                                   : maxThreads + 1) {
+            RayBatchOptions batch;
+            batch.numThreads = threads;
+            double castMs = bench::timeMs([&]() { tree.rayCastBatch(rays, hits, batch); });
+            size_t differing = 0;
+            for (size_t i = 0; i < rays.size(); ++i) {
+                differing += hits[i].hit != reference[i].hit || hits[i].distance != reference[i].distance;
+            }
+            mismatches += differing;
+            std::cout << std::setprecision(1) << "SAH batch, " << threads << " threads: cast " << std::setw(6) << castMs
+                      << " ms (" << std::setprecision(2) << rays.size() / castMs / 1000.0 << " Mrays/s)"
+                      << ", mismatches " << differing << "\n";
+        }
+    }
+
+    // Any-hit queries against closest-hit casts, over a short and an unbounded distance
+    {
+        AABBTree tree;
+        tree.build(vertices, faces);
+        struct Range {
+            const char* name;
+            double limit;
+        };
+        for (const Range& range : {Range{"within 5 mm", 5.0}, Range{"at any distance", std::numeric_limits<double>::max()}}) {
+            const double limit = range.limit;
+            std::vector<uint8_t> expected(rays.size()), occluded(rays.size());
+            double castMs = bench::timeMs([&]() {
+                for (size_t i = 0; i < rays.size(); ++i) {
+                    expected[i] = tree.rayCast(rays[i], limit).hit;
+                }
+            });
+            double occludedMs = bench::timeMs([&]() {
+                for (size_t i = 0; i < rays.size(); ++i) {
+                    occluded[i] = tree.occluded(rays[i], limit);
+                }
+            });
+            RayBatchOptions batch;
+            batch.maxDistance = limit;
+            batch.numThreads = maxThreads;
+            std::vector<uint8_t> batched(rays.size());
+            double batchMs = bench::timeMs([&]() { tree.occludedBatch(rays, batched, batch); });
+            size_t differing = 0;
+            for (size_t i = 0; i < rays.size(); ++i) {
+                differing += occluded[i] != expected[i] || batched[i] != expected[i];
+            }
+            mismatches += differing;
+            std::cout << std::setprecision(1) << "SAH occlusion " << range.name << ": rayCast " << std::setw(6) << castMs << " ms, occluded " << std::setw(6) << occludedMs
+                      << " ms (" << std::setprecision(2) << castMs / occludedMs << "x), batch on " << maxThreads
+                      << " threads " << std::setprecision(1) << batchMs << " ms, mismatches " << differing << "\n";
+        }
+    }
+
+    // Closest points to the ray origins, one by one and batched
+    {
+        AABBTree tree;
+        tree.build(vertices, faces);
+        std::vector<Vector3> points(rays.size());
+        for (size_t i = 0; i < rays.size(); ++i) {
+            points[i] = rays[i].origin;
+        }
+        std::vector<ClosestPoint> expected(points.size());
+        double loopMs = bench::timeMs([&]() {
+            for (size_t i = 0; i < points.size(); ++i) {
+                expected[i] = tree.closestPoint(points[i]);
+            }
+        });
+        std::cout << std::setprecision(1) << "SAH closest point: " << std::setw(6) << loopMs << " ms ("
+                  << std::setprecision(2) << points.size() / loopMs / 1000.0 << " Mqueries/s)\n";
+        std::vector<ClosestPoint> results(points.size());
+        for (int threads = 1; threads <= maxThreads; threads = threads < maxThreads ? std::min(threads * 2, maxThreads)
+                                                                                   : maxThreads + 1) {
+            PointBatchOptions batch;
+            batch.numThreads = threads;
+            double queryMs = bench::timeMs([&]() { tree.closestPointBatch(points, results, batch); });
+            size_t differing = 0;
+            for (size_t i = 0; i < points.size(); ++i) {
+                differing += results[i].distance != expected[i].distance ||
+                             results[i].triangleIndex != expected[i].triangleIndex;
+            }
+            mismatches += differing;
+            std::cout << std::setprecision(1) << "SAH closest point batch, " << threads << " threads: "
+                      << std::setw(6) << queryMs << " ms (" << std::setprecision(2)
+                      << points.size() / queryMs / 1000.0 << " Mqueries/s), mismatches " << differing << "\n";
+        }
+    }
+
+    // Parallel build scaling, compared against the single-threaded tree
+    bool identical = true;
+    for (const Config& config : {configs[1], configs[4], configs[5]}) {
+        AABBTree serial;
+        double serialMs = 0.0;
+        std::cout << config.name << " build scaling:\n";
+        for (int threads = 1; threads <= maxThreads; threads = threads < maxThreads ? std::min(threads * 2, maxThreads)
+                                                                                   : maxThreads + 1) {
+            BVHBuildOptions options;
+            options.builder = config.builder;
+            options.treeletPasses = config.treeletPasses;
+            options.numThreads = threads;
+            AABBTree tree;
+            double buildMs = bench::timeMs([&]() { tree.build(vertices, faces, options); });
+            bool same = true;
+            if (threads == 1) {
+                serial = std::move(tree);
+                serialMs = buildMs;
+            } else {
+                const std::vector<BVHNode>& a = tree.getNodes();
+                const std::vector<BVHNode>& b = serial.getNodes();
+                same = a.size() == b.size() && std::memcmp(a.data(), b.data(), a.size() * sizeof(BVHNode)) == 0 &&
+                       tree.getTriangleOrder() == serial.getTriangleOrder();
+                identical = identical && same;
+            }
+            std::cout << std::setprecision(1) << "  " << std::setw(3) << threads << " threads: "
+                      << std::setw(7) << buildMs << " ms (" << std::setprecision(2) << serialMs / buildMs << "x)"
+                      << (same ? "" : "  TREE DIFFERS") << "\n";
+        }
+    }
+    std::cout << "Identical trees: " << (identical ? "yes" : "NO") << std::endl;
+    return mismatches == 0 && identical ? 0 : 1;
+}
@@ -0,0 +1,63 @@
+/**
+ * bench_gcmesh - Cold STL analysis setup vs. loading a .gcmesh cache
+ *
+ * Usage: bench_gcmesh [sphere_segments=1000]
+ *
+ * Compares "parse + weld + build spatial index" with "map .gcmesh" and
+ * checks that both give the same printability report.
+ */
+
+#include "BenchUtil.hpp"
+#include "geom-core/Analyzer.hpp"
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+
+using namespace madfam::geom;
+
+int main(int argc, char** argv) {
+    int segments = bench::intArg(argc, argv, 1, 1000);
+
+    std::string stl = bench::encodeBinarySTL(bench::makeSphereSoup(segments));
+    auto temp = std::filesystem::temp_directory_path();
+    std::string stlPath = (temp / "bench_gcmesh.stl").string();
+    std::string cachePath = (temp / "bench_gcmesh.gcmesh").string();
+    {
+        std::ofstream out(stlPath, std::ios::binary);
+        out.write(stl.data(), static_cast<std::streamsize>(stl.size()));
+    }
+
+    Analyzer cold;
+    double coldMs = bench::timeMs([&]() {
+        cold.loadSTL(stlPath);
+        cold.buildSpatialIndex();
+    }, 1);
+
+    double saveMs = bench::timeMs([&]() { cold.saveMeshCache(cachePath); }, 1);
+
+    Analyzer warm;
+    double warmMs = bench::timeMs([&]() { warm.loadMeshCache(cachePath); });
+
+    PrintabilityReport a = cold.getPrintabilityReport(45.0, 2.0);
+    PrintabilityReport b = warm.getPrintabilityReport(45.0, 2.0);
+    bool identical = warm.getVertexCount() == cold.getVertexCount() &&
+                     warm.getTriangleCount() == cold.getTriangleCount() &&
+                     a.thinWallVertexCount == b.thinWallVertexCount &&
+                     a.overhangArea == b.overhangArea;
+
+    std::cout << std::fixed << std::setprecision(1)
+              << "Triangles: " << cold.getTriangleCount()
+              << ", cache size: " << std::filesystem::file_size(cachePath) / (1024.0 * 1024.0) << " MB\n"
+              << "STL load + weld + BVH: " << coldMs << " ms\n"
+              << "save .gcmesh:          " << saveMs << " ms\n"
+              << "load .gcmesh:          " << warmMs << " ms ("
+              << std::setprecision(0) << coldMs / warmMs << "x faster)\n"
+              << "Identical report: " << (identical ? "yes" : "NO") << std::endl;
+
+    std::remove(stlPath.c_str());
+    std::remove(cachePath.c_str());
+    return identical ? 0 : 1;
+}
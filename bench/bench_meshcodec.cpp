@@ -0,0 +1,248 @@
+/**
+ * bench_meshcodec - Compact MeshData wire encoding vs. raw arrays
+ *
+ * Usage: bench_meshcodec [sphere_segments=1000] [threads=1] [position_bits=16] [normal_bits=12]
+ *
+ * Encodes a welded sphere with normals, decodes it, and reports sizes,
+ * timings, quantization error and the vertex cache miss ratio (ACMR, FIFO
+ * cache of 16) of the decoded triangle order. Fails if the decoded mesh
+ * does not have the original topology, errors exceed the bounds, or a
+ * truncated or corrupted stream is not rejected.
+ */
+
+#include "BenchUtil.hpp"
+#include "geom-core/Mesh.hpp"
+#include "geom-core/cad/MeshCodec.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <iomanip>
+#include <map>
+
+using namespace madfam::geom;
+
+namespace {
+
+double cacheMissRatio(const std::vector<uint32_t>& indices, size_t cacheSize = 16) {
+    std::deque<uint32_t> cache;
+    size_t misses = 0;
+    for (uint32_t v : indices) {
+        if (std::find(cache.begin(), cache.end(), v) == cache.end()) {
+            ++misses;
+            cache.push_back(v);
+            if (cache.size() > cacheSize) cache.pop_front();
+        }
+    }
+    return indices.empty() ? 0.0 : static_cast<double>(misses) / (indices.size() / 3);
+}
+
+// Every edge used exactly twice, in opposite directions (closed, consistently wound)
+bool closedAndOriented(const std::vector<uint32_t>& indices) {
+    std::map<std::pair<uint32_t, uint32_t>, int> edges;
+    for (size_t i = 0; i < indices.size(); i += 3) {
+        for (int k = 0; k < 3; ++k) {
+            ++edges[{indices[i + k], indices[i + (k + 1) % 3]}];
+        }
+    }
+    for (const auto& [edge, count] : edges) {
+        auto reverse = edges.find({edge.second, edge.first});
+        if (count != 1 || reverse == edges.end() || reverse->second != 1) return false;
+    }
+    return true;
+}
+
+double volume(const cad::MeshData& mesh) {
+    double sum = 0.0;
+    for (size_t i = 0; i < mesh.indices.size(); i += 3) {
+        const float* a = &mesh.positions[3 * mesh.indices[i]];
+        const float* b = &mesh.positions[3 * mesh.indices[i + 1]];
+        const float* c = &mesh.positions[3 * mesh.indices[i + 2]];
+        sum += a[0] * (double(b[1]) * c[2] - double(b[2]) * c[1]) -
+               a[1] * (double(b[0]) * c[2] - double(b[2]) * c[0]) +
+               a[2] * (double(b[0]) * c[1] - double(b[1]) * c[0]);
+    }
+    return sum / 6.0;
+}
+
+// Truncated and corrupted copies of a valid stream must all fail to decode
+bool rejectsMalformed(const std::vector<uint8_t>& stream) {
+    auto rejected = [](std::vector<uint8_t> bytes) {
+        return !cad::decodeMeshData(bytes.data(), bytes.size()).success;
+    };
+    auto withField = [&](size_t offset, uint32_t value) {
+        std::vector<uint8_t> bytes = stream;
+        std::memcpy(bytes.data() + offset, &value, 4);
+        return bytes;
+    };
+
+    bool ok = true;
+    for (size_t size : {size_t(0), size_t(47), size_t(48), stream.size() / 2, stream.size() - 1}) {
+        ok &= rejected(std::vector<uint8_t>(stream.begin(), stream.begin() + size));
+    }
+    ok &= rejected(withField(0, 0));                          // magic
+
+    // Header only, no vertices, an index count no index section could hold
+    std::vector<uint8_t> header(stream.begin(), stream.begin() + 48);
+    const uint32_t fields[3] = {0, 0xFFFFFFFCu, 0};           // vertexCount, indexCount, indexBytes
+    std::memcpy(header.data() + 12, fields, sizeof(fields));
+    ok &= rejected(header);
+
+    std::vector<uint8_t> unterminated = stream;
+    unterminated.back() = 0x80;                               // last varint continues past the end
+    ok &= rejected(unterminated);
+    return ok;
+}
+
+// Worst position error of a decode, in units of the documented bound: half
+// a grid step plus rounding the result to float. The soup spans +-1000, so
+// grid offsets are much coarser floats than coordinates near zero; it keeps
+// its vertex order (no cache reordering, vertices used in order)
+double gridErrorRatio(int positionBits) {
+    cad::MeshData soup;
+    uint32_t state = 12345;
+    for (uint32_t v = 0; v < 30000; ++v) {
+        for (int a = 0; a < 3; ++a) {
+            state = state * 1664525u + 1013904223u;
+            soup.positions.push_back(-1000.0f + static_cast<float>(state >> 8) * (2000.0f / 16777216.0f));
+        }
+        soup.indices.push_back(v);
+    }
+    cad::MeshEncodeOptions options;
+    options.positionBits = positionBits;
+    options.optimizeVertexCache = false;
+    auto encoded = cad::encodeMeshData(soup, options);
+    if (!encoded.success) return 1e9;
+    auto decoded = cad::decodeMeshData(encoded.value.data(), encoded.value.size());
+    if (!decoded.success || decoded.value.positions.size() != soup.positions.size()) return 1e9;
+
+    float step[3];
+    std::memcpy(step, encoded.value.data() + 36, sizeof(step));
+    double worst = 0.0;
+    for (size_t i = 0; i < soup.positions.size(); ++i) {
+        float value = decoded.value.positions[i];
+        double ulp = std::nextafter(value, INFINITY) - value;
+        double bound = 0.5 * step[i % 3] + 0.5 * ulp;
+        worst = std::max(worst, std::fabs(double(value) - soup.positions[i]) / bound);
+    }
+    return worst;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int segments = bench::intArg(argc, argv, 1, 1000);
+    cad::MeshEncodeOptions options;
+    options.numThreads = bench::intArg(argc, argv, 2, 1);
+    options.positionBits = bench::intArg(argc, argv, 3, 16);
+    options.normalBits = bench::intArg(argc, argv, 4, 12);
+
+    std::string stl = bench::encodeBinarySTL(bench::makeSphereSoup(segments));
+    Mesh welded;
+    welded.loadFromSTLBuffer(stl.data(), stl.size());
+
+    cad::MeshData mesh;
+    for (const auto& v : welded.getVertices()) {
+        double length = std::sqrt(v.x * v.x + v.y * v.y + v.z * v.z);
+        mesh.positions.insert(mesh.positions.end(),
+            {static_cast<float>(v.x), static_cast<float>(v.y), static_cast<float>(v.z)});
+        mesh.normals.insert(mesh.normals.end(),
+            {static_cast<float>(v.x / length), static_cast<float>(v.y / length), static_cast<float>(v.z / length)});
+    }
+    for (const auto& f : welded.getFaces()) {
+        mesh.indices.insert(mesh.indices.end(),
+            {static_cast<uint32_t>(f.v0), static_cast<uint32_t>(f.v1), static_cast<uint32_t>(f.v2)});
+    }
+
+    cad::Result<std::vector<uint8_t>> encoded;
+    cad::Result<cad::MeshData> decoded;
+    double encodeMs = bench::timeMs([&]() { encoded = cad::encodeMeshData(mesh, options); }, 1);
+    if (!encoded.success) {
+        std::cerr << encoded.errorMessage << std::endl;
+        return 1;
+    }
+    const std::vector<uint8_t>& stream = encoded.value;
+    double decodeMs = bench::timeMs([&]() {
+        decoded = cad::decodeMeshData(stream.data(), stream.size(), options.numThreads);
+    });
+    if (!decoded.success) {
+        std::cerr << decoded.errorMessage << std::endl;
+        return 1;
+    }
+    const cad::MeshData& out = decoded.value;
+
+    // Raw arrays copied once, as a stand-in for moving the uncompressed bytes
+    double copyMs = bench::timeMs([&]() {
+        cad::MeshData copy = mesh;
+        if (copy.positions.empty()) std::abort();
+    });
+
+    // Decoded vertices are reordered, so errors are measured against the
+    // analytic sphere: radius 10, normals pointing away from the center
+    float lo[3], hi[3];
+    for (int a = 0; a < 3; ++a) {
+        lo[a] = hi[a] = mesh.positions[a];
+    }
+    for (size_t i = 0; i < mesh.positions.size(); ++i) {
+        lo[i % 3] = std::min(lo[i % 3], mesh.positions[i]);
+        hi[i % 3] = std::max(hi[i % 3], mesh.positions[i]);
+    }
+    double maxStep = 0.0;
+    for (int a = 0; a < 3; ++a) {
+        maxStep = std::max(maxStep, double(hi[a] - lo[a]) / ((1u << options.positionBits) - 1));
+    }
+    double maxNormalError = 0.0;
+    double maxRadiusError = 0.0;
+    for (size_t v = 0; v < out.vertexCount(); ++v) {
+        const float* p = &out.positions[3 * v];
+        const float* n = &out.normals[3 * v];
+        double r = std::sqrt(double(p[0]) * p[0] + double(p[1]) * p[1] + double(p[2]) * p[2]);
+        maxRadiusError = std::max(maxRadiusError, std::fabs(r - 10.0));
+        if (r > 0.0) {
+            double dot = (p[0] * n[0] + p[1] * n[1] + p[2] * n[2]) / r;
+            maxNormalError = std::max(maxNormalError, std::acos(std::min(1.0, dot)));
+        }
+    }
+
+    const double rawBytes = static_cast<double>(mesh.byteSize());
+    const double gigabitMs = 1000.0 / (125.0 * 1024 * 1024);
+    bool topology = out.vertexCount() == mesh.vertexCount() &&
+                    out.triangleCount() == mesh.triangleCount() &&
+                    closedAndOriented(out.indices);
+    double volumeError = std::fabs(volume(out) - volume(mesh)) / volume(mesh);
+    bool malformed = rejectsMalformed(stream);
+    double gridError = 0.0;
+    for (int bits : {8, 12, 16, 20, 24}) {
+        gridError = std::max(gridError, gridErrorRatio(bits));
+    }
+    bool ok = topology && malformed && volumeError < 1e-3 && maxNormalError < 0.01 && maxRadiusError < maxStep &&
+              gridError <= 1.0;
+
+    const size_t vertexBytes = mesh.vertexCount() * (3 * (options.positionBits > 16 ? 4 : 2) +
+                                                     2 * (options.normalBits > 8 ? 2 : 1));
+    const double indexBits = 8.0 * (stream.size() - 48 - vertexBytes) / mesh.indices.size();
+
+    std::cout << std::fixed << std::setprecision(1)
+              << "Triangles: " << mesh.triangleCount() << ", vertices: " << mesh.vertexCount()
+              << " (" << options.positionBits << "-bit positions, " << options.normalBits << "-bit normals)\n"
+              << "Raw MeshData:   " << rawBytes / (1024 * 1024) << " MB\n"
+              << "Encoded:        " << stream.size() / (1024.0 * 1024.0) << " MB ("
+              << std::setprecision(2) << rawBytes / stream.size() << "x smaller, "
+              << indexBits << " bits/index)\n" << std::setprecision(1)
+              << "Encode (" << options.numThreads << "t):     " << encodeMs << " ms\n"
+              << "Decode (" << options.numThreads << "t):     " << decodeMs << " ms\n"
+              << "Copy raw arrays: " << copyMs << " ms\n"
+              << "At 1 Gb/s:      raw " << rawBytes * gigabitMs << " ms, encoded + decode "
+              << stream.size() * gigabitMs + decodeMs << " ms\n"
+              << std::setprecision(4)
+              << "ACMR:           " << cacheMissRatio(mesh.indices) << " -> " << cacheMissRatio(out.indices) << "\n"
+              << "Max radius error: " << maxRadiusError << " (grid step " << maxStep << ")\n"
+              << "Grid error / bound: " << gridError << " (8-24 bits)\n"
+              << "Max normal error: " << maxNormalError * 180.0 / 3.14159265358979 << " deg\n"
+              << "Volume rel. error: " << std::scientific << volumeError << "\n"
+              << "Topology preserved: " << (topology ? "yes" : "NO") << "\n"
+              << "Malformed streams rejected: " << (malformed ? "yes" : "NO") << std::endl;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,129 @@
+/**
+ * bench_obj - OBJ export and import throughput vs. thread count
+ *
+ * Usage: bench_obj [sphere_segments=1000] [max_threads=hardware]
+ *
+ * Writes a welded sphere with io::writeOBJToString, reads it back with
+ * Mesh::loadFromOBJBuffer (and with a line-by-line istringstream reader
+ * for reference), and checks that every thread count gives the same mesh.
+ */
+
+#include "BenchUtil.hpp"
+#include "geom-core/Mesh.hpp"
+#include "geom-core/io/OBJIO.hpp"
+
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <thread>
+
+using namespace madfam::geom;
+
+namespace {
+
+// Reference reader: getline + istringstream per line, triangles only
+size_t parseWithStreams(const std::string& text) {
+    std::istringstream in(text);
+    std::string line, keyword;
+    std::vector<double> positions;
+    std::vector<int> indices;
+    while (std::getline(in, line)) {
+        std::istringstream ls(line);
+        ls >> keyword;
+        if (keyword == "v") {
+            double x, y, z;
+            ls >> x >> y >> z;
+            positions.insert(positions.end(), {x, y, z});
+        } else if (keyword == "f") {
+            std::string corner;
+            while (ls >> corner) {
+                indices.push_back(std::stoi(corner) - 1);
+            }
+        }
+    }
+    return indices.size() / 3;
+}
+
+bool sameMesh(const Mesh& mesh, const cad::MeshData& data) {
+    const auto& vertices = mesh.getVertices();
+    const auto& faces = mesh.getFaces();
+    if (vertices.size() != data.vertexCount() || faces.size() != data.triangleCount()) {
+        return false;
+    }
+    for (size_t i = 0; i < vertices.size(); ++i) {
+        if (static_cast<float>(vertices[i].x) != data.positions[i * 3] ||
+            static_cast<float>(vertices[i].y) != data.positions[i * 3 + 1] ||
+            static_cast<float>(vertices[i].z) != data.positions[i * 3 + 2]) {
+            return false;
+        }
+    }
+    for (size_t i = 0; i < faces.size(); ++i) {
+        if (static_cast<uint32_t>(faces[i].v0) != data.indices[i * 3] ||
+            static_cast<uint32_t>(faces[i].v1) != data.indices[i * 3 + 1] ||
+            static_cast<uint32_t>(faces[i].v2) != data.indices[i * 3 + 2]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void report(const std::string& label, double ms, double megabytes, double baseline) {
+    std::cout << std::left << std::setw(24) << label << std::right
+              << std::setw(9) << std::setprecision(1) << ms
+              << std::setw(9) << std::setprecision(0) << megabytes / (ms / 1000.0)
+              << std::setw(8) << std::setprecision(2) << baseline / ms << "x" << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int segments = bench::intArg(argc, argv, 1, 1000);
+    int hardware = static_cast<int>(std::thread::hardware_concurrency());
+    int maxThreads = bench::intArg(argc, argv, 2, hardware > 0 ? hardware : 1);
+
+    // Welded (indexed) sphere as exported meshes are
+    std::string stl = bench::encodeBinarySTL(bench::makeSphereSoup(segments));
+    Mesh welded;
+    welded.loadFromSTLBuffer(stl.data(), stl.size());
+
+    cad::MeshData data;
+    for (const auto& v : welded.getVertices()) {
+        data.positions.insert(data.positions.end(),
+            {static_cast<float>(v.x), static_cast<float>(v.y), static_cast<float>(v.z)});
+    }
+    for (const auto& f : welded.getFaces()) {
+        data.indices.insert(data.indices.end(),
+            {static_cast<uint32_t>(f.v0), static_cast<uint32_t>(f.v1), static_cast<uint32_t>(f.v2)});
+    }
+
+    std::string text;
+    io::writeOBJToString(data, text, 1);
+    double megabytes = text.size() / (1024.0 * 1024.0);
+
+    std::cout << std::fixed << "Vertices: " << data.vertexCount() << ", triangles: " << data.triangleCount()
+              << ", OBJ size: " << std::setprecision(1) << megabytes << " MB" << std::endl;
+
+    std::cout << "write                          ms     MB/s  speedup" << std::endl;
+    double writeBase = 0.0;
+    for (int threads = 1; threads <= maxThreads; threads *= 2) {
+        std::string out;
+        double ms = bench::timeMs([&]() { io::writeOBJToString(data, out, threads); });
+        if (threads == 1) writeBase = ms;
+        report("writeOBJToString, " + std::to_string(threads) + "t", ms, megabytes, writeBase);
+    }
+
+    std::cout << "read                           ms     MB/s  speedup" << std::endl;
+    double streamMs = bench::timeMs([&]() { parseWithStreams(text); }, 1);
+    report("istringstream lines", streamMs, megabytes, streamMs);
+
+    bool identical = true;
+    for (int threads = 1; threads <= maxThreads; threads *= 2) {
+        Mesh mesh;
+        double ms = bench::timeMs([&]() { mesh.loadFromOBJBuffer(text.data(), text.size(), threads); });
+        report("loadFromOBJBuffer, " + std::to_string(threads) + "t", ms, megabytes, streamMs);
+        identical = identical && sameMesh(mesh, data);
+    }
+
+    std::cout << "Round trip identical: " << (identical ? "yes" : "NO") << std::endl;
+    return identical ? 0 : 1;
+}
@@ -0,0 +1,114 @@
+/**
+ * bench_ply - PLY import vs. binary STL of the same geometry
+ *
+ * Usage: bench_ply [sphere_segments=1000] [threads=1]
+ *
+ * Loads the same sphere from binary STL (parse + weld) and from binary and
+ * ASCII PLY (indexed, no welding) into Mesh, and checks all give the same
+ * mesh.
+ */
+
+#include "BenchUtil.hpp"
+#include "geom-core/Mesh.hpp"
+
+#include <cstring>
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+
+using namespace madfam::geom;
+
+namespace {
+
+std::string encodePLY(const Mesh& mesh, bool binary) {
+    std::ostringstream out;
+    out << "ply\nformat " << (binary ? "binary_little_endian" : "ascii") << " 1.0\n"
+        << "comment bench_ply sphere\n"
+        << "element vertex " << mesh.getVertexCount() << "\n"
+        << "property float x\nproperty float y\nproperty float z\n"
+        << "element face " << mesh.getTriangleCount() << "\n"
+        << "property list uchar int vertex_indices\nend_header\n";
+    std::string text = out.str();
+
+    if (binary) {
+        size_t offset = text.size();
+        text.resize(offset + mesh.getVertexCount() * 12 + mesh.getTriangleCount() * 13);
+        char* p = &text[offset];
+        for (const Vector3& v : mesh.getVertices()) {
+            float xyz[3] = {static_cast<float>(v.x), static_cast<float>(v.y), static_cast<float>(v.z)};
+            std::memcpy(p, xyz, 12);
+            p += 12;
+        }
+        for (const Triangle& f : mesh.getFaces()) {
+            int32_t indices[3] = {f.v0, f.v1, f.v2};
+            *p++ = 3;
+            std::memcpy(p, indices, 12);
+            p += 12;
+        }
+        return text;
+    }
+
+    std::ostringstream body;
+    body << std::setprecision(9);
+    for (const Vector3& v : mesh.getVertices()) {
+        body << static_cast<float>(v.x) << ' ' << static_cast<float>(v.y) << ' '
+             << static_cast<float>(v.z) << '\n';
+    }
+    for (const Triangle& f : mesh.getFaces()) {
+        body << "3 " << f.v0 << ' ' << f.v1 << ' ' << f.v2 << '\n';
+    }
+    return text + body.str();
+}
+
+bool sameMesh(const Mesh& a, const Mesh& b) {
+    if (a.getVertexCount() != b.getVertexCount() || a.getTriangleCount() != b.getTriangleCount()) {
+        return false;
+    }
+    for (size_t i = 0; i < a.getVertexCount(); ++i) {
+        const Vector3& p = a.getVertices()[i];
+        const Vector3& q = b.getVertices()[i];
+        if (p.x != q.x || p.y != q.y || p.z != q.z) {
+            return false;
+        }
+    }
+    for (size_t i = 0; i < a.getTriangleCount(); ++i) {
+        const Triangle& f = a.getFaces()[i];
+        const Triangle& g = b.getFaces()[i];
+        if (f.v0 != g.v0 || f.v1 != g.v1 || f.v2 != g.v2) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int segments = bench::intArg(argc, argv, 1, 1000);
+    int threads = bench::intArg(argc, argv, 2, 1);
+
+    std::string stl = bench::encodeBinarySTL(bench::makeSphereSoup(segments));
+    Mesh fromSTL;
+    double stlMs = bench::timeMs([&]() { fromSTL.loadFromSTLBuffer(stl.data(), stl.size(), 0.0, threads); });
+
+    std::string binary = encodePLY(fromSTL, true);
+    std::string ascii = encodePLY(fromSTL, false);
+
+    Mesh fromBinary, fromASCII;
+    double binaryMs = bench::timeMs([&]() { fromBinary.loadFromPLYBuffer(binary.data(), binary.size(), threads); });
+    double asciiMs = bench::timeMs([&]() { fromASCII.loadFromPLYBuffer(ascii.data(), ascii.size(), threads); }, 1);
+
+    bool identical = sameMesh(fromSTL, fromBinary) && sameMesh(fromSTL, fromASCII);
+
+    std::cout << std::fixed << std::setprecision(1)
+              << "Triangles: " << fromSTL.getTriangleCount()
+              << ", STL: " << stl.size() / (1024.0 * 1024.0) << " MB"
+              << ", PLY: " << binary.size() / (1024.0 * 1024.0) << " MB binary, "
+              << ascii.size() / (1024.0 * 1024.0) << " MB ASCII\n"
+              << "Mesh STL load + weld (" << threads << "t): " << stlMs << " ms\n"
+              << "Mesh binary PLY load:       " << binaryMs << " ms ("
+              << std::setprecision(2) << stlMs / binaryMs << "x)\n" << std::setprecision(1)
+              << "Mesh ASCII PLY load:        " << asciiMs << " ms\n"
+              << "Identical mesh: " << (identical ? "yes" : "NO") << std::endl;
+    return identical ? 0 : 1;
+}
@@ -0,0 +1,108 @@
+/**
+ * bench_stl_ascii - ASCII STL parsing throughput
+ *
+ * Usage: bench_stl_ascii [sphere_segments=400]
+ *
+ * Encodes a synthetic sphere as ASCII STL and reports MB/s for:
+ *   - the previous getline/istringstream line parser (reference)
+ *   - the from_chars tokenizer shared by io::readSTL and Mesh
+ *   - a full welded Mesh load, checked against the binary encoding
+ */
+
+#include "BenchUtil.hpp"
+#include "geom-core/Mesh.hpp"
+#include "io/ASCIISTLParser.hpp"
+
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+
+using namespace madfam::geom;
+
+namespace {
+
+// The line-oriented parser io::readASCIISTL used before the tokenizer
+size_t parseWithStringStreams(const std::string& text, std::vector<float>& positions) {
+    std::istringstream file(text);
+    std::string line;
+    while (std::getline(file, line)) {
+        std::istringstream iss(line);
+        std::string keyword;
+        iss >> keyword;
+        if (keyword == "facet") {
+            std::getline(file, line);  // outer loop
+            for (int v = 0; v < 3; ++v) {
+                std::getline(file, line);
+                std::istringstream viss(line);
+                std::string vertexKeyword;
+                float x, y, z;
+                viss >> vertexKeyword >> x >> y >> z;
+                positions.push_back(x);
+                positions.push_back(y);
+                positions.push_back(z);
+            }
+            std::getline(file, line);  // endloop
+            std::getline(file, line);  // endfacet
+        }
+    }
+    return positions.size() / 9;
+}
+
+void report(const char* label, double ms, double megabytes, double baseline) {
+    std::cout << std::left << std::setw(22) << label << std::right
+              << std::setw(9) << std::setprecision(1) << ms
+              << std::setw(9) << std::setprecision(0) << megabytes / (ms / 1000.0)
+              << std::setw(8) << std::setprecision(2) << baseline / ms << "x" << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int segments = bench::intArg(argc, argv, 1, 400);
+
+    std::vector<float> soup = bench::makeSphereSoup(segments);
+    std::string text = bench::encodeASCIISTL(soup);
+    std::string binary = bench::encodeBinarySTL(soup);
+    double megabytes = text.size() / (1024.0 * 1024.0);
+
+    std::cout << "Triangles: " << soup.size() / 9
+              << ", ASCII size: " << std::fixed << std::setprecision(1) << megabytes << " MB"
+              << std::endl;
+    std::cout << "parser                      ms     MB/s  speedup" << std::endl;
+
+    double baseline = bench::timeMs([&]() {
+        std::vector<float> positions;
+        parseWithStringStreams(text, positions);
+    });
+    report("istringstream", baseline, megabytes, baseline);
+
+    double tokenizer = bench::timeMs([&]() {
+        std::vector<float> positions;
+        positions.reserve(soup.size());
+        std::string error;
+        io::parseASCIISTL(text.data(), text.size(), [&](const float*, const float* v) {
+            positions.insert(positions.end(), v, v + 9);
+        }, error);
+    });
+    report("from_chars tokenizer", tokenizer, megabytes, baseline);
+
+    Mesh fromText;
+    double load = bench::timeMs([&]() {
+        fromText.loadFromSTLBuffer(text.data(), text.size());
+    });
+    report("Mesh load (welded)", load, megabytes, baseline);
+
+    Mesh fromBinary;
+    fromBinary.loadFromSTLBuffer(binary.data(), binary.size());
+
+    bool identical = fromText.getVertexCount() == fromBinary.getVertexCount() &&
+                     fromText.getTriangleCount() == fromBinary.getTriangleCount();
+    for (size_t i = 0; identical && i < fromText.getTriangleCount(); ++i) {
+        const Triangle& a = fromText.getFaces()[i];
+        const Triangle& b = fromBinary.getFaces()[i];
+        identical = a.v0 == b.v0 && a.v1 == b.v1 && a.v2 == b.v2;
+    }
+    std::cout << "Welded mesh identical to binary load: " << (identical ? "yes" : "NO") << std::endl;
+
+    return identical ? 0 : 1;
+}
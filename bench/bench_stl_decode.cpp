@@ -0,0 +1,104 @@
+/**
+ * bench_stl_decode - Binary STL to MeshData decode throughput
+ *
+ * Usage: bench_stl_decode [sphere_segments=1000]
+ *
+ * Compares io::readSTL / io::readSTLFromMemory against the previous
+ * per-triangle decoder (six ifstream::read calls and nine push_backs per
+ * triangle) and checks that both produce the same MeshData.
+ */
+
+#include "BenchUtil.hpp"
+#include "geom-core/io/STLIO.hpp"
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+
+using namespace madfam::geom;
+
+namespace {
+
+// The decoder io::readSTL used before the bulk decode
+cad::MeshData readWithStreamReads(const std::string& path) {
+    cad::MeshData mesh;
+    std::ifstream file(path, std::ios::binary);
+    file.seekg(80);
+    uint32_t numTriangles;
+    file.read(reinterpret_cast<char*>(&numTriangles), 4);
+    mesh.positions.reserve(static_cast<size_t>(numTriangles) * 9);
+    mesh.normals.reserve(static_cast<size_t>(numTriangles) * 9);
+    mesh.indices.reserve(static_cast<size_t>(numTriangles) * 3);
+
+    for (uint32_t i = 0; i < numTriangles; ++i) {
+        float normal[3];
+        file.read(reinterpret_cast<char*>(normal), 12);
+        for (int v = 0; v < 3; ++v) {
+            float vertex[3];
+            file.read(reinterpret_cast<char*>(vertex), 12);
+            mesh.positions.push_back(vertex[0]);
+            mesh.positions.push_back(vertex[1]);
+            mesh.positions.push_back(vertex[2]);
+            mesh.normals.push_back(normal[0]);
+            mesh.normals.push_back(normal[1]);
+            mesh.normals.push_back(normal[2]);
+            mesh.indices.push_back(i * 3 + v);
+        }
+        uint16_t attr;
+        file.read(reinterpret_cast<char*>(&attr), 2);
+    }
+    return mesh;
+}
+
+void report(const char* label, double ms, double megabytes, double baseline) {
+    std::cout << std::left << std::setw(24) << label << std::right
+              << std::setw(9) << std::setprecision(1) << ms
+              << std::setw(9) << std::setprecision(0) << megabytes / (ms / 1000.0)
+              << std::setw(8) << std::setprecision(2) << baseline / ms << "x" << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int segments = bench::intArg(argc, argv, 1, 1000);
+
+    std::string stl = bench::encodeBinarySTL(bench::makeSphereSoup(segments));
+    double megabytes = stl.size() / (1024.0 * 1024.0);
+
+    std::string path = (std::filesystem::temp_directory_path() / "bench_stl_decode.stl").string();
+    {
+        std::ofstream out(path, std::ios::binary);
+        out.write(stl.data(), static_cast<std::streamsize>(stl.size()));
+    }
+
+    std::cout << "Triangles: " << (stl.size() - 84) / 50
+              << ", size: " << std::fixed << std::setprecision(1) << megabytes << " MB" << std::endl;
+    std::cout << "decoder                        ms     MB/s  speedup" << std::endl;
+
+    cad::MeshData legacy;
+    double baseline = bench::timeMs([&]() { legacy = readWithStreamReads(path); });
+    report("ifstream per-triangle", baseline, megabytes, baseline);
+
+    cad::Result<cad::MeshData> fromFile;
+    double fileMs = bench::timeMs([&]() { fromFile = io::readSTL(path); });
+    report("readSTL (mapped)", fileMs, megabytes, baseline);
+
+    cad::Result<cad::MeshData> fromMemory;
+    double memoryMs = bench::timeMs([&]() {
+        fromMemory = io::readSTLFromMemory(reinterpret_cast<const uint8_t*>(stl.data()), stl.size());
+    });
+    report("readSTLFromMemory", memoryMs, megabytes, baseline);
+
+    std::remove(path.c_str());
+
+    bool identical = fromFile.success && fromMemory.success &&
+                     fromFile.value.positions == legacy.positions &&
+                     fromFile.value.normals == legacy.normals &&
+                     fromFile.value.indices == legacy.indices &&
+                     fromMemory.value.positions == legacy.positions;
+    std::cout << "Identical to previous decoder: " << (identical ? "yes" : "NO") << std::endl;
+
+    return identical ? 0 : 1;
+}
@@ -0,0 +1,60 @@
+/**
+ * bench_stl_load - Binary STL ingestion throughput vs. thread count
+ *
+ * Usage: bench_stl_load [sphere_segments=1000] [max_threads=hardware]
+ *
+ * Loads a synthetic sphere (~2 * segments^2 triangles) from memory with
+ * 1, 2, 4, ... threads and reports time, throughput and speedup. Also
+ * checks that every thread count produces the same welded mesh.
+ */
+
+#include "BenchUtil.hpp"
+#include "geom-core/Mesh.hpp"
+
+#include <iostream>
+#include <iomanip>
+#include <thread>
+
+using namespace madfam::geom;
+
+int main(int argc, char** argv) {
+    int segments = bench::intArg(argc, argv, 1, 1000);
+    int hardware = static_cast<int>(std::thread::hardware_concurrency());
+    int maxThreads = bench::intArg(argc, argv, 2, hardware > 0 ? hardware : 1);
+
+    std::string stl = bench::encodeBinarySTL(bench::makeSphereSoup(segments));
+    double megabytes = stl.size() / (1024.0 * 1024.0);
+
+    Mesh reference;
+    reference.loadFromSTLBuffer(stl.data(), stl.size(), 0.0, 1);
+
+    std::cout << "Triangles: " << reference.getTriangleCount()
+              << ", vertices: " << reference.getVertexCount()
+              << ", size: " << std::fixed << std::setprecision(1) << megabytes << " MB"
+              << std::endl;
+    std::cout << "threads      ms     MB/s  speedup  identical" << std::endl;
+
+    double baseline = 0.0;
+    for (int threads = 1; threads <= maxThreads; threads *= 2) {
+        Mesh mesh;
+        double ms = bench::timeMs([&]() {
+            mesh.loadFromSTLBuffer(stl.data(), stl.size(), 0.0, threads);
+        });
+        if (threads == 1) baseline = ms;
+
+        bool identical = mesh.getVertexCount() == reference.getVertexCount();
+        for (size_t i = 0; identical && i < mesh.getTriangleCount(); ++i) {
+            const Triangle& a = mesh.getFaces()[i];
+            const Triangle& b = reference.getFaces()[i];
+            identical = a.v0 == b.v0 && a.v1 == b.v1 && a.v2 == b.v2;
+        }
+
+        std::cout << std::setw(7) << threads
+                  << std::setw(8) << std::setprecision(1) << ms
+                  << std::setw(9) << std::setprecision(0) << megabytes / (ms / 1000.0)
+                  << std::setw(8) << std::setprecision(2) << baseline / ms << "x"
+                  << std::setw(11) << (identical ? "yes" : "NO") << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,113 @@
+/**
+ * bench_stl_write - STL export throughput vs. thread count
+ *
+ * Usage: bench_stl_write [sphere_segments=1000] [max_threads=hardware]
+ *
+ * Compares the previous per-float ofstream writer with io::writeSTL and
+ * io::writeSTLToString (binary and ASCII), and checks that the output
+ * reads back to the same positions.
+ */
+
+#include "BenchUtil.hpp"
+#include "geom-core/io/STLIO.hpp"
+
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+#include <thread>
+
+using namespace madfam::geom;
+
+namespace {
+
+// The writer io::writeSTL used before buffering: one ofstream::write per value
+void writeWithStreamWrites(const cad::MeshData& mesh, const std::string& path) {
+    std::ofstream file(path, std::ios::binary);
+    char header[80] = {};
+    file.write(header, 80);
+    uint32_t count = static_cast<uint32_t>(mesh.triangleCount());
+    file.write(reinterpret_cast<const char*>(&count), 4);
+
+    for (uint32_t i = 0; i < count; ++i) {
+        const float* v0 = &mesh.positions[mesh.indices[i * 3 + 0] * 3];
+        const float* v1 = &mesh.positions[mesh.indices[i * 3 + 1] * 3];
+        const float* v2 = &mesh.positions[mesh.indices[i * 3 + 2] * 3];
+
+        float e1[3] = {v1[0] - v0[0], v1[1] - v0[1], v1[2] - v0[2]};
+        float e2[3] = {v2[0] - v0[0], v2[1] - v0[1], v2[2] - v0[2]};
+        float nx = e1[1] * e2[2] - e1[2] * e2[1];
+        float ny = e1[2] * e2[0] - e1[0] * e2[2];
+        float nz = e1[0] * e2[1] - e1[1] * e2[0];
+        float len = std::sqrt(nx * nx + ny * ny + nz * nz);
+        if (len > 1e-10f) { nx /= len; ny /= len; nz /= len; }
+
+        file.write(reinterpret_cast<const char*>(&nx), 4);
+        file.write(reinterpret_cast<const char*>(&ny), 4);
+        file.write(reinterpret_cast<const char*>(&nz), 4);
+        file.write(reinterpret_cast<const char*>(v0), 12);
+        file.write(reinterpret_cast<const char*>(v1), 12);
+        file.write(reinterpret_cast<const char*>(v2), 12);
+        uint16_t attr = 0;
+        file.write(reinterpret_cast<const char*>(&attr), 2);
+    }
+}
+
+void report(const std::string& label, double ms, double megabytes, double baseline) {
+    std::cout << std::left << std::setw(26) << label << std::right
+              << std::setw(9) << std::setprecision(1) << ms
+              << std::setw(9) << std::setprecision(0) << megabytes / (ms / 1000.0)
+              << std::setw(8) << std::setprecision(2) << baseline / ms << "x" << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int segments = bench::intArg(argc, argv, 1, 1000);
+    int hardware = static_cast<int>(std::thread::hardware_concurrency());
+    int maxThreads = bench::intArg(argc, argv, 2, hardware > 0 ? hardware : 1);
+
+    cad::MeshData mesh;
+    mesh.positions = bench::makeSphereSoup(segments);
+    mesh.indices.resize(mesh.positions.size() / 3);
+    for (size_t i = 0; i < mesh.indices.size(); ++i) {
+        mesh.indices[i] = static_cast<uint32_t>(i);
+    }
+
+    double megabytes = io::binarySTLSize(mesh) / (1024.0 * 1024.0);
+    std::string path = (std::filesystem::temp_directory_path() / "bench_stl_write.stl").string();
+
+    std::cout << "Triangles: " << mesh.triangleCount()
+              << ", binary size: " << std::fixed << std::setprecision(1) << megabytes << " MB" << std::endl;
+    std::cout << "writer                           ms     MB/s  speedup" << std::endl;
+
+    double baseline = bench::timeMs([&]() { writeWithStreamWrites(mesh, path); });
+    report("ofstream per-value (file)", baseline, megabytes, baseline);
+
+    bool identical = true;
+    for (int threads = 1; threads <= maxThreads; threads *= 2) {
+        double ms = bench::timeMs([&]() { io::writeSTL(mesh, path, true, threads); });
+        report("writeSTL file, " + std::to_string(threads) + "t", ms, megabytes, baseline);
+
+        std::string out;
+        ms = bench::timeMs([&]() { io::writeSTLToString(mesh, out, true, threads); });
+        report("writeSTLToString, " + std::to_string(threads) + "t", ms, megabytes, baseline);
+
+        auto back = io::readSTLFromMemory(reinterpret_cast<const uint8_t*>(out.data()), out.size());
+        identical = identical && back.success && back.value.positions == mesh.positions;
+    }
+
+    std::string text;
+    double asciiMs = bench::timeMs([&]() { io::writeSTLToString(mesh, text, false, maxThreads); }, 1);
+    std::cout << "ASCII, " << maxThreads << "t: " << std::setprecision(1) << asciiMs << " ms, "
+              << std::setprecision(0) << text.size() / (1024.0 * 1024.0) / (asciiMs / 1000.0) << " MB/s" << std::endl;
+
+    auto back = io::readSTLFromMemory(reinterpret_cast<const uint8_t*>(text.data()), text.size());
+    identical = identical && back.success && back.value.positions == mesh.positions;
+
+    std::remove(path.c_str());
+    std::cout << "Round trip identical: " << (identical ? "yes" : "NO") << std::endl;
+    return identical ? 0 : 1;
+}
@@ -1,9 +1,66 @@
 #include <pybind11/pybind11.h>
+#include <pybind11/numpy.h>
+#include <pybind11/stl.h>
 #include "geom-core/Analyzer.hpp"
 #include "geom-core/Vector3.hpp"
 
 namespace py = pybind11;
 
+namespace {
+
+// Mesh arrays are exchanged with NumPy as (N, 3) float64 / int32 arrays
+static_assert(sizeof(madfam::geom::Vector3) == 3 * sizeof(double), "Vector3 must be three packed doubles");
+static_assert(sizeof(madfam::geom::Triangle) == 3 * sizeof(int32_t), "Triangle must be three packed int32");
+
+using VertexArray = py::array_t<double, py::array::c_style | py::array::forcecast>;
+using FaceArray = py::array_t<int32_t, py::array::c_style | py::array::forcecast>;
+
+/**
+ * @brief Read-only NumPy array over memory kept alive by owner (no copy)
+ */
+template<typename T>
+py::array readOnlyView(py::handle owner, const T* data, std::vector<py::ssize_t> shape) {
+    py::array view(py::dtype::of<T>(), std::move(shape), data, owner);
+    py::detail::array_proxy(view.ptr())->flags &= ~py::detail::npy_api::NPY_ARRAY_WRITEABLE_;
+    return view;
+}
+
+/**
+ * @brief Read-only (N, 3) view of the Analyzer's current mesh arrays (no copy)
+ *
+ * The array's base holds the mesh itself (which, for load_mesh_arrays,
+ * holds the caller's arrays it refers to), so later loads start a new mesh
+ * and never touch what an existing array reads.
+ */
+template<typename T, typename Rows>
+py::array meshView(py::object self, Rows (*rows)(const madfam::geom::Mesh&)) {
+    auto* mesh = new std::shared_ptr<const madfam::geom::Mesh>(
+        self.cast<const madfam::geom::Analyzer&>().getMeshHandle());
+    py::capsule handle(mesh, [](void* p) { delete static_cast<std::shared_ptr<const madfam::geom::Mesh>*>(p); });
+
+    Rows values = *mesh ? rows(**mesh) : Rows();
+    return readOnlyView(handle, reinterpret_cast<const T*>(values.data()),
+                        {static_cast<py::ssize_t>(values.size()), 3});
+}
+
+/**
+ * @brief Read-only 1-D NumPy array that owns values (moved, no copy)
+ */
+template<typename T>
+py::array ownedArray(std::vector<T>&& values) {
+    auto* storage = new std::vector<T>(std::move(values));
+    py::capsule owner(storage, [](void* p) { delete static_cast<std::vector<T>*>(p); });
+    return readOnlyView(owner, storage->data(), {static_cast<py::ssize_t>(storage->size())});
+}
+
+void requireRows3(const py::array& values, const char* name) {
+    if (values.ndim() != 2 || values.shape(1) != 3) {
+        throw py::value_error(std::string(name) + " must have shape (N, 3)");
+    }
+}
+
+} // namespace
+
 PYBIND11_MODULE(geom_core_py, m) {
     m.doc() = "geom-core: High-performance geometry analysis library";
 
@@ -44,6 +101,59 @@ PYBIND11_MODULE(geom_core_py, m) {
                    " mm², optimized=" + std::to_string(r.optimizedOverhangArea) + " mm²)";
         });
 
+    // Spatial index builders
+    py::enum_<madfam::geom::BVHBuilder>(m, "BVHBuilder")
+        .value("MEDIAN", madfam::geom::BVHBuilder::Median)
+        .value("BINNED_SAH", madfam::geom::BVHBuilder::BinnedSAH)
+        .value("LINEAR", madfam::geom::BVHBuilder::Linear);
+
+    py::enum_<madfam::geom::BVHNodeFormat>(m, "BVHNodeFormat")
+        .value("BINARY", madfam::geom::BVHNodeFormat::Binary)
+        .value("WIDE4", madfam::geom::BVHNodeFormat::Wide4)
+        .value("WIDE4_QUANTIZED", madfam::geom::BVHNodeFormat::Wide4Quantized);
+
+    // Batch analysis
+    py::class_<madfam::geom::BatchOptions>(m, "BatchOptions")
+        .def(py::init<>())
+        .def_readwrite("critical_angle_degrees", &madfam::geom::BatchOptions::criticalAngleDegrees,
+                      "Overhang angle threshold (degrees)")
+        .def_readwrite("min_wall_thickness_mm", &madfam::geom::BatchOptions::minWallThicknessMM,
+                      "Thin-wall threshold (mm)")
+        .def_readwrite("auto_orient", &madfam::geom::BatchOptions::autoOrient,
+                      "Also find the optimal orientation of each file")
+        .def_readwrite("sample_resolution", &madfam::geom::BatchOptions::sampleResolution,
+                      "Orientations sampled by auto-orientation")
+        .def_readwrite("step_cache_directory", &madfam::geom::BatchOptions::stepCacheDirectory,
+                      "STEP tessellation cache directory (empty = disabled)")
+        .def_readwrite("step_cache_max_bytes", &madfam::geom::BatchOptions::stepCacheMaxBytes,
+                      "Size bound of the STEP tessellation cache");
+
+    py::class_<madfam::geom::BatchResult>(m, "BatchResult")
+        .def_readonly("filepath", &madfam::geom::BatchResult::filepath)
+        .def_readonly("success", &madfam::geom::BatchResult::success,
+                     "False if the file could not be loaded")
+        .def_readonly("vertex_count", &madfam::geom::BatchResult::vertexCount)
+        .def_readonly("triangle_count", &madfam::geom::BatchResult::triangleCount)
+        .def_readonly("volume", &madfam::geom::BatchResult::volume)
+        .def_readonly("watertight", &madfam::geom::BatchResult::watertight)
+        .def_readonly("bounding_box", &madfam::geom::BatchResult::boundingBox)
+        .def_readonly("report", &madfam::geom::BatchResult::report)
+        .def_readonly("orientation", &madfam::geom::BatchResult::orientation,
+                     "Only filled in when BatchOptions.auto_orient is set")
+        .def("__repr__", [](const madfam::geom::BatchResult& r) {
+            return "BatchResult(filepath='" + r.filepath + "', success=" + (r.success ? "True" : "False") +
+                   ", triangles=" + std::to_string(r.triangleCount) +
+                   ", score=" + std::to_string(r.report.score) + ")";
+        });
+
+    m.def("analyze_many", &madfam::geom::Analyzer::analyzeMany,
+          py::call_guard<py::gil_scoped_release>(),
+          "Load and analyze many mesh files on C++ threads started for the call (format by extension; "
+          "threads <= 0 uses all cores). Returns one BatchResult per path, in order",
+          py::arg("paths"),
+          py::arg("options") = madfam::geom::BatchOptions(),
+          py::arg("threads") = 0);
+
     // Vector3 class
     py::class_<madfam::geom::Vector3>(m, "Vector3")
         .def(py::init<>())
@@ -59,39 +169,203 @@ PYBIND11_MODULE(geom_core_py, m) {
         });
 
     // Analyzer class
+    // Heavy methods release the GIL, so separate Analyzer objects can be
+    // used from several Python threads at once (one thread per Analyzer)
     py::class_<madfam::geom::Analyzer>(m, "Analyzer")
         .def(py::init<>())
 
         // Real mesh analysis methods (Milestone 2)
         .def("load_stl", &madfam::geom::Analyzer::loadSTL,
-             "Load a mesh from binary STL file",
+             py::call_guard<py::gil_scoped_release>(),
+             "Load a mesh from binary STL file (num_threads <= 0 uses all cores)",
+             py::arg("filepath"),
+             py::arg("num_threads") = 1)
+        .def("load_obj", &madfam::geom::Analyzer::loadOBJ,
+             py::call_guard<py::gil_scoped_release>(),
+             "Load a mesh from a Wavefront OBJ file (num_threads <= 0 uses all cores)",
+             py::arg("filepath"),
+             py::arg("num_threads") = 1)
+        .def("load_3mf", &madfam::geom::Analyzer::load3MF,
+             py::call_guard<py::gil_scoped_release>(),
+             "Load a mesh from a 3MF package (all build items, in millimeters; "
+             "num_threads > 1 inflates while scanning, <= 0 uses all cores)",
+             py::arg("filepath"),
+             py::arg("num_threads") = 1)
+        .def("load_ply", &madfam::geom::Analyzer::loadPLY,
+             py::call_guard<py::gil_scoped_release>(),
+             "Load a mesh from a binary or ASCII PLY file (num_threads <= 0 uses all cores)",
+             py::arg("filepath"),
+             py::arg("num_threads") = 1)
+        .def("load_mesh_arrays",
+             [](madfam::geom::Analyzer& analyzer, VertexArray vertices, FaceArray faces) {
+                 requireRows3(vertices, "vertices");
+                 requireRows3(faces, "faces");
+                 madfam::geom::Span<const madfam::geom::Vector3> vertexView(
+                     reinterpret_cast<const madfam::geom::Vector3*>(vertices.data()),
+                     static_cast<size_t>(vertices.shape(0)));
+                 madfam::geom::Span<const madfam::geom::Triangle> faceView(
+                     reinterpret_cast<const madfam::geom::Triangle*>(faces.data()),
+                     static_cast<size_t>(faces.shape(0)));
+                 // The mesh refers to the arrays in place and holds them while
+                 // it exists; it may be dropped with the GIL released
+                 std::shared_ptr<const void> owner(
+                     new py::object(py::make_tuple(vertices, faces)),
+                     [](py::object* arrays) {
+                         py::gil_scoped_acquire gil;
+                         delete arrays;
+                     });
+                 py::gil_scoped_release release;
+                 return analyzer.loadMeshView(vertexView, faceView, std::move(owner));
+             },
+             "Load a mesh from NumPy arrays: vertices (N, 3) and faces (M, 3). "
+             "C-contiguous float64 vertices and int32 faces are used in place without "
+             "copying (other dtypes are converted once) and must not be modified afterwards",
+             py::arg("vertices"),
+             py::arg("faces"))
+        .def("load_stl_streaming",
+             [](madfam::geom::Analyzer& self, const std::string& filepath,
+                size_t memoryLimitBytes, const std::string& spillDirectory) {
+                 madfam::geom::StreamingOptions options;
+                 options.memoryLimitBytes = memoryLimitBytes;
+                 options.spillDirectory = spillDirectory;
+                 return self.loadSTLStreaming(filepath, options);
+             },
+             py::call_guard<py::gil_scoped_release>(),
+             "Analyze a binary STL file in a bounded-memory streaming pass "
+             "(volume, bounding box, watertightness and counts only)",
+             py::arg("filepath"),
+             py::arg("memory_limit_bytes") = 256u * 1024u * 1024u,
+             py::arg("spill_directory") = "")
+        .def("save_mesh_cache", &madfam::geom::Analyzer::saveMeshCache,
+             py::call_guard<py::gil_scoped_release>(),
+             "Save the loaded mesh (and spatial index, if built) as a .gcmesh cache file",
+             py::arg("filepath"))
+        .def("load_mesh_cache", &madfam::geom::Analyzer::loadMeshCache,
+             py::call_guard<py::gil_scoped_release>(),
+             "Load a .gcmesh cache file (mesh, adjacency and spatial index, no parsing)",
              py::arg("filepath"))
         .def("load_step", &madfam::geom::Analyzer::loadStep,
-             "Load a mesh from STEP file (requires OCCT)",
+             py::call_guard<py::gil_scoped_release>(),
+             "Load a mesh from STEP file (requires OCCT; num_threads <= 0 uses all cores)",
              py::arg("filepath"),
              py::arg("linear_deflection") = 0.1,
-             py::arg("angular_deflection") = 0.5)
+             py::arg("angular_deflection") = 0.5,
+             py::arg("num_threads") = 1)
+        .def("set_step_cache", &madfam::geom::Analyzer::setStepCache,
+             "Cache STEP tessellations in directory (keyed by file content, deflections and "
+             "library versions; least recently used entries beyond max_bytes are evicted). "
+             "An empty directory disables the cache",
+             py::arg("directory"),
+             py::arg("max_bytes") = 1ull << 30)
         .def("get_volume", &madfam::geom::Analyzer::getVolume,
+             py::call_guard<py::gil_scoped_release>(),
              "Calculate the volume of the loaded mesh")
         .def("is_watertight", &madfam::geom::Analyzer::isWatertight,
+             py::call_guard<py::gil_scoped_release>(),
              "Check if the loaded mesh is watertight (manifold)")
         .def("get_bounding_box", &madfam::geom::Analyzer::getBoundingBox,
+             py::call_guard<py::gil_scoped_release>(),
              "Get bounding box dimensions as Vector3(width, height, depth)")
         .def("get_vertex_count", &madfam::geom::Analyzer::getVertexCount,
              "Get number of vertices in the loaded mesh")
         .def("get_triangle_count", &madfam::geom::Analyzer::getTriangleCount,
              "Get number of triangles in the loaded mesh")
+        .def("get_vertices",
+             [](py::object self) {
+                 return meshView<double>(self, +[](const madfam::geom::Mesh& mesh) { return mesh.getVertices(); });
+             },
+             "Vertex positions as a read-only (N, 3) float64 NumPy view (no copy; keeps this mesh "
+             "alive and unchanged after later loads)")
+        .def("get_faces",
+             [](py::object self) {
+                 return meshView<int32_t>(self, +[](const madfam::geom::Mesh& mesh) { return mesh.getFaces(); });
+             },
+             "Triangle vertex indices as a read-only (M, 3) int32 NumPy view (no copy; keeps this mesh "
+             "alive and unchanged after later loads)")
 
         // Printability analysis (Milestone 4)
-        .def("build_spatial_index", &madfam::geom::Analyzer::buildSpatialIndex,
-             "Build spatial acceleration structure for ray queries (required for thickness analysis)")
+        .def("build_spatial_index",
+             [](madfam::geom::Analyzer& self, madfam::geom::BVHBuilder builder, uint32_t maxLeafTriangles,
+                int numThreads, madfam::geom::BVHNodeFormat nodeFormat, int treeletPasses) {
+                 madfam::geom::BVHBuildOptions options;
+                 options.builder = builder;
+                 options.maxLeafTriangles = maxLeafTriangles;
+                 options.numThreads = numThreads;
+                 options.nodeFormat = nodeFormat;
+                 options.treeletPasses = treeletPasses;
+                 self.buildSpatialIndex(options);
+             },
+             py::call_guard<py::gil_scoped_release>(),
+             "Build spatial acceleration structure for ray queries (required for thickness analysis); "
+             "num_threads <= 0 uses all cores and gives the same tree as 1; "
+             "treelet_passes refines BVHBuilder.LINEAR trees",
+             py::arg("builder") = madfam::geom::BVHBuilder::BinnedSAH,
+             py::arg("max_leaf_triangles") = 10,
+             py::arg("num_threads") = 1,
+             py::arg("node_format") = madfam::geom::BVHNodeFormat::Binary,
+             py::arg("treelet_passes") = 0)
         .def("get_printability_report", &madfam::geom::Analyzer::getPrintabilityReport,
+             py::call_guard<py::gil_scoped_release>(),
              "Analyze printability for 3D printing",
              py::arg("critical_angle_degrees") = 45.0,
              py::arg("min_wall_thickness_mm") = 0.8)
 
+        // Visualization data export (Milestone 8) - NumPy arrays owning the computed maps
+        .def("calculate_overhang_map",
+             [](const madfam::geom::Analyzer& self, double criticalAngleDegrees) {
+                 std::vector<uint8_t> map;
+                 {
+                     py::gil_scoped_release release;
+                     self.calculateOverhangMap(criticalAngleDegrees, map);
+                 }
+                 return ownedArray(std::move(map));
+             },
+             "Per-triangle overhang classification as a read-only uint8 NumPy array "
+             "(0 = safe, 1 = overhang, 2 = ground; computed in place, no copy)",
+             py::arg("critical_angle_degrees") = 45.0)
+        .def("calculate_wall_thickness_map",
+             [](const madfam::geom::Analyzer& self, double maxSearchDistanceMM, int numThreads) {
+                 std::vector<float> map;
+                 {
+                     py::gil_scoped_release release;
+                     self.calculateWallThicknessMap(maxSearchDistanceMM, numThreads, map);
+                 }
+                 return ownedArray(std::move(map));
+             },
+             "Per-vertex wall thickness in mm as a read-only float32 NumPy array "
+             "(requires build_spatial_index(); computed in place, no copy); "
+             "num_threads <= 0 uses all cores",
+             py::arg("max_search_distance_mm") = 10.0,
+             py::arg("num_threads") = 1)
+        .def("distance_to_surface",
+             [](const madfam::geom::Analyzer& self, VertexArray points, double maxDistanceMM, int numThreads) {
+                 requireRows3(points, "points");
+                 const size_t count = static_cast<size_t>(points.shape(0));
+                 py::array_t<double> distances(static_cast<py::ssize_t>(count));
+                 bool computed;
+                 {
+                     py::gil_scoped_release release;
+                     computed = self.distanceToSurface(
+                         madfam::geom::Span<const madfam::geom::Vector3>(
+                             reinterpret_cast<const madfam::geom::Vector3*>(points.data()), count),
+                         madfam::geom::Span<double>(distances.mutable_data(), count),
+                         maxDistanceMM, numThreads);
+                 }
+                 if (!computed) {
+                     throw std::runtime_error("Spatial index not built - call build_spatial_index() first");
+                 }
+                 return distances;
+             },
+             "Unsigned distance in mm from each of the (N, 3) points to the nearest triangle, "
+             "as a float64 array (requires build_spatial_index()); points farther than "
+             "max_distance_mm read as max_distance_mm; num_threads <= 0 uses all cores",
+             py::arg("points"),
+             py::arg("max_distance_mm") = std::numeric_limits<double>::max(),
+             py::arg("num_threads") = 1)
+
         // Auto-orientation (Milestone 5)
         .def("auto_orient", &madfam::geom::Analyzer::autoOrient,
+             py::call_guard<py::gil_scoped_release>(),
              "Find optimal mesh orientation to minimize overhang area",
              py::arg("sample_resolution") = 26,
              py::arg("critical_angle_degrees") = 45.0)
@@ -38,6 +38,28 @@ val getWallThicknessMapJS(Analyzer& self, double maxSearchDistanceMM) {
     return val(typed_memory_view(data.size(), data.data()));
 }
 
+// ========================================
+// Loader Wrappers
+// ========================================
+
+/**
+ * @brief Load binary STL bytes, decoding with the given number of threads
+ *
+ * Embind has no default arguments, so the single-argument loaders below
+ * keep the original JS signatures and use one thread.
+ */
+bool loadSTLFromBytesJS(Analyzer& self, const std::string& data) {
+    return self.loadSTLFromBytes(data);
+}
+
+bool loadSTLFromBytesThreadedJS(Analyzer& self, const std::string& data, int numThreads) {
+    return self.loadSTLFromBytes(data, numThreads);
+}
+
+bool loadSTLJS(Analyzer& self, const std::string& filepath) {
+    return self.loadSTL(filepath);
+}
+
 EMSCRIPTEN_BINDINGS(geom_core_module) {
     // PrintabilityReport struct
     value_object<PrintabilityReport>("PrintabilityReport")
@@ -63,14 +85,15 @@ EMSCRIPTEN_BINDINGS(geom_core_module) {
     // Analyzer class
     class_<Analyzer>("Analyzer")
         .constructor<>()
-        .function("loadSTLFromBytes", &Analyzer::loadSTLFromBytes)
-        .function("loadSTL", &Analyzer::loadSTL)
+        .function("loadSTLFromBytes", &loadSTLFromBytesJS)
+        .function("loadSTLFromBytesThreaded", &loadSTLFromBytesThreadedJS)
+        .function("loadSTL", &loadSTLJS)
         .function("getVolume", &Analyzer::getVolume)
         .function("isWatertight", &Analyzer::isWatertight)
         .function("getBoundingBox", &Analyzer::getBoundingBox)
         .function("getVertexCount", &Analyzer::getVertexCount)
         .function("getTriangleCount", &Analyzer::getTriangleCount)
-        .function("buildSpatialIndex", &Analyzer::buildSpatialIndex)
+        .function("buildSpatialIndex", select_overload<void()>(&Analyzer::buildSpatialIndex))
         .function("getPrintabilityReport", &Analyzer::getPrintabilityReport)
         .function("autoOrient", &Analyzer::autoOrient)
         // Visualization data export (Milestone 8) - Typed Arrays
@@ -1,6 +1,9 @@
 #pragma once
+#include <cstdint>
 #include <string>
 #include <memory>
+#include <optional>
+#include <vector>
 #include "Mesh.hpp"
 #include "Vector3.hpp"
 #include "Spatial.hpp"
@@ -41,6 +44,48 @@ namespace madfam::geom {
             , improvementPercent(0.0) {}
     };
 
+    /**
+     * @brief Settings for Analyzer::analyzeMany()
+     */
+    struct BatchOptions {
+        double criticalAngleDegrees;    // Overhang threshold
+        double minWallThicknessMM;      // Thin-wall threshold
+        bool autoOrient;                // Also run autoOrient() on each file
+        int sampleResolution;           // autoOrient() sample count
+        std::string stepCacheDirectory; // STEP tessellation cache (empty = off)
+        uint64_t stepCacheMaxBytes;
+
+        BatchOptions()
+            : criticalAngleDegrees(45.0)
+            , minWallThicknessMM(0.8)
+            , autoOrient(false)
+            , sampleResolution(26)
+            , stepCacheMaxBytes(1ull << 30) {}
+    };
+
+    /**
+     * @brief Analysis of one file from Analyzer::analyzeMany()
+     */
+    struct BatchResult {
+        std::string filepath;
+        bool success;                   // false if the file could not be loaded
+        size_t vertexCount;
+        size_t triangleCount;
+        double volume;
+        bool watertight;
+        Vector3 boundingBox;            // (width, height, depth)
+        PrintabilityReport report;
+        OrientationResult orientation;  // Only filled in with BatchOptions::autoOrient
+
+        BatchResult()
+            : success(false)
+            , vertexCount(0)
+            , triangleCount(0)
+            , volume(0.0)
+            , watertight(false)
+            , boundingBox(0, 0, 0) {}
+    };
+
     /**
      * @brief High-level geometry analysis interface
      *
@@ -59,25 +104,91 @@ namespace madfam::geom {
         /**
          * @brief Load a mesh from an STL file
          * @param filepath Path to binary STL file
+         * @param numThreads Threads used to decode and weld (<= 0 = all cores)
          * @return true if successful, false otherwise
+         *
+         * The loaded mesh is identical for every thread count.
          */
-        bool loadSTL(const std::string& filepath);
+        bool loadSTL(const std::string& filepath, int numThreads = 1);
 
         /**
          * @brief Load a mesh from STL data in memory (for WASM)
          * @param data Binary STL data as a string
+         * @param numThreads Threads used to decode and weld (<= 0 = all cores)
          * @return true if successful, false otherwise
          *
          * In JavaScript/WASM, you can pass a Uint8Array or binary string.
          * Emscripten will automatically convert it to std::string.
          */
-        bool loadSTLFromBytes(const std::string& data);
+        bool loadSTLFromBytes(const std::string& data, int numThreads = 1);
+
+        /**
+         * @brief Load a mesh from a Wavefront OBJ file
+         * @param filepath Path to OBJ file
+         * @param numThreads Threads used to parse (<= 0 = all cores)
+         * @return true if successful, false otherwise
+         */
+        bool loadOBJ(const std::string& filepath, int numThreads = 1);
+
+        /**
+         * @brief Load a mesh from a 3MF package (all build items, in millimeters)
+         * @param filepath Path to .3mf file
+         * @param numThreads Threads used to inflate and scan (<= 0 = all cores)
+         * @return true if successful, false otherwise
+         */
+        bool load3MF(const std::string& filepath, int numThreads = 1);
+
+        /**
+         * @brief Load a mesh from a PLY file (binary or ASCII, not welded)
+         * @param filepath Path to PLY file
+         * @param numThreads Threads used to decode binary data (<= 0 = all cores)
+         * @return true if successful, false otherwise
+         */
+        bool loadPLY(const std::string& filepath, int numThreads = 1);
+
+        /**
+         * @brief Load a mesh from in-memory arrays, taking over their storage
+         * @param vertices Vertex positions (moved from, no copy)
+         * @param faces Triangles indexing into vertices (moved from, no copy)
+         * @return false if a face refers to a missing vertex
+         */
+        bool loadMesh(std::vector<Vector3>&& vertices, std::vector<Triangle>&& faces);
+
+        /**
+         * @brief Analyze externally owned arrays in place (NumPy, WASM heap, mmap)
+         * @param vertices Vertex positions
+         * @param faces Triangles indexing into vertices
+         * @param owner Optional handle keeping the arrays alive; held by the
+         *        mesh, so it is released with it (see getMeshHandle())
+         * @return false if a face refers to a missing vertex
+         *
+         * Nothing is copied: the arrays must stay alive and unchanged until
+         * the next load or the Analyzer is destroyed.
+         */
+        bool loadMeshView(Span<const Vector3> vertices, Span<const Triangle> faces,
+                          std::shared_ptr<const void> owner = nullptr);
+
+        /**
+         * @brief Analyze an STL file in a bounded-memory streaming pass
+         * @param filepath Path to binary STL file
+         * @param options Memory cap, window size and spill settings
+         * @return true if successful, false otherwise
+         *
+         * For files larger than the worker's memory budget. The mesh is never
+         * held in memory: getVolume(), getBoundingBox(), isWatertight(),
+         * getVertexCount() and getTriangleCount() answer from the streamed
+         * summary. Analyses that need the full mesh (spatial index,
+         * printability, orientation) are unavailable until a regular load.
+         */
+        bool loadSTLStreaming(const std::string& filepath,
+                              const StreamingOptions& options = StreamingOptions());
 
         /**
          * @brief Load a mesh from a STEP file (requires OCCT)
          * @param filepath Path to STEP file (.step or .stp)
          * @param linearDeflection Tessellation precision in mm (default 0.1mm)
          * @param angularDeflection Angular precision in radians (default 0.5)
+         * @param numThreads Threads used to convert the tessellation (<= 0 = all cores)
          * @return true if successful, false otherwise
          *
          * This method requires Open CASCADE Technology (OCCT) to be installed.
@@ -87,10 +198,45 @@ namespace madfam::geom {
          * The linearDeflection parameter controls the maximum distance between
          * the tessellated mesh and the original CAD surface. Smaller values
          * produce more accurate (but larger) meshes.
+         *
+         * With setStepCache() enabled, a previous tessellation of the same
+         * file at the same settings is loaded from the cache instead.
          */
         bool loadStep(const std::string& filepath,
                      double linearDeflection = 0.1,
-                     double angularDeflection = 0.5);
+                     double angularDeflection = 0.5,
+                     int numThreads = 1);
+
+        /**
+         * @brief Cache STEP tessellations on disk (see loadStep())
+         * @param directory Cache directory; empty disables the cache
+         * @param maxBytes Size bound; least recently used entries are evicted
+         *
+         * Entries are keyed by a SHA-256 of the file content, its size, the
+         * deflection settings and the geom-core and OCCT versions. Each entry
+         * stores that identity and is only used when it matches, so a
+         * changed file or setting never hits a stale mesh. The directory can
+         * be shared between processes.
+         */
+        void setStepCache(const std::string& directory, uint64_t maxBytes = 1ull << 30);
+
+        /**
+         * @brief Save the loaded mesh (and spatial index, if built) as a .gcmesh cache
+         * @param filepath Destination path
+         * @return true if successful, false otherwise
+         */
+        bool saveMeshCache(const std::string& filepath) const;
+
+        /**
+         * @brief Load a mesh saved by saveMeshCache()
+         * @param filepath Path to a .gcmesh file
+         * @return true if successful, false otherwise
+         *
+         * Restores the welded mesh, its vertex-face adjacency and, when the
+         * file has one, the spatial index, so printability analysis can run
+         * without buildSpatialIndex().
+         */
+        bool loadMeshCache(const std::string& filepath);
 
         /**
          * @brief Calculate the volume of the loaded mesh
@@ -120,6 +266,29 @@ namespace madfam::geom {
          */
         size_t getTriangleCount() const;
 
+        /**
+         * @brief View of the loaded mesh's vertices (empty after a streaming load)
+         *
+         * Refers to the mesh storage directly; valid until the next load.
+         */
+        Span<const Vector3> getVertices() const;
+
+        /**
+         * @brief View of the loaded mesh's triangles (empty after a streaming load)
+         *
+         * Refers to the mesh storage directly; valid until the next load.
+         */
+        Span<const Triangle> getFaces() const;
+
+        /**
+         * @brief Shared ownership of the loaded mesh
+         *
+         * Every load starts a new Mesh, so a held handle keeps the arrays
+         * behind getVertices()/getFaces() alive and unchanged across later
+         * loads (for views handed to other owners, such as NumPy arrays).
+         */
+        std::shared_ptr<const Mesh> getMeshHandle() const;
+
         // ========================================
         // Printability Analysis (Milestone 4)
         // ========================================
@@ -128,10 +297,19 @@ namespace madfam::geom {
          * @brief Build spatial acceleration structure for ray queries
          *
          * Call this after loading a mesh and before running printability analysis.
-         * Required for wall thickness checks.
+         * Required for wall thickness checks. Uses the default builder
+         * (binned SAH).
          */
         void buildSpatialIndex();
 
+        /**
+         * @brief Build the spatial index with explicit builder settings
+         * @param options Split strategy (median, binned SAH, or linear for the
+         *        fastest build on very large meshes), leaf size and build
+         *        threads (any thread count gives the same tree)
+         */
+        void buildSpatialIndex(const BVHBuildOptions& options);
+
         /**
          * @brief Analyze printability for 3D printing
          *
@@ -182,10 +360,19 @@ namespace madfam::geom {
          */
         const std::vector<uint8_t>& calculateOverhangMap(double criticalAngleDegrees);
 
+        /**
+         * @brief Calculate the overhang map into caller-owned storage
+         *
+         * Same values as calculateOverhangMap(); map is replaced (empty if no
+         * mesh is loaded).
+         */
+        void calculateOverhangMap(double criticalAngleDegrees, std::vector<uint8_t>& map) const;
+
         /**
          * @brief Calculate per-vertex wall thickness values
          *
          * @param minWallThicknessMM Minimum acceptable wall thickness (typically 0.8-2.0mm)
+         * @param numThreads Threads used to cast the rays (<= 0 = all cores; same result)
          * @return Vector of float with size = vertex count
          *         Values: Distance to nearest opposite wall in mm
          *
@@ -193,7 +380,53 @@ namespace madfam::geom {
          * Requires buildSpatialIndex() to be called first.
          * Returns 0.0 for vertices where no opposite wall is found.
          */
-        const std::vector<float>& calculateWallThicknessMap(double maxSearchDistanceMM);
+        const std::vector<float>& calculateWallThicknessMap(double maxSearchDistanceMM, int numThreads = 1);
+
+        /**
+         * @brief Calculate the wall thickness map into caller-owned storage
+         *
+         * Same values as calculateWallThicknessMap(); map is replaced (empty
+         * if no mesh is loaded or the spatial index is not built).
+         */
+        void calculateWallThicknessMap(double maxSearchDistanceMM, int numThreads,
+                                       std::vector<float>& map) const;
+
+        /**
+         * @brief Unsigned distance from each point to the nearest triangle
+         *
+         * @param points Query points
+         * @param distances Output, one per point
+         * @param maxDistanceMM Points farther from the mesh read as this value
+         * @param numThreads Query threads (<= 0 = all cores; same result)
+         * @return false if the sizes differ or the spatial index is not built
+         *
+         * Exact closest-point queries on the spatial index, for clearance
+         * and tolerance checks. Requires buildSpatialIndex() to be called first.
+         */
+        bool distanceToSurface(Span<const Vector3> points, Span<double> distances,
+                               double maxDistanceMM = std::numeric_limits<double>::max(),
+                               int numThreads = 1) const;
+
+        // ========================================
+        // Batch Analysis
+        // ========================================
+
+        /**
+         * @brief Load and analyze many files on worker threads started for the call
+         * @param filepaths Mesh files; the format follows the extension
+         *        (.stl, .obj, .3mf, .ply, .gcmesh, .step/.stp)
+         * @param options Analysis thresholds
+         * @param numThreads Files analyzed concurrently (<= 0 = all cores)
+         * @return One result per path, in input order
+         *
+         * Each file gets its own Analyzer (load, spatial index, printability
+         * report and optionally auto-orientation), so results match
+         * analyzing the files one by one. Files that fail to load are
+         * reported with success = false.
+         */
+        static std::vector<BatchResult> analyzeMany(const std::vector<std::string>& filepaths,
+                                                    const BatchOptions& options = BatchOptions(),
+                                                    int numThreads = 0);
 
         // ========================================
         // Legacy Methods (for backward compatibility)
@@ -217,9 +450,22 @@ namespace madfam::geom {
         int add(int a, int b);
 
     private:
-        std::unique_ptr<Mesh> mesh;
+        // Shared so getMeshHandle() can outlive the next load
+        std::shared_ptr<Mesh> mesh;
         std::unique_ptr<AABBTree> spatialTree;
 
+        // Set by loadSTLStreaming(); cleared by every full mesh load
+        std::optional<MeshSummary> streamSummary;
+
+        // STEP tessellation cache (disabled while the directory is empty)
+        std::string stepCacheDirectory;
+        uint64_t stepCacheMaxBytes = 1ull << 30;
+
+        /**
+         * @brief New mesh to load into, with state derived from the previous mesh dropped
+         */
+        Mesh& prepareMeshLoad();
+
         // Cached visualization data (Milestone 8)
         std::vector<uint8_t> overhangMapCache;
         std::vector<float> wallThicknessCache;
@@ -1,7 +1,11 @@
 #pragma once
 #include "Vector3.hpp"
+#include "Span.hpp"
+#include <cstdint>
 #include <vector>
 #include <string>
+#include <functional>
+#include <memory>
 
 namespace madfam::geom {
 
@@ -15,6 +19,58 @@ struct Triangle {
     Triangle(int a, int b, int c) : v0(a), v1(b), v2(c) {}
 };
 
+/**
+ * @brief Vertex-to-face adjacency in CSR (compressed sparse row) form
+ *
+ * Faces using vertex v are faceIndices[offsets[v] .. offsets[v + 1]), in
+ * ascending face order. A face that repeats a vertex is listed once.
+ */
+struct VertexFaceAdjacency {
+    std::vector<uint32_t> offsets;      // vertexCount + 1 entries
+    std::vector<uint32_t> faceIndices;
+
+    bool empty() const { return offsets.empty(); }
+};
+
+class AABBTree;
+
+/**
+ * @brief Options for bounded-memory streaming analysis (Mesh::streamSTL)
+ */
+struct StreamingOptions {
+    size_t memoryLimitBytes;    // Cap on buffers held by the streaming pass
+    size_t windowTriangles;     // Triangles read and welded per window
+    bool allowSpill;            // Spill vertex/edge tables to disk when over the cap
+    std::string spillDirectory; // Where spill files go (empty = system temp files)
+
+    StreamingOptions()
+        : memoryLimitBytes(256u * 1024u * 1024u)
+        , windowTriangles(1u << 16)
+        , allowSpill(true) {}
+};
+
+/**
+ * @brief Whole-mesh properties computed by a streaming pass
+ *
+ * Values match what Mesh::getVolume(), getBoundingBox() and isWatertight()
+ * return for the same file loaded with exact welding.
+ */
+struct MeshSummary {
+    size_t vertexCount;      // Unique (welded) vertices
+    size_t triangleCount;
+    double volume;
+    Vector3 boundingBox;     // (width, height, depth)
+    bool watertight;
+    size_t spillPartitions;  // 0 = everything stayed in memory
+
+    MeshSummary()
+        : vertexCount(0)
+        , triangleCount(0)
+        , volume(0.0)
+        , watertight(false)
+        , spillPartitions(0) {}
+};
+
 /**
  * @brief Triangular mesh data structure
  *
@@ -27,24 +83,161 @@ public:
     ~Mesh() = default;
 
     /**
-     * @brief Load mesh from binary STL file
-     * @param filepath Path to the binary STL file
+     * @brief Load mesh from STL file (binary or ASCII)
+     * @param filepath Path to the STL file
+     * @param weldTolerance Distance below which vertices are merged (0 = exact match)
+     * @param numThreads Worker threads for decoding/welding (<= 0 = all cores)
      * @return true if successful, false otherwise
      *
      * Automatically deduplicates vertices to create a proper connected mesh.
+     * The file is memory-mapped and decoded in place (no heap staging copy);
+     * pages are released as soon as their triangles have been welded.
+     * ASCII files (including multi-solid files) are detected automatically.
      */
-    bool loadFromSTL(const std::string& filepath);
+    bool loadFromSTL(const std::string& filepath, double weldTolerance = 0.0, int numThreads = 1);
 
     /**
-     * @brief Load mesh from binary STL data in memory
-     * @param buffer Pointer to binary STL data
+     * @brief Load mesh from STL data in memory (binary or ASCII)
+     * @param buffer Pointer to STL data
      * @param size Size of the buffer in bytes
+     * @param weldTolerance Distance below which vertices are merged (0 = exact match)
+     * @param numThreads Worker threads for decoding/welding (<= 0 = all cores)
      * @return true if successful, false otherwise
      *
-     * Automatically deduplicates vertices to create a proper connected mesh.
-     * This method is used for WASM where there's no file system.
+     * Automatically deduplicates vertices to create a proper connected mesh
+     * using a hash-grid VertexWelder. This method is used for WASM where
+     * there's no file system.
+     *
+     * Triangles are decoded and welded in fixed 64K-triangle chunks (in
+     * parallel when numThreads > 1), then merged in chunk order. The result
+     * is identical for every thread count; with weldTolerance == 0 it is also
+     * identical to a single serial welding pass.
+     */
+    bool loadFromSTLBuffer(const char* buffer, size_t size, double weldTolerance = 0.0,
+                           int numThreads = 1);
+
+    /**
+     * @brief Load mesh from a Wavefront OBJ file
+     * @param filepath Path to the OBJ file
+     * @param numThreads Worker threads for parsing (<= 0 = all cores)
+     * @return true if successful, false otherwise
+     *
+     * Only geometry is read: "v" positions and "f" faces (any of the
+     * v, v/vt, v//vn, v/vt/vn corner forms, negative indices allowed).
+     * Polygons are fan-triangulated. Vertices keep the file's order and are
+     * not welded, so per-vertex results line up with the file's "v" lines.
+     */
+    bool loadFromOBJ(const std::string& filepath, int numThreads = 1);
+
+    /**
+     * @brief Load mesh from OBJ text in memory
+     * @param buffer Pointer to OBJ text
+     * @param size Size of the buffer in bytes
+     * @param numThreads Worker threads for parsing (<= 0 = all cores)
+     * @return true if successful, false otherwise
+     *
+     * The text is split into fixed-size chunks on line boundaries which are
+     * parsed in parallel; the result is identical for every thread count.
+     */
+    bool loadFromOBJBuffer(const char* buffer, size_t size, int numThreads = 1);
+
+    /**
+     * @brief Load mesh from a 3MF package
+     * @param filepath Path to the .3mf file
+     * @param numThreads More than one (<= 0 = all cores) inflates the model
+     *        on a second thread while its XML is scanned
+     * @return true if successful, false otherwise
+     *
+     * Every build item is placed with its transform (components included)
+     * and converted to millimeters. Vertices are shared as in the file;
+     * separate objects are not welded to each other.
+     */
+    bool loadFrom3MF(const std::string& filepath, int numThreads = 1);
+
+    /**
+     * @brief Load mesh from a 3MF package in memory
+     * @param buffer Pointer to the ZIP package bytes
+     * @param size Size of the buffer in bytes
+     * @param numThreads See loadFrom3MF()
+     * @return true if successful, false otherwise
+     */
+    bool loadFrom3MFBuffer(const char* buffer, size_t size, int numThreads = 1);
+
+    /**
+     * @brief Load mesh from a PLY file (binary little/big endian or ASCII)
+     * @param filepath Path to the PLY file
+     * @param numThreads Worker threads for binary decoding (<= 0 = all cores)
+     * @return true if successful, false otherwise
+     *
+     * The vertex (x, y, z) and face (vertex_indices) elements are read as
+     * indexed in the file; vertices are not welded. Other properties and
+     * elements are skipped. Polygons are fan-triangulated.
+     */
+    bool loadFromPLY(const std::string& filepath, int numThreads = 1);
+
+    /**
+     * @brief Load mesh from PLY data in memory
+     * @param buffer Pointer to PLY data
+     * @param size Size of the buffer in bytes
+     * @param numThreads Worker threads for binary decoding (<= 0 = all cores)
+     * @return true if successful, false otherwise
+     *
+     * Binary vertex and triangle records are decoded in parallel blocks
+     * straight into the mesh arrays; the result is identical for every
+     * thread count.
      */
-    bool loadFromSTLBuffer(const char* buffer, size_t size);
+    bool loadFromPLYBuffer(const char* buffer, size_t size, int numThreads = 1);
+
+    /**
+     * @brief Analyze a binary STL file without loading it (out-of-core)
+     * @param filepath Path to the binary STL file
+     * @param options Memory cap, window size and spill settings
+     * @param summary Output: vertex/triangle counts, volume, bbox, watertightness
+     * @return true if successful, false otherwise
+     *
+     * Reads fixed-size windows of triangles and never holds the full triangle
+     * soup. Each window is welded locally; its unique vertices and edges
+     * (with use counts) are hash-partitioned. If the partitions would exceed
+     * memoryLimitBytes, they are spilled to temporary files and reduced one
+     * partition at a time, so peak memory stays bounded by the limit. A limit
+     * that would need more than 256 partitions is rejected.
+     */
+    static bool streamSTL(const std::string& filepath,
+                          const StreamingOptions& options,
+                          MeshSummary& summary);
+
+    /**
+     * @brief Write the mesh to a .gcmesh cache file
+     * @param filepath Destination (written to a temporary file, then renamed)
+     * @param tree Optional spatial index to store alongside the mesh
+     * @param source Optional identity of what the mesh was derived from
+     *        (opaque bytes, checked by loadCache())
+     * @return true if successful, false otherwise
+     *
+     * A .gcmesh file is a versioned container of fixed-layout sections:
+     * welded vertices, faces, vertex-face adjacency and (optionally) the
+     * flattened BVH. Loading it back needs no parsing, welding or tree
+     * building. The format is native-endian and meant as a local cache,
+     * not an interchange format.
+     */
+    bool saveCache(const std::string& filepath, const AABBTree* tree = nullptr,
+                   const std::string& source = std::string()) const;
+
+    /**
+     * @brief Load a mesh from a .gcmesh cache file
+     * @param filepath Path written by saveCache()
+     * @param tree Optional: receives the stored spatial index (left unbuilt
+     *        if the file has none)
+     * @param expectedSource If not empty, the file must have been saved with
+     *        exactly this source identity
+     * @return true if successful, false otherwise (version mismatch, corrupt
+     *         file, different source)
+     *
+     * The file is memory-mapped and its sections are copied straight into
+     * the mesh arrays.
+     */
+    bool loadCache(const std::string& filepath, AABBTree* tree = nullptr,
+                   const std::string& expectedSource = std::string());
 
     /**
      * @brief Calculate the volume of the mesh using signed tetrahedron method
@@ -73,43 +266,122 @@ public:
     /**
      * @brief Get the number of vertices in the mesh
      */
-    size_t getVertexCount() const { return vertices.size(); }
+    size_t getVertexCount() const { return getVertices().size(); }
 
     /**
      * @brief Get the number of triangles in the mesh
      */
-    size_t getTriangleCount() const { return faces.size(); }
+    size_t getTriangleCount() const { return getFaces().size(); }
 
     /**
-     * @brief Clear all mesh data
+     * @brief Clear all mesh data (and drop any wrapped external arrays)
      */
     void clear();
 
     /**
-     * @brief Get const reference to vertex array (for spatial indexing)
+     * @brief View of the vertex array (owned or wrapped), e.g. for spatial indexing
      */
-    const std::vector<Vector3>& getVertices() const { return vertices; }
+    Span<const Vector3> getVertices() const {
+        return externalVertices ? vertexView : Span<const Vector3>(vertices);
+    }
 
     /**
-     * @brief Get const reference to face array (for spatial indexing)
+     * @brief View of the face array (owned or wrapped), e.g. for spatial indexing
      */
-    const std::vector<Triangle>& getFaces() const { return faces; }
+    Span<const Triangle> getFaces() const {
+        return externalFaces ? faceView : Span<const Triangle>(faces);
+    }
+
+    /**
+     * @brief Whether vertices or faces are externally owned arrays (see wrap())
+     */
+    bool isView() const { return externalVertices || externalFaces; }
+
+    /**
+     * @brief Faces around each vertex (built on first use, then cached)
+     *
+     * O(V + F) to build. The first call is not thread-safe; later calls are.
+     */
+    const VertexFaceAdjacency& getVertexFaceAdjacency() const;
 
     /**
      * @brief Set vertices directly (for STEP loader and other importers)
-     * @param verts Vector of vertices to set
+     * @param verts Vector of vertices to set (copied)
+     */
+    void setVertices(const std::vector<Vector3>& verts) { setVertices(std::vector<Vector3>(verts)); }
+
+    /**
+     * @brief Set vertices by taking over the vector's storage (no copy)
      */
-    void setVertices(const std::vector<Vector3>& verts) { vertices = verts; }
+    void setVertices(std::vector<Vector3>&& verts);
 
     /**
      * @brief Set triangles directly (for STEP loader and other importers)
-     * @param tris Vector of triangles to set
+     * @param tris Vector of triangles to set (copied)
+     */
+    void setTriangles(const std::vector<Triangle>& tris) { setTriangles(std::vector<Triangle>(tris)); }
+
+    /**
+     * @brief Set triangles by taking over the vector's storage (no copy)
+     */
+    void setTriangles(std::vector<Triangle>&& tris);
+
+    /**
+     * @brief Take over complete vertex and face arrays without copying
+     * @return false (mesh left empty) if a face refers to a missing vertex
+     *
+     * Importers should build their arrays and hand them over here, so the
+     * mesh never exists twice in memory.
+     */
+    bool adopt(std::vector<Vector3>&& verts, std::vector<Triangle>&& tris);
+
+    /**
+     * @brief Use externally owned arrays in place (NumPy, WASM heap, mmap)
+     * @return false (mesh left empty) if a face refers to a missing vertex
+     *
+     * Nothing is copied. The arrays must stay alive and unchanged until the
+     * mesh is cleared, reloaded or destroyed; owner, if given, is held until
+     * then to keep them alive. Loading into the mesh replaces the view with
+     * owned storage as usual.
      */
-    void setTriangles(const std::vector<Triangle>& tris) { faces = tris; }
+    bool wrap(Span<const Vector3> verts, Span<const Triangle> tris,
+              std::shared_ptr<const void> owner = nullptr);
 
 private:
+    // Owned storage; unused for an array that is wrapped
     std::vector<Vector3> vertices;
     std::vector<Triangle> faces;
+
+    // Externally owned arrays set by wrap()
+    Span<const Vector3> vertexView;
+    Span<const Triangle> faceView;
+    bool externalVertices = false;
+    bool externalFaces = false;
+    std::shared_ptr<const void> viewOwner;  // Released once nothing is wrapped
+
+    // Lazily built by getVertexFaceAdjacency(); reset whenever faces change
+    mutable VertexFaceAdjacency adjacency;
+
+    /**
+     * @brief Shared STL decoder behind loadFromSTL/loadFromSTLBuffer
+     *
+     * Detects ASCII vs binary and feeds both through weldTriangles, so the
+     * same triangles produce the same welded mesh in either encoding.
+     * @param chunkDone Optional callback receiving (offset, length) of each
+     *        byte range that has been fully decoded (may run on worker threads)
+     */
+    bool parseSTL(const char* buffer, size_t size, double weldTolerance, int numThreads,
+                  const std::function<void(size_t, size_t)>& chunkDone);
+
+    /**
+     * @brief Weld a triangle soup into vertices/faces in fixed-size chunks
+     * @param records First triangle's 9 packed floats (x0 y0 z0 x1 ... z2)
+     * @param stride Bytes between consecutive triangles
+     * @param chunkDone Optional callback receiving (first, count) triangles welded
+     */
+    void weldTriangles(const char* records, size_t stride, size_t triangleCount,
+                       double weldTolerance, int numThreads,
+                       const std::function<void(size_t, size_t)>& chunkDone);
 };
 
 } // namespace madfam::geom
@@ -0,0 +1,53 @@
+#pragma once
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+namespace madfam::geom {
+
+/**
+ * @brief Non-owning view of a contiguous array (a minimal C++17 std::span)
+ *
+ * Converts implicitly from std::vector, so functions taking Span<const T>
+ * accept vectors, Mesh storage and externally owned buffers (NumPy arrays,
+ * the WASM heap, memory-mapped files) alike. The viewed memory must outlive
+ * the span.
+ */
+template<typename T>
+class Span {
+public:
+    using element_type = T;
+    using value_type = std::remove_cv_t<T>;
+    using iterator = T*;
+
+    constexpr Span() noexcept = default;
+    constexpr Span(T* data, size_t size) noexcept : ptr(data), count(size) {}
+
+    template<typename U, typename A,
+             typename = std::enable_if_t<std::is_convertible<U (*)[], T (*)[]>::value>>
+    Span(std::vector<U, A>& values) noexcept : ptr(values.data()), count(values.size()) {}
+
+    template<typename U, typename A,
+             typename = std::enable_if_t<std::is_convertible<const U (*)[], T (*)[]>::value>>
+    Span(const std::vector<U, A>& values) noexcept : ptr(values.data()), count(values.size()) {}
+
+    template<typename U, typename = std::enable_if_t<std::is_convertible<U (*)[], T (*)[]>::value>>
+    constexpr Span(const Span<U>& other) noexcept : ptr(other.data()), count(other.size()) {}
+
+    constexpr T* data() const noexcept { return ptr; }
+    constexpr size_t size() const noexcept { return count; }
+    constexpr bool empty() const noexcept { return count == 0; }
+
+    constexpr T& operator[](size_t index) const { return ptr[index]; }
+    constexpr T& front() const { return ptr[0]; }
+    constexpr T& back() const { return ptr[count - 1]; }
+
+    constexpr iterator begin() const noexcept { return ptr; }
+    constexpr iterator end() const noexcept { return ptr + count; }
+
+private:
+    T* ptr = nullptr;
+    size_t count = 0;
+};
+
+} // namespace madfam::geom
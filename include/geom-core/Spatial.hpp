@@ -1,9 +1,10 @@
 #pragma once
 #include "Vector3.hpp"
 #include "Mesh.hpp"
+#include <cmath>
+#include <cstdint>
 #include <vector>
 #include <limits>
-#include <memory>
 
 namespace madfam::geom {
 
@@ -96,11 +97,170 @@ struct RayHit {
     RayHit() : hit(false), distance(std::numeric_limits<double>::max()), triangleIndex(-1) {}
 };
 
+/**
+ * @brief Result of a closest-point query
+ */
+struct ClosestPoint {
+    bool found;          // false if no triangle lies within the search distance
+    double distance;     // Unsigned distance from the query point to point
+    int triangleIndex;
+    Vector3 point;       // Nearest point on the mesh
+
+    ClosestPoint() : found(false), distance(std::numeric_limits<double>::max()), triangleIndex(-1) {}
+};
+
+/**
+ * @brief Node of a flattened BVH (stored in one array, root at index 0)
+ *
+ * 32 bytes, so two nodes share a cache line. Bounds are single precision,
+ * rounded outward so they still contain the double precision triangles.
+ * Nodes are in depth-first order: an interior node's first child is the
+ * next node and only the second child's index is stored.
+ *
+ * Plain data with no pointers, so a node array can be written to and
+ * mapped back from a .gcmesh cache file as-is.
+ */
+struct BVHNode {
+    float boundsMin[3];
+    float boundsMax[3];
+    uint32_t offset;         // Leaves: first entry in AABBTree::getTriangleOrder(); interior: second child
+    uint32_t triangleCount;  // 0 for interior nodes
+
+    bool isLeaf() const { return triangleCount > 0; }
+
+    /**
+     * @brief Store box, rounding outward to float
+     */
+    void setBounds(const AABB& box) {
+        const double lo[3] = {box.min.x, box.min.y, box.min.z};
+        const double hi[3] = {box.max.x, box.max.y, box.max.z};
+        for (int i = 0; i < 3; ++i) {
+            boundsMin[i] = static_cast<float>(lo[i]);
+            boundsMax[i] = static_cast<float>(hi[i]);
+            if (boundsMin[i] > lo[i]) boundsMin[i] = std::nextafter(boundsMin[i], -std::numeric_limits<float>::infinity());
+            if (boundsMax[i] < hi[i]) boundsMax[i] = std::nextafter(boundsMax[i], std::numeric_limits<float>::infinity());
+        }
+    }
+
+    AABB bounds() const {
+        return AABB(Vector3(boundsMin[0], boundsMin[1], boundsMin[2]),
+                    Vector3(boundsMax[0], boundsMax[1], boundsMax[2]));
+    }
+};
+
+static_assert(sizeof(BVHNode) == 32, "BVHNode must stay half a cache line");
+
+/**
+ * @brief Split strategy for AABBTree::build()
+ *
+ * Trades build time for tree quality: Linear builds fastest, for one-off
+ * query passes over very large meshes; BinnedSAH gives the fastest queries.
+ */
+enum class BVHBuilder {
+    Median,     // Sort by centroid and split in half along the longest axis
+    BinnedSAH,  // Binned surface area heuristic over all three axes
+    Linear      // Radix tree over Morton-sorted centroids (LBVH), optionally refined by treelets
+};
+
+/**
+ * @brief Node layout AABBTree traverses for ray casts
+ *
+ * The binary BVHNode tree is always built (and cached); wide formats are
+ * collapsed from it, four children per node, and test a ray against all
+ * four child boxes with one SIMD kernel (SSE2 or WASM SIMD128, scalar
+ * elsewhere). They pay off for rays through open space; rays cast from
+ * mesh vertices, as in wall thickness analysis, touch every leaf around the
+ * vertex and are as fast with Binary (see bench_bvh).
+ */
+enum class BVHNodeFormat {
+    Binary,          // BVHNode: two double precision box tests per visited node
+    Wide4,           // BVH4Node: 128 bytes, float child boxes
+    Wide4Quantized   // BVH4QuantizedNode: 64 bytes, 8-bit child boxes
+};
+
+/**
+ * @brief AABBTree build settings
+ */
+struct BVHBuildOptions {
+    BVHBuilder builder;
+    uint32_t maxLeafTriangles;   // Larger ranges are always split
+    int numThreads;              // Build threads (<= 0 = all cores); the tree does not depend on it
+    BVHNodeFormat nodeFormat;    // Layout used by rayCast()
+    int treeletPasses;           // Linear builder: SAH treelet re-optimization passes (0 = none)
+
+    BVHBuildOptions()
+        : builder(BVHBuilder::BinnedSAH)
+        , maxLeafTriangles(10)
+        , numThreads(1)
+        , nodeFormat(BVHNodeFormat::Binary)
+        , treeletPasses(0) {}
+};
+
+/**
+ * @brief AABBTree::rayCastBatch() settings
+ */
+struct RayBatchOptions {
+    double maxDistance;   // Search distance for every ray, as in rayCast()
+    int numThreads;       // Casting threads (<= 0 = all cores); hits do not depend on it
+
+    RayBatchOptions()
+        : maxDistance(std::numeric_limits<double>::max())
+        , numThreads(1) {}
+};
+
+/**
+ * @brief AABBTree::closestPointBatch() settings
+ */
+struct PointBatchOptions {
+    double maxDistance;   // Search distance for every point, as in closestPoint()
+    int numThreads;       // Query threads (<= 0 = all cores); results do not depend on it
+
+    PointBatchOptions()
+        : maxDistance(std::numeric_limits<double>::max())
+        , numThreads(1) {}
+};
+
+/**
+ * @brief 4-wide BVH node with float child boxes (two cache lines)
+ *
+ * Child boxes are stored as structure-of-arrays lanes, so one SIMD kernel
+ * tests a ray against all four. Unused lanes have an EMPTY child.
+ */
+struct BVH4Node {
+    static constexpr uint32_t EMPTY = 0xffffffffu;
+
+    float bounds[6][4];      // minX, minY, minZ, maxX, maxY, maxZ per child
+    uint32_t children[4];    // Interior child: wide node index; leaf: first triangle-order entry
+    uint32_t counts[4];      // Leaf triangle count, 0 for interior children
+};
+
+/**
+ * @brief 4-wide BVH node with child boxes quantized to 8 bits (one cache line)
+ *
+ * Child planes along axis a are origin[a] + q * 2^exponent[a], with q
+ * rounded outward within the parent's box.
+ */
+struct BVH4QuantizedNode {
+    float origin[3];
+    int8_t exponent[3];
+    uint8_t unused;
+    uint8_t bounds[6][4];    // Quantized minX, minY, minZ, maxX, maxY, maxZ per child
+    uint32_t children[4];    // As in BVH4Node
+    uint16_t counts[4];
+};
+
+static_assert(sizeof(BVH4Node) == 128, "BVH4Node must stay two cache lines");
+static_assert(sizeof(BVH4QuantizedNode) == 64, "BVH4QuantizedNode must stay one cache line");
+
 /**
  * @brief Axis-Aligned Bounding Box Tree for spatial acceleration
  *
  * Implements a simple BVH (Bounding Volume Hierarchy) for fast ray-triangle queries.
  * Essential for wall thickness analysis on large meshes.
+ *
+ * Nodes live in a single flat array in depth-first order; each leaf refers
+ * to a contiguous range of a shared triangle-order array. Ray casts walk the
+ * array with an explicit stack, nearer child first.
  */
 class AABBTree {
 public:
@@ -111,9 +271,14 @@ public:
      * @brief Build tree from mesh data
      * @param vertices Mesh vertex array
      * @param faces Mesh triangle array
+     * @param options Split strategy, leaf size, threads and node format
+     *
+     * The tree refers to the arrays without copying them; they must outlive
+     * the tree (or the next build()/clear()). An empty mesh leaves the tree
+     * unbuilt.
      */
-    void build(const std::vector<Vector3>& vertices,
-              const std::vector<Triangle>& faces);
+    void build(Span<const Vector3> vertices, Span<const Triangle> faces,
+               const BVHBuildOptions& options = BVHBuildOptions());
 
     /**
      * @brief Cast a ray through the tree
@@ -123,40 +288,142 @@ public:
      */
     RayHit rayCast(const Ray& ray, double maxDistance = std::numeric_limits<double>::max()) const;
 
+    /**
+     * @brief Cast many rays; hits[i] receives rayCast(rays[i], options.maxDistance)
+     * @return false (hits untouched) if hits and rays differ in size
+     *
+     * Rays are cast in order of direction octant and origin Morton code
+     * rather than as given, so consecutive rays visit the same nodes and
+     * triangles while they are still in cache. Large batches are split
+     * across options.numThreads.
+     */
+    bool rayCastBatch(Span<const Ray> rays, Span<RayHit> hits,
+                      const RayBatchOptions& options = RayBatchOptions()) const;
+
+    /**
+     * @brief Whether any triangle crosses ray within maxDistance
+     *
+     * Stops at the first hit instead of searching for the closest, and
+     * builds no hit record; same result as rayCast(ray, maxDistance).hit
+     * on the binary layout. Traverses the binary nodes for any node format.
+     */
+    bool occluded(const Ray& ray, double maxDistance) const;
+
+    /**
+     * @brief results[i] = 1 if occluded(rays[i], options.maxDistance), else 0
+     * @return false (results untouched) if results and rays differ in size
+     *
+     * Rays are ordered and split across threads as in rayCastBatch().
+     */
+    bool occludedBatch(Span<const Ray> rays, Span<uint8_t> results,
+                       const RayBatchOptions& options = RayBatchOptions()) const;
+
+    /**
+     * @brief Nearest point on the mesh to point
+     * @param maxDistance Only triangles closer than this are considered; a
+     *        tight bound skips most of the tree
+     * @return The closest point, or found == false if none is within maxDistance
+     *
+     * Branch and bound over the binary nodes (for any node format): subtrees
+     * whose box is no closer than the best triangle so far are skipped, and
+     * each remaining triangle is measured exactly. Ties keep the first
+     * triangle found.
+     */
+    ClosestPoint closestPoint(const Vector3& point,
+                              double maxDistance = std::numeric_limits<double>::max()) const;
+
+    /**
+     * @brief Unsigned distance from point to the mesh, or maxDistance if it is not closer
+     */
+    double distanceTo(const Vector3& point, double maxDistance = std::numeric_limits<double>::max()) const;
+
+    /**
+     * @brief Closest points for many points; results[i] receives closestPoint(points[i], options.maxDistance)
+     * @return false (results untouched) if results and points differ in size
+     *
+     * Points are processed in Morton order, as rays in rayCastBatch().
+     */
+    bool closestPointBatch(Span<const Vector3> points, Span<ClosestPoint> results,
+                           const PointBatchOptions& options = PointBatchOptions()) const;
+
+    /**
+     * @brief Drop the tree (isBuilt() becomes false)
+     */
+    void clear();
+
     /**
      * @brief Check if tree is built
      */
-    bool isBuilt() const { return root != nullptr; }
+    bool isBuilt() const { return !nodes.empty(); }
 
-private:
-    struct Node {
-        AABB bounds;
-        std::unique_ptr<Node> left;
-        std::unique_ptr<Node> right;
-        std::vector<int> triangleIndices; // Leaf nodes only
+    /**
+     * @brief Flattened node array (root first), e.g. for Mesh::saveCache
+     */
+    const std::vector<BVHNode>& getNodes() const { return nodes; }
 
-        bool isLeaf() const { return !left && !right; }
-    };
+    /**
+     * @brief Triangle indices referenced by leaf ranges
+     */
+    const std::vector<int>& getTriangleOrder() const { return triangleOrder; }
 
-    std::unique_ptr<Node> root;
-    const std::vector<Vector3>* vertices = nullptr;
-    const std::vector<Triangle>* faces = nullptr;
+    /**
+     * @brief Install a previously built tree instead of building one
+     * @param treeNodes Flattened nodes (as returned by getNodes())
+     * @param order Leaf triangle order (as returned by getTriangleOrder())
+     * @param vertices, faces Mesh the tree was built for (referenced, as in build())
+     * @param format Node layout to traverse (wide formats are collapsed from treeNodes)
+     * @return false (tree left empty) if the arrays are inconsistent with each other
+     *         or the mesh, or the tree is deeper than MAX_DEPTH
+     */
+    bool adopt(std::vector<BVHNode> treeNodes, std::vector<int> order,
+               Span<const Vector3> vertices, Span<const Triangle> faces,
+               BVHNodeFormat format = BVHBuildOptions().nodeFormat);
 
     /**
-     * @brief Recursively build tree
+     * @brief Layout rayCast() traverses
+     *
+     * Wide4Quantized falls back to Wide4 for trees it cannot encode (leaves
+     * over 65535 triangles or coordinates beyond 1e10).
      */
-    std::unique_ptr<Node> buildNode(std::vector<int>& triangleIndices, int depth);
+    BVHNodeFormat getNodeFormat() const { return nodeFormat; }
 
     /**
-     * @brief Compute AABB for a set of triangles
+     * @brief Number of nodes in the traversed layout
      */
-    AABB computeBounds(const std::vector<int>& triangleIndices) const;
+    size_t getTraversalNodeCount() const;
 
     /**
-     * @brief Recursively traverse tree for ray casting
+     * @brief Depth limit of built and adopted trees (bounds the traversal stack)
      */
-    void rayCastRecursive(const Node* node, const Ray& ray,
-                         double maxDistance, RayHit& bestHit) const;
+    static constexpr int MAX_DEPTH = 64;
+
+private:
+    std::vector<BVHNode> nodes;
+    std::vector<int> triangleOrder;
+    Span<const Vector3> vertices;
+    Span<const Triangle> faces;
+
+    BVHNodeFormat nodeFormat = BVHNodeFormat::Binary;
+    std::vector<BVH4Node> wideNodes;
+    std::vector<BVH4QuantizedNode> quantizedNodes;
+
+    /**
+     * @brief Collapse the binary nodes into the given wide format (SpatialWide.cpp)
+     */
+    void buildWideNodes(BVHNodeFormat format);
+
+    RayHit rayCastBinary(const Ray& ray, double maxDistance) const;
+    RayHit rayCastWide(const Ray& ray, double maxDistance) const;
+    RayHit rayCastQuantized(const Ray& ray, double maxDistance) const;
+
+    /**
+     * @brief Test the leaf range triangleOrder[first, first + count), keeping the closest hit
+     *
+     * Only hit, distance and triangleIndex are kept; rayCast() fills in the
+     * point and normal of the final hit.
+     */
+    void intersectLeaf(uint32_t first, uint32_t count, const Ray& ray,
+                       double maxDistance, RayHit& bestHit) const;
 };
 
 /**
@@ -176,6 +443,14 @@ bool intersectRayTriangle(const Ray& ray,
                          double& u,
                          double& v);
 
+/**
+ * @brief Closest point to p on triangle (v0, v1, v2)
+ *
+ * Exact Voronoi region classification; degenerate triangles give the
+ * closest point on their edges.
+ */
+Vector3 closestPointOnTriangle(const Vector3& p, const Vector3& v0, const Vector3& v1, const Vector3& v2);
+
 /**
  * @brief Calculate triangle normal
  */
@@ -0,0 +1,89 @@
+#pragma once
+#include "Vector3.hpp"
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace madfam::geom {
+
+/**
+ * @brief Hash-grid vertex welder for building indexed meshes from triangle soup
+ *
+ * Replaces the std::map<Vector3, int> deduplication used by the importers with
+ * an open-addressing table keyed on quantized coordinates.
+ *
+ * - tolerance == 0: exact matching (bitwise-equal coordinates, with -0.0 == 0.0),
+ *   identical to the old std::map behaviour.
+ * - tolerance > 0: vertices within `tolerance` (Euclidean) of an already
+ *   inserted vertex are merged into it. The grid cell size is 2 * tolerance, so
+ *   each lookup probes the home cell plus the 7 neighbours on the near side.
+ *   When several candidates are in range, the lowest index wins, so the result
+ *   depends only on insertion order.
+ */
+class VertexWelder {
+public:
+    /**
+     * @param tolerance Weld distance (0 = exact match only)
+     * @param expectedVertices Capacity hint to avoid rehashing
+     */
+    explicit VertexWelder(double tolerance = 0.0, size_t expectedVertices = 0);
+
+    /**
+     * @brief Insert a vertex, returning the index of its welded representative
+     *
+     * New vertices are appended to the vertex array and get the next index.
+     */
+    int insert(const Vector3& vertex);
+
+    /**
+     * @brief Look up a vertex without inserting it
+     * @return Index of the welded representative, or -1 if none is in range
+     */
+    int find(const Vector3& vertex) const;
+
+    /**
+     * @brief Pre-size the table for the given number of unique vertices
+     */
+    void reserve(size_t expectedVertices);
+
+    /**
+     * @brief Remove all vertices, keeping the allocated table
+     */
+    void clear();
+
+    size_t size() const { return vertices.size(); }
+    double getTolerance() const { return tolerance; }
+
+    /**
+     * @brief Get the welded vertex array (indexed by insert() return values)
+     */
+    const std::vector<Vector3>& getVertices() const { return vertices; }
+
+    /**
+     * @brief Move the welded vertex array out of the welder
+     *
+     * The welder is left empty and can be reused.
+     */
+    std::vector<Vector3> releaseVertices();
+
+private:
+    // 8-byte slot: upper hash bits as a tag plus the vertex index (-1 = empty)
+    struct Slot {
+        uint32_t tag;
+        int32_t index;
+    };
+
+    double tolerance;
+    double invCellSize;
+    std::vector<Slot> slots;
+    size_t mask = 0;
+    std::vector<Vector3> vertices;
+
+    uint64_t hashOf(const Vector3& v) const;
+    int findExact(const Vector3& v, uint64_t hash) const;
+    int findWithinTolerance(const Vector3& v) const;
+    void insertSlot(uint64_t hash, int32_t index);
+    void rehash(size_t newCapacity);
+};
+
+} // namespace madfam::geom
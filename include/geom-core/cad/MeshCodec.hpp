@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "Types.hpp"
+
+namespace madfam::geom::cad {
+
+// ===========================================================================
+// MeshData Wire Encoding
+// ===========================================================================
+//
+// Compact, lossy stream for sending MeshData to the viewer or a remote
+// executor:
+//   - positions quantized to an integer grid over the bounding box
+//   - normals octahedrally encoded into two signed integers
+//   - triangles reordered for the vertex cache, vertices renumbered in
+//     first-use order, and each index varint-coded as its distance back
+//     from the next unused vertex (0 = new vertex)
+//   - UVs stored as float32
+// Positions and normals use fixed-width fields so they decode in straight,
+// vectorizable loops. Decoding returns the same triangles (same winding),
+// but vertex and triangle order follow the encoder's reordering.
+// The stream is little-endian.
+
+/**
+ * @brief Encoder settings
+ */
+struct MeshEncodeOptions {
+    int positionBits = 16;             // Per axis, 1-24 (error <= half a grid step, plus float rounding)
+    int normalBits = 12;               // Per octahedral component, 2-16
+    bool optimizeVertexCache = true;   // Reorder triangles (Tipsify) before coding indices
+    int numThreads = 1;                // For quantization (<= 0 = all cores)
+};
+
+/**
+ * @brief Encode mesh into the compact wire format
+ * @return The stream, or INVALID_DATA / INVALID_PARAMS
+ */
+Result<std::vector<uint8_t>> encodeMeshData(const MeshData& mesh, const MeshEncodeOptions& options = {});
+
+/**
+ * @brief Decode a stream produced by encodeMeshData
+ * @param numThreads Threads for dequantization (<= 0 = all cores)
+ * @return The mesh, or INVALID_DATA if the stream is malformed
+ */
+Result<MeshData> decodeMeshData(const uint8_t* data, size_t size, int numThreads = 1);
+
+/**
+ * @brief Upper bound on the encoded size, for preallocating transfer buffers
+ */
+size_t maxEncodedMeshSize(const MeshData& mesh, const MeshEncodeOptions& options = {});
+
+} // namespace madfam::geom::cad
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <string>
+#include "../cad/Types.hpp"
+
+namespace madfam::geom::io {
+
+// ===========================================================================
+// OBJ Writing - "v" positions, optional "vt"/"vn", 1-based "f" triangles
+// ===========================================================================
+//
+// Vertex and face lines are formatted in parallel blocks (numThreads <= 0 =
+// all cores) into preallocated buffers with std::to_chars. Floats use the
+// shortest form that reads back to the same value. Normals and UVs are
+// written when they have one entry per vertex.
+
+/**
+ * @brief Encode OBJ text into a string
+ */
+cad::Result<bool> writeOBJToString(const cad::MeshData& mesh, std::string& out, int numThreads = 1);
+
+/**
+ * @brief Write OBJ to a file, streaming the blocks as they are encoded
+ */
+cad::Result<bool> writeOBJ(const cad::MeshData& mesh, const std::string& filepath, int numThreads = 1);
+
+} // namespace madfam::geom::io
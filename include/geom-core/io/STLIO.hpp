@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "../cad/Types.hpp"
+
+namespace madfam::geom::io {
+
+// ===========================================================================
+// STL Reading - Triangle soup into MeshData (3 unshared vertices per face)
+// ===========================================================================
+
+/**
+ * @brief Read an STL file (binary or ASCII, auto-detected)
+ *
+ * The file is memory-mapped (or read in one bulk read where mmap is not
+ * available) and decoded in place. Binary records are scattered into
+ * exactly-sized positions/normals arrays; facet normals are replicated to
+ * the three vertices of each face.
+ */
+cad::Result<cad::MeshData> readSTL(const std::string& filepath);
+
+/**
+ * @brief Read STL data from memory (binary or ASCII, auto-detected)
+ */
+cad::Result<cad::MeshData> readSTLFromMemory(const uint8_t* data, size_t size);
+
+// ===========================================================================
+// STL Writing - Face normals are recomputed from the vertex positions
+// ===========================================================================
+//
+// Output is encoded in parallel blocks of triangles (numThreads <= 0 = all
+// cores) into one buffer and written with a single write()/writev().
+
+/**
+ * @brief Exact size in bytes of the binary STL encoding of mesh
+ */
+size_t binarySTLSize(const cad::MeshData& mesh);
+
+/**
+ * @brief Encode binary STL into a caller-provided buffer (e.g. a WASM heap view)
+ * @return Bytes written (binarySTLSize), or BUFFER_TOO_SMALL
+ */
+cad::Result<size_t> writeBinarySTLToBuffer(const cad::MeshData& mesh, char* out, size_t capacity,
+                                           int numThreads = 1);
+
+/**
+ * @brief Encode STL into a string (binary or ASCII)
+ */
+cad::Result<bool> writeSTLToString(const cad::MeshData& mesh, std::string& out,
+                                   bool binary = true, int numThreads = 1);
+
+/**
+ * @brief Write STL to an open file descriptor (POSIX only)
+ *
+ * The descriptor is not closed.
+ */
+cad::Result<bool> writeSTLToFd(const cad::MeshData& mesh, int fd,
+                               bool binary = true, int numThreads = 1);
+
+/**
+ * @brief Write STL to a file (binary or ASCII)
+ */
+cad::Result<bool> writeSTL(const cad::MeshData& mesh, const std::string& filepath,
+                           bool binary = true, int numThreads = 1);
+
+/**
+ * @brief Write STL to a byte vector (binary or ASCII)
+ */
+cad::Result<std::vector<uint8_t>> writeSTLToMemory(const cad::MeshData& mesh,
+                                                   bool binary = true, int numThreads = 1);
+
+} // namespace madfam::geom::io
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "../cad/Types.hpp"
+
+namespace madfam::geom::io {
+
+// ===========================================================================
+// 3MF Reading - Indexed MeshData (vertices shared as in the file)
+// ===========================================================================
+//
+// The package is memory-mapped; the root model part is inflated and scanned
+// in a single streaming pass. All build items are placed with their
+// transforms (including nested components) and converted to millimeters.
+// Objects are not welded to each other. Normals are not produced. With
+// numThreads > 1 (<= 0 = all cores) the model part is inflated on a second
+// thread while its XML is scanned.
+
+/**
+ * @brief Read a 3MF file
+ */
+cad::Result<cad::MeshData> read3MF(const std::string& filepath, int numThreads = 1);
+
+/**
+ * @brief Read a 3MF package from memory
+ */
+cad::Result<cad::MeshData> read3MFFromMemory(const uint8_t* data, size_t size, int numThreads = 1);
+
+// ===========================================================================
+// 3MF Writing - One object, one build item, millimeter units
+// ===========================================================================
+//
+// The model XML is formatted in parallel blocks with std::to_chars and
+// deflated in parallel pieces (numThreads <= 0 = all cores).
+
+/**
+ * @brief Encode a 3MF package into a byte vector
+ */
+cad::Result<std::vector<uint8_t>> write3MFToMemory(const cad::MeshData& mesh, int numThreads = 1);
+
+/**
+ * @brief Write a 3MF file
+ */
+cad::Result<bool> write3MF(const cad::MeshData& mesh, const std::string& filepath, int numThreads = 1);
+
+} // namespace madfam::geom::io
@@ -130,7 +130,7 @@ setup(
     cmdclass=dict(build_ext=CMakeBuild),
     zip_safe=False,
     python_requires='>=3.7',
-    install_requires=[],
+    install_requires=['numpy'],
     extras_require={
         'dev': ['pytest', 'pytest-cov', 'black', 'flake8'],
     },
@@ -1,15 +1,98 @@
 #include "geom-core/Analyzer.hpp"
+#include "Parallel.hpp"
+#include <algorithm>
+#include <cctype>
+#include <exception>
+#include <iomanip>
 #include <iostream>
+#include <sstream>
 #include <cmath>
 
 #ifdef GC_USE_OCCT
 #include "BRepLoader.hpp"
+#include "TessellationCache.hpp"
 #endif
 
 namespace madfam::geom {
 
+namespace {
+
+/**
+ * Average of the unit normals of the faces around vertex (in face order).
+ * Returns false for vertices not used by any face.
+ */
+bool averageVertexNormal(Span<const Vector3> vertices,
+                         Span<const Triangle> faces,
+                         const VertexFaceAdjacency& adjacency,
+                         size_t vertex,
+                         Vector3& normal) {
+    uint32_t begin = adjacency.offsets[vertex];
+    uint32_t end = adjacency.offsets[vertex + 1];
+    if (begin == end) {
+        return false;
+    }
+
+    Vector3 sum(0, 0, 0);
+    for (uint32_t k = begin; k < end; ++k) {
+        const Triangle& face = faces[adjacency.faceIndices[k]];
+        sum = sum + calculateTriangleNormal(vertices[face.v0], vertices[face.v1], vertices[face.v2]);
+    }
+    normal = sum.normalized();
+    return true;
+}
+
+// Vertices whose inward rays are cast as one batch; bounds the ray and hit
+// buffers, which are reused across batches
+const size_t RAY_BATCH_VERTICES = 1 << 16;
+
+/**
+ * Rays cast inward from every stride-th vertex in [begin, end) along its
+ * negated average normal, starting just outside the surface to avoid
+ * self-intersection. Vertices not used by any face get no ray; rayVertices
+ * receives the vertex of each ray.
+ */
+void inwardVertexRays(Span<const Vector3> vertices,
+                      Span<const Triangle> faces,
+                      const VertexFaceAdjacency& adjacency,
+                      size_t begin, size_t end, size_t stride,
+                      std::vector<Ray>& rays,
+                      std::vector<uint32_t>& rayVertices) {
+    const double epsilon = 0.001;
+    rays.clear();
+    rayVertices.clear();
+    for (size_t i = begin; i < end; i += stride) {
+        Vector3 vertexNormal;
+        if (averageVertexNormal(vertices, faces, adjacency, i, vertexNormal)) {
+            rays.emplace_back(vertices[i] + vertexNormal * epsilon, vertexNormal * -1.0);
+            rayVertices.push_back(static_cast<uint32_t>(i));
+        }
+    }
+}
+
+/**
+ * Load a file with the loader matching its extension (case-insensitive).
+ */
+bool loadByExtension(Analyzer& analyzer, const std::string& filepath) {
+    size_t dot = filepath.find_last_of('.');
+    std::string extension = dot == std::string::npos ? "" : filepath.substr(dot + 1);
+    std::transform(extension.begin(), extension.end(), extension.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+
+    if (extension == "stl") return analyzer.loadSTL(filepath);
+    if (extension == "obj") return analyzer.loadOBJ(filepath);
+    if (extension == "3mf") return analyzer.load3MF(filepath);
+    if (extension == "ply") return analyzer.loadPLY(filepath);
+    if (extension == "gcmesh") return analyzer.loadMeshCache(filepath);
+    if (extension == "step" || extension == "stp") return analyzer.loadStep(filepath);
+
+    std::cerr << "Error: Unsupported mesh file extension: " << filepath << std::endl;
+    return false;
+}
+
+} // namespace
+
 // Constructor
-Analyzer::Analyzer() : mesh(std::make_unique<Mesh>()) {}
+Analyzer::Analyzer() : mesh(std::make_shared<Mesh>()) {}
 
 // Destructor
 Analyzer::~Analyzer() = default;
@@ -18,30 +101,105 @@ Analyzer::~Analyzer() = default;
 // Real Mesh Analysis Methods (Milestone 2)
 // ========================================
 
-bool Analyzer::loadSTL(const std::string& filepath) {
-    if (!mesh) {
-        mesh = std::make_unique<Mesh>();
+Mesh& Analyzer::prepareMeshLoad() {
+    // Never load into the previous mesh: handles from getMeshHandle() may
+    // still be reading it
+    mesh = std::make_shared<Mesh>();
+    // The spatial index refers to the mesh arrays, which the load replaces
+    spatialTree.reset();
+    streamSummary.reset();
+    return *mesh;
+}
+
+bool Analyzer::loadSTL(const std::string& filepath, int numThreads) {
+    return prepareMeshLoad().loadFromSTL(filepath, 0.0, numThreads);
+}
+
+bool Analyzer::loadSTLFromBytes(const std::string& data, int numThreads) {
+    return prepareMeshLoad().loadFromSTLBuffer(data.data(), data.size(), 0.0, numThreads);
+}
+
+bool Analyzer::loadOBJ(const std::string& filepath, int numThreads) {
+    return prepareMeshLoad().loadFromOBJ(filepath, numThreads);
+}
+
+bool Analyzer::load3MF(const std::string& filepath, int numThreads) {
+    return prepareMeshLoad().loadFrom3MF(filepath, numThreads);
+}
+
+bool Analyzer::loadPLY(const std::string& filepath, int numThreads) {
+    return prepareMeshLoad().loadFromPLY(filepath, numThreads);
+}
+
+bool Analyzer::loadMesh(std::vector<Vector3>&& vertices, std::vector<Triangle>&& faces) {
+    return prepareMeshLoad().adopt(std::move(vertices), std::move(faces));
+}
+
+bool Analyzer::loadMeshView(Span<const Vector3> vertices, Span<const Triangle> faces,
+                            std::shared_ptr<const void> owner) {
+    return prepareMeshLoad().wrap(vertices, faces, std::move(owner));
+}
+
+bool Analyzer::loadSTLStreaming(const std::string& filepath, const StreamingOptions& options) {
+    // Drop any resident mesh so the streaming pass is the only large allocation
+    mesh = std::make_shared<Mesh>();
+    spatialTree.reset();
+    streamSummary.reset();
+
+    MeshSummary summary;
+    if (!Mesh::streamSTL(filepath, options, summary)) {
+        return false;
     }
-    return mesh->loadFromSTL(filepath);
+
+    streamSummary = summary;
+    return true;
 }
 
-bool Analyzer::loadSTLFromBytes(const std::string& data) {
-    if (!mesh) {
-        mesh = std::make_unique<Mesh>();
+bool Analyzer::saveMeshCache(const std::string& filepath) const {
+    if (!mesh || mesh->getVertexCount() == 0) {
+        std::cerr << "Error: Cannot save mesh cache - no mesh loaded" << std::endl;
+        return false;
     }
-    return mesh->loadFromSTLBuffer(data.data(), data.size());
+    return mesh->saveCache(filepath, spatialTree.get());
+}
+
+bool Analyzer::loadMeshCache(const std::string& filepath) {
+    Mesh& target = prepareMeshLoad();
+
+    spatialTree = std::make_unique<AABBTree>();
+    bool success = target.loadCache(filepath, spatialTree.get());
+    if (!spatialTree->isBuilt()) {
+        spatialTree.reset();
+    }
+    return success;
 }
 
 bool Analyzer::loadStep(const std::string& filepath,
                        double linearDeflection,
-                       double angularDeflection) {
+                       double angularDeflection,
+                       int numThreads) {
 #ifdef GC_USE_OCCT
-    if (!mesh) {
-        mesh = std::make_unique<Mesh>();
+    Mesh& target = prepareMeshLoad();
+
+    // A cached tessellation of the same file and settings skips OCCT entirely
+    TessellationCache cache(stepCacheDirectory, stepCacheMaxBytes);
+    TessellationCache::Key cacheKey;
+    if (!stepCacheDirectory.empty()) {
+        std::ostringstream settings;
+        settings << std::setprecision(17) << "step linear=" << linearDeflection
+                 << " angular=" << angularDeflection << " " << brep::tessellatorVersion();
+        cacheKey = TessellationCache::makeKey(filepath, settings.str());
+        if (cache.load(cacheKey, target)) {
+            std::cout << "Loaded STEP tessellation from cache: " << filepath << std::endl;
+            return true;
+        }
     }
 
     // Use the BRepLoader to load and tessellate the STEP file
-    bool success = brep::loadStepFile(filepath, *mesh, linearDeflection, angularDeflection);
+    bool success = brep::loadStepFile(filepath, target, linearDeflection, angularDeflection, numThreads);
+    if (success && !cacheKey.name.empty()) {
+        cache.store(cacheKey, target);
+    }
 
     if (success) {
         std::cout << "Successfully loaded STEP file: " << filepath << std::endl;
@@ -59,47 +217,76 @@ bool Analyzer::loadStep(const std::string& filepath,
     (void)filepath;  // Suppress unused parameter warning
     (void)linearDeflection;
     (void)angularDeflection;
+    (void)numThreads;
     return false;
 #endif
 }
 
 double Analyzer::getVolume() const {
+    if (streamSummary) return streamSummary->volume;
     if (!mesh) return 0.0;
     return mesh->getVolume();
 }
 
 bool Analyzer::isWatertight() const {
+    if (streamSummary) return streamSummary->watertight;
     if (!mesh) return false;
     return mesh->isWatertight();
 }
 
 Vector3 Analyzer::getBoundingBox() const {
+    if (streamSummary) return streamSummary->boundingBox;
     if (!mesh) return Vector3(0, 0, 0);
     return mesh->getBoundingBox();
 }
 
 size_t Analyzer::getVertexCount() const {
+    if (streamSummary) return streamSummary->vertexCount;
     if (!mesh) return 0;
     return mesh->getVertexCount();
 }
 
 size_t Analyzer::getTriangleCount() const {
+    if (streamSummary) return streamSummary->triangleCount;
     if (!mesh) return 0;
     return mesh->getTriangleCount();
 }
 
+void Analyzer::setStepCache(const std::string& directory, uint64_t maxBytes) {
+    stepCacheDirectory = directory;
+    stepCacheMaxBytes = maxBytes;
+}
+
+Span<const Vector3> Analyzer::getVertices() const {
+    if (!mesh) return Span<const Vector3>();
+    return mesh->getVertices();
+}
+
+Span<const Triangle> Analyzer::getFaces() const {
+    if (!mesh) return Span<const Triangle>();
+    return mesh->getFaces();
+}
+
+std::shared_ptr<const Mesh> Analyzer::getMeshHandle() const {
+    return mesh;
+}
+
 // ========================================
 // Printability Analysis (Milestone 4)
 // ========================================
 
 void Analyzer::buildSpatialIndex() {
+    buildSpatialIndex(BVHBuildOptions());
+}
+
+void Analyzer::buildSpatialIndex(const BVHBuildOptions& options) {
     if (!mesh || mesh->getVertexCount() == 0) {
         std::cerr << "Error: Cannot build spatial index - no mesh loaded" << std::endl;
         return;
     }
 
     spatialTree = std::make_unique<AABBTree>();
-    spatialTree->build(mesh->getVertices(), mesh->getFaces());
+    spatialTree->build(mesh->getVertices(), mesh->getFaces(), options);
     std::cout << "Built spatial index for " << mesh->getTriangleCount() << " triangles" << std::endl;
 }
 
@@ -140,39 +327,23 @@ PrintabilityReport Analyzer::getPrintabilityReport(double criticalAngleDegrees,
         // For large meshes, sample every N vertices
         size_t sampleRate = (vertices.size() > 10000) ? 10 : 1;
 
-        for (size_t i = 0; i < vertices.size(); i += sampleRate) {
-            const Vector3& vertex = vertices[i];
-
-            // Compute vertex normal (average of adjacent face normals)
-            Vector3 vertexNormal(0, 0, 0);
-            int faceCount = 0;
-
-            for (const auto& face : faces) {
-                if (face.v0 == static_cast<int>(i) ||
-                    face.v1 == static_cast<int>(i) ||
-                    face.v2 == static_cast<int>(i)) {
-                    const Vector3& v0 = vertices[face.v0];
-                    const Vector3& v1 = vertices[face.v1];
-                    const Vector3& v2 = vertices[face.v2];
-                    vertexNormal = vertexNormal + calculateTriangleNormal(v0, v1, v2);
-                    faceCount++;
-                }
-            }
-
-            if (faceCount > 0) {
-                vertexNormal = vertexNormal.normalized();
-
-                // Cast ray inward (negative normal direction)
-                const double epsilon = 0.001; // Offset to avoid self-intersection
-                Ray ray(vertex + vertexNormal * epsilon, vertexNormal * -1.0);
-
-                // Cast ray to find opposite wall
-                RayHit hit = spatialTree->rayCast(ray, minWallThicknessMM * 10.0); // Search up to 10x min thickness
-
-                if (hit.hit && hit.distance < minWallThicknessMM) {
-                    thinWallCount++;
-                }
-            }
+        // Faces around each vertex, instead of scanning every face per vertex
+        const VertexFaceAdjacency& adjacency = mesh->getVertexFaceAdjacency();
+
+        // A wall is thin if any surface lies inward closer than the minimum
+        // thickness; which surface is nearest does not matter
+        std::vector<Ray> rays;
+        std::vector<uint32_t> rayVertices;
+        std::vector<uint8_t> occluded;
+        RayBatchOptions batch;
+        batch.maxDistance = minWallThicknessMM;
+        const size_t batchVertices = RAY_BATCH_VERTICES * sampleRate;
+        for (size_t begin = 0; begin < vertices.size(); begin += batchVertices) {
+            inwardVertexRays(vertices, faces, adjacency, begin, std::min(begin + batchVertices, vertices.size()),
+                             sampleRate, rays, rayVertices);
+            occluded.resize(rays.size());
+            spatialTree->occludedBatch(rays, occluded, batch);
+            thinWallCount += static_cast<int>(std::count(occluded.begin(), occluded.end(), uint8_t(1)));
         }
 
         report.thinWallVertexCount = thinWallCount;
@@ -299,19 +470,23 @@ OrientationResult Analyzer::autoOrient(int sampleResolution, double criticalAngl
 // ========================================
 
 const std::vector<uint8_t>& Analyzer::calculateOverhangMap(double criticalAngleDegrees) {
-    // Clear and resize cache
-    overhangMapCache.clear();
+    calculateOverhangMap(criticalAngleDegrees, overhangMapCache);
+    return overhangMapCache;
+}
+
+void Analyzer::calculateOverhangMap(double criticalAngleDegrees, std::vector<uint8_t>& map) const {
+    map.clear();
 
     if (!mesh || mesh->getVertexCount() == 0) {
         std::cerr << "Error: No mesh loaded for overhang map" << std::endl;
-        return overhangMapCache;
+        return;
     }
 
     const auto& vertices = mesh->getVertices();
     const auto& faces = mesh->getFaces();
 
     // Resize to triangle count
-    overhangMapCache.resize(faces.size());
+    map.resize(faces.size());
 
     // Z-up coordinate system
     Vector3 upVector(0, 0, 1);
@@ -338,83 +513,92 @@ const std::vector<uint8_t>& Analyzer::calculateOverhangMap(double criticalAngleD
         // Classify triangle
         if (dotProduct < groundThreshold) {
             // Triangle pointing straight down (build platform contact)
-            overhangMapCache[i] = 2;
+            map[i] = 2;
         } else if (dotProduct < -cosThreshold) {
             // Overhang requiring support
-            overhangMapCache[i] = 1;
+            map[i] = 1;
         } else {
             // Safe angle (self-supporting)
-            overhangMapCache[i] = 0;
+            map[i] = 0;
         }
     }
 
     std::cout << "Generated overhang map for " << faces.size() << " triangles" << std::endl;
-    return overhangMapCache;
 }
 
-const std::vector<float>& Analyzer::calculateWallThicknessMap(double maxSearchDistanceMM) {
-    // Clear and resize cache
-    wallThicknessCache.clear();
+const std::vector<float>& Analyzer::calculateWallThicknessMap(double maxSearchDistanceMM, int numThreads) {
+    calculateWallThicknessMap(maxSearchDistanceMM, numThreads, wallThicknessCache);
+    return wallThicknessCache;
+}
+
+void Analyzer::calculateWallThicknessMap(double maxSearchDistanceMM, int numThreads,
+                                         std::vector<float>& map) const {
+    map.clear();
 
     if (!mesh || mesh->getVertexCount() == 0) {
         std::cerr << "Error: No mesh loaded for wall thickness map" << std::endl;
-        return wallThicknessCache;
+        return;
     }
 
     if (!spatialTree || !spatialTree->isBuilt()) {
         std::cerr << "Error: Spatial index not built - call buildSpatialIndex() first" << std::endl;
-        return wallThicknessCache;
+        return;
     }
 
     const auto& vertices = mesh->getVertices();
     const auto& faces = mesh->getFaces();
 
     // Resize to vertex count
-    wallThicknessCache.resize(vertices.size(), 0.0f);
+    map.resize(vertices.size(), 0.0f);
 
     std::cout << "Calculating wall thickness for " << vertices.size() << " vertices..." << std::endl;
 
+    const VertexFaceAdjacency& adjacency = mesh->getVertexFaceAdjacency();
+
     // For each vertex, compute average normal and cast ray inward
-    for (size_t i = 0; i < vertices.size(); ++i) {
-        const Vector3& vertex = vertices[i];
-
-        // Compute vertex normal (average of adjacent face normals)
-        Vector3 vertexNormal(0, 0, 0);
-        int faceCount = 0;
-
-        for (const auto& face : faces) {
-            if (face.v0 == static_cast<int>(i) ||
-                face.v1 == static_cast<int>(i) ||
-                face.v2 == static_cast<int>(i)) {
-                const Vector3& v0 = vertices[face.v0];
-                const Vector3& v1 = vertices[face.v1];
-                const Vector3& v2 = vertices[face.v2];
-                vertexNormal = vertexNormal + calculateTriangleNormal(v0, v1, v2);
-                faceCount++;
-            }
+    std::vector<Ray> rays;
+    std::vector<uint32_t> rayVertices;
+    std::vector<RayHit> hits;
+    RayBatchOptions batch;
+    batch.maxDistance = maxSearchDistanceMM;
+    batch.numThreads = numThreads;
+    for (size_t begin = 0; begin < vertices.size(); begin += RAY_BATCH_VERTICES) {
+        inwardVertexRays(vertices, faces, adjacency, begin, std::min(begin + RAY_BATCH_VERTICES, vertices.size()),
+                         1, rays, rayVertices);
+        hits.resize(rays.size());
+        spatialTree->rayCastBatch(rays, hits, batch);
+        for (size_t k = 0; k < rays.size(); ++k) {
+            // No opposite wall within the search distance reads as the distance
+            map[rayVertices[k]] =
+                static_cast<float>(hits[k].hit ? hits[k].distance : maxSearchDistanceMM);
         }
+    }
 
-        if (faceCount > 0) {
-            vertexNormal = vertexNormal.normalized();
-
-            // Cast ray inward (negative normal direction)
-            const double epsilon = 0.001; // Offset to avoid self-intersection
-            Ray ray(vertex + vertexNormal * epsilon, vertexNormal * -1.0);
+    std::cout << "Wall thickness calculation complete" << std::endl;
+}
 
-            // Cast ray to find opposite wall
-            RayHit hit = spatialTree->rayCast(ray, maxSearchDistanceMM);
+bool Analyzer::distanceToSurface(Span<const Vector3> points, Span<double> distances,
+                                 double maxDistanceMM, int numThreads) const {
+    if (!spatialTree || !spatialTree->isBuilt()) {
+        std::cerr << "Error: Spatial index not built - call buildSpatialIndex() first" << std::endl;
+        return false;
+    }
 
-            if (hit.hit) {
-                wallThicknessCache[i] = static_cast<float>(hit.distance);
-            } else {
-                // No opposite wall found within search distance
-                wallThicknessCache[i] = static_cast<float>(maxSearchDistanceMM);
-            }
-        }
+    if (distances.size() != points.size()) {
+        std::cerr << "Error: distanceToSurface needs one distance per point (" << points.size() << " points, "
+                  << distances.size() << " distances)" << std::endl;
+        return false;
     }
 
-    std::cout << "Wall thickness calculation complete" << std::endl;
-    return wallThicknessCache;
+    std::vector<ClosestPoint> closest(points.size());
+    PointBatchOptions batch;
+    batch.maxDistance = maxDistanceMM;
+    batch.numThreads = numThreads;
+    spatialTree->closestPointBatch(points, closest, batch);
+    for (size_t i = 0; i < points.size(); ++i) {
+        distances[i] = closest[i].found ? closest[i].distance : maxDistanceMM;
+    }
+    return true;
 }
 
 // ========================================
@@ -465,6 +649,52 @@ double Analyzer::analyzeOverhangs(const Vector3& upVector,
     return overhangArea;
 }
 
+// ========================================
+// Batch Analysis
+// ========================================
+
+std::vector<BatchResult> Analyzer::analyzeMany(const std::vector<std::string>& filepaths,
+                                               const BatchOptions& options,
+                                               int numThreads) {
+    std::vector<BatchResult> results(filepaths.size());
+
+    parallel::forEachIndex(filepaths.size(), parallel::resolveThreadCount(numThreads), [&](size_t i) {
+        BatchResult& result = results[i];
+        result.filepath = filepaths[i];
+
+        // One failing file (e.g. out of memory) must not abort the batch
+        try {
+            Analyzer analyzer;
+            analyzer.setStepCache(options.stepCacheDirectory, options.stepCacheMaxBytes);
+            if (!loadByExtension(analyzer, filepaths[i])) {
+                return;
+            }
+            if (!analyzer.spatialTree) {
+                analyzer.buildSpatialIndex();
+            }
+
+            result.vertexCount = analyzer.getVertexCount();
+            result.triangleCount = analyzer.getTriangleCount();
+            result.volume = analyzer.getVolume();
+            result.watertight = analyzer.isWatertight();
+            result.boundingBox = analyzer.getBoundingBox();
+            result.report = analyzer.getPrintabilityReport(options.criticalAngleDegrees,
+                                                           options.minWallThicknessMM);
+            if (options.autoOrient) {
+                result.orientation = analyzer.autoOrient(options.sampleResolution,
+                                                         options.criticalAngleDegrees);
+            }
+            result.success = true;
+        } catch (const std::exception& e) {
+            std::cerr << "Error: Analysis of " << filepaths[i] << " failed: " << e.what() << std::endl;
+            result = BatchResult();
+            result.filepath = filepaths[i];
+        }
+    });
+
+    return results;
+}
+
 // ========================================
 // Legacy Methods (for backward compatibility)
 // ========================================
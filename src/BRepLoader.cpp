@@ -1,7 +1,9 @@
 #ifdef GC_USE_OCCT
 
 #include "BRepLoader.hpp"
+#include "Parallel.hpp"
 #include "geom-core/Mesh.hpp"
+#include "geom-core/VertexWelder.hpp"
 
 // Open CASCADE includes
 #include <STEPControl_Reader.hxx>
@@ -14,20 +16,157 @@
 #include <BRep_Tool.hxx>
 #include <TopLoc_Location.hxx>
 #include <gp_Pnt.hxx>
-#include <TColgp_Array1OfPnt.hxx>
-#include <Poly_Array1OfTriangle.hxx>
 #include <Poly_Triangle.hxx>
+#include <Standard_Version.hxx>
 
+#include <algorithm>
+#include <cstdint>
 #include <iostream>
-#include <map>
+#include <utility>
 #include <vector>
 
 namespace madfam::geom::brep {
 
+namespace {
+
+/**
+ * Nodes and triangles of one face triangulation (0-based local indices,
+ * winding already matching the face orientation).
+ */
+struct FaceBuffer {
+    std::vector<Vector3> nodes;
+    std::vector<Triangle> triangles;
+    std::vector<uint8_t> onBoundary;   // Node lies on an open edge of the face mesh
+};
+
+/**
+ * Flag the nodes of edges used by only one triangle of the face. Faces share
+ * nodes only along their boundary edges (and seams), so only these nodes
+ * need welding; interior nodes are unique to their face.
+ */
+void markBoundaryNodes(FaceBuffer& face) {
+    std::vector<std::pair<int, int>> edges;
+    edges.reserve(face.triangles.size() * 3);
+    for (const Triangle& tri : face.triangles) {
+        edges.emplace_back(std::minmax(tri.v0, tri.v1));
+        edges.emplace_back(std::minmax(tri.v1, tri.v2));
+        edges.emplace_back(std::minmax(tri.v2, tri.v0));
+    }
+    std::sort(edges.begin(), edges.end());
+
+    face.onBoundary.assign(face.nodes.size(), 0);
+    for (size_t i = 0; i < edges.size();) {
+        size_t j = i + 1;
+        while (j < edges.size() && edges[j] == edges[i]) {
+            ++j;
+        }
+        if (j - i == 1) {
+            face.onBoundary[edges[i].first] = 1;
+            face.onBoundary[edges[i].second] = 1;
+        }
+        i = j;
+    }
+}
+
+/**
+ * Convert one face triangulation; faces without one are left empty.
+ * Only reads the (already meshed) shape, so faces can run in parallel.
+ */
+void extractFace(const TopoDS_Face& face, FaceBuffer& out) {
+    TopLoc_Location loc;
+    Handle(Poly_Triangulation) triangulation = BRep_Tool::Triangulation(face, loc);
+    if (triangulation.IsNull()) {
+        return;
+    }
+
+    const gp_Trsf transform = loc.Transformation();
+    const Standard_Integer nodeCount = triangulation->NbNodes();
+    out.nodes.resize(nodeCount);
+    for (Standard_Integer i = 1; i <= nodeCount; ++i) {
+        gp_Pnt pt = triangulation->Node(i);
+        pt.Transform(transform);
+        out.nodes[i - 1] = Vector3(pt.X(), pt.Y(), pt.Z());
+    }
+
+    // Reverse the winding of flipped faces (OCCT indices are 1-based)
+    const bool reversed = (face.Orientation() == TopAbs_REVERSED);
+    const Standard_Integer triangleCount = triangulation->NbTriangles();
+    out.triangles.resize(triangleCount);
+    for (Standard_Integer i = 1; i <= triangleCount; ++i) {
+        Standard_Integer n1, n2, n3;
+        triangulation->Triangle(i).Get(n1, n2, n3);
+        if (reversed) {
+            std::swap(n2, n3);
+        }
+        out.triangles[i - 1] = Triangle(n1 - 1, n2 - 1, n3 - 1);
+    }
+
+    markBoundaryNodes(out);
+}
+
+/**
+ * Merge face buffers into one indexed mesh.
+ *
+ * Boundary nodes are welded serially in face order with the hash-grid
+ * welder and come first; each face's interior nodes follow in a block at a
+ * prefix-summed offset, so copying them and remapping the triangles runs
+ * in parallel. Buffers are released as they are merged.
+ */
+void mergeFaces(std::vector<FaceBuffer>& faces, int numThreads,
+                std::vector<Vector3>& vertices, std::vector<Triangle>& triangles) {
+    // Local node -> global vertex, filled for boundary nodes first
+    std::vector<std::vector<int>> globalIndex(faces.size());
+    VertexWelder welder;
+    for (size_t f = 0; f < faces.size(); ++f) {
+        const FaceBuffer& face = faces[f];
+        globalIndex[f].assign(face.nodes.size(), -1);
+        for (size_t n = 0; n < face.nodes.size(); ++n) {
+            if (face.onBoundary[n]) {
+                globalIndex[f][n] = welder.insert(face.nodes[n]);
+            }
+        }
+    }
+    const size_t boundaryCount = welder.size();
+    vertices = welder.releaseVertices();
+
+    std::vector<size_t> vertexOffset(faces.size() + 1, boundaryCount);
+    std::vector<size_t> triangleOffset(faces.size() + 1, 0);
+    for (size_t f = 0; f < faces.size(); ++f) {
+        const FaceBuffer& face = faces[f];
+        size_t interior = face.nodes.size() -
+            static_cast<size_t>(std::count(face.onBoundary.begin(), face.onBoundary.end(), 1));
+        vertexOffset[f + 1] = vertexOffset[f] + interior;
+        triangleOffset[f + 1] = triangleOffset[f] + face.triangles.size();
+    }
+    vertices.resize(vertexOffset.back());
+    triangles.resize(triangleOffset.back());
+
+    parallel::forEachIndex(faces.size(), numThreads, [&](size_t f) {
+        FaceBuffer& face = faces[f];
+        std::vector<int>& local = globalIndex[f];
+        size_t next = vertexOffset[f];
+        for (size_t n = 0; n < face.nodes.size(); ++n) {
+            if (!face.onBoundary[n]) {
+                vertices[next] = face.nodes[n];
+                local[n] = static_cast<int>(next++);
+            }
+        }
+        Triangle* out = triangles.data() + triangleOffset[f];
+        for (const Triangle& tri : face.triangles) {
+            *out++ = Triangle(local[tri.v0], local[tri.v1], local[tri.v2]);
+        }
+        face = FaceBuffer();
+        std::vector<int>().swap(local);
+    });
+}
+
+} // namespace
+
 bool loadStepFile(const std::string& filepath,
                   Mesh& outMesh,
                   double linearDeflection,
-                  double angularDeflection) {
+                  double angularDeflection,
+                  int numThreads) {
     
     std::cout << "Loading STEP file: " << filepath << std::endl;
     std::cout << "Linear deflection: " << linearDeflection << " mm" << std::endl;
@@ -79,100 +218,25 @@ bool loadStepFile(const std::string& filepath,
     // ========================================
     // Step 3: Extract triangulation data
     // ========================================
-    
-    // We need to build a unified vertex list and triangle list
-    // OCCT provides per-face triangulations with local indices
-    
-    std::vector<Vector3> vertices;
-    std::vector<Mesh::Triangle> triangles;
-    
-    // Map from (face_ptr, local_vertex_index) to global vertex index
-    // We use a map to deduplicate vertices across faces
-    std::map<Vector3, int> vertexMap;
-    
-    int faceCount = 0;
-    int triangleCount = 0;
-    
-    // Iterate over all faces in the shape
+
+    // OCCT provides per-face triangulations with local indices. Faces are
+    // converted independently in parallel, then merged into one indexed mesh.
+    std::vector<TopoDS_Face> faces;
     for (TopExp_Explorer faceExp(shape, TopAbs_FACE); faceExp.More(); faceExp.Next()) {
-        const TopoDS_Face& face = TopoDS::Face(faceExp.Current());
-        faceCount++;
-        
-        // Get the triangulation for this face
-        TopLoc_Location loc;
-        Handle(Poly_Triangulation) triangulation = BRep_Tool::Triangulation(face, loc);
-        
-        if (triangulation.IsNull()) {
-            // Face has no triangulation - skip it
-            continue;
-        }
-        
-        // Get transformation matrix for this face
-        gp_Trsf transform = loc.Transformation();
-        
-        // Build local vertex map for this face
-        std::vector<int> localToGlobal(triangulation->NbNodes() + 1); // OCCT uses 1-based indexing
-        
-        // Process vertices
-        const TColgp_Array1OfPnt& nodes = triangulation->Nodes();
-        for (Standard_Integer i = nodes.Lower(); i <= nodes.Upper(); i++) {
-            // Get vertex position
-            gp_Pnt pt = nodes(i);
-            
-            // Apply transformation
-            pt.Transform(transform);
-            
-            // Convert to our Vector3
-            Vector3 vertex(pt.X(), pt.Y(), pt.Z());
-            
-            // Check if vertex already exists (deduplication)
-            auto it = vertexMap.find(vertex);
-            int globalIndex;
-            
-            if (it != vertexMap.end()) {
-                // Vertex already exists
-                globalIndex = it->second;
-            } else {
-                // New vertex
-                globalIndex = static_cast<int>(vertices.size());
-                vertices.push_back(vertex);
-                vertexMap[vertex] = globalIndex;
-            }
-            
-            // Map local index to global index
-            localToGlobal[i] = globalIndex;
-        }
-        
-        // Process triangles
-        const Poly_Array1OfTriangle& tris = triangulation->Triangles();
-        for (Standard_Integer i = tris.Lower(); i <= tris.Upper(); i++) {
-            const Poly_Triangle& tri = tris(i);
-            
-            // Get vertex indices (1-based in OCCT)
-            Standard_Integer n1, n2, n3;
-            tri.Get(n1, n2, n3);
-            
-            // Check face orientation (reversed if face is flipped)
-            bool reversed = (face.Orientation() == TopAbs_REVERSED);
-            
-            // Convert to global indices and create triangle
-            Mesh::Triangle triangle;
-            if (reversed) {
-                // Reverse winding order
-                triangle.v0 = localToGlobal[n1];
-                triangle.v1 = localToGlobal[n3];
-                triangle.v2 = localToGlobal[n2];
-            } else {
-                triangle.v0 = localToGlobal[n1];
-                triangle.v1 = localToGlobal[n2];
-                triangle.v2 = localToGlobal[n3];
-            }
-            
-            triangles.push_back(triangle);
-            triangleCount++;
-        }
+        faces.push_back(TopoDS::Face(faceExp.Current()));
     }
-    
+    const size_t faceCount = faces.size();
+
+    const int threads = parallel::resolveThreadCount(numThreads);
+    std::vector<FaceBuffer> buffers(faceCount);
+    parallel::forEachIndex(faceCount, threads, [&](size_t i) {
+        extractFace(faces[i], buffers[i]);
+    });
+
+    std::vector<Vector3> vertices;
+    std::vector<Triangle> triangles;
+    mergeFaces(buffers, threads, vertices, triangles);
+
     std::cout << "Extracted " << faceCount << " faces" << std::endl;
     std::cout << "Generated " << vertices.size() << " vertices" << std::endl;
     std::cout << "Generated " << triangles.size() << " triangles" << std::endl;
@@ -186,12 +250,10 @@ bool loadStepFile(const std::string& filepath,
     // Step 4: Populate the Mesh object
     // ========================================
     
-    // Clear existing data
-    outMesh.clear();
-    
-    // Set vertices and triangles
-    outMesh.setVertices(vertices);
-    outMesh.setTriangles(triangles);
+    // Hand the arrays over without copying (replaces any existing data)
+    if (!outMesh.adopt(std::move(vertices), std::move(triangles))) {
+        return false;
+    }
     
     std::cout << "STEP file loaded successfully into mesh" << std::endl;
     std::cout << "Final mesh: " << outMesh.getVertexCount() << " vertices, "
@@ -200,6 +262,10 @@ bool loadStepFile(const std::string& filepath,
     return true;
 }
 
+std::string tessellatorVersion() {
+    return "OCCT " OCC_VERSION_COMPLETE;
+}
+
 } // namespace madfam::geom::brep
 
 #endif // GC_USE_OCCT
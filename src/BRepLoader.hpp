@@ -21,12 +21,22 @@ namespace madfam::geom::brep {
  * @param outMesh Output mesh to populate with triangulated data
  * @param linearDeflection Tessellation precision in mm (default 0.1mm)
  * @param angularDeflection Angular precision in radians (default 0.5)
+ * @param numThreads Threads used to convert face triangulations (<= 0 = all cores)
  * @return true if successful, false otherwise
+ *
+ * Faces are converted in parallel; only nodes on face boundaries are welded.
+ * The mesh is identical for every thread count.
  */
 bool loadStepFile(const std::string& filepath, 
                   Mesh& outMesh,
                   double linearDeflection = 0.1,
-                  double angularDeflection = 0.5);
+                  double angularDeflection = 0.5,
+                  int numThreads = 1);
+
+/**
+ * @brief Version of the tessellator behind loadStepFile (for cache keys)
+ */
+std::string tessellatorVersion();
 
 } // namespace madfam::geom::brep
 
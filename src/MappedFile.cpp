@@ -0,0 +1,127 @@
+#include "MappedFile.hpp"
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+
+#if (defined(__unix__) || defined(__APPLE__)) && !defined(__EMSCRIPTEN__)
+#define GC_HAVE_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace madfam::geom {
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+bool MappedFile::open(const std::string& filepath) {
+    close();
+
+#ifdef GC_HAVE_MMAP
+    int fd = ::open(filepath.c_str(), O_RDONLY);
+    if (fd < 0) {
+        std::cerr << "Error: Could not open file: " << filepath << std::endl;
+        return false;
+    }
+
+    struct stat info;
+    if (::fstat(fd, &info) != 0) {
+        std::cerr << "Error: Could not stat file: " << filepath << std::endl;
+        ::close(fd);
+        return false;
+    }
+
+    length = static_cast<size_t>(info.st_size);
+    if (length == 0) {
+        // mmap rejects zero-length mappings; an empty file is still "open"
+        ::close(fd);
+        opened = true;
+        return true;
+    }
+
+    void* ptr = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);  // The mapping keeps its own reference to the file
+
+    if (ptr == MAP_FAILED) {
+        std::cerr << "Error: Could not memory-map file: " << filepath << std::endl;
+        length = 0;
+        return false;
+    }
+
+    mapping = ptr;
+    bytes = static_cast<const char*>(ptr);
+    opened = true;
+    return true;
+#else
+    std::ifstream file(filepath, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) {
+        std::cerr << "Error: Could not open file: " << filepath << std::endl;
+        return false;
+    }
+
+    std::streamsize size = file.tellg();
+    file.seekg(0, std::ios::beg);
+
+    fallback.resize(static_cast<size_t>(size));
+    if (size > 0 && !file.read(fallback.data(), size)) {
+        std::cerr << "Error: Failed to read file: " << filepath << std::endl;
+        fallback.clear();
+        return false;
+    }
+
+    bytes = fallback.data();
+    length = fallback.size();
+    opened = true;
+    return true;
+#endif
+}
+
+void MappedFile::close() {
+#ifdef GC_HAVE_MMAP
+    if (mapping) {
+        ::munmap(mapping, length);
+    }
+#endif
+    mapping = nullptr;
+    bytes = nullptr;
+    length = 0;
+    opened = false;
+    std::vector<char>().swap(fallback);
+}
+
+void MappedFile::adviseSequential() const {
+#ifdef GC_HAVE_MMAP
+    if (mapping) {
+        ::madvise(mapping, length, MADV_SEQUENTIAL);
+    }
+#endif
+}
+
+void MappedFile::adviseDone(size_t offset, size_t rangeLength) const {
+#ifdef GC_HAVE_MMAP
+    if (!mapping || offset >= length) {
+        return;
+    }
+
+    const size_t page = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+    size_t end = std::min(offset + rangeLength, length);
+
+    // Only release pages that lie entirely inside the range
+    size_t first = (offset + page - 1) / page * page;
+    size_t last = end / page * page;
+    if (end == length) {
+        last = end;
+    }
+    if (last > first) {
+        ::madvise(static_cast<char*>(mapping) + first, last - first, MADV_DONTNEED);
+    }
+#else
+    (void)offset;
+    (void)rangeLength;
+#endif
+}
+
+} // namespace madfam::geom
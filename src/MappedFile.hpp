@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace madfam::geom {
+
+/**
+ * @brief Read-only view of a whole file, memory-mapped where possible
+ *
+ * On POSIX systems the file is mmap'ed, so parsers read straight from the
+ * page cache without a heap staging copy. Pages are file-backed and clean,
+ * which lets the kernel drop them under memory pressure instead of counting
+ * them against the worker like anonymous heap memory.
+ *
+ * On platforms without mmap (Windows, Emscripten) the file is read into an
+ * owned buffer instead, so callers can use data()/size() unconditionally.
+ */
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /**
+     * @brief Map (or read) the file at filepath
+     * @return true if successful, false otherwise (error printed to stderr)
+     */
+    bool open(const std::string& filepath);
+
+    /**
+     * @brief Unmap the file and release any fallback buffer
+     */
+    void close();
+
+    /**
+     * @brief Hint that the mapping will be read front to back
+     *
+     * Enables aggressive kernel read-ahead (madvise MADV_SEQUENTIAL).
+     * No-op when the file is not memory-mapped.
+     */
+    void adviseSequential() const;
+
+    /**
+     * @brief Hint that [offset, offset + rangeLength) will not be read again
+     *
+     * Lets the kernel drop those pages from the process' resident set early.
+     * Only whole pages inside the range are released. No-op when the file is
+     * not memory-mapped.
+     */
+    void adviseDone(size_t offset, size_t rangeLength) const;
+
+    const char* data() const { return bytes; }
+    size_t size() const { return length; }
+    bool isOpen() const { return opened; }
+
+    /**
+     * @brief Whether the data is an mmap view (false = heap fallback buffer)
+     */
+    bool isMapped() const { return mapping != nullptr; }
+
+private:
+    const char* bytes = nullptr;
+    size_t length = 0;
+    bool opened = false;
+    void* mapping = nullptr;
+    std::vector<char> fallback;
+};
+
+} // namespace madfam::geom
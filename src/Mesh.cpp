@@ -1,5 +1,8 @@
 #include "geom-core/Mesh.hpp"
-#include <fstream>
+#include "geom-core/VertexWelder.hpp"
+#include "MappedFile.hpp"
+#include "io/ASCIISTLParser.hpp"
+#include "Parallel.hpp"
 #include <map>
 #include <unordered_map>
 #include <algorithm>
@@ -10,34 +13,74 @@
 
 namespace madfam::geom {
 
-bool Mesh::loadFromSTL(const std::string& filepath) {
-    // Read entire file into memory
-    std::ifstream file(filepath, std::ios::binary | std::ios::ate);
-    if (!file.is_open()) {
-        std::cerr << "Error: Could not open STL file: " << filepath << std::endl;
-        return false;
-    }
+namespace {
 
-    // Get file size and read into buffer
-    std::streamsize size = file.tellg();
-    file.seekg(0, std::ios::beg);
+// Triangles decoded and welded per work item by the binary STL loader
+const size_t STL_CHUNK_TRIANGLES = 1 << 16;
 
-    std::vector<char> buffer(size);
-    if (!file.read(buffer.data(), size)) {
-        std::cerr << "Error: Failed to read STL file: " << filepath << std::endl;
+} // namespace
+
+bool Mesh::loadFromSTL(const std::string& filepath, double weldTolerance, int numThreads) {
+    // Map the file instead of staging it in a heap buffer, so peak memory
+    // is the welded mesh plus whatever pages are currently being decoded
+    MappedFile file;
+    if (!file.open(filepath)) {
+        std::cerr << "Error: Could not open STL file: " << filepath << std::endl;
         return false;
     }
 
-    file.close();
+    file.adviseSequential();
 
-    // Delegate to buffer-based loader
-    return loadFromSTLBuffer(buffer.data(), buffer.size());
+    // Decode straight from the mapped pages, dropping each chunk once welded
+    return parseSTL(file.data(), file.size(), weldTolerance, numThreads,
+                    [&file](size_t offset, size_t length) {
+                        file.adviseDone(offset, length);
+                    });
 }
 
-bool Mesh::loadFromSTLBuffer(const char* buffer, size_t size) {
+bool Mesh::loadFromSTLBuffer(const char* buffer, size_t size, double weldTolerance, int numThreads) {
+    return parseSTL(buffer, size, weldTolerance, numThreads, nullptr);
+}
+
+bool Mesh::parseSTL(const char* buffer, size_t size, double weldTolerance, int numThreads,
+                    const std::function<void(size_t, size_t)>& chunkDone) {
     // Clear existing data
     clear();
 
+    if (io::isASCIISTL(buffer, size)) {
+        // Tokenize into a packed soup, then weld exactly like binary records
+        std::vector<float> soup;
+        soup.reserve((size / 250 + 1) * 9);
+
+        std::string error;
+        size_t solids = 0;
+        bool ok = io::parseASCIISTL(buffer, size, [&soup](const float*, const float* coords) {
+            soup.insert(soup.end(), coords, coords + 9);
+        }, error, &solids);
+
+        // Binary files whose header starts with "solid" and that carry
+        // trailing bytes land here too; they fail to parse as text (or
+        // yield no facets) and are read as binary below
+        if (!io::fitsBinarySTL(buffer, size) || (ok && !soup.empty())) {
+            if (!ok) {
+                std::cerr << "Error: Invalid ASCII STL: " << error << std::endl;
+                return false;
+            }
+
+            if (chunkDone) {
+                chunkDone(0, size);
+            }
+
+            weldTriangles(reinterpret_cast<const char*>(soup.data()), 9 * sizeof(float),
+                          soup.size() / 9, weldTolerance, numThreads, nullptr);
+
+            std::cout << "Loaded ASCII STL: " << vertices.size() << " vertices, "
+                      << faces.size() << " triangles (" << solids << " solid"
+                      << (solids == 1 ? "" : "s") << ")" << std::endl;
+            return true;
+        }
+    }
+
     // Validate minimum size (80-byte header + 4-byte count)
     if (size < 84) {
         std::cerr << "Error: STL buffer too small (< 84 bytes)" << std::endl;
@@ -53,68 +96,99 @@ bool Mesh::loadFromSTLBuffer(const char* buffer, size_t size) {
     offset += 4;
 
     // Validate buffer size
-    size_t expectedSize = 84 + (triangleCount * 50); // header + count + (triangles * 50 bytes each)
+    size_t expectedSize = 84 + (static_cast<size_t>(triangleCount) * 50); // header + count + (triangles * 50 bytes each)
     if (size < expectedSize) {
         std::cerr << "Error: STL buffer size mismatch. Expected at least " << expectedSize
                   << " bytes, got " << size << std::endl;
         return false;
     }
 
-    // Map to deduplicate vertices: vertex -> index
-    std::map<Vector3, int> vertexMap;
-    int nextVertexIndex = 0;
+    // Skip each record's 12-byte normal; 3 vertices follow (3 floats each)
+    weldTriangles(buffer + offset + 12, 50, triangleCount, weldTolerance, numThreads,
+                  [&](size_t first, size_t count) {
+                      if (chunkDone) {
+                          chunkDone(offset + first * 50, count * 50);
+                      }
+                  });
 
-    // Reserve space for efficiency
-    faces.reserve(triangleCount);
+    std::cout << "Loaded STL: " << vertices.size() << " vertices, "
+              << faces.size() << " triangles" << std::endl;
 
-    // Read each triangle
-    for (uint32_t i = 0; i < triangleCount; ++i) {
-        // Check if we have enough data left
-        if (offset + 50 > size) {
-            std::cerr << "Error: Unexpected end of STL buffer at triangle " << i << std::endl;
-            return false;
-        }
+    return true;
+}
+
+void Mesh::weldTriangles(const char* records, size_t stride, size_t triangleCount,
+                         double weldTolerance, int numThreads,
+                         const std::function<void(size_t, size_t)>& chunkDone) {
+    // Triangles are decoded and welded in fixed-size chunks. The chunk size
+    // does not depend on the thread count, so the welded mesh is identical
+    // no matter how many threads are used.
+    const size_t chunkCount = (triangleCount + STL_CHUNK_TRIANGLES - 1) / STL_CHUNK_TRIANGLES;
+    std::vector<std::vector<Vector3>> chunkVertices(chunkCount);
+
+    // Faces first receive chunk-local indices and are remapped after merging
+    faces.resize(triangleCount);
+
+    parallel::forEachIndex(chunkCount, parallel::resolveThreadCount(numThreads), [&](size_t chunk) {
+        const size_t first = chunk * STL_CHUNK_TRIANGLES;
+        const size_t last = std::min(first + STL_CHUNK_TRIANGLES, triangleCount);
+
+        // A closed mesh has roughly half as many vertices as triangles
+        VertexWelder localWelder(weldTolerance, (last - first) / 2 + 3);
+
+        for (size_t i = first; i < last; ++i) {
+            const char* record = records + i * stride;
+
+            int indices[3];
+            for (int j = 0; j < 3; ++j) {
+                float coords[3];
+                std::memcpy(coords, record + j * 12, 12);
 
-        // Read normal vector (12 bytes) - we'll skip it
-        offset += 12;
-
-        // Read 3 vertices (12 bytes each = 3 floats per vertex)
-        int indices[3];
-        for (int j = 0; j < 3; ++j) {
-            float coords[3];
-            std::memcpy(coords, buffer + offset, 12);
-            offset += 12;
-
-            Vector3 vertex(coords[0], coords[1], coords[2]);
-
-            // Check if vertex already exists in map
-            auto it = vertexMap.find(vertex);
-            if (it != vertexMap.end()) {
-                // Vertex exists, reuse index
-                indices[j] = it->second;
-            } else {
-                // New vertex, add to map and vertices list
-                indices[j] = nextVertexIndex;
-                vertexMap[vertex] = nextVertexIndex;
-                vertices.push_back(vertex);
-                nextVertexIndex++;
+                // Reuse the index of an existing (or near-coincident) vertex
+                indices[j] = localWelder.insert(Vector3(coords[0], coords[1], coords[2]));
             }
+
+            faces[i] = Triangle(indices[0], indices[1], indices[2]);
         }
 
-        // Create triangle from indices
-        faces.emplace_back(indices[0], indices[1], indices[2]);
+        chunkVertices[chunk] = localWelder.releaseVertices();
 
-        // Read attribute byte count (2 bytes) - skip it
-        offset += 2;
+        if (chunkDone) {
+            chunkDone(first, last - first);
+        }
+    });
+
+    // Merge pass: weld each chunk's unique vertices into the global table in
+    // chunk order, which reproduces the serial first-occurrence ordering.
+    VertexWelder welder(weldTolerance, triangleCount / 2 + 3);
+    std::vector<std::vector<int>> chunkRemap(chunkCount);
+
+    for (size_t chunk = 0; chunk < chunkCount; ++chunk) {
+        auto& local = chunkVertices[chunk];
+        chunkRemap[chunk].resize(local.size());
+        for (size_t i = 0; i < local.size(); ++i) {
+            chunkRemap[chunk][i] = welder.insert(local[i]);
+        }
+        std::vector<Vector3>().swap(local);
     }
 
-    std::cout << "Loaded STL: " << vertices.size() << " vertices, "
-              << faces.size() << " triangles" << std::endl;
+    parallel::forEachIndex(chunkCount, parallel::resolveThreadCount(numThreads), [&](size_t chunk) {
+        const size_t first = chunk * STL_CHUNK_TRIANGLES;
+        const size_t last = std::min(first + STL_CHUNK_TRIANGLES, triangleCount);
+        const std::vector<int>& remap = chunkRemap[chunk];
 
-    return true;
+        for (size_t i = first; i < last; ++i) {
+            Triangle& face = faces[i];
+            face = Triangle(remap[face.v0], remap[face.v1], remap[face.v2]);
+        }
+    });
+
+    vertices = welder.releaseVertices();
 }
 
 double Mesh::getVolume() const {
+    const Span<const Vector3> vertices = getVertices();
+    const Span<const Triangle> faces = getFaces();
     if (faces.empty()) {
         return 0.0;
     }
@@ -143,6 +217,7 @@ double Mesh::getVolume() const {
 }
 
 bool Mesh::isWatertight() const {
+    const Span<const Triangle> faces = getFaces();
     if (faces.empty()) {
         return false;
     }
@@ -184,6 +259,7 @@ bool Mesh::isWatertight() const {
 }
 
 Vector3 Mesh::getBoundingBox() const {
+    const Span<const Vector3> vertices = getVertices();
     if (vertices.empty()) {
         return Vector3(0, 0, 0);
     }
@@ -210,6 +286,108 @@ Vector3 Mesh::getBoundingBox() const {
 void Mesh::clear() {
     vertices.clear();
     faces.clear();
+    vertexView = Span<const Vector3>();
+    faceView = Span<const Triangle>();
+    externalVertices = false;
+    externalFaces = false;
+    viewOwner.reset();
+    adjacency = VertexFaceAdjacency();
+}
+
+void Mesh::setVertices(std::vector<Vector3>&& verts) {
+    vertices = std::move(verts);
+    vertexView = Span<const Vector3>();
+    externalVertices = false;
+    if (!externalFaces) {
+        viewOwner.reset();
+    }
+    adjacency = VertexFaceAdjacency();
+}
+
+void Mesh::setTriangles(std::vector<Triangle>&& tris) {
+    faces = std::move(tris);
+    faceView = Span<const Triangle>();
+    externalFaces = false;
+    if (!externalVertices) {
+        viewOwner.reset();
+    }
+    adjacency = VertexFaceAdjacency();
+}
+
+namespace {
+
+bool facesInRange(Span<const Triangle> faces, size_t vertexCount) {
+    for (const Triangle& face : faces) {
+        if (face.v0 < 0 || face.v1 < 0 || face.v2 < 0 ||
+            static_cast<size_t>(face.v0) >= vertexCount ||
+            static_cast<size_t>(face.v1) >= vertexCount ||
+            static_cast<size_t>(face.v2) >= vertexCount) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+bool Mesh::adopt(std::vector<Vector3>&& verts, std::vector<Triangle>&& tris) {
+    clear();
+    if (verts.size() > static_cast<size_t>(std::numeric_limits<int>::max()) ||
+        !facesInRange(tris, verts.size())) {
+        std::cerr << "Error: Mesh arrays rejected: face index out of range" << std::endl;
+        return false;
+    }
+    vertices = std::move(verts);
+    faces = std::move(tris);
+    return true;
+}
+
+bool Mesh::wrap(Span<const Vector3> verts, Span<const Triangle> tris, std::shared_ptr<const void> owner) {
+    clear();
+    if (verts.size() > static_cast<size_t>(std::numeric_limits<int>::max()) ||
+        !facesInRange(tris, verts.size())) {
+        std::cerr << "Error: Mesh arrays rejected: face index out of range" << std::endl;
+        return false;
+    }
+    vertexView = verts;
+    faceView = tris;
+    externalVertices = true;
+    externalFaces = true;
+    viewOwner = std::move(owner);
+    return true;
+}
+
+const VertexFaceAdjacency& Mesh::getVertexFaceAdjacency() const {
+    const Span<const Vector3> vertices = getVertices();
+    const Span<const Triangle> faces = getFaces();
+    if (!adjacency.empty() || vertices.empty()) {
+        return adjacency;
+    }
+
+    // Counting sort by vertex: count, prefix-sum, then scatter in face order
+    std::vector<uint32_t> offsets(vertices.size() + 1, 0);
+    for (const auto& face : faces) {
+        offsets[face.v0 + 1]++;
+        if (face.v1 != face.v0) offsets[face.v1 + 1]++;
+        if (face.v2 != face.v0 && face.v2 != face.v1) offsets[face.v2 + 1]++;
+    }
+    for (size_t v = 0; v < vertices.size(); ++v) {
+        offsets[v + 1] += offsets[v];
+    }
+
+    std::vector<uint32_t> faceIndices(offsets.back());
+    std::vector<uint32_t> cursor(offsets.begin(), offsets.end() - 1);
+    for (size_t f = 0; f < faces.size(); ++f) {
+        const Triangle& face = faces[f];
+        uint32_t index = static_cast<uint32_t>(f);
+        faceIndices[cursor[face.v0]++] = index;
+        if (face.v1 != face.v0) faceIndices[cursor[face.v1]++] = index;
+        if (face.v2 != face.v0 && face.v2 != face.v1) faceIndices[cursor[face.v2]++] = index;
+    }
+
+    adjacency.offsets = std::move(offsets);
+    adjacency.faceIndices = std::move(faceIndices);
+    return adjacency;
 }
 
 } // namespace madfam::geom
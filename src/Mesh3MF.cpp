@@ -0,0 +1,42 @@
+/**
+ * 3MF loading (Mesh::loadFrom3MF / loadFrom3MFBuffer)
+ *
+ * The package is decoded by io/ThreeMFModel.hpp, whose scanner writes
+ * vertices and triangles straight into Vector3/Triangle arrays; for the
+ * usual single-object build these arrays are moved into the mesh.
+ */
+
+#include "geom-core/Mesh.hpp"
+#include "io/ThreeMFModel.hpp"
+#include "MappedFile.hpp"
+#include <iostream>
+
+namespace madfam::geom {
+
+bool Mesh::loadFrom3MF(const std::string& filepath, int numThreads) {
+    MappedFile file;
+    if (!file.open(filepath)) {
+        std::cerr << "Error: Could not open 3MF file: " << filepath << std::endl;
+        return false;
+    }
+    return loadFrom3MFBuffer(file.data(), file.size(), numThreads);
+}
+
+bool Mesh::loadFrom3MFBuffer(const char* buffer, size_t size, int numThreads) {
+    clear();
+
+    io::ThreeMFModel model;
+    std::string error;
+    if (!io::read3MFModel(reinterpret_cast<const uint8_t*>(buffer), size, model, error, numThreads) ||
+        !io::flatten3MFModel(std::move(model), vertices, faces, error)) {
+        std::cerr << "Error: Invalid 3MF: " << error << std::endl;
+        clear();
+        return false;
+    }
+
+    std::cout << "Loaded 3MF: " << vertices.size() << " vertices, "
+              << faces.size() << " triangles" << std::endl;
+    return true;
+}
+
+} // namespace madfam::geom
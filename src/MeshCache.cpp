@@ -0,0 +1,307 @@
+/**
+ * .gcmesh cache container (Mesh::saveCache / Mesh::loadCache)
+ *
+ * Layout (native endianness, every section 64-byte aligned):
+ *
+ *   CacheHeader      64 bytes: magic, version, endian tag, counts
+ *   SectionEntry[]   one per section: kind, element size, offset, count
+ *   section data     raw arrays, exactly as held in memory
+ *
+ * Readers skip section kinds they do not know, so sections can be added
+ * without a version bump. Changing the layout of an existing section
+ * requires bumping GCMESH_VERSION; old files are then rejected and the
+ * caller falls back to re-parsing the source model.
+ */
+
+#include "geom-core/Mesh.hpp"
+#include "geom-core/Spatial.hpp"
+#include "MappedFile.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <type_traits>
+
+namespace madfam::geom {
+
+namespace {
+
+const char GCMESH_MAGIC[8] = {'G', 'C', 'M', 'E', 'S', 'H', '\0', '\0'};
+const uint32_t GCMESH_VERSION = 2;  // 2: 32-byte BVHNode
+const uint32_t GCMESH_ENDIAN_TAG = 0x01020304;
+const uint64_t GCMESH_ALIGNMENT = 64;
+
+enum SectionKind : uint32_t {
+    SECTION_VERTICES = 1,           // Vector3[vertexCount]
+    SECTION_FACES = 2,              // Triangle[faceCount]
+    SECTION_ADJACENCY_OFFSETS = 3,  // uint32_t[vertexCount + 1]
+    SECTION_ADJACENCY_FACES = 4,    // uint32_t[...]
+    SECTION_BVH_NODES = 5,          // BVHNode[...]
+    SECTION_BVH_TRIANGLES = 6,      // int32_t[faceCount]
+    SECTION_SOURCE = 7              // char[...]: saveCache's source identity
+};
+
+struct CacheHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t endianTag;
+    uint64_t fileSize;
+    uint64_t vertexCount;
+    uint64_t faceCount;
+    uint32_t sectionCount;
+    uint32_t reserved[5];
+};
+
+struct SectionEntry {
+    uint32_t kind;
+    uint32_t elementSize;
+    uint64_t offset;
+    uint64_t count;
+};
+
+static_assert(sizeof(CacheHeader) == 64, "CacheHeader layout changed");
+static_assert(sizeof(SectionEntry) == 24, "SectionEntry layout changed");
+static_assert(std::is_trivially_copyable<Vector3>::value, "Vector3 must be raw-copyable");
+static_assert(std::is_trivially_copyable<Triangle>::value, "Triangle must be raw-copyable");
+static_assert(std::is_trivially_copyable<BVHNode>::value, "BVHNode must be raw-copyable");
+
+uint64_t alignUp(uint64_t value) {
+    return (value + GCMESH_ALIGNMENT - 1) / GCMESH_ALIGNMENT * GCMESH_ALIGNMENT;
+}
+
+struct PendingSection {
+    SectionEntry entry;
+    const void* data;
+};
+
+template<typename T>
+PendingSection section(uint32_t kind, Span<const T> values) {
+    return {{kind, static_cast<uint32_t>(sizeof(T)), 0, values.size()}, values.data()};
+}
+
+/**
+ * Copy a section into a vector after checking bounds and element size.
+ * Missing sections leave out empty and return true.
+ */
+template<typename T>
+bool readSection(const MappedFile& file, const SectionEntry* entries, uint32_t sectionCount,
+                 uint32_t kind, std::vector<T>& out) {
+    out.clear();
+    for (uint32_t i = 0; i < sectionCount; ++i) {
+        const SectionEntry& entry = entries[i];
+        if (entry.kind != kind) {
+            continue;
+        }
+        if (entry.elementSize != sizeof(T)) {
+            std::cerr << "Error: .gcmesh section " << kind << " has element size "
+                      << entry.elementSize << ", expected " << sizeof(T) << std::endl;
+            return false;
+        }
+        if (entry.offset % GCMESH_ALIGNMENT != 0 || entry.offset > file.size() ||
+            entry.count > (file.size() - entry.offset) / sizeof(T)) {
+            std::cerr << "Error: .gcmesh section " << kind << " lies outside the file" << std::endl;
+            return false;
+        }
+        out.resize(entry.count);
+        if (entry.count > 0) {
+            std::memcpy(out.data(), file.data() + entry.offset, entry.count * sizeof(T));
+        }
+        return true;
+    }
+    return true;
+}
+
+} // namespace
+
+bool Mesh::saveCache(const std::string& filepath, const AABBTree* tree, const std::string& source) const {
+    const VertexFaceAdjacency& adj = getVertexFaceAdjacency();
+
+    std::vector<PendingSection> sections;
+    const Span<const Vector3> vertices = getVertices();
+    const Span<const Triangle> faces = getFaces();
+    sections.push_back(section<Vector3>(SECTION_VERTICES, vertices));
+    sections.push_back(section<Triangle>(SECTION_FACES, faces));
+    sections.push_back(section<uint32_t>(SECTION_ADJACENCY_OFFSETS, adj.offsets));
+    sections.push_back(section<uint32_t>(SECTION_ADJACENCY_FACES, adj.faceIndices));
+    if (tree && tree->isBuilt()) {
+        sections.push_back(section<BVHNode>(SECTION_BVH_NODES, tree->getNodes()));
+        sections.push_back(section<int>(SECTION_BVH_TRIANGLES, tree->getTriangleOrder()));
+    }
+    if (!source.empty()) {
+        sections.push_back(section<char>(SECTION_SOURCE, Span<const char>(source.data(), source.size())));
+    }
+
+    // Assign aligned offsets after the header and section table
+    uint64_t offset = alignUp(sizeof(CacheHeader) + sections.size() * sizeof(SectionEntry));
+    for (auto& pending : sections) {
+        pending.entry.offset = offset;
+        offset = alignUp(offset + pending.entry.count * pending.entry.elementSize);
+    }
+
+    CacheHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, GCMESH_MAGIC, sizeof(GCMESH_MAGIC));
+    header.version = GCMESH_VERSION;
+    header.endianTag = GCMESH_ENDIAN_TAG;
+    header.fileSize = offset;
+    header.vertexCount = vertices.size();
+    header.faceCount = faces.size();
+    header.sectionCount = static_cast<uint32_t>(sections.size());
+
+    // Write beside the target and rename, so readers never map a partial file
+    const std::string tempPath = filepath + ".tmp";
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            std::cerr << "Error: Could not create cache file: " << tempPath << std::endl;
+            return false;
+        }
+
+        const char padding[GCMESH_ALIGNMENT] = {};
+        uint64_t written = 0;
+        auto padTo = [&](uint64_t target) {
+            file.write(padding, static_cast<std::streamsize>(target - written));
+            written = target;
+        };
+
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        written += sizeof(header);
+        for (const auto& pending : sections) {
+            file.write(reinterpret_cast<const char*>(&pending.entry), sizeof(SectionEntry));
+            written += sizeof(SectionEntry);
+        }
+
+        for (const auto& pending : sections) {
+            padTo(pending.entry.offset);
+            uint64_t bytes = pending.entry.count * pending.entry.elementSize;
+            file.write(static_cast<const char*>(pending.data), static_cast<std::streamsize>(bytes));
+            written += bytes;
+        }
+        padTo(header.fileSize);
+
+        if (!file) {
+            std::cerr << "Error: Failed to write cache file: " << tempPath << std::endl;
+            std::remove(tempPath.c_str());
+            return false;
+        }
+    }
+
+    if (std::rename(tempPath.c_str(), filepath.c_str()) != 0) {
+        std::cerr << "Error: Could not move cache file into place: " << filepath << std::endl;
+        std::remove(tempPath.c_str());
+        return false;
+    }
+
+    return true;
+}
+
+bool Mesh::loadCache(const std::string& filepath, AABBTree* tree, const std::string& expectedSource) {
+    clear();
+    if (tree) {
+        tree->clear();
+    }
+
+    MappedFile file;
+    if (!file.open(filepath)) {
+        return false;
+    }
+
+    CacheHeader header;
+    if (file.size() < sizeof(header)) {
+        std::cerr << "Error: Not a .gcmesh file (too small): " << filepath << std::endl;
+        return false;
+    }
+    std::memcpy(&header, file.data(), sizeof(header));
+
+    if (std::memcmp(header.magic, GCMESH_MAGIC, sizeof(GCMESH_MAGIC)) != 0) {
+        std::cerr << "Error: Not a .gcmesh file: " << filepath << std::endl;
+        return false;
+    }
+    if (header.version != GCMESH_VERSION || header.endianTag != GCMESH_ENDIAN_TAG) {
+        std::cerr << "Error: Unsupported .gcmesh version " << header.version
+                  << " (expected " << GCMESH_VERSION << ") or byte order" << std::endl;
+        return false;
+    }
+    if (header.fileSize != file.size() ||
+        header.sectionCount > (file.size() - sizeof(header)) / sizeof(SectionEntry)) {
+        std::cerr << "Error: Truncated .gcmesh file: " << filepath << std::endl;
+        return false;
+    }
+
+    // The section table directly follows the 64-byte header, so it is aligned
+    const SectionEntry* entries = reinterpret_cast<const SectionEntry*>(file.data() + sizeof(header));
+
+    if (!expectedSource.empty()) {
+        std::vector<char> source;
+        if (!readSection(file, entries, header.sectionCount, SECTION_SOURCE, source)) {
+            return false;
+        }
+        if (source.size() != expectedSource.size() ||
+            std::memcmp(source.data(), expectedSource.data(), source.size()) != 0) {
+            std::cerr << "Error: .gcmesh file was saved from a different source: " << filepath << std::endl;
+            return false;
+        }
+    }
+
+    std::vector<uint32_t> adjacencyOffsets;
+    std::vector<uint32_t> adjacencyFaces;
+    if (!readSection(file, entries, header.sectionCount, SECTION_VERTICES, vertices) ||
+        !readSection(file, entries, header.sectionCount, SECTION_FACES, faces) ||
+        !readSection(file, entries, header.sectionCount, SECTION_ADJACENCY_OFFSETS, adjacencyOffsets) ||
+        !readSection(file, entries, header.sectionCount, SECTION_ADJACENCY_FACES, adjacencyFaces)) {
+        clear();
+        return false;
+    }
+
+    // Cheap consistency checks; a corrupt cache must not crash later queries
+    bool valid = vertices.size() == header.vertexCount && faces.size() == header.faceCount;
+    const int vertexCount = static_cast<int>(vertices.size());
+    for (size_t i = 0; valid && i < faces.size(); ++i) {
+        const Triangle& face = faces[i];
+        valid = face.v0 >= 0 && face.v0 < vertexCount &&
+                face.v1 >= 0 && face.v1 < vertexCount &&
+                face.v2 >= 0 && face.v2 < vertexCount;
+    }
+    if (!valid) {
+        std::cerr << "Error: Corrupt .gcmesh mesh sections: " << filepath << std::endl;
+        clear();
+        return false;
+    }
+
+    // Adjacency is optional; rebuilt on demand if missing or inconsistent
+    if (adjacencyOffsets.size() == vertices.size() + 1 && adjacencyOffsets.front() == 0 &&
+        adjacencyOffsets.back() == adjacencyFaces.size() &&
+        std::is_sorted(adjacencyOffsets.begin(), adjacencyOffsets.end())) {
+        bool facesValid = true;
+        for (uint32_t face : adjacencyFaces) {
+            if (face >= faces.size()) {
+                facesValid = false;
+                break;
+            }
+        }
+        if (facesValid) {
+            adjacency.offsets = std::move(adjacencyOffsets);
+            adjacency.faceIndices = std::move(adjacencyFaces);
+        }
+    }
+
+    if (tree) {
+        std::vector<BVHNode> nodes;
+        std::vector<int> order;
+        if (!readSection(file, entries, header.sectionCount, SECTION_BVH_NODES, nodes) ||
+            !readSection(file, entries, header.sectionCount, SECTION_BVH_TRIANGLES, order)) {
+            clear();
+            return false;
+        }
+        if (!nodes.empty() && !tree->adopt(std::move(nodes), std::move(order), vertices, faces)) {
+            std::cerr << "Warning: Ignoring corrupt spatial index in " << filepath << std::endl;
+        }
+    }
+
+    std::cout << "Loaded mesh cache: " << vertices.size() << " vertices, "
+              << faces.size() << " triangles" << std::endl;
+    return true;
+}
+
+} // namespace madfam::geom
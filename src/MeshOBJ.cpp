@@ -0,0 +1,243 @@
+/**
+ * Parallel Wavefront OBJ reader (Mesh::loadFromOBJ / loadFromOBJBuffer)
+ *
+ * The buffer is cut into fixed-size chunks on line boundaries and each chunk
+ * is parsed independently. Vertex counts per chunk are prefix-summed so
+ * relative (negative) face indices can be resolved after the parallel pass.
+ */
+
+#include "geom-core/Mesh.hpp"
+#include "MappedFile.hpp"
+#include "Parallel.hpp"
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <string>
+
+namespace madfam::geom {
+
+namespace {
+
+// Bytes per parse work item (cut at the next newline)
+const size_t OBJ_CHUNK_BYTES = 1 << 20;
+
+/**
+ * Triangle as parsed: absolute (0-based) indices, or for relative (negative)
+ * OBJ indices a position relative to the chunk's first vertex, which may
+ * point into an earlier chunk. Resolved once chunk vertex offsets are known.
+ */
+struct RawFace {
+    int64_t v[3];
+    uint8_t relativeMask;  // Bit k set: v[k] is chunk-relative
+};
+
+struct OBJChunk {
+    std::vector<Vector3> vertices;
+    std::vector<RawFace> faces;
+    std::string error;
+    size_t errorLine = 0;  // 1-based line within the chunk
+};
+
+inline bool isSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+inline const char* skipSpaces(const char* p, const char* end) {
+    while (p < end && isSpace(*p)) ++p;
+    return p;
+}
+
+inline const char* parseDouble(const char* p, const char* end, double& value) {
+    p = skipSpaces(p, end);
+    if (p < end && *p == '+') ++p;  // from_chars rejects a leading '+'
+    auto result = std::from_chars(p, end, value);
+    return result.ec == std::errc() ? result.ptr : nullptr;
+}
+
+/**
+ * Parse one face corner "v", "v/vt", "v//vn" or "v/vt/vn", keeping only v.
+ * Returns nullptr on malformed input.
+ */
+inline const char* parseCorner(const char* p, const char* end, size_t localVertexCount,
+                               int64_t& index, bool& relative) {
+    int64_t value = 0;
+    auto result = std::from_chars(p, end, value);
+    if (result.ec != std::errc() || value == 0) {
+        return nullptr;
+    }
+    p = result.ptr;
+    while (p < end && !isSpace(*p)) ++p;  // Skip /vt/vn
+
+    // -1 is the most recently defined vertex
+    relative = value < 0;
+    index = relative ? static_cast<int64_t>(localVertexCount) + value : value - 1;
+    return p;
+}
+
+void parseChunk(const char* begin, const char* end, OBJChunk& chunk) {
+    const char* p = begin;
+    size_t line = 0;
+    std::vector<int64_t> polygon;
+    std::vector<bool> polygonRelative;
+
+    auto fail = [&](const char* message) {
+        chunk.error = message;
+        chunk.errorLine = line;
+    };
+
+    while (p < end) {
+        ++line;
+        const char* lineEnd = static_cast<const char*>(std::memchr(p, '\n', end - p));
+        if (!lineEnd) lineEnd = end;
+
+        p = skipSpaces(p, lineEnd);
+        if (lineEnd - p >= 2 && p[0] == 'v' && isSpace(p[1])) {
+            Vector3 v;
+            const char* q = parseDouble(p + 2, lineEnd, v.x);
+            if (q) q = parseDouble(q, lineEnd, v.y);
+            if (q) q = parseDouble(q, lineEnd, v.z);
+            if (!q) {
+                fail("invalid vertex");
+                return;
+            }
+            chunk.vertices.push_back(v);
+        } else if (lineEnd - p >= 2 && p[0] == 'f' && isSpace(p[1])) {
+            polygon.clear();
+            polygonRelative.clear();
+            const char* q = skipSpaces(p + 2, lineEnd);
+            while (q < lineEnd && *q != '#') {
+                int64_t index;
+                bool relative;
+                q = parseCorner(q, lineEnd, chunk.vertices.size(), index, relative);
+                if (!q) {
+                    fail("invalid face index");
+                    return;
+                }
+                polygon.push_back(index);
+                polygonRelative.push_back(relative);
+                q = skipSpaces(q, lineEnd);
+            }
+            if (polygon.size() < 3) {
+                fail("face with fewer than 3 vertices");
+                return;
+            }
+            // Fan-triangulate polygons
+            for (size_t k = 1; k + 1 < polygon.size(); ++k) {
+                RawFace face;
+                face.v[0] = polygon[0];
+                face.v[1] = polygon[k];
+                face.v[2] = polygon[k + 1];
+                face.relativeMask = static_cast<uint8_t>(
+                    (polygonRelative[0] ? 1 : 0) | (polygonRelative[k] ? 2 : 0) |
+                    (polygonRelative[k + 1] ? 4 : 0));
+                chunk.faces.push_back(face);
+            }
+        }
+        // Everything else (vt, vn, g, o, s, usemtl, comments, ...) is ignored
+
+        p = lineEnd + 1;
+    }
+}
+
+} // namespace
+
+bool Mesh::loadFromOBJ(const std::string& filepath, int numThreads) {
+    MappedFile file;
+    if (!file.open(filepath)) {
+        std::cerr << "Error: Could not open OBJ file: " << filepath << std::endl;
+        return false;
+    }
+    file.adviseSequential();
+    return loadFromOBJBuffer(file.data(), file.size(), numThreads);
+}
+
+bool Mesh::loadFromOBJBuffer(const char* buffer, size_t size, int numThreads) {
+    clear();
+
+    // Cut on line boundaries; chunking is independent of the thread count
+    std::vector<std::pair<size_t, size_t>> ranges;
+    size_t start = 0;
+    while (start < size) {
+        size_t stop = std::min(start + OBJ_CHUNK_BYTES, size);
+        if (stop < size) {
+            const void* newline = std::memchr(buffer + stop, '\n', size - stop);
+            stop = newline ? static_cast<size_t>(static_cast<const char*>(newline) - buffer) + 1 : size;
+        }
+        ranges.emplace_back(start, stop);
+        start = stop;
+    }
+
+    std::vector<OBJChunk> chunks(ranges.size());
+    parallel::forEachIndex(ranges.size(), parallel::resolveThreadCount(numThreads), [&](size_t c) {
+        parseChunk(buffer + ranges[c].first, buffer + ranges[c].second, chunks[c]);
+    });
+
+    // Report the first error with a file-wide line number
+    size_t lineBase = 0;
+    for (size_t c = 0; c < chunks.size(); ++c) {
+        if (!chunks[c].error.empty()) {
+            std::cerr << "Error: Invalid OBJ: " << chunks[c].error << " at line "
+                      << lineBase + chunks[c].errorLine << std::endl;
+            clear();
+            return false;
+        }
+        const char* first = buffer + ranges[c].first;
+        lineBase += static_cast<size_t>(std::count(first, buffer + ranges[c].second, '\n'));
+    }
+
+    // Prefix sums give each chunk's first global vertex and face
+    std::vector<size_t> vertexBase(chunks.size() + 1, 0);
+    std::vector<size_t> faceBase(chunks.size() + 1, 0);
+    for (size_t c = 0; c < chunks.size(); ++c) {
+        vertexBase[c + 1] = vertexBase[c] + chunks[c].vertices.size();
+        faceBase[c + 1] = faceBase[c] + chunks[c].faces.size();
+    }
+
+    const int64_t vertexCount = static_cast<int64_t>(vertexBase.back());
+    if (vertexBase.back() > static_cast<size_t>(std::numeric_limits<int>::max())) {
+        std::cerr << "Error: OBJ has too many vertices" << std::endl;
+        clear();
+        return false;
+    }
+    vertices.resize(vertexBase.back());
+    faces.resize(faceBase.back());
+
+    std::vector<char> chunkValid(chunks.size(), 1);
+    parallel::forEachIndex(chunks.size(), parallel::resolveThreadCount(numThreads), [&](size_t c) {
+        OBJChunk& chunk = chunks[c];
+        std::copy(chunk.vertices.begin(), chunk.vertices.end(), vertices.begin() + vertexBase[c]);
+
+        const int64_t base = static_cast<int64_t>(vertexBase[c]);
+        for (size_t i = 0; i < chunk.faces.size(); ++i) {
+            const RawFace& raw = chunk.faces[i];
+            int resolved[3];
+            for (int k = 0; k < 3; ++k) {
+                int64_t absolute = (raw.relativeMask & (1 << k)) ? base + raw.v[k] : raw.v[k];
+                if (absolute < 0 || absolute >= vertexCount) {
+                    chunkValid[c] = 0;
+                    absolute = 0;
+                }
+                resolved[k] = static_cast<int>(absolute);
+            }
+            faces[faceBase[c] + i] = Triangle(resolved[0], resolved[1], resolved[2]);
+        }
+
+        std::vector<Vector3>().swap(chunk.vertices);
+        std::vector<RawFace>().swap(chunk.faces);
+    });
+
+    if (std::find(chunkValid.begin(), chunkValid.end(), 0) != chunkValid.end()) {
+        std::cerr << "Error: Invalid OBJ: face index out of range" << std::endl;
+        clear();
+        return false;
+    }
+
+    std::cout << "Loaded OBJ: " << vertices.size() << " vertices, "
+              << faces.size() << " triangles" << std::endl;
+    return true;
+}
+
+} // namespace madfam::geom
@@ -0,0 +1,702 @@
+/**
+ * PLY reader (Mesh::loadFromPLY / loadFromPLYBuffer)
+ *
+ * PLY is already indexed, so vertex and face lists are decoded straight into
+ * the mesh arrays without welding. Binary vertex records have a fixed size
+ * and are decoded in parallel blocks. Face records are decoded in parallel
+ * on the assumption that every face is a triangle (fixed record size); the
+ * first face that is not falls back to a sequential pass that
+ * fan-triangulates polygons. ASCII files are parsed sequentially.
+ */
+
+#include "geom-core/Mesh.hpp"
+#include "MappedFile.hpp"
+#include "Parallel.hpp"
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace madfam::geom {
+
+namespace {
+
+// Vertices or faces per parallel work item (minimum)
+const size_t PLY_BLOCK = 1 << 16;
+
+// Headers are small; anything longer is not a PLY file
+const size_t PLY_MAX_HEADER = 1 << 20;
+
+enum class PLYFormat { ASCII, BinaryLittleEndian, BinaryBigEndian };
+
+enum class PLYType : uint8_t { Int8, UInt8, Int16, UInt16, Int32, UInt32, Float32, Float64 };
+
+struct PLYProperty {
+    std::string name;
+    bool isList = false;
+    PLYType countType = PLYType::UInt8;  // Lists only
+    PLYType type = PLYType::Float32;     // Value type (list item type for lists)
+};
+
+struct PLYElement {
+    std::string name;
+    uint64_t count = 0;
+    std::vector<PLYProperty> properties;
+
+    /**
+     * Bytes per binary record, or 0 if the element has list properties
+     */
+    size_t fixedSize() const;
+
+    /**
+     * Bytes taken by the scalar (non-list) properties of a record
+     */
+    size_t scalarSize() const;
+};
+
+struct PLYHeader {
+    PLYFormat format = PLYFormat::ASCII;
+    std::vector<PLYElement> elements;
+    size_t dataOffset = 0;
+};
+
+size_t typeSize(PLYType type) {
+    switch (type) {
+        case PLYType::Int8: case PLYType::UInt8: return 1;
+        case PLYType::Int16: case PLYType::UInt16: return 2;
+        case PLYType::Int32: case PLYType::UInt32: case PLYType::Float32: return 4;
+        case PLYType::Float64: return 8;
+    }
+    return 0;
+}
+
+bool isIntegerType(PLYType type) {
+    return type != PLYType::Float32 && type != PLYType::Float64;
+}
+
+size_t PLYElement::fixedSize() const {
+    size_t size = 0;
+    for (const auto& property : properties) {
+        if (property.isList) {
+            return 0;
+        }
+        size += typeSize(property.type);
+    }
+    return size;
+}
+
+size_t PLYElement::scalarSize() const {
+    size_t size = 0;
+    for (const auto& property : properties) {
+        if (!property.isList) {
+            size += typeSize(property.type);
+        }
+    }
+    return size;
+}
+
+inline bool isLittleEndian() {
+    const uint16_t probe = 1;
+    uint8_t first;
+    std::memcpy(&first, &probe, 1);
+    return first == 1;
+}
+
+bool parseType(const std::string& name, PLYType& type) {
+    static const struct { const char* name; PLYType type; } names[] = {
+        {"char", PLYType::Int8}, {"int8", PLYType::Int8},
+        {"uchar", PLYType::UInt8}, {"uint8", PLYType::UInt8},
+        {"short", PLYType::Int16}, {"int16", PLYType::Int16},
+        {"ushort", PLYType::UInt16}, {"uint16", PLYType::UInt16},
+        {"int", PLYType::Int32}, {"int32", PLYType::Int32},
+        {"uint", PLYType::UInt32}, {"uint32", PLYType::UInt32},
+        {"float", PLYType::Float32}, {"float32", PLYType::Float32},
+        {"double", PLYType::Float64}, {"float64", PLYType::Float64},
+    };
+    for (const auto& entry : names) {
+        if (name == entry.name) {
+            type = entry.type;
+            return true;
+        }
+    }
+    return false;
+}
+
+std::vector<std::string> splitWords(const char* begin, const char* end) {
+    std::vector<std::string> words;
+    const char* p = begin;
+    while (p < end) {
+        while (p < end && (*p == ' ' || *p == '\t' || *p == '\r')) ++p;
+        const char* word = p;
+        while (p < end && *p != ' ' && *p != '\t' && *p != '\r') ++p;
+        if (p > word) {
+            words.emplace_back(word, p);
+        }
+    }
+    return words;
+}
+
+bool parseHeader(const char* buffer, size_t size, PLYHeader& header, std::string& error) {
+    if (size < 4 || std::memcmp(buffer, "ply", 3) != 0 || (buffer[3] != '\n' && buffer[3] != '\r')) {
+        error = "missing 'ply' magic";
+        return false;
+    }
+
+    bool haveFormat = false;
+    const char* p = buffer;
+    const char* const limit = buffer + std::min(size, PLY_MAX_HEADER);
+    while (true) {
+        const char* lineEnd = static_cast<const char*>(std::memchr(p, '\n', limit - p));
+        if (!lineEnd) {
+            error = "header has no end_header line";
+            return false;
+        }
+        std::vector<std::string> words = splitWords(p, lineEnd);
+        p = lineEnd + 1;
+        if (words.empty() || words[0] == "ply" || words[0] == "comment" || words[0] == "obj_info") {
+            continue;
+        }
+
+        if (words[0] == "end_header") {
+            break;
+        } else if (words[0] == "format") {
+            if (words.size() < 2) {
+                error = "malformed format line";
+                return false;
+            }
+            if (words[1] == "ascii") {
+                header.format = PLYFormat::ASCII;
+            } else if (words[1] == "binary_little_endian") {
+                header.format = PLYFormat::BinaryLittleEndian;
+            } else if (words[1] == "binary_big_endian") {
+                header.format = PLYFormat::BinaryBigEndian;
+            } else {
+                error = "unknown format '" + words[1] + "'";
+                return false;
+            }
+            haveFormat = true;
+        } else if (words[0] == "element") {
+            PLYElement element;
+            if (words.size() != 3 ||
+                std::from_chars(words[2].data(), words[2].data() + words[2].size(), element.count).ec != std::errc()) {
+                error = "malformed element line";
+                return false;
+            }
+            element.name = words[1];
+            header.elements.push_back(std::move(element));
+        } else if (words[0] == "property") {
+            if (header.elements.empty()) {
+                error = "property before any element";
+                return false;
+            }
+            PLYProperty property;
+            bool valid;
+            if (words.size() == 5 && words[1] == "list") {
+                property.isList = true;
+                property.name = words[4];
+                valid = parseType(words[2], property.countType) && isIntegerType(property.countType) &&
+                        parseType(words[3], property.type);
+            } else {
+                property.name = words.size() == 3 ? words[2] : "";
+                valid = words.size() == 3 && parseType(words[1], property.type);
+            }
+            if (!valid) {
+                error = "malformed property line";
+                return false;
+            }
+            header.elements.back().properties.push_back(std::move(property));
+        } else {
+            error = "unknown header keyword '" + words[0] + "'";
+            return false;
+        }
+    }
+
+    if (!haveFormat) {
+        error = "missing format line";
+        return false;
+    }
+    header.dataOffset = static_cast<size_t>(p - buffer);
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// Binary decoding
+// ---------------------------------------------------------------------------
+
+template<bool Swap, typename T>
+inline T loadRaw(const char* p) {
+    if constexpr (Swap && sizeof(T) > 1) {
+        char bytes[sizeof(T)];
+        for (size_t i = 0; i < sizeof(T); ++i) {
+            bytes[i] = p[sizeof(T) - 1 - i];
+        }
+        T value;
+        std::memcpy(&value, bytes, sizeof(T));
+        return value;
+    } else {
+        T value;
+        std::memcpy(&value, p, sizeof(T));
+        return value;
+    }
+}
+
+template<bool Swap>
+inline double loadScalar(const char* p, PLYType type) {
+    switch (type) {
+        case PLYType::Int8: return loadRaw<Swap, int8_t>(p);
+        case PLYType::UInt8: return loadRaw<Swap, uint8_t>(p);
+        case PLYType::Int16: return loadRaw<Swap, int16_t>(p);
+        case PLYType::UInt16: return loadRaw<Swap, uint16_t>(p);
+        case PLYType::Int32: return loadRaw<Swap, int32_t>(p);
+        case PLYType::UInt32: return loadRaw<Swap, uint32_t>(p);
+        case PLYType::Float32: return loadRaw<Swap, float>(p);
+        case PLYType::Float64: return loadRaw<Swap, double>(p);
+    }
+    return 0.0;
+}
+
+template<bool Swap>
+inline int64_t loadInteger(const char* p, PLYType type) {
+    switch (type) {
+        case PLYType::Int8: return loadRaw<Swap, int8_t>(p);
+        case PLYType::UInt8: return loadRaw<Swap, uint8_t>(p);
+        case PLYType::Int16: return loadRaw<Swap, int16_t>(p);
+        case PLYType::UInt16: return loadRaw<Swap, uint16_t>(p);
+        case PLYType::Int32: return loadRaw<Swap, int32_t>(p);
+        case PLYType::UInt32: return loadRaw<Swap, uint32_t>(p);
+        default: return -1;  // Float list indices are rejected up front
+    }
+}
+
+/**
+ * Byte offset of the element after this one, walking records if they
+ * contain lists; nullptr if the data is truncated
+ */
+template<bool Swap>
+const char* skipElement(const char* p, const char* end, const PLYElement& element) {
+    if (element.properties.empty()) {
+        return p;
+    }
+    size_t fixed = element.fixedSize();
+    if (fixed > 0) {
+        if (element.count > static_cast<uint64_t>(end - p) / fixed) {
+            return nullptr;
+        }
+        return p + element.count * fixed;
+    }
+    for (uint64_t i = 0; i < element.count; ++i) {
+        for (const auto& property : element.properties) {
+            size_t valueSize = typeSize(property.type);
+            if (!property.isList) {
+                if (static_cast<size_t>(end - p) < valueSize) return nullptr;
+                p += valueSize;
+                continue;
+            }
+            size_t countSize = typeSize(property.countType);
+            if (static_cast<size_t>(end - p) < countSize) return nullptr;
+            int64_t count = loadInteger<Swap>(p, property.countType);
+            p += countSize;
+            if (count < 0 || static_cast<uint64_t>(count) > static_cast<size_t>(end - p) / valueSize) {
+                return nullptr;
+            }
+            p += static_cast<size_t>(count) * valueSize;
+        }
+    }
+    return p;
+}
+
+struct FaceLayout {
+    size_t listIndex = 0;      // Index of the vertex_indices property
+    size_t listOffset = 0;     // Bytes of scalar properties before the list
+    bool otherLists = false;   // Record has lists besides vertex_indices
+};
+
+/**
+ * Decode a binary vertex element with fixed-size records in parallel
+ */
+template<bool Swap>
+void decodeVertices(const char* data, const PLYElement& element, const size_t offsets[3],
+                    const PLYType types[3], int numThreads, std::vector<Vector3>& vertices) {
+    const size_t stride = element.fixedSize();
+    vertices.resize(static_cast<size_t>(element.count));
+    const bool allFloat = types[0] == PLYType::Float32 && types[1] == PLYType::Float32 &&
+                          types[2] == PLYType::Float32;
+    parallel::forEachBlock(vertices.size(), numThreads, PLY_BLOCK, [&](size_t begin, size_t end) {
+        const char* record = data + begin * stride;
+        for (size_t i = begin; i < end; ++i, record += stride) {
+            if (allFloat) {
+                vertices[i] = Vector3(loadRaw<Swap, float>(record + offsets[0]),
+                                      loadRaw<Swap, float>(record + offsets[1]),
+                                      loadRaw<Swap, float>(record + offsets[2]));
+            } else {
+                vertices[i] = Vector3(loadScalar<Swap>(record + offsets[0], types[0]),
+                                      loadScalar<Swap>(record + offsets[1], types[1]),
+                                      loadScalar<Swap>(record + offsets[2], types[2]));
+            }
+        }
+    });
+}
+
+/**
+ * Bytes per face record if every face is a triangle
+ */
+size_t triangleRecordSize(const PLYElement& element, const FaceLayout& layout) {
+    const PLYProperty& list = element.properties[layout.listIndex];
+    return element.scalarSize() + typeSize(list.countType) + 3 * typeSize(list.type);
+}
+
+/**
+ * Parallel face decode assuming every face is a triangle
+ * @return false if some face is not a triangle (faces left partially filled)
+ *
+ * Indices are range-checked by the caller; values that do not fit an int
+ * wrap to negative and fail that check.
+ */
+template<bool Swap>
+bool decodeTriangleFaces(const char* data, const PLYElement& element, const FaceLayout& layout,
+                         int numThreads, std::vector<Triangle>& faces) {
+    const PLYProperty& list = element.properties[layout.listIndex];
+    const size_t countSize = typeSize(list.countType);
+    const size_t indexSize = typeSize(list.type);
+    const size_t stride = triangleRecordSize(element, layout);
+
+    faces.resize(static_cast<size_t>(element.count));
+    std::atomic<bool> allTriangles{true};
+    parallel::forEachBlock(faces.size(), numThreads, PLY_BLOCK, [&](size_t begin, size_t end) {
+        const char* record = data + begin * stride + layout.listOffset;
+        for (size_t i = begin; i < end; ++i, record += stride) {
+            if (loadInteger<Swap>(record, list.countType) != 3) {
+                allTriangles.store(false, std::memory_order_relaxed);
+                return;
+            }
+            const char* indices = record + countSize;
+            faces[i] = Triangle(static_cast<int>(loadInteger<Swap>(indices, list.type)),
+                                static_cast<int>(loadInteger<Swap>(indices + indexSize, list.type)),
+                                static_cast<int>(loadInteger<Swap>(indices + 2 * indexSize, list.type)));
+        }
+    });
+    return allTriangles.load();
+}
+
+/**
+ * Sequential face decode for arbitrary records; polygons are fan-triangulated
+ * @return nullptr if the data is truncated or an index is negative
+ */
+template<bool Swap>
+const char* walkFaces(const char* p, const char* end, const PLYElement& element,
+                      const FaceLayout& layout, std::vector<Triangle>& faces, std::string& error) {
+    faces.clear();
+    std::vector<int> polygon;
+    for (uint64_t i = 0; i < element.count; ++i) {
+        for (size_t k = 0; k < element.properties.size(); ++k) {
+            const PLYProperty& property = element.properties[k];
+            size_t valueSize = typeSize(property.type);
+            if (!property.isList) {
+                if (static_cast<size_t>(end - p) < valueSize) {
+                    error = "face data truncated";
+                    return nullptr;
+                }
+                p += valueSize;
+                continue;
+            }
+            size_t countSize = typeSize(property.countType);
+            int64_t count = static_cast<size_t>(end - p) < countSize ? -1 : loadInteger<Swap>(p, property.countType);
+            if (count < 0 || static_cast<uint64_t>(count) > static_cast<size_t>(end - p - countSize) / valueSize) {
+                error = "face data truncated";
+                return nullptr;
+            }
+            p += countSize;
+            if (k == layout.listIndex) {
+                polygon.clear();
+                for (int64_t j = 0; j < count; ++j, p += valueSize) {
+                    int64_t index = loadInteger<Swap>(p, property.type);
+                    if (index < 0 || index > std::numeric_limits<int>::max()) {
+                        error = "face index out of range";
+                        return nullptr;
+                    }
+                    polygon.push_back(static_cast<int>(index));
+                }
+                for (size_t j = 1; j + 1 < polygon.size(); ++j) {
+                    faces.emplace_back(polygon[0], polygon[j], polygon[j + 1]);
+                }
+            } else {
+                p += static_cast<size_t>(count) * valueSize;
+            }
+        }
+    }
+    return p;
+}
+
+// ---------------------------------------------------------------------------
+// ASCII decoding
+// ---------------------------------------------------------------------------
+
+class ASCIIReader {
+public:
+    ASCIIReader(const char* begin, const char* end) : p(begin), end(end) {}
+
+    bool scalar(PLYType type, double& value) {
+        skipSpace();
+        if (p < end && *p == '+') ++p;  // from_chars rejects a leading '+'
+        std::from_chars_result result;
+        if (type == PLYType::Float32) {
+            // Read at the declared precision, like the binary path
+            float f;
+            result = std::from_chars(p, end, f);
+            value = f;
+        } else {
+            result = std::from_chars(p, end, value);
+        }
+        return finish(result);
+    }
+
+    bool integer(int64_t& value) {
+        skipSpace();
+        if (p < end && *p == '+') ++p;
+        return finish(std::from_chars(p, end, value));
+    }
+
+private:
+    const char* p;
+    const char* end;
+
+    void skipSpace() {
+        while (p < end && (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n')) ++p;
+    }
+
+    bool finish(const std::from_chars_result& result) {
+        if (result.ec != std::errc()) {
+            return false;
+        }
+        p = result.ptr;
+        return true;
+    }
+};
+
+bool readASCII(const char* begin, const char* end, const PLYHeader& header,
+               std::vector<Vector3>& vertices, std::vector<Triangle>& faces, std::string& error) {
+    ASCIIReader reader(begin, end);
+    std::vector<int> polygon;
+    bool haveVertices = false;
+    bool haveFaces = false;
+    for (const PLYElement& element : header.elements) {
+        if (haveVertices && haveFaces) {
+            break;  // Trailing elements (edges, materials, ...) are not needed
+        }
+        const bool isVertex = element.name == "vertex" && !haveVertices;
+        const bool isFace = element.name == "face" && !haveFaces;
+        haveVertices |= isVertex;
+        haveFaces |= isFace;
+        if (isVertex) {
+            vertices.reserve(static_cast<size_t>(std::min<uint64_t>(element.count, end - begin)));
+        }
+        for (uint64_t i = 0; i < element.count; ++i) {
+            double xyz[3] = {0.0, 0.0, 0.0};
+            for (const PLYProperty& property : element.properties) {
+                if (!property.isList) {
+                    double value;
+                    if (!reader.scalar(property.type, value)) {
+                        error = "invalid " + element.name + " value";
+                        return false;
+                    }
+                    if (isVertex && property.name.size() == 1 && property.name[0] >= 'x' && property.name[0] <= 'z') {
+                        xyz[property.name[0] - 'x'] = value;
+                    }
+                    continue;
+                }
+                int64_t count;
+                if (!reader.integer(count) || count < 0) {
+                    error = "invalid " + element.name + " list";
+                    return false;
+                }
+                const bool indices = isFace && (property.name == "vertex_indices" || property.name == "vertex_index");
+                polygon.clear();
+                for (int64_t j = 0; j < count; ++j) {
+                    double value;
+                    if (!reader.scalar(property.type, value)) {
+                        error = "invalid " + element.name + " list";
+                        return false;
+                    }
+                    if (indices) {
+                        if (value < 0 || value > std::numeric_limits<int>::max()) {
+                            error = "face index out of range";
+                            return false;
+                        }
+                        polygon.push_back(static_cast<int>(value));
+                    }
+                }
+                for (size_t j = 1; j + 1 < polygon.size(); ++j) {
+                    faces.emplace_back(polygon[0], polygon[j], polygon[j + 1]);
+                }
+            }
+            if (isVertex) {
+                vertices.emplace_back(xyz[0], xyz[1], xyz[2]);
+            }
+        }
+    }
+    return true;
+}
+
+template<bool Swap>
+bool readBinary(const char* begin, const char* end, const PLYHeader& header, int numThreads,
+                std::vector<Vector3>& vertices, std::vector<Triangle>& faces, std::string& error) {
+    const char* p = begin;
+    bool haveVertices = false;
+    bool haveFaces = false;
+    for (const PLYElement& element : header.elements) {
+        if (haveVertices && haveFaces) {
+            break;  // Trailing elements (edges, materials, ...) are not needed
+        }
+        if (element.name == "vertex" && !haveVertices) {
+            haveVertices = true;
+            size_t offsets[3];
+            PLYType types[3];
+            size_t offset = 0;
+            int found = 0;
+            for (const auto& property : element.properties) {
+                if (property.isList) {
+                    error = "list properties on vertices are not supported";
+                    return false;
+                }
+                if (property.name.size() == 1 && property.name[0] >= 'x' && property.name[0] <= 'z') {
+                    int axis = property.name[0] - 'x';
+                    offsets[axis] = offset;
+                    types[axis] = property.type;
+                    found |= 1 << axis;
+                }
+                offset += typeSize(property.type);
+            }
+            if (found != 7) {
+                error = "vertex element without x, y and z";
+                return false;
+            }
+            const char* next = skipElement<Swap>(p, end, element);
+            if (!next) {
+                error = "vertex data truncated";
+                return false;
+            }
+            decodeVertices<Swap>(p, element, offsets, types, numThreads, vertices);
+            p = next;
+        } else if (element.name == "face" && !haveFaces) {
+            haveFaces = true;
+            FaceLayout layout;
+            bool haveList = false;
+            for (size_t k = 0; k < element.properties.size(); ++k) {
+                const PLYProperty& property = element.properties[k];
+                if (!property.isList) {
+                    if (!haveList) layout.listOffset += typeSize(property.type);
+                    continue;
+                }
+                if (!haveList && (property.name == "vertex_indices" || property.name == "vertex_index")) {
+                    layout.listIndex = k;
+                    haveList = true;
+                } else {
+                    layout.otherLists = true;
+                }
+            }
+            if (!haveList || !isIntegerType(element.properties[layout.listIndex].type)) {
+                error = "face element without integer vertex_indices";
+                return false;
+            }
+
+            // Fast path: triangle records of one fixed size
+            const size_t triangleStride = triangleRecordSize(element, layout);
+            bool decoded = false;
+            if (!layout.otherLists && element.count <= static_cast<uint64_t>(end - p) / triangleStride) {
+                decoded = decodeTriangleFaces<Swap>(p, element, layout, numThreads, faces);
+                if (decoded) {
+                    p += element.count * triangleStride;
+                }
+            }
+            if (!decoded) {
+                p = walkFaces<Swap>(p, end, element, layout, faces, error);
+                if (!p) {
+                    return false;
+                }
+            }
+        } else {
+            p = skipElement<Swap>(p, end, element);
+            if (!p) {
+                error = "element '" + element.name + "' truncated";
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+bool Mesh::loadFromPLY(const std::string& filepath, int numThreads) {
+    MappedFile file;
+    if (!file.open(filepath)) {
+        std::cerr << "Error: Could not open PLY file: " << filepath << std::endl;
+        return false;
+    }
+    file.adviseSequential();
+    return loadFromPLYBuffer(file.data(), file.size(), numThreads);
+}
+
+bool Mesh::loadFromPLYBuffer(const char* buffer, size_t size, int numThreads) {
+    clear();
+
+    PLYHeader header;
+    std::string error;
+    bool ok = parseHeader(buffer, size, header, error);
+    if (ok) {
+        auto vertexElement = std::find_if(header.elements.begin(), header.elements.end(),
+                                          [](const PLYElement& e) { return e.name == "vertex"; });
+        if (vertexElement == header.elements.end()) {
+            error = "no vertex element";
+            ok = false;
+        } else if (vertexElement->count > static_cast<uint64_t>(std::numeric_limits<int>::max())) {
+            error = "too many vertices";
+            ok = false;
+        }
+    }
+    if (ok) {
+        const char* data = buffer + header.dataOffset;
+        const char* end = buffer + size;
+        const int threads = parallel::resolveThreadCount(numThreads);
+        switch (header.format) {
+            case PLYFormat::ASCII:
+                ok = readASCII(data, end, header, vertices, faces, error);
+                break;
+            case PLYFormat::BinaryLittleEndian:
+                ok = isLittleEndian() ? readBinary<false>(data, end, header, threads, vertices, faces, error)
+                                      : readBinary<true>(data, end, header, threads, vertices, faces, error);
+                break;
+            case PLYFormat::BinaryBigEndian:
+                ok = isLittleEndian() ? readBinary<true>(data, end, header, threads, vertices, faces, error)
+                                      : readBinary<false>(data, end, header, threads, vertices, faces, error);
+                break;
+        }
+    }
+    if (ok) {
+        const size_t vertexCount = vertices.size();
+        for (const Triangle& f : faces) {
+            if (static_cast<size_t>(f.v0) >= vertexCount || static_cast<size_t>(f.v1) >= vertexCount ||
+                static_cast<size_t>(f.v2) >= vertexCount) {
+                error = "face index out of range";
+                ok = false;
+                break;
+            }
+        }
+    }
+    if (!ok) {
+        std::cerr << "Error: Invalid PLY: " << error << std::endl;
+        clear();
+        return false;
+    }
+
+    std::cout << "Loaded PLY: " << vertices.size() << " vertices, "
+              << faces.size() << " triangles" << std::endl;
+    return true;
+}
+
+} // namespace madfam::geom
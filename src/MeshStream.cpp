@@ -0,0 +1,431 @@
+/**
+ * MeshStream.cpp - Bounded-memory streaming analysis of binary STL files
+ *
+ * The file is read in fixed windows of triangles. Volume and bounding box are
+ * accumulated directly. Each window is welded locally and emits its unique
+ * vertices and its unique edges (with use counts) into hash partitions. When
+ * the partitions cannot fit in the memory limit they are spilled to disk and
+ * reduced one partition at a time afterwards: distinct vertices give the
+ * welded vertex count, and the edge counts decide watertightness.
+ */
+
+#include "geom-core/Mesh.hpp"
+#include "geom-core/VertexWelder.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <memory>
+
+namespace madfam::geom {
+
+namespace {
+
+// Coordinates are compared by their float bit patterns (-0.0 folded to 0.0),
+// which is exactly the equality used by exact welding.
+struct VertexKey {
+    uint32_t bits[3];
+
+    bool operator<(const VertexKey& other) const {
+        if (bits[0] != other.bits[0]) return bits[0] < other.bits[0];
+        if (bits[1] != other.bits[1]) return bits[1] < other.bits[1];
+        return bits[2] < other.bits[2];
+    }
+    bool operator==(const VertexKey& other) const {
+        return bits[0] == other.bits[0] && bits[1] == other.bits[1] && bits[2] == other.bits[2];
+    }
+};
+
+struct EdgeRecord {
+    VertexKey a;  // a <= b
+    VertexKey b;
+    uint32_t count;
+};
+
+const size_t TRIANGLE_RECORD_BYTES = 50;
+
+// Rough per-window working set: raw records, local welder, edge list
+const size_t WINDOW_BYTES_PER_TRIANGLE = 200;
+
+// Each spill partition holds two files open and two write buffers
+const size_t MAX_SPILL_PARTITIONS = 256;
+const size_t SPILL_BUFFER_BYTES = 1u << 20;
+
+inline uint32_t floatKey(double value) {
+    float f = static_cast<float>(value) + 0.0f;
+    uint32_t bits;
+    std::memcpy(&bits, &f, sizeof(bits));
+    return bits;
+}
+
+inline VertexKey makeKey(const Vector3& v) {
+    return VertexKey{{floatKey(v.x), floatKey(v.y), floatKey(v.z)}};
+}
+
+inline uint64_t mix64(uint64_t h) {
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+inline uint64_t hashKey(const VertexKey& key) {
+    return mix64((static_cast<uint64_t>(key.bits[0]) << 32 | key.bits[1]) ^ mix64(key.bits[2]));
+}
+
+/**
+ * @brief Append-only record store, either in memory or spilled to a file
+ *
+ * In memory, records go straight into the vector readAll() hands out, sized
+ * up front so it never reallocates. Spilled, they are staged in a write
+ * buffer of bufferRecords and appended to the file.
+ */
+template<typename T>
+class Partition {
+public:
+    Partition() = default;
+    Partition(const Partition&) = delete;
+    Partition& operator=(const Partition&) = delete;
+
+    ~Partition() {
+        if (file) {
+            std::fclose(file);
+        }
+        if (!path.empty()) {
+            std::remove(path.c_str());
+        }
+    }
+
+    /**
+     * @brief Keep records in memory, with room for maxRecords
+     */
+    void reserve(size_t maxRecords) {
+        records.reserve(maxRecords);
+    }
+
+    /**
+     * @brief Back this partition with a file (tmpfile() if directory is empty)
+     */
+    bool openSpill(const std::string& directory, size_t index, size_t bufferRecords) {
+        if (directory.empty()) {
+            file = std::tmpfile();
+        } else {
+            path = directory + "/geom-core-spill-" +
+                   std::to_string(reinterpret_cast<uintptr_t>(this)) + "-" +
+                   std::to_string(index) + ".bin";
+            file = std::fopen(path.c_str(), "w+b");
+        }
+        flushRecords = std::max<size_t>(1, bufferRecords);
+        records.reserve(flushRecords);
+        return file != nullptr;
+    }
+
+    bool append(const T& record) {
+        records.push_back(record);
+        totalRecords++;
+        if (file && records.size() >= flushRecords) {
+            return flush();
+        }
+        return true;
+    }
+
+    /**
+     * @brief Move every record into out, releasing the write buffer
+     */
+    bool readAll(std::vector<T>& out) {
+        out.clear();
+        if (!file) {
+            out.swap(records);
+            return true;
+        }
+
+        if (!flush()) {
+            return false;
+        }
+        std::vector<T>().swap(records);
+
+        out.resize(totalRecords);
+        std::rewind(file);
+        return std::fread(out.data(), sizeof(T), out.size(), file) == out.size();
+    }
+
+private:
+    std::FILE* file = nullptr;
+    std::string path;
+    std::vector<T> records;
+    size_t flushRecords = 0;
+    size_t totalRecords = 0;
+
+    bool flush() {
+        if (!records.empty() &&
+            std::fwrite(records.data(), sizeof(T), records.size(), file) != records.size()) {
+            return false;
+        }
+        records.clear();
+        return true;
+    }
+};
+
+} // namespace
+
+bool Mesh::streamSTL(const std::string& filepath,
+                     const StreamingOptions& options,
+                     MeshSummary& summary) {
+    summary = MeshSummary();
+
+    std::ifstream file(filepath, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) {
+        std::cerr << "Error: Could not open STL file: " << filepath << std::endl;
+        return false;
+    }
+
+    const size_t fileSize = static_cast<size_t>(file.tellg());
+    file.seekg(0, std::ios::beg);
+
+    if (fileSize < 84) {
+        std::cerr << "Error: STL file too small (< 84 bytes)" << std::endl;
+        return false;
+    }
+
+    char header[84];
+    file.read(header, 84);
+
+    uint32_t triangleCount;
+    std::memcpy(&triangleCount, header + 80, 4);
+
+    size_t expectedSize = 84 + static_cast<size_t>(triangleCount) * TRIANGLE_RECORD_BYTES;
+    if (fileSize < expectedSize) {
+        std::cerr << "Error: STL file size mismatch. Expected at least " << expectedSize
+                  << " bytes, got " << fileSize << std::endl;
+        return false;
+    }
+
+    // ========================================
+    // Plan partitions from the memory budget
+    // ========================================
+
+    const size_t window = std::max<size_t>(1, std::min<size_t>(options.windowTriangles, triangleCount));
+    const size_t windowBytes = window * WINDOW_BYTES_PER_TRIANGLE;
+    if (options.memoryLimitBytes <= windowBytes) {
+        std::cerr << "Error: Memory limit " << options.memoryLimitBytes
+                  << " bytes is too small for a window of " << window << " triangles" << std::endl;
+        return false;
+    }
+    const size_t budget = options.memoryLimitBytes - windowBytes;
+
+    // Upper bounds (no sharing at all): 3 vertices and 3 edges per triangle
+    const size_t vertexBytesMax = static_cast<size_t>(triangleCount) * 3 * sizeof(VertexKey);
+    const size_t edgeBytesMax = static_cast<size_t>(triangleCount) * 3 * sizeof(EdgeRecord);
+
+    size_t partitionCount = 1;
+    bool spill = false;
+
+    if (vertexBytesMax + edgeBytesMax > budget) {
+        if (!options.allowSpill) {
+            std::cerr << "Error: Mesh tables exceed the memory limit and spilling is disabled" << std::endl;
+            return false;
+        }
+        // Half the budget reduces one partition (with 25% headroom for hash
+        // skew); the other half holds the 2 * partitionCount write buffers.
+        spill = true;
+        partitionCount = (edgeBytesMax + edgeBytesMax / 4) / std::max<size_t>(1, budget / 2) + 1;
+        if (partitionCount > MAX_SPILL_PARTITIONS) {
+            std::cerr << "Error: Memory limit " << options.memoryLimitBytes << " bytes would need "
+                      << partitionCount << " spill partitions for " << triangleCount
+                      << " triangles (at most " << MAX_SPILL_PARTITIONS << "); raise the limit" << std::endl;
+            return false;
+        }
+    }
+
+    // Buffers shrink below their preferred size rather than exceed the budget
+    const size_t flushBytes = spill ? std::min<size_t>(SPILL_BUFFER_BYTES, budget / (4 * partitionCount)) : 0;
+
+    std::vector<std::unique_ptr<Partition<VertexKey>>> vertexParts;
+    std::vector<std::unique_ptr<Partition<EdgeRecord>>> edgeParts;
+    for (size_t k = 0; k < partitionCount; ++k) {
+        vertexParts.push_back(std::make_unique<Partition<VertexKey>>());
+        edgeParts.push_back(std::make_unique<Partition<EdgeRecord>>());
+        if (!spill) {
+            vertexParts.back()->reserve(vertexBytesMax / sizeof(VertexKey));
+            edgeParts.back()->reserve(edgeBytesMax / sizeof(EdgeRecord));
+        } else if (!vertexParts.back()->openSpill(options.spillDirectory, 2 * k, flushBytes / sizeof(VertexKey)) ||
+                   !edgeParts.back()->openSpill(options.spillDirectory, 2 * k + 1, flushBytes / sizeof(EdgeRecord))) {
+            std::cerr << "Error: Could not create spill file in '"
+                      << options.spillDirectory << "'" << std::endl;
+            return false;
+        }
+    }
+
+    // ========================================
+    // Streaming pass over triangle windows
+    // ========================================
+
+    double volume = 0.0;
+    double minX = std::numeric_limits<double>::max();
+    double minY = std::numeric_limits<double>::max();
+    double minZ = std::numeric_limits<double>::max();
+    double maxX = std::numeric_limits<double>::lowest();
+    double maxY = std::numeric_limits<double>::lowest();
+    double maxZ = std::numeric_limits<double>::lowest();
+
+    std::vector<char> records(window * TRIANGLE_RECORD_BYTES);
+    std::vector<uint64_t> edges;
+    edges.reserve(window * 3);
+    VertexWelder welder(0.0, window / 2 + 3);
+
+    for (size_t first = 0; first < triangleCount; first += window) {
+        const size_t count = std::min<size_t>(window, triangleCount - first);
+        if (!file.read(records.data(), static_cast<std::streamsize>(count * TRIANGLE_RECORD_BYTES))) {
+            std::cerr << "Error: Unexpected end of STL file at triangle " << first << std::endl;
+            return false;
+        }
+
+        welder.clear();
+        edges.clear();
+
+        for (size_t i = 0; i < count; ++i) {
+            // Skip the 12-byte normal; 3 vertices follow (3 floats each)
+            float coords[9];
+            std::memcpy(coords, records.data() + i * TRIANGLE_RECORD_BYTES + 12, 36);
+
+            Vector3 p1(coords[0], coords[1], coords[2]);
+            Vector3 p2(coords[3], coords[4], coords[5]);
+            Vector3 p3(coords[6], coords[7], coords[8]);
+
+            // Same accumulation order as Mesh::getVolume()
+            volume += p1 * (p2 % p3);
+
+            for (const Vector3* p : {&p1, &p2, &p3}) {
+                minX = std::min(minX, p->x);
+                minY = std::min(minY, p->y);
+                minZ = std::min(minZ, p->z);
+                maxX = std::max(maxX, p->x);
+                maxY = std::max(maxY, p->y);
+                maxZ = std::max(maxZ, p->z);
+            }
+
+            uint64_t v[3] = {
+                static_cast<uint64_t>(welder.insert(p1)),
+                static_cast<uint64_t>(welder.insert(p2)),
+                static_cast<uint64_t>(welder.insert(p3))
+            };
+            for (int e = 0; e < 3; ++e) {
+                uint64_t a = v[e];
+                uint64_t b = v[(e + 1) % 3];
+                edges.push_back(a < b ? (a << 32 | b) : (b << 32 | a));
+            }
+        }
+
+        // Emit window-unique vertices
+        const auto& windowVertices = welder.getVertices();
+        std::vector<VertexKey> keys(windowVertices.size());
+        for (size_t i = 0; i < windowVertices.size(); ++i) {
+            keys[i] = makeKey(windowVertices[i]);
+            if (!vertexParts[hashKey(keys[i]) % partitionCount]->append(keys[i])) {
+                std::cerr << "Error: Failed to write spill file" << std::endl;
+                return false;
+            }
+        }
+
+        // Emit window-unique edges with their use counts
+        std::sort(edges.begin(), edges.end());
+        for (size_t i = 0; i < edges.size();) {
+            size_t j = i + 1;
+            while (j < edges.size() && edges[j] == edges[i]) ++j;
+
+            const VertexKey& ka = keys[edges[i] >> 32];
+            const VertexKey& kb = keys[edges[i] & 0xffffffffu];
+
+            EdgeRecord record;
+            record.a = (kb < ka) ? kb : ka;
+            record.b = (kb < ka) ? ka : kb;
+            record.count = static_cast<uint32_t>(j - i);
+
+            uint64_t h = mix64(hashKey(record.a) ^ (hashKey(record.b) * 0x9e3779b97f4a7c15ULL));
+            if (!edgeParts[h % partitionCount]->append(record)) {
+                std::cerr << "Error: Failed to write spill file" << std::endl;
+                return false;
+            }
+            i = j;
+        }
+    }
+
+    // ========================================
+    // Reduce partitions one at a time
+    // ========================================
+
+    size_t vertexCount = 0;
+    bool watertight = triangleCount > 0;
+
+    for (size_t k = 0; k < partitionCount; ++k) {
+        std::vector<VertexKey> keys;
+        if (!vertexParts[k]->readAll(keys)) {
+            std::cerr << "Error: Failed to read spill file" << std::endl;
+            return false;
+        }
+        vertexParts[k].reset();
+
+        std::sort(keys.begin(), keys.end());
+        vertexCount += std::unique(keys.begin(), keys.end()) - keys.begin();
+        std::vector<VertexKey>().swap(keys);
+
+        if (!watertight) {
+            edgeParts[k].reset();
+            continue;
+        }
+
+        std::vector<EdgeRecord> edgeRecords;
+        if (!edgeParts[k]->readAll(edgeRecords)) {
+            std::cerr << "Error: Failed to read spill file" << std::endl;
+            return false;
+        }
+        edgeParts[k].reset();
+
+        std::sort(edgeRecords.begin(), edgeRecords.end(),
+            [](const EdgeRecord& x, const EdgeRecord& y) {
+                if (!(x.a == y.a)) return x.a < y.a;
+                return x.b < y.b;
+            });
+
+        // Every edge must be shared by exactly 2 faces
+        for (size_t i = 0; i < edgeRecords.size() && watertight;) {
+            uint64_t uses = 0;
+            size_t j = i;
+            while (j < edgeRecords.size() &&
+                   edgeRecords[j].a == edgeRecords[i].a &&
+                   edgeRecords[j].b == edgeRecords[i].b) {
+                uses += edgeRecords[j].count;
+                ++j;
+            }
+            watertight = (uses == 2);
+            i = j;
+        }
+    }
+
+    summary.triangleCount = triangleCount;
+    summary.vertexCount = vertexCount;
+    summary.volume = std::abs(volume / 6.0);
+    summary.boundingBox = (triangleCount > 0)
+        ? Vector3(maxX - minX, maxY - minY, maxZ - minZ)
+        : Vector3(0, 0, 0);
+    summary.watertight = watertight;
+    summary.spillPartitions = spill ? partitionCount : 0;
+
+    std::cout << "Streamed STL: " << vertexCount << " vertices, "
+              << triangleCount << " triangles";
+    if (spill) {
+        std::cout << " (" << partitionCount << " spill partitions)";
+    }
+    std::cout << std::endl;
+
+    return true;
+}
+
+} // namespace madfam::geom
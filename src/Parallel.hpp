@@ -0,0 +1,110 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace madfam::geom::parallel {
+
+/**
+ * @brief Resolve a user-facing thread count knob
+ * @param requested Requested threads (<= 0 means "all hardware threads")
+ * @return Number of threads to use (always >= 1)
+ *
+ * WASM builds without pthreads cannot spawn threads and always get 1.
+ */
+inline int resolveThreadCount(int requested) {
+#if defined(__EMSCRIPTEN__) && !defined(__EMSCRIPTEN_PTHREADS__)
+    (void)requested;
+    return 1;
+#else
+    if (requested > 0) {
+        return requested;
+    }
+    unsigned int hw = std::thread::hardware_concurrency();
+    return hw > 0 ? static_cast<int>(hw) : 1;
+#endif
+}
+
+/**
+ * @brief Run fn(i) for every i in [0, count) on up to numThreads threads
+ *
+ * Work items are handed out dynamically, so uneven items balance out.
+ * The calling thread participates; with numThreads <= 1 (or a single item)
+ * everything runs inline on the caller. The first exception thrown by fn is
+ * rethrown on the calling thread after all workers have finished. Helper
+ * threads are started for each call and joined before it returns; there is
+ * no persistent pool.
+ */
+template<typename Func>
+void forEachIndex(size_t count, int numThreads, Func&& fn) {
+    if (count == 0) {
+        return;
+    }
+
+    size_t threads = std::min(static_cast<size_t>(std::max(numThreads, 1)), count);
+    if (threads == 1) {
+        for (size_t i = 0; i < count; ++i) {
+            fn(i);
+        }
+        return;
+    }
+
+    std::atomic<size_t> next{0};
+    std::exception_ptr error;
+    std::mutex errorMutex;
+
+    auto worker = [&]() {
+        try {
+            for (size_t i = next.fetch_add(1); i < count; i = next.fetch_add(1)) {
+                fn(i);
+            }
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(errorMutex);
+            if (!error) {
+                error = std::current_exception();
+            }
+            next.store(count);
+        }
+    };
+
+    std::vector<std::thread> pool;
+    pool.reserve(threads - 1);
+    for (size_t t = 1; t < threads; ++t) {
+        pool.emplace_back(worker);
+    }
+    worker();
+    for (auto& thread : pool) {
+        thread.join();
+    }
+
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+/**
+ * @brief Run fn(begin, end) over [0, count) split into contiguous blocks
+ *
+ * Blocks hold at least minBlock items, so tiny ranges stay on one thread.
+ */
+template<typename Func>
+void forEachBlock(size_t count, int numThreads, size_t minBlock, Func&& fn) {
+    if (count == 0) {
+        return;
+    }
+    size_t threads = static_cast<size_t>(std::max(numThreads, 1));
+    size_t blockSize = std::max(minBlock, (count + threads * 4 - 1) / (threads * 4));
+    size_t blocks = (count + blockSize - 1) / blockSize;
+
+    forEachIndex(blocks, numThreads, [&](size_t b) {
+        size_t begin = b * blockSize;
+        fn(begin, std::min(begin + blockSize, count));
+    });
+}
+
+} // namespace madfam::geom::parallel
@@ -0,0 +1,195 @@
+#include "Sha256.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+// x86 SHA extensions, selected at run time
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define GC_SHA256_SHANI 1
+#include <immintrin.h>
+#endif
+
+namespace madfam::geom {
+
+namespace {
+
+const uint32_t ROUND_CONSTANTS[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2};
+
+const uint32_t INITIAL_STATE[8] = {
+    0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19};
+
+inline uint32_t rotr(uint32_t value, int bits) {
+    return (value >> bits) | (value << (32 - bits));
+}
+
+inline uint32_t loadBE32(const uint8_t* p) {
+    return (uint32_t(p[0]) << 24) | (uint32_t(p[1]) << 16) | (uint32_t(p[2]) << 8) | uint32_t(p[3]);
+}
+
+#ifdef GC_SHA256_SHANI
+bool shaniSupported() {
+    static const bool supported = __builtin_cpu_supports("sha") && __builtin_cpu_supports("sse4.1");
+    return supported;
+}
+
+/**
+ * @brief Compress whole blocks with SHA-NI; two rounds per sha256rnds2
+ *
+ * The instructions keep the state as ABEF/CDGH halves and take the message
+ * schedule four words at a time; msg1/msg2 extend it for rounds 16-63.
+ */
+__attribute__((target("sha,sse4.1,ssse3")))
+void compressShani(uint32_t state[8], const uint8_t* data, size_t blocks) {
+    const __m128i byteSwap = _mm_set_epi64x(0x0c0d0e0f08090a0bll, 0x0405060700010203ll);
+    __m128i tmp = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(state)), 0xB1);
+    __m128i state1 = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(state + 4)), 0x1B);
+    __m128i state0 = _mm_alignr_epi8(tmp, state1, 8);  // ABEF
+    state1 = _mm_blend_epi16(state1, tmp, 0xF0);       // CDGH
+
+    for (; blocks > 0; --blocks, data += 64) {
+        const __m128i savedAbef = state0;
+        const __m128i savedCdgh = state1;
+        __m128i msg[4];
+        for (int i = 0; i < 4; ++i) {
+            msg[i] = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 16 * i)), byteSwap);
+        }
+        for (int group = 0; group < 16; ++group) {
+            const __m128i words = msg[group & 3];
+            __m128i rounds = _mm_add_epi32(
+                words, _mm_loadu_si128(reinterpret_cast<const __m128i*>(ROUND_CONSTANTS + 4 * group)));
+            state1 = _mm_sha256rnds2_epu32(state1, state0, rounds);
+            if (group >= 3 && group < 15) {
+                __m128i& next = msg[(group + 1) & 3];
+                next = _mm_add_epi32(next, _mm_alignr_epi8(words, msg[(group - 1) & 3], 4));
+                next = _mm_sha256msg2_epu32(next, words);
+            }
+            rounds = _mm_shuffle_epi32(rounds, 0x0E);
+            state0 = _mm_sha256rnds2_epu32(state0, state1, rounds);
+            if (group >= 1 && group < 13) {
+                __m128i& previous = msg[(group - 1) & 3];
+                previous = _mm_sha256msg1_epu32(previous, words);
+            }
+        }
+        state0 = _mm_add_epi32(state0, savedAbef);
+        state1 = _mm_add_epi32(state1, savedCdgh);
+    }
+
+    tmp = _mm_shuffle_epi32(state0, 0x1B);                 // FEBA
+    state1 = _mm_shuffle_epi32(state1, 0xB1);              // DCHG
+    state0 = _mm_blend_epi16(tmp, state1, 0xF0);           // DCBA
+    state1 = _mm_alignr_epi8(state1, tmp, 8);              // HGFE
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(state), state0);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(state + 4), state1);
+}
+#endif
+
+} // namespace
+
+Sha256::Sha256() {
+    std::memcpy(state, INITIAL_STATE, sizeof(state));
+}
+
+void Sha256::compress(const uint8_t* data, size_t blocks) {
+#ifdef GC_SHA256_SHANI
+    if (blocks > 0 && shaniSupported()) {
+        compressShani(state, data, blocks);
+        return;
+    }
+#endif
+    for (; blocks > 0; --blocks, data += 64) {
+        uint32_t w[64];
+        for (int i = 0; i < 16; ++i) {
+            w[i] = loadBE32(data + 4 * i);
+        }
+        for (int i = 16; i < 64; ++i) {
+            uint32_t s0 = rotr(w[i - 15], 7) ^ rotr(w[i - 15], 18) ^ (w[i - 15] >> 3);
+            uint32_t s1 = rotr(w[i - 2], 17) ^ rotr(w[i - 2], 19) ^ (w[i - 2] >> 10);
+            w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+        }
+
+        uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+        uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+        for (int i = 0; i < 64; ++i) {
+            uint32_t t1 = h + (rotr(e, 6) ^ rotr(e, 11) ^ rotr(e, 25)) + ((e & f) ^ (~e & g)) +
+                          ROUND_CONSTANTS[i] + w[i];
+            uint32_t t2 = (rotr(a, 2) ^ rotr(a, 13) ^ rotr(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+            h = g;
+            g = f;
+            f = e;
+            e = d + t1;
+            d = c;
+            c = b;
+            b = a;
+            a = t1 + t2;
+        }
+        state[0] += a; state[1] += b; state[2] += c; state[3] += d;
+        state[4] += e; state[5] += f; state[6] += g; state[7] += h;
+    }
+}
+
+void Sha256::update(const void* data, size_t size) {
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    messageBytes += size;
+
+    if (blockSize > 0) {
+        size_t take = std::min(size, sizeof(block) - blockSize);
+        std::memcpy(block + blockSize, bytes, take);
+        blockSize += take;
+        bytes += take;
+        size -= take;
+        if (blockSize < sizeof(block)) {
+            return;
+        }
+        compress(block, 1);
+        blockSize = 0;
+    }
+
+    // Whole blocks straight from the input, the rest buffered
+    compress(bytes, size / 64);
+    bytes += size / 64 * 64;
+    size %= 64;
+    std::memcpy(block, bytes, size);
+    blockSize = size;
+}
+
+Sha256::Digest Sha256::finish() {
+    const uint64_t messageBits = messageBytes * 8;
+    const uint8_t marker = 0x80;
+    const uint8_t zeros[64] = {};
+    update(&marker, 1);
+    update(zeros, (sizeof(block) + 56 - blockSize) % sizeof(block));
+    uint8_t length[8];
+    for (int i = 0; i < 8; ++i) {
+        length[i] = static_cast<uint8_t>(messageBits >> (56 - 8 * i));
+    }
+    update(length, sizeof(length));
+
+    Digest digest;
+    for (int i = 0; i < 8; ++i) {
+        digest[4 * i] = static_cast<uint8_t>(state[i] >> 24);
+        digest[4 * i + 1] = static_cast<uint8_t>(state[i] >> 16);
+        digest[4 * i + 2] = static_cast<uint8_t>(state[i] >> 8);
+        digest[4 * i + 3] = static_cast<uint8_t>(state[i]);
+    }
+    return digest;
+}
+
+std::string Sha256::hex(const Digest& digest) {
+    static const char digits[] = "0123456789abcdef";
+    std::string text(digest.size() * 2, '0');
+    for (size_t i = 0; i < digest.size(); ++i) {
+        text[2 * i] = digits[digest[i] >> 4];
+        text[2 * i + 1] = digits[digest[i] & 0xf];
+    }
+    return text;
+}
+
+} // namespace madfam::geom
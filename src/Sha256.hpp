@@ -0,0 +1,46 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace madfam::geom {
+
+/**
+ * @brief Incremental SHA-256 (FIPS 180-4)
+ *
+ * Used where a content digest must be collision resistant, such as cache
+ * keys that decide whether a stored result belongs to a source file.
+ */
+class Sha256 {
+public:
+    using Digest = std::array<uint8_t, 32>;
+
+    Sha256();
+
+    /**
+     * @brief Append size bytes to the message
+     */
+    void update(const void* data, size_t size);
+
+    /**
+     * @brief Pad the message and return its digest (the object is spent)
+     */
+    Digest finish();
+
+    /**
+     * @brief Lowercase hexadecimal form of a digest
+     */
+    static std::string hex(const Digest& digest);
+
+private:
+    uint32_t state[8];
+    uint8_t block[64];
+    size_t blockSize = 0;
+    uint64_t messageBytes = 0;
+
+    void compress(const uint8_t* data, size_t blocks);
+};
+
+} // namespace madfam::geom
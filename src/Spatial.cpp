@@ -1,10 +1,915 @@
 #include "geom-core/Spatial.hpp"
+#include "Parallel.hpp"
 #include <algorithm>
 #include <cmath>
 #include <iostream>
+#include <numeric>
 
 namespace madfam::geom {
 
+namespace {
+
+// Binned SAH: bins per axis and the cost of one traversal step relative
+// to one ray-triangle test (measured with bench_bvh; lower values give
+// deeper trees, no faster)
+const int SAH_BINS = 16;
+const double SAH_TRAVERSAL_COST = 4.0;
+
+double axisValue(const Vector3& v, int axis) {
+    return axis == 0 ? v.x : axis == 1 ? v.y : v.z;
+}
+
+// Ray prepared for repeated slab tests against BVHNode bounds
+struct RaySlabs {
+    double origin[3];
+    double invDirection[3];
+
+    explicit RaySlabs(const Ray& ray) {
+        const double direction[3] = {ray.direction.x, ray.direction.y, ray.direction.z};
+        origin[0] = ray.origin.x;
+        origin[1] = ray.origin.y;
+        origin[2] = ray.origin.z;
+        for (int i = 0; i < 3; ++i) {
+            // Near-parallel axes get a huge finite factor: the slab then
+            // spans everything or nothing, as in AABB::intersect, and a zero
+            // offset yields 0 rather than 0 * inf = NaN
+            invDirection[i] = std::abs(direction[i]) < 1e-8 ? std::numeric_limits<double>::max()
+                                                            : 1.0 / direction[i];
+        }
+    }
+
+    // Entry distance into node's box if it is entered before limit
+    bool intersect(const BVHNode& node, double limit, double& tEntry) const {
+        double tMin = 0.0;
+        double tMax = std::numeric_limits<double>::max();
+        for (int i = 0; i < 3; ++i) {
+            double t1 = (node.boundsMin[i] - origin[i]) * invDirection[i];
+            double t2 = (node.boundsMax[i] - origin[i]) * invDirection[i];
+            if (t1 > t2) std::swap(t1, t2);
+            tMin = std::max(tMin, t1);
+            tMax = std::min(tMax, t2);
+        }
+        tEntry = tMin;
+        return tMin <= tMax && tMin <= limit;
+    }
+};
+
+
+// Parallel build: ranges this large are bounded, binned and partitioned by
+// several threads in blocks, and subtrees this large become separate tasks
+const size_t PARALLEL_PASS_MIN = 1 << 16;
+const size_t PARALLEL_TASK_MIN = 1 << 12;
+const size_t PARALLEL_BLOCK = 1 << 14;
+
+struct RangeBounds {
+    AABB bounds;     // Union of the triangles' boxes
+    AABB centroids;  // Box around the triangles' centroids
+};
+
+struct Bin {
+    AABB bounds;
+    size_t count = 0;
+
+    void merge(const Bin& other) {
+        // Empty bins hold an inverted box that expand() cannot merge
+        if (other.count > 0) {
+            bounds.expand(other.bounds);
+            count += other.count;
+        }
+    }
+};
+
+struct SAHSplit {
+    int axis = -1;   // -1: all centroids coincide
+    int bin = 0;     // Last bin of the first child
+    double lo = 0.0;
+    double scale = 0.0;
+    double cost = std::numeric_limits<double>::max();
+
+    int binOf(const Vector3& centroid) const {
+        return std::min(static_cast<int>((axisValue(centroid, axis) - lo) * scale), SAH_BINS - 1);
+    }
+};
+
+// Append a subtree built into its own array (child offsets relative to it)
+void appendSubtree(std::vector<BVHNode>& out, const std::vector<BVHNode>& subtree) {
+    const uint32_t base = static_cast<uint32_t>(out.size());
+    out.insert(out.end(), subtree.begin(), subtree.end());
+    for (size_t i = base; i < out.size(); ++i) {
+        if (!out[i].isLeaf()) {
+            out[i].offset += base;
+        }
+    }
+}
+
+// Query batches smaller than this run as given; sorted batches run in
+// blocks of BATCH_BLOCK consecutive queries per task
+const size_t BATCH_SORT_MIN = 256;
+const size_t BATCH_BLOCK = 1 << 10;
+
+// A batch whose consecutive queries change ray octant or coarse cell (key
+// bits above COHERENT_SHIFT: 32 cells per axis) less than once every
+// COHERENT_RUN queries is already coherent, e.g. queries from a mesh's
+// vertices in order, and runs as given: sorting it measured slower
+const int COHERENT_SHIFT = 12;
+const size_t COHERENT_RUN = 4;
+
+// Batch keys grid each axis into 512 cells (27-bit Morton codes), leaving
+// room for the ray octant
+const int BATCH_MORTON_BITS = 9;
+
+// Spread the low 10 bits of x two bits apart
+uint32_t spreadBits(uint32_t x) {
+    x &= 0x3ff;
+    x = (x | x << 16) & 0x30000ff;
+    x = (x | x << 8) & 0x300f00f;
+    x = (x | x << 4) & 0x30c30c3;
+    x = (x | x << 2) & 0x9249249;
+    return x;
+}
+
+// Morton code (3 * bits wide) of point's cell in a grid of 2^bits cells
+// per axis over box; bits is at most 10
+uint32_t mortonCode(const Vector3& point, const AABB& box, int bits) {
+    const double p[3] = {point.x, point.y, point.z};
+    const double lo[3] = {box.min.x, box.min.y, box.min.z};
+    const double hi[3] = {box.max.x, box.max.y, box.max.z};
+    const uint32_t lastCell = (1u << bits) - 1;
+    uint32_t code = 0;
+    for (int a = 0; a < 3; ++a) {
+        const double extent = hi[a] - lo[a];
+        const double cell = extent > 0.0 ? (p[a] - lo[a]) * ((lastCell + 1.0) / extent) : 0.0;
+        // Written so NaN coordinates land in cell 0
+        const uint32_t q = cell >= lastCell ? lastCell : cell > 0.0 ? static_cast<uint32_t>(cell) : 0u;
+        code |= spreadBits(q) << a;
+    }
+    return code;
+}
+
+// Direction octant above the Morton code of the origin
+uint32_t rayOrderKey(const Ray& ray, const AABB& box) {
+    const uint32_t octant = static_cast<uint32_t>(ray.direction.x < 0.0) |
+                            static_cast<uint32_t>(ray.direction.y < 0.0) << 1 |
+                            static_cast<uint32_t>(ray.direction.z < 0.0) << 2;
+    return octant << 27 | mortonCode(ray.origin, box, BATCH_MORTON_BITS);
+}
+
+// LSD radix sort by bits [32, 62), a 30-bit key above a 32-bit index.
+// Large arrays are counted and scattered in blocks on several threads;
+// digits are placed block by block, so the result is the serial one
+void sortByKey(std::vector<uint64_t>& values, int threads) {
+    const int RADIX_BITS = 10;
+    const size_t RADIX = size_t(1) << RADIX_BITS;
+    const size_t count = values.size();
+    const size_t blocks = threads > 1 && count >= PARALLEL_PASS_MIN
+        ? std::min(static_cast<size_t>(threads) * 4, (count + PARALLEL_BLOCK - 1) / PARALLEL_BLOCK)
+        : 1;
+    const size_t blockSize = (count + blocks - 1) / blocks;
+    std::vector<uint64_t> scratch(count);
+    std::vector<size_t> offsets(blocks * RADIX);
+    for (int shift = 32; shift < 62; shift += RADIX_BITS) {
+        std::fill(offsets.begin(), offsets.end(), size_t(0));
+        parallel::forEachIndex(blocks, threads, [&](size_t b) {
+            size_t* counts = &offsets[b * RADIX];
+            const size_t last = std::min(count, (b + 1) * blockSize);
+            for (size_t i = b * blockSize; i < last; ++i) {
+                counts[(values[i] >> shift) & (RADIX - 1)]++;
+            }
+        });
+        size_t sum = 0;
+        for (size_t digit = 0; digit < RADIX; ++digit) {
+            for (size_t b = 0; b < blocks; ++b) {
+                const size_t digitCount = offsets[b * RADIX + digit];
+                offsets[b * RADIX + digit] = sum;
+                sum += digitCount;
+            }
+        }
+        parallel::forEachIndex(blocks, threads, [&](size_t b) {
+            size_t* next = &offsets[b * RADIX];
+            const size_t last = std::min(count, (b + 1) * blockSize);
+            for (size_t i = b * blockSize; i < last; ++i) {
+                scratch[next[(values[i] >> shift) & (RADIX - 1)]++] = values[i];
+            }
+        });
+        values.swap(scratch);
+    }
+}
+
+/**
+ * Run query(i) for every i in [0, count) on threads, in order of the
+ * 30-bit key(i) so consecutive queries touch the same nodes and triangles.
+ * Small and already coherent batches run in the given order.
+ */
+template<typename Key, typename Query>
+void runOrderedBatch(size_t count, int threads, Key&& key, Query&& query) {
+    auto runAsGiven = [&]() {
+        parallel::forEachBlock(count, threads, BATCH_BLOCK, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                query(i);
+            }
+        });
+    };
+    if (count < BATCH_SORT_MIN || count > std::numeric_limits<uint32_t>::max()) {
+        runAsGiven();
+        return;
+    }
+
+    // Key above each query's index; sorting the pairs gives the order
+    std::vector<uint64_t> order(count);
+    parallel::forEachBlock(count, threads, PARALLEL_BLOCK, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            order[i] = static_cast<uint64_t>(key(i)) << 32 | i;
+        }
+    });
+    size_t cellChanges = 0;
+    for (size_t i = 1; i < count; ++i) {
+        cellChanges += (order[i] >> (32 + COHERENT_SHIFT)) != (order[i - 1] >> (32 + COHERENT_SHIFT));
+    }
+    if (cellChanges * COHERENT_RUN < count) {
+        runAsGiven();
+        return;
+    }
+    sortByKey(order, threads);
+
+    parallel::forEachBlock(count, threads, BATCH_BLOCK, [&](size_t begin, size_t end) {
+        for (size_t k = begin; k < end; ++k) {
+            query(static_cast<uint32_t>(order[k]));
+        }
+    });
+}
+
+// Squared distance from p to node's box (0 inside); never more than the
+// distance to anything in the box, as the float bounds are rounded outward
+double boxDistanceSquared(const BVHNode& node, const double p[3]) {
+    double sum = 0.0;
+    for (int a = 0; a < 3; ++a) {
+        const double d = std::max({node.boundsMin[a] - p[a], 0.0, p[a] - node.boundsMax[a]});
+        sum += d * d;
+    }
+    return sum;
+}
+
+// Closest point to p on segment [a, b]
+Vector3 closestPointOnSegment(const Vector3& p, const Vector3& a, const Vector3& b) {
+    const Vector3 ab = b - a;
+    const double lengthSquared = ab * ab;
+    if (!(lengthSquared > 0.0)) {
+        return a;
+    }
+    const double t = std::min(std::max(((p - a) * ab) / lengthSquared, 0.0), 1.0);
+    return a + ab * t;
+}
+
+// Linear builder: centroid Morton codes use 10 bits per axis (the sort key
+// width); triangles in one cell are ordered by index, and such clusters
+// are smaller than a leaf on meshes far beyond a billion triangles
+const int LINEAR_MORTON_BITS = 10;
+
+// Linear builder: child references with this bit set are single triangles
+// (their Morton-order position); others are radix tree nodes
+const uint32_t LINEAR_TRIANGLE = 0x80000000u;
+
+// Treelet re-optimization: leaves per treelet, whose best topology is found
+// by dynamic programming over all their subsets (Karras and Aila 2013);
+// 5 gives trees as fast as the paper's 7 at a third of the cost (bench_bvh)
+const int TREELET_LEAVES = 5;
+
+// Radix tree node of the linear builder
+struct LinearNode {
+    uint32_t children[2];
+    uint32_t first;   // Leaf ranges: first Morton-order position
+    uint32_t count;   // Triangles below
+    bool leaf;        // At most maxLeafTriangles, contiguous from first
+};
+
+// Number of leading zero bits of a nonzero value
+int leadingZeros(uint64_t value) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_clzll(value);
+#else
+    int zeros = 0;
+    for (uint64_t bit = uint64_t(1) << 63; !(value & bit); bit >>= 1) {
+        ++zeros;
+    }
+    return zeros;
+#endif
+}
+
+/**
+ * Builds the nodes of one AABBTree. Nodes are written in depth-first order
+ * into the vector passed down; with threads > 1 the second child of a large
+ * node is built concurrently into its own vector and appended once the
+ * first child is done. Reductions are exact (min/max and counts) and
+ * partitions are stable, so every thread count yields the same tree.
+ */
+class TreeBuilder {
+public:
+    TreeBuilder(Span<const Vector3> vertices, Span<const Triangle> faces, std::vector<int>& order,
+                uint32_t maxLeafTriangles, int threads)
+        : order(order), scratch(faces.size()), centroids(faces.size()), triangleBounds(faces.size()),
+          maxLeafTriangles(maxLeafTriangles) {
+        parallel::forEachBlock(faces.size(), threads, PARALLEL_BLOCK, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                const Triangle& tri = faces[i];
+                order[i] = static_cast<int>(i);
+                centroids[i] = (vertices[tri.v0] + vertices[tri.v1] + vertices[tri.v2]) * (1.0 / 3.0);
+                triangleBounds[i].expand(vertices[tri.v0]);
+                triangleBounds[i].expand(vertices[tri.v1]);
+                triangleBounds[i].expand(vertices[tri.v2]);
+            }
+        });
+    }
+
+    /**
+     * @brief Median split along the longest axis; returns the node's index in out
+     */
+    uint32_t buildMedian(size_t begin, size_t end, int depth, std::vector<BVHNode>& out, int threads);
+
+    /**
+     * @brief Binned SAH split; returns the node's index in out
+     */
+    uint32_t buildSAH(size_t begin, size_t end, int depth, std::vector<BVHNode>& out, int threads);
+
+    /**
+     * @brief Linear BVH over all triangles; returns the root's index in out
+     */
+    uint32_t buildLinear(int treeletPasses, std::vector<BVHNode>& out, int threads);
+
+private:
+    std::vector<int>& order;
+    std::vector<int> scratch;
+    std::vector<Vector3> centroids;
+    std::vector<AABB> triangleBounds;
+    uint32_t maxLeafTriangles;
+
+    // Linear builder: radix tree, with box and SAH cost per node while
+    // treelets are optimized; scratch holds the Morton order
+    std::vector<LinearNode> linear;
+    std::vector<AABB> linearBounds;
+    std::vector<double> linearCost;
+
+    struct Treelet {
+        uint32_t leaves[TREELET_LEAVES];
+        uint32_t internals[TREELET_LEAVES - 1];   // Root first
+        int leafCount;
+        AABB bounds[1 << TREELET_LEAVES];          // Per subset of the leaves
+        double cost[1 << TREELET_LEAVES];
+        uint8_t split[1 << TREELET_LEAVES];        // Leaves under a subset's first child
+    };
+
+    static size_t blockCount(size_t count, int threads) {
+        return threads > 1 && count >= PARALLEL_PASS_MIN ? (count + PARALLEL_BLOCK - 1) / PARALLEL_BLOCK : 1;
+    }
+
+    RangeBounds rangeBounds(size_t begin, size_t end, int threads) const;
+
+    uint32_t linearCount(uint32_t ref) const {
+        return ref & LINEAR_TRIANGLE ? 1 : linear[ref].count;
+    }
+    AABB linearBoundsOf(uint32_t ref) const {
+        return ref & LINEAR_TRIANGLE ? triangleBounds[scratch[ref & ~LINEAR_TRIANGLE]] : linearBounds[ref];
+    }
+    double linearCostOf(uint32_t ref) const {
+        return ref & LINEAR_TRIANGLE ? triangleBounds[scratch[ref & ~LINEAR_TRIANGLE]].surfaceArea()
+                                     : linearCost[ref];
+    }
+
+    void buildRadixTree(const std::vector<uint64_t>& keys, int threads);
+    void optimizeTreelets(uint32_t ref, int threads);
+    void restructureTreelet(uint32_t root);
+    void assignTreelet(const Treelet& treelet, int subset, uint32_t id, int& nextInternal);
+    void gatherLinear(uint32_t ref, size_t& next);
+    uint32_t emitLinear(uint32_t ref, size_t begin, int depth, std::vector<BVHNode>& out, int threads);
+    SAHSplit findSplit(size_t begin, size_t end, const AABB& centroidBounds, int threads) const;
+    size_t partition(size_t begin, size_t end, const SAHSplit& split, int threads);
+
+    /**
+     * @brief Build both children of [begin, end) split at mid; returns the second child's index
+     */
+    template<typename Build>
+    uint32_t buildChildren(size_t begin, size_t mid, size_t end, std::vector<BVHNode>& out, int threads,
+                           Build&& build) {
+        if (threads > 1 && end - begin >= PARALLEL_TASK_MIN) {
+            std::vector<BVHNode> second;
+            const int firstThreads = (threads + 1) / 2;
+            parallel::forEachIndex(2, 2, [&](size_t child) {
+                if (child == 0) {
+                    build(begin, mid, out, firstThreads);
+                } else {
+                    build(mid, end, second, threads - firstThreads);
+                }
+            });
+            const uint32_t index = static_cast<uint32_t>(out.size());
+            appendSubtree(out, second);
+            return index;
+        }
+        build(begin, mid, out, 1);
+        return build(mid, end, out, 1);
+    }
+};
+
+RangeBounds TreeBuilder::rangeBounds(size_t begin, size_t end, int threads) const {
+    const size_t blocks = blockCount(end - begin, threads);
+    std::vector<RangeBounds> partial(blocks);
+    parallel::forEachIndex(blocks, threads, [&](size_t b) {
+        const size_t first = begin + b * PARALLEL_BLOCK;
+        const size_t last = blocks == 1 ? end : std::min(first + PARALLEL_BLOCK, end);
+        RangeBounds& range = partial[b];
+        for (size_t i = first; i < last; ++i) {
+            range.bounds.expand(triangleBounds[order[i]]);
+            range.centroids.expand(centroids[order[i]]);
+        }
+    });
+    for (size_t b = 1; b < blocks; ++b) {
+        partial[0].bounds.expand(partial[b].bounds);
+        partial[0].centroids.expand(partial[b].centroids);
+    }
+    return partial[0];
+}
+
+SAHSplit TreeBuilder::findSplit(size_t begin, size_t end, const AABB& centroidBounds, int threads) const {
+    double lo[3], scale[3];
+    for (int axis = 0; axis < 3; ++axis) {
+        lo[axis] = axisValue(centroidBounds.min, axis);
+        const double extent = axisValue(centroidBounds.max, axis) - lo[axis];
+        scale[axis] = extent > 0.0 ? SAH_BINS / extent : 0.0;
+    }
+
+    // Bin centroids along all three axes in one pass over the range
+    struct BinGrid {
+        Bin bins[3][SAH_BINS];
+    };
+    const size_t blocks = blockCount(end - begin, threads);
+    std::vector<BinGrid> grids(blocks);
+    parallel::forEachIndex(blocks, threads, [&](size_t b) {
+        const size_t first = begin + b * PARALLEL_BLOCK;
+        const size_t last = blocks == 1 ? end : std::min(first + PARALLEL_BLOCK, end);
+        BinGrid& grid = grids[b];
+        for (size_t i = first; i < last; ++i) {
+            const int tri = order[i];
+            for (int axis = 0; axis < 3; ++axis) {
+                if (scale[axis] > 0.0) {
+                    int bin = std::min(static_cast<int>((axisValue(centroids[tri], axis) - lo[axis]) * scale[axis]),
+                                       SAH_BINS - 1);
+                    grid.bins[axis][bin].count++;
+                    grid.bins[axis][bin].bounds.expand(triangleBounds[tri]);
+                }
+            }
+        }
+    });
+    for (size_t b = 1; b < blocks; ++b) {
+        for (int axis = 0; axis < 3; ++axis) {
+            for (int bin = 0; bin < SAH_BINS; ++bin) {
+                grids[0].bins[axis][bin].merge(grids[b].bins[axis][bin]);
+            }
+        }
+    }
+
+    // Sweep the bin boundaries for the split with the lowest sum of
+    // (child surface area * triangle count)
+    SAHSplit best;
+    for (int axis = 0; axis < 3; ++axis) {
+        if (!(scale[axis] > 0.0)) {
+            continue;
+        }
+        const Bin* bins = grids[0].bins[axis];
+
+        // rightCost[b]: cost of everything in bins (b, SAH_BINS)
+        double rightCost[SAH_BINS - 1];
+        Bin right;
+        for (int b = SAH_BINS - 1; b > 0; --b) {
+            right.merge(bins[b]);
+            rightCost[b - 1] = right.count > 0 ? right.bounds.surfaceArea() * right.count : -1.0;
+        }
+
+        Bin left;
+        for (int b = 0; b < SAH_BINS - 1; ++b) {
+            left.merge(bins[b]);
+            if (left.count == 0 || rightCost[b] < 0.0) {
+                continue;
+            }
+            double cost = left.bounds.surfaceArea() * left.count + rightCost[b];
+            if (cost < best.cost) {
+                best.cost = cost;
+                best.axis = axis;
+                best.bin = b;
+                best.lo = lo[axis];
+                best.scale = scale[axis];
+            }
+        }
+    }
+    return best;
+}
+
+size_t TreeBuilder::partition(size_t begin, size_t end, const SAHSplit& split, int threads) {
+    const size_t blocks = blockCount(end - begin, threads);
+    if (blocks == 1) {
+        // Stable: first child's triangles compacted in place, the rest via scratch
+        size_t first = begin;
+        size_t second = begin;
+        for (size_t i = begin; i < end; ++i) {
+            const int tri = order[i];
+            if (split.binOf(centroids[tri]) <= split.bin) {
+                order[first++] = tri;
+            } else {
+                scratch[second++] = tri;
+            }
+        }
+        std::copy(scratch.begin() + begin, scratch.begin() + second, order.begin() + first);
+        return first;
+    }
+
+    // Count per block, then scatter each block to its place in scratch
+    std::vector<size_t> firstCounts(blocks, 0);
+    parallel::forEachIndex(blocks, threads, [&](size_t b) {
+        const size_t last = std::min(begin + (b + 1) * PARALLEL_BLOCK, end);
+        for (size_t i = begin + b * PARALLEL_BLOCK; i < last; ++i) {
+            firstCounts[b] += split.binOf(centroids[order[i]]) <= split.bin;
+        }
+    });
+    const size_t firstTotal = std::accumulate(firstCounts.begin(), firstCounts.end(), size_t(0));
+    std::vector<size_t> firstStart(blocks), secondStart(blocks);
+    for (size_t b = 0, firstSum = 0, secondSum = 0; b < blocks; ++b) {
+        firstStart[b] = begin + firstSum;
+        secondStart[b] = begin + firstTotal + secondSum;
+        const size_t blockSize = std::min(begin + (b + 1) * PARALLEL_BLOCK, end) - (begin + b * PARALLEL_BLOCK);
+        firstSum += firstCounts[b];
+        secondSum += blockSize - firstCounts[b];
+    }
+    parallel::forEachIndex(blocks, threads, [&](size_t b) {
+        const size_t last = std::min(begin + (b + 1) * PARALLEL_BLOCK, end);
+        size_t first = firstStart[b];
+        size_t second = secondStart[b];
+        for (size_t i = begin + b * PARALLEL_BLOCK; i < last; ++i) {
+            const int tri = order[i];
+            scratch[split.binOf(centroids[tri]) <= split.bin ? first++ : second++] = tri;
+        }
+    });
+    parallel::forEachIndex(blocks, threads, [&](size_t b) {
+        const size_t first = begin + b * PARALLEL_BLOCK;
+        const size_t last = std::min(first + PARALLEL_BLOCK, end);
+        std::copy(scratch.begin() + first, scratch.begin() + last, order.begin() + first);
+    });
+    return begin + firstTotal;
+}
+
+uint32_t TreeBuilder::buildMedian(size_t begin, size_t end, int depth, std::vector<BVHNode>& out, int threads) {
+    const uint32_t index = static_cast<uint32_t>(out.size());
+    out.emplace_back();
+
+    // Compute bounds for this node
+    const AABB bounds = rangeBounds(begin, end, threads).bounds;
+    BVHNode node;
+    node.setBounds(bounds);
+    node.offset = static_cast<uint32_t>(begin);
+    node.triangleCount = 0;
+
+    // Leaf condition: few triangles or max depth
+    const int MAX_DEPTH = 32;
+
+    if (end - begin <= maxLeafTriangles || depth >= MAX_DEPTH) {
+        // Create leaf
+        node.triangleCount = static_cast<uint32_t>(end - begin);
+        out[index] = node;
+        return index;
+    }
+
+    // Choose split axis (longest axis)
+    Vector3 extent = bounds.max - bounds.min;
+    int axis = 0;
+    if (extent.y > extent.x) axis = 1;
+    if (extent.z > extent.x && extent.z > extent.y) axis = 2;
+
+    // Sort triangles by centroid along axis
+    std::sort(order.begin() + begin, order.begin() + end,
+        [this, axis](int a, int b) {
+            return axisValue(centroids[a], axis) < axisValue(centroids[b], axis);
+        });
+
+    // Split in half
+    size_t mid = begin + (end - begin) / 2;
+
+    // Build children (out may reallocate, so fill in last); the first
+    // child lands at index + 1
+    node.offset = buildChildren(begin, mid, end, out, threads,
+        [this, depth](size_t b, size_t e, std::vector<BVHNode>& o, int t) {
+            return buildMedian(b, e, depth + 1, o, t);
+        });
+    out[index] = node;
+
+    return index;
+}
+
+uint32_t TreeBuilder::buildSAH(size_t begin, size_t end, int depth, std::vector<BVHNode>& out, int threads) {
+    const uint32_t index = static_cast<uint32_t>(out.size());
+    out.emplace_back();
+
+    const RangeBounds range = rangeBounds(begin, end, threads);
+    BVHNode node;
+    node.setBounds(range.bounds);
+    node.offset = static_cast<uint32_t>(begin);
+    node.triangleCount = static_cast<uint32_t>(end - begin);
+
+    // SAH trees can be unbalanced, so the depth cap is looser than the median builder's
+    const size_t count = end - begin;
+    if (count == 1 || depth >= AABBTree::MAX_DEPTH) {
+        out[index] = node;
+        return index;
+    }
+
+    const SAHSplit split = findSplit(begin, end, range.centroids, threads);
+    size_t mid;
+    if (split.axis < 0) {
+        // All centroids coincide: no spatial split exists
+        if (count <= maxLeafTriangles) {
+            out[index] = node;
+            return index;
+        }
+        mid = begin + count / 2;
+    } else {
+        // Leaf cost is one intersection test per triangle
+        const double area = range.bounds.surfaceArea();
+        const double splitCost = area > 0.0 ? SAH_TRAVERSAL_COST + split.cost / area
+                                            : static_cast<double>(count);
+        if (count <= maxLeafTriangles && splitCost >= static_cast<double>(count)) {
+            out[index] = node;
+            return index;
+        }
+        mid = partition(begin, end, split, threads);
+    }
+
+    // Build children (out may reallocate, so fill in last); the first
+    // child lands at index + 1
+    node.triangleCount = 0;
+    node.offset = buildChildren(begin, mid, end, out, threads,
+        [this, depth](size_t b, size_t e, std::vector<BVHNode>& o, int t) {
+            return buildSAH(b, e, depth + 1, o, t);
+        });
+    out[index] = node;
+
+    return index;
+}
+
+uint32_t TreeBuilder::buildLinear(int treeletPasses, std::vector<BVHNode>& out, int threads) {
+    const size_t count = centroids.size();
+
+    // Morton code of each centroid above the triangle's index, so every key
+    // is unique and equal codes are ordered by index
+    const AABB centroidBounds = rangeBounds(0, count, threads).centroids;
+    std::vector<uint64_t> keys(count);
+    parallel::forEachBlock(count, threads, PARALLEL_BLOCK, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            keys[i] = static_cast<uint64_t>(mortonCode(centroids[i], centroidBounds, LINEAR_MORTON_BITS)) << 32 | i;
+        }
+    });
+    sortByKey(keys, threads);
+    for (size_t i = 0; i < count; ++i) {
+        scratch[i] = static_cast<int>(static_cast<uint32_t>(keys[i]));
+    }
+
+    if (count == 1) {
+        return emitLinear(LINEAR_TRIANGLE, 0, 0, out, threads);
+    }
+    buildRadixTree(keys, threads);
+    keys = std::vector<uint64_t>();
+
+    if (treeletPasses > 0) {
+        linearBounds.resize(linear.size());
+        linearCost.resize(linear.size());
+        for (int pass = 0; pass < treeletPasses; ++pass) {
+            optimizeTreelets(0, threads);
+        }
+        linearBounds = std::vector<AABB>();
+        linearCost = std::vector<double>();
+    }
+    return emitLinear(0, 0, 0, out, threads);
+}
+
+void TreeBuilder::buildRadixTree(const std::vector<uint64_t>& keys, int threads) {
+    // Karras 2012: each of the n - 1 nodes is found independently from the
+    // sorted keys. Node i covers a range ending at position i, extending
+    // towards the neighbour that shares the longer key prefix, and splits
+    // where the range's common prefix ends
+    const int64_t n = static_cast<int64_t>(keys.size());
+    linear.resize(keys.size() - 1);
+    auto prefix = [&](int64_t i, int64_t j) {
+        return j < 0 || j >= n ? -1 : leadingZeros(keys[i] ^ keys[j]);
+    };
+    parallel::forEachBlock(linear.size(), threads, PARALLEL_BLOCK, [&](size_t begin, size_t end) {
+        for (int64_t i = static_cast<int64_t>(begin); i < static_cast<int64_t>(end); ++i) {
+            const int64_t direction = prefix(i, i + 1) > prefix(i, i - 1) ? 1 : -1;
+            const int minPrefix = prefix(i, i - direction);
+
+            // Range length: exponential, then binary search
+            int64_t maxLength = 2;
+            while (prefix(i, i + maxLength * direction) > minPrefix) {
+                maxLength *= 2;
+            }
+            int64_t length = 0;
+            for (int64_t step = maxLength / 2; step >= 1; step /= 2) {
+                if (prefix(i, i + (length + step) * direction) > minPrefix) {
+                    length += step;
+                }
+            }
+            const int64_t j = i + length * direction;
+
+            // Split: the last position still sharing the range's prefix with i
+            const int nodePrefix = prefix(i, j);
+            int64_t split = 0;
+            for (int64_t divisor = 2;; divisor *= 2) {
+                const int64_t step = (length + divisor - 1) / divisor;
+                if (prefix(i, i + (split + step) * direction) > nodePrefix) {
+                    split += step;
+                }
+                if (step == 1) {
+                    break;
+                }
+            }
+            const int64_t gamma = i + split * direction + std::min<int64_t>(direction, 0);
+
+            LinearNode& node = linear[i];
+            node.first = static_cast<uint32_t>(std::min(i, j));
+            node.count = static_cast<uint32_t>(std::abs(j - i) + 1);
+            node.leaf = node.count <= maxLeafTriangles;
+            node.children[0] = static_cast<uint32_t>(gamma) | (node.first == gamma ? LINEAR_TRIANGLE : 0);
+            node.children[1] = static_cast<uint32_t>(gamma + 1) |
+                               (std::max(i, j) == gamma + 1 ? LINEAR_TRIANGLE : 0);
+        }
+    });
+}
+
+void TreeBuilder::optimizeTreelets(uint32_t ref, int threads) {
+    if (ref & LINEAR_TRIANGLE) {
+        return;
+    }
+    LinearNode& node = linear[ref];
+    if (node.leaf) {
+        AABB bounds;
+        for (uint32_t i = node.first; i < node.first + node.count; ++i) {
+            bounds.expand(triangleBounds[scratch[i]]);
+        }
+        linearBounds[ref] = bounds;
+        linearCost[ref] = bounds.surfaceArea() * node.count;
+        return;
+    }
+
+    // Children first, so each treelet is formed from optimized subtrees
+    if (threads > 1 && node.count >= PARALLEL_TASK_MIN) {
+        const int firstThreads = (threads + 1) / 2;
+        parallel::forEachIndex(2, 2, [&](size_t child) {
+            optimizeTreelets(node.children[child], child == 0 ? firstThreads : threads - firstThreads);
+        });
+    } else {
+        optimizeTreelets(node.children[0], 1);
+        optimizeTreelets(node.children[1], 1);
+    }
+    AABB bounds = linearBoundsOf(node.children[0]);
+    bounds.expand(linearBoundsOf(node.children[1]));
+    linearBounds[ref] = bounds;
+    linearCost[ref] = SAH_TRAVERSAL_COST * bounds.surfaceArea() +
+                      linearCostOf(node.children[0]) + linearCostOf(node.children[1]);
+    restructureTreelet(ref);
+}
+
+void TreeBuilder::restructureTreelet(uint32_t root) {
+    // Grow the treelet by opening its largest-area node until it has
+    // TREELET_LEAVES leaves (triangles and leaf ranges stay closed)
+    Treelet treelet;
+    treelet.leaves[0] = linear[root].children[0];
+    treelet.leaves[1] = linear[root].children[1];
+    treelet.internals[0] = root;
+    treelet.leafCount = 2;
+    while (treelet.leafCount < TREELET_LEAVES) {
+        int largest = -1;
+        double largestArea = -1.0;
+        for (int k = 0; k < treelet.leafCount; ++k) {
+            const uint32_t ref = treelet.leaves[k];
+            if (!(ref & LINEAR_TRIANGLE) && !linear[ref].leaf && linearBounds[ref].surfaceArea() > largestArea) {
+                largest = k;
+                largestArea = linearBounds[ref].surfaceArea();
+            }
+        }
+        if (largest < 0) {
+            break;
+        }
+        const uint32_t opened = treelet.leaves[largest];
+        treelet.internals[treelet.leafCount - 1] = opened;
+        treelet.leaves[largest] = linear[opened].children[0];
+        treelet.leaves[treelet.leafCount++] = linear[opened].children[1];
+    }
+    if (treelet.leafCount < 3) {
+        return;
+    }
+
+    // Cheapest topology for every subset of the leaves, smaller subsets
+    // first; a subset's first child always holds its lowest leaf, so each
+    // split is tried once
+    const int all = (1 << treelet.leafCount) - 1;
+    for (int subset = 1; subset <= all; ++subset) {
+        const int lowest = subset & -subset;
+        if (subset == lowest) {
+            int leaf = 0;
+            while (!(lowest & (1 << leaf))) {
+                ++leaf;
+            }
+            treelet.bounds[subset] = linearBoundsOf(treelet.leaves[leaf]);
+            treelet.cost[subset] = linearCostOf(treelet.leaves[leaf]);
+            continue;
+        }
+        treelet.bounds[subset] = treelet.bounds[lowest];
+        treelet.bounds[subset].expand(treelet.bounds[subset ^ lowest]);
+        double best = std::numeric_limits<double>::max();
+        for (int part = (subset - 1) & subset; part != 0; part = (part - 1) & subset) {
+            if ((part & lowest) && treelet.cost[part] + treelet.cost[subset ^ part] < best) {
+                best = treelet.cost[part] + treelet.cost[subset ^ part];
+                treelet.split[subset] = static_cast<uint8_t>(part);
+            }
+        }
+        treelet.cost[subset] = SAH_TRAVERSAL_COST * treelet.bounds[subset].surfaceArea() + best;
+    }
+
+    // Rewire only on a real gain; the current topology is among those tried
+    if (treelet.cost[all] < linearCost[root] * (1.0 - 1e-9)) {
+        int nextInternal = 1;
+        assignTreelet(treelet, all, root, nextInternal);
+    }
+}
+
+void TreeBuilder::assignTreelet(const Treelet& treelet, int subset, uint32_t id, int& nextInternal) {
+    LinearNode& node = linear[id];
+    const int parts[2] = {treelet.split[subset], subset ^ treelet.split[subset]};
+    for (int c = 0; c < 2; ++c) {
+        const int part = parts[c];
+        if ((part & (part - 1)) == 0) {
+            int leaf = 0;
+            while (!(part & (1 << leaf))) {
+                ++leaf;
+            }
+            node.children[c] = treelet.leaves[leaf];
+        } else {
+            node.children[c] = treelet.internals[nextInternal++];
+            assignTreelet(treelet, part, node.children[c], nextInternal);
+        }
+    }
+    node.count = linearCount(node.children[0]) + linearCount(node.children[1]);
+    node.leaf = false;
+    linearBounds[id] = treelet.bounds[subset];
+    linearCost[id] = treelet.cost[subset];
+}
+
+void TreeBuilder::gatherLinear(uint32_t ref, size_t& next) {
+    if (ref & LINEAR_TRIANGLE) {
+        order[next++] = scratch[ref & ~LINEAR_TRIANGLE];
+    } else if (linear[ref].leaf) {
+        const LinearNode& node = linear[ref];
+        std::copy(scratch.begin() + node.first, scratch.begin() + node.first + node.count, order.begin() + next);
+        next += node.count;
+    } else {
+        gatherLinear(linear[ref].children[0], next);
+        gatherLinear(linear[ref].children[1], next);
+    }
+}
+
+uint32_t TreeBuilder::emitLinear(uint32_t ref, size_t begin, int depth, std::vector<BVHNode>& out, int threads) {
+    const uint32_t index = static_cast<uint32_t>(out.size());
+    out.emplace_back();
+
+    // Leaves take their triangles' next positions in order, so every
+    // subtree's triangles stay contiguous there
+    const size_t end = begin + linearCount(ref);
+    BVHNode node;
+    if ((ref & LINEAR_TRIANGLE) || linear[ref].leaf || depth >= AABBTree::MAX_DEPTH) {
+        size_t next = begin;
+        gatherLinear(ref, next);
+        AABB bounds;
+        for (size_t i = begin; i < end; ++i) {
+            bounds.expand(triangleBounds[order[i]]);
+        }
+        node.setBounds(bounds);
+        node.offset = static_cast<uint32_t>(begin);
+        node.triangleCount = static_cast<uint32_t>(end - begin);
+        out[index] = node;
+        return index;
+    }
+
+    // Build children (out may reallocate, so fill in last); the first
+    // child lands at index + 1
+    const uint32_t children[2] = {linear[ref].children[0], linear[ref].children[1]};
+    node.triangleCount = 0;
+    node.offset = buildChildren(begin, begin + linearCount(children[0]), end, out, threads,
+        [this, &children, begin, depth](size_t b, size_t, std::vector<BVHNode>& o, int t) {
+            return emitLinear(children[b == begin ? 0 : 1], b, depth + 1, o, t);
+        });
+    AABB bounds = out[index + 1].bounds();
+    bounds.expand(out[node.offset].bounds());
+    node.setBounds(bounds);
+    out[index] = node;
+
+    return index;
+}
+
+} // namespace
+
 // ==========================================
 // AABB Implementation
 // ==========================================
@@ -111,138 +1016,444 @@ double calculateTriangleArea(const Vector3& v0, const Vector3& v1, const Vector3
     return (edge1 % edge2).length() * 0.5;
 }
 
+Vector3 closestPointOnTriangle(const Vector3& p, const Vector3& v0, const Vector3& v1, const Vector3& v2) {
+    const Vector3 ab = v1 - v0;
+    const Vector3 ac = v2 - v0;
+
+    // Slivers (sin^2 of the angle at v0 near rounding level) have no usable
+    // face region; the nearest of their edge points is exact up to their width
+    const Vector3 normal = ab % ac;
+    if (!(normal * normal > 64.0 * std::numeric_limits<double>::epsilon() * (ab * ab) * (ac * ac))) {
+        Vector3 best = closestPointOnSegment(p, v0, v1);
+        for (const Vector3& candidate : {closestPointOnSegment(p, v1, v2), closestPointOnSegment(p, v2, v0)}) {
+            if ((candidate - p) * (candidate - p) < (best - p) * (best - p)) {
+                best = candidate;
+            }
+        }
+        return best;
+    }
+
+    // Voronoi regions of v0, v1, edge v0v1, v2, edge v0v2, edge v1v2, then
+    // the face (Ericson, Real-Time Collision Detection, 5.1.5)
+    const Vector3 ap = p - v0;
+    const double d1 = ab * ap;
+    const double d2 = ac * ap;
+    if (d1 <= 0.0 && d2 <= 0.0) {
+        return v0;
+    }
+
+    const Vector3 bp = p - v1;
+    const double d3 = ab * bp;
+    const double d4 = ac * bp;
+    if (d3 >= 0.0 && d4 <= d3) {
+        return v1;
+    }
+
+    const double vc = d1 * d4 - d3 * d2;
+    if (vc <= 0.0 && d1 >= 0.0 && d3 <= 0.0) {
+        return v0 + ab * (d1 / (d1 - d3));
+    }
+
+    const Vector3 cp = p - v2;
+    const double d5 = ab * cp;
+    const double d6 = ac * cp;
+    if (d6 >= 0.0 && d5 <= d6) {
+        return v2;
+    }
+
+    const double vb = d5 * d2 - d1 * d6;
+    if (vb <= 0.0 && d2 >= 0.0 && d6 <= 0.0) {
+        return v0 + ac * (d2 / (d2 - d6));
+    }
+
+    const double va = d3 * d6 - d5 * d4;
+    if (va <= 0.0 && d4 - d3 >= 0.0 && d5 - d6 >= 0.0) {
+        return v1 + (v2 - v1) * ((d4 - d3) / ((d4 - d3) + (d5 - d6)));
+    }
+
+    const double sum = va + vb + vc;
+    return v0 + ab * (vb / sum) + ac * (vc / sum);
+}
+
 // ==========================================
 // AABBTree Implementation
 // ==========================================
 
-void AABBTree::build(const std::vector<Vector3>& verts,
-                    const std::vector<Triangle>& tris) {
-    vertices = &verts;
-    faces = &tris;
+void AABBTree::build(Span<const Vector3> verts, Span<const Triangle> tris,
+                     const BVHBuildOptions& options) {
+    vertices = verts;
+    faces = tris;
+    nodes.clear();
+    triangleOrder.resize(tris.size());
+    if (tris.empty()) {
+        buildWideNodes(BVHNodeFormat::Binary);
+        return;
+    }
+
+    const int threads = parallel::resolveThreadCount(options.numThreads);
+    TreeBuilder builder(verts, tris, triangleOrder, std::max<uint32_t>(options.maxLeafTriangles, 1), threads);
 
-    // Create list of all triangle indices
-    std::vector<int> triangleIndices(tris.size());
-    for (size_t i = 0; i < tris.size(); ++i) {
-        triangleIndices[i] = static_cast<int>(i);
+    if (options.builder == BVHBuilder::Median) {
+        // A balanced tree with <= 10 triangles per leaf has about n/5 nodes
+        nodes.reserve(tris.size() / 5 + 1);
+        builder.buildMedian(0, tris.size(), 0, nodes, threads);
+    } else if (options.builder == BVHBuilder::Linear) {
+        nodes.reserve(tris.size() / 4 + 1);
+        builder.buildLinear(options.treeletPasses, nodes, threads);
+    } else {
+        nodes.reserve(tris.size() / 2 + 1);
+        builder.buildSAH(0, tris.size(), 0, nodes, threads);
     }
+    buildWideNodes(options.nodeFormat);
+}
 
-    // Build tree recursively
-    root = buildNode(triangleIndices, 0);
+void AABBTree::clear() {
+    nodes.clear();
+    triangleOrder.clear();
+    vertices = Span<const Vector3>();
+    faces = Span<const Triangle>();
+    buildWideNodes(BVHNodeFormat::Binary);
 }
 
-AABB AABBTree::computeBounds(const std::vector<int>& triangleIndices) const {
-    AABB bounds;
+bool AABBTree::adopt(std::vector<BVHNode> treeNodes, std::vector<int> order,
+                     Span<const Vector3> verts, Span<const Triangle> tris, BVHNodeFormat format) {
+    clear();
 
-    for (int triIdx : triangleIndices) {
-        const Triangle& tri = (*faces)[triIdx];
-        bounds.expand((*vertices)[tri.v0]);
-        bounds.expand((*vertices)[tri.v1]);
-        bounds.expand((*vertices)[tri.v2]);
+    if (treeNodes.empty()) {
+        return false;
     }
 
-    return bounds;
-}
+    // Children always follow their parent in depth-first order, which also
+    // rules out cycles in a corrupted file; depth is bounded by the
+    // traversal stack
+    const size_t nodeCount = treeNodes.size();
+    std::vector<int> depth(nodeCount, 0);
+    for (size_t i = 0; i < nodeCount; ++i) {
+        const BVHNode& node = treeNodes[i];
+        if (node.isLeaf()) {
+            if (static_cast<size_t>(node.offset) + node.triangleCount > order.size()) {
+                return false;
+            }
+            continue;
+        }
+        if (node.offset <= i + 1 || node.offset >= nodeCount || depth[i] >= MAX_DEPTH) {
+            return false;
+        }
+        depth[i + 1] = std::max(depth[i + 1], depth[i] + 1);
+        depth[node.offset] = std::max(depth[node.offset], depth[i] + 1);
+    }
+    for (int triIdx : order) {
+        if (triIdx < 0 || static_cast<size_t>(triIdx) >= tris.size()) {
+            return false;
+        }
+    }
 
-std::unique_ptr<AABBTree::Node> AABBTree::buildNode(std::vector<int>& triangleIndices, int depth) {
-    auto node = std::make_unique<Node>();
+    nodes = std::move(treeNodes);
+    triangleOrder = std::move(order);
+    vertices = verts;
+    faces = tris;
+    buildWideNodes(format);
+    return true;
+}
 
-    // Compute bounds for this node
-    node->bounds = computeBounds(triangleIndices);
+size_t AABBTree::getTraversalNodeCount() const {
+    switch (nodeFormat) {
+        case BVHNodeFormat::Wide4: return wideNodes.size();
+        case BVHNodeFormat::Wide4Quantized: return quantizedNodes.size();
+        default: return nodes.size();
+    }
+}
 
-    // Leaf condition: few triangles or max depth
-    const int MAX_LEAF_TRIANGLES = 10;
-    const int MAX_DEPTH = 32;
+RayHit AABBTree::rayCast(const Ray& ray, double maxDistance) const {
+    RayHit hit;
+    switch (nodeFormat) {
+        case BVHNodeFormat::Wide4: hit = rayCastWide(ray, maxDistance); break;
+        case BVHNodeFormat::Wide4Quantized: hit = rayCastQuantized(ray, maxDistance); break;
+        default: hit = rayCastBinary(ray, maxDistance); break;
+    }
 
-    if (triangleIndices.size() <= MAX_LEAF_TRIANGLES || depth >= MAX_DEPTH) {
-        // Create leaf
-        node->triangleIndices = std::move(triangleIndices);
-        return node;
+    // Only the closest hit needs its point and normal
+    if (hit.hit) {
+        const Triangle& tri = faces[hit.triangleIndex];
+        hit.point = ray.at(hit.distance);
+        hit.normal = calculateTriangleNormal(vertices[tri.v0], vertices[tri.v1], vertices[tri.v2]);
     }
+    return hit;
+}
 
-    // Choose split axis (longest axis)
-    Vector3 extent = node->bounds.max - node->bounds.min;
-    int axis = 0;
-    if (extent.y > extent.x) axis = 1;
-    if (extent.z > extent.x && extent.z > extent.y) axis = 2;
+bool AABBTree::rayCastBatch(Span<const Ray> rays, Span<RayHit> hits, const RayBatchOptions& options) const {
+    if (hits.size() != rays.size()) {
+        std::cerr << "Error: rayCastBatch needs one hit per ray (" << rays.size() << " rays, "
+                  << hits.size() << " hits)" << std::endl;
+        return false;
+    }
+    if (nodes.empty()) {
+        std::fill(hits.begin(), hits.end(), RayHit());
+        return true;
+    }
+    const AABB box = nodes[0].bounds();
+    runOrderedBatch(rays.size(), parallel::resolveThreadCount(options.numThreads),
+                    [&](size_t i) { return rayOrderKey(rays[i], box); },
+                    [&](size_t i) { hits[i] = rayCast(rays[i], options.maxDistance); });
+    return true;
+}
 
-    // Sort triangles by centroid along axis
-    std::sort(triangleIndices.begin(), triangleIndices.end(),
-        [this, axis](int a, int b) {
-            const Triangle& triA = (*faces)[a];
-            const Triangle& triB = (*faces)[b];
+bool AABBTree::occluded(const Ray& ray, double maxDistance) const {
+    if (nodes.empty()) {
+        return false;
+    }
 
-            Vector3 centroidA = ((*vertices)[triA.v0] + (*vertices)[triA.v1] + (*vertices)[triA.v2]) * (1.0 / 3.0);
-            Vector3 centroidB = ((*vertices)[triB.v0] + (*vertices)[triB.v1] + (*vertices)[triB.v2]) * (1.0 / 3.0);
+    const RaySlabs slabs(ray);
+    double tEntry;
+    if (!slabs.intersect(nodes[0], maxDistance, tEntry)) {
+        return false;
+    }
 
-            double valA = (axis == 0) ? centroidA.x : (axis == 1) ? centroidA.y : centroidA.z;
-            double valB = (axis == 0) ? centroidB.x : (axis == 1) ? centroidB.y : centroidB.z;
+    // Any hit ends the search, so deferred children need no entry distance
+    uint32_t stack[MAX_DEPTH];
+    int stackSize = 0;
+    uint32_t current = 0;
 
-            return valA < valB;
-        });
+    while (true) {
+        const BVHNode& node = nodes[current];
 
-    // Split in half
-    size_t mid = triangleIndices.size() / 2;
-    std::vector<int> leftIndices(triangleIndices.begin(), triangleIndices.begin() + mid);
-    std::vector<int> rightIndices(triangleIndices.begin() + mid, triangleIndices.end());
+        if (node.isLeaf()) {
+            for (uint32_t i = 0; i < node.triangleCount; ++i) {
+                const Triangle& tri = faces[triangleOrder[node.offset + i]];
+                double t, u, v;
+                if (intersectRayTriangle(ray, vertices[tri.v0], vertices[tri.v1], vertices[tri.v2], t, u, v) &&
+                    t < maxDistance && t > 1e-6) {
+                    return true;
+                }
+            }
+        } else {
+            // Nearer child first: a hit there ends the search soonest
+            const uint32_t first = current + 1;
+            const uint32_t second = node.offset;
+            double tFirst, tSecond;
+            const bool hitFirst = slabs.intersect(nodes[first], maxDistance, tFirst);
+            const bool hitSecond = slabs.intersect(nodes[second], maxDistance, tSecond);
+            if (hitFirst && hitSecond) {
+                const bool secondNearer = tSecond < tFirst;
+                stack[stackSize++] = secondNearer ? first : second;
+                current = secondNearer ? second : first;
+                continue;
+            }
+            if (hitFirst || hitSecond) {
+                current = hitFirst ? first : second;
+                continue;
+            }
+        }
 
-    // Recursively build children
-    node->left = buildNode(leftIndices, depth + 1);
-    node->right = buildNode(rightIndices, depth + 1);
+        if (stackSize == 0) {
+            return false;
+        }
+        current = stack[--stackSize];
+    }
+}
 
-    return node;
+bool AABBTree::occludedBatch(Span<const Ray> rays, Span<uint8_t> results, const RayBatchOptions& options) const {
+    if (results.size() != rays.size()) {
+        std::cerr << "Error: occludedBatch needs one result per ray (" << rays.size() << " rays, "
+                  << results.size() << " results)" << std::endl;
+        return false;
+    }
+    if (nodes.empty()) {
+        std::fill(results.begin(), results.end(), uint8_t(0));
+        return true;
+    }
+    const AABB box = nodes[0].bounds();
+    runOrderedBatch(rays.size(), parallel::resolveThreadCount(options.numThreads),
+                    [&](size_t i) { return rayOrderKey(rays[i], box); },
+                    [&](size_t i) { results[i] = occluded(rays[i], options.maxDistance); });
+    return true;
 }
 
-RayHit AABBTree::rayCast(const Ray& ray, double maxDistance) const {
-    RayHit bestHit;
+ClosestPoint AABBTree::closestPoint(const Vector3& point, double maxDistance) const {
+    ClosestPoint best;
+    if (nodes.empty() || !(maxDistance > 0.0)) {
+        return best;
+    }
 
-    if (!root) {
-        return bestHit;
+    // Squared distance to beat: boxes and triangles no closer are skipped
+    const double p[3] = {point.x, point.y, point.z};
+    double bound = maxDistance * maxDistance;
+    if (boxDistanceSquared(nodes[0], p) >= bound) {
+        return best;
     }
 
-    rayCastRecursive(root.get(), ray, maxDistance, bestHit);
-    return bestHit;
+    struct StackEntry {
+        uint32_t node;
+        double distanceSquared;
+    };
+    StackEntry stack[MAX_DEPTH];
+    int stackSize = 0;
+    uint32_t current = 0;
+
+    while (true) {
+        const BVHNode& node = nodes[current];
+
+        if (node.isLeaf()) {
+            for (uint32_t i = 0; i < node.triangleCount; ++i) {
+                const int triIdx = triangleOrder[node.offset + i];
+                const Triangle& tri = faces[triIdx];
+                const Vector3 closest = closestPointOnTriangle(point, vertices[tri.v0], vertices[tri.v1],
+                                                               vertices[tri.v2]);
+                const Vector3 offset = closest - point;
+                const double distanceSquared = offset * offset;
+                if (distanceSquared < bound) {
+                    bound = distanceSquared;
+                    best.found = true;
+                    best.triangleIndex = triIdx;
+                    best.point = closest;
+                }
+            }
+        } else {
+            // Visit the nearer child next and defer the other
+            const uint32_t first = current + 1;
+            const uint32_t second = node.offset;
+            const double dFirst = boxDistanceSquared(nodes[first], p);
+            const double dSecond = boxDistanceSquared(nodes[second], p);
+            const bool nearFirst = dFirst < bound;
+            const bool nearSecond = dSecond < bound;
+            if (nearFirst && nearSecond) {
+                if (dSecond < dFirst) {
+                    stack[stackSize++] = {first, dFirst};
+                    current = second;
+                } else {
+                    stack[stackSize++] = {second, dSecond};
+                    current = first;
+                }
+                continue;
+            }
+            if (nearFirst || nearSecond) {
+                current = nearFirst ? first : second;
+                continue;
+            }
+        }
+
+        // Pop the next deferred child that can still hold a closer triangle
+        while (stackSize > 0 && stack[stackSize - 1].distanceSquared >= bound) {
+            --stackSize;
+        }
+        if (stackSize == 0) {
+            break;
+        }
+        current = stack[--stackSize].node;
+    }
+
+    if (best.found) {
+        best.distance = std::sqrt(bound);
+    }
+    return best;
 }
 
-void AABBTree::rayCastRecursive(const Node* node, const Ray& ray,
-                                double maxDistance, RayHit& bestHit) const {
-    if (!node) {
-        return;
+double AABBTree::distanceTo(const Vector3& point, double maxDistance) const {
+    const ClosestPoint closest = closestPoint(point, maxDistance);
+    return closest.found ? closest.distance : maxDistance;
+}
+
+bool AABBTree::closestPointBatch(Span<const Vector3> points, Span<ClosestPoint> results,
+                                 const PointBatchOptions& options) const {
+    if (results.size() != points.size()) {
+        std::cerr << "Error: closestPointBatch needs one result per point (" << points.size() << " points, "
+                  << results.size() << " results)" << std::endl;
+        return false;
     }
+    if (nodes.empty()) {
+        std::fill(results.begin(), results.end(), ClosestPoint());
+        return true;
+    }
+    const AABB box = nodes[0].bounds();
+    runOrderedBatch(points.size(), parallel::resolveThreadCount(options.numThreads),
+                    [&](size_t i) { return mortonCode(points[i], box, BATCH_MORTON_BITS); },
+                    [&](size_t i) { results[i] = closestPoint(points[i], options.maxDistance); });
+    return true;
+}
+
+void AABBTree::intersectLeaf(uint32_t first, uint32_t count, const Ray& ray,
+                             double maxDistance, RayHit& bestHit) const {
+    for (uint32_t i = 0; i < count; ++i) {
+        int triIdx = triangleOrder[first + i];
+        const Triangle& tri = faces[triIdx];
+        const Vector3& v0 = vertices[tri.v0];
+        const Vector3& v1 = vertices[tri.v1];
+        const Vector3& v2 = vertices[tri.v2];
+
+        double t, u, v;
+        if (intersectRayTriangle(ray, v0, v1, v2, t, u, v)) {
+            if (t < bestHit.distance && t < maxDistance && t > 1e-6) {
+                bestHit.hit = true;
+                bestHit.distance = t;
+                bestHit.triangleIndex = triIdx;
+            }
+        }
+    }
+}
+
+RayHit AABBTree::rayCastBinary(const Ray& ray, double maxDistance) const {
+    RayHit bestHit;
 
-    // Test ray against bounding box
-    double tMin, tMax;
-    if (!node->bounds.intersect(ray, tMin, tMax)) {
-        return; // Ray misses this node
+    if (nodes.empty()) {
+        return bestHit;
     }
 
-    if (tMin > maxDistance || tMin > bestHit.distance) {
-        return; // Too far away
+    const RaySlabs slabs(ray);
+    double tEntry;
+    if (!slabs.intersect(nodes[0], maxDistance, tEntry)) {
+        return bestHit;
     }
 
-    if (node->isLeaf()) {
-        // Test all triangles in leaf
-        for (int triIdx : node->triangleIndices) {
-            const Triangle& tri = (*faces)[triIdx];
-            const Vector3& v0 = (*vertices)[tri.v0];
-            const Vector3& v1 = (*vertices)[tri.v1];
-            const Vector3& v2 = (*vertices)[tri.v2];
+    // Far children waiting to be visited, with their entry distances; at
+    // most one is pushed per level
+    struct StackEntry {
+        uint32_t node;
+        double tEntry;
+    };
+    StackEntry stack[MAX_DEPTH];
+    int stackSize = 0;
+    uint32_t current = 0;
+
+    while (true) {
+        const BVHNode& node = nodes[current];
 
-            double t, u, v;
-            if (intersectRayTriangle(ray, v0, v1, v2, t, u, v)) {
-                if (t < bestHit.distance && t < maxDistance && t > 1e-6) {
-                    bestHit.hit = true;
-                    bestHit.distance = t;
-                    bestHit.triangleIndex = triIdx;
-                    bestHit.point = ray.at(t);
-                    bestHit.normal = calculateTriangleNormal(v0, v1, v2);
+        if (node.isLeaf()) {
+            intersectLeaf(node.offset, node.triangleCount, ray, maxDistance, bestHit);
+        } else {
+            // Visit the nearer child next and defer the other
+            const double limit = std::min(maxDistance, bestHit.distance);
+            const uint32_t first = current + 1;
+            const uint32_t second = node.offset;
+            double tFirst, tSecond;
+            const bool hitFirst = slabs.intersect(nodes[first], limit, tFirst);
+            const bool hitSecond = slabs.intersect(nodes[second], limit, tSecond);
+            if (hitFirst && hitSecond) {
+                if (tSecond < tFirst) {
+                    stack[stackSize++] = {first, tFirst};
+                    current = second;
+                } else {
+                    stack[stackSize++] = {second, tSecond};
+                    current = first;
                 }
+                continue;
+            }
+            if (hitFirst || hitSecond) {
+                current = hitFirst ? first : second;
+                continue;
             }
         }
-    } else {
-        // Recurse into children
-        rayCastRecursive(node->left.get(), ray, maxDistance, bestHit);
-        rayCastRecursive(node->right.get(), ray, maxDistance, bestHit);
+
+        // Pop the next deferred child that can still hold a closer hit
+        while (stackSize > 0 && stack[stackSize - 1].tEntry > bestHit.distance) {
+            --stackSize;
+        }
+        if (stackSize == 0) {
+            break;
+        }
+        current = stack[--stackSize].node;
     }
+
+    return bestHit;
 }
 
 } // namespace madfam::geom
@@ -0,0 +1,457 @@
+/**
+ * 4-wide BVH layouts for AABBTree ray casts
+ *
+ * The binary tree is collapsed top-down: each wide node takes a binary
+ * node's children and keeps replacing its largest interior child by that
+ * child's own two children until it holds four. Child boxes are stored as
+ * SoA lanes (float, or 8-bit offsets in the parent's box) and a ray is
+ * tested against all four with one SIMD kernel: SSE2 on x86, SIMD128 in
+ * WASM builds with -msimd128, plain loops elsewhere.
+ *
+ * The kernel runs in single precision, so every box is widened by a few
+ * float ulps of the largest coordinate involved (ray origin or mesh). That
+ * keeps the test conservative; triangles are still intersected in double
+ * precision. Rays that pass exactly through a vertex or edge on a box face
+ * may resolve to a different one of the touching triangles than in the
+ * binary traversal, as they already do between builders.
+ */
+
+#include "geom-core/Spatial.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define GC_BVH_SSE2 1
+#elif defined(__wasm_simd128__)
+#include <wasm_simd128.h>
+#define GC_BVH_SIMD128 1
+#endif
+
+namespace madfam::geom {
+
+namespace {
+
+// Box widening relative to the largest coordinate magnitude (~16 float ulps)
+const double BOX_PADDING = 1.0 / (1 << 20);
+
+// Inverse direction used for axes the ray is (nearly) parallel to: large
+// enough to put every slab at +-infinity or all-containing, small enough
+// that multiplying it by a quantization step stays finite
+const float PARALLEL_INVERSE = 1e30f;
+
+// Quantization steps are limited so they times PARALLEL_INVERSE cannot overflow
+const int MIN_EXPONENT = -126;
+const int MAX_EXPONENT = 26;
+
+// Traversal stack: each visited node defers up to three of its children
+const int STACK_SIZE = 3 * AABBTree::MAX_DEPTH + 4;
+
+// 2^exponent for a normal float exponent, without a libm call
+inline float powerOfTwo(int exponent) {
+    const uint32_t bits = static_cast<uint32_t>(exponent + 127) << 23;
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+// ------------------------------------------
+// Four-lane float operations
+// ------------------------------------------
+
+#if defined(GC_BVH_SSE2)
+
+using Lanes = __m128;
+inline Lanes load(const float* p) { return _mm_loadu_ps(p); }
+inline Lanes splat(float v) { return _mm_set1_ps(v); }
+inline Lanes add(Lanes a, Lanes b) { return _mm_add_ps(a, b); }
+inline Lanes sub(Lanes a, Lanes b) { return _mm_sub_ps(a, b); }
+inline Lanes mul(Lanes a, Lanes b) { return _mm_mul_ps(a, b); }
+inline Lanes min(Lanes a, Lanes b) { return _mm_min_ps(a, b); }
+inline Lanes max(Lanes a, Lanes b) { return _mm_max_ps(a, b); }
+inline int lessEqualMask(Lanes a, Lanes b) { return _mm_movemask_ps(_mm_cmple_ps(a, b)); }
+inline void store(float* p, Lanes v) { _mm_storeu_ps(p, v); }
+inline Lanes loadBytes(const uint8_t* p) {
+    int32_t word;
+    std::memcpy(&word, p, 4);
+    const __m128i zero = _mm_setzero_si128();
+    __m128i bytes = _mm_cvtsi32_si128(word);
+    return _mm_cvtepi32_ps(_mm_unpacklo_epi16(_mm_unpacklo_epi8(bytes, zero), zero));
+}
+
+#elif defined(GC_BVH_SIMD128)
+
+using Lanes = v128_t;
+inline Lanes load(const float* p) { return wasm_v128_load(p); }
+inline Lanes splat(float v) { return wasm_f32x4_splat(v); }
+inline Lanes add(Lanes a, Lanes b) { return wasm_f32x4_add(a, b); }
+inline Lanes sub(Lanes a, Lanes b) { return wasm_f32x4_sub(a, b); }
+inline Lanes mul(Lanes a, Lanes b) { return wasm_f32x4_mul(a, b); }
+inline Lanes min(Lanes a, Lanes b) { return wasm_f32x4_pmin(a, b); }
+inline Lanes max(Lanes a, Lanes b) { return wasm_f32x4_pmax(a, b); }
+inline int lessEqualMask(Lanes a, Lanes b) { return static_cast<int>(wasm_i32x4_bitmask(wasm_f32x4_le(a, b))); }
+inline void store(float* p, Lanes v) { wasm_v128_store(p, v); }
+inline Lanes loadBytes(const uint8_t* p) {
+    v128_t bytes = wasm_v128_load32_zero(p);
+    return wasm_f32x4_convert_u32x4(wasm_u32x4_extend_low_u16x8(wasm_u16x8_extend_low_u8x16(bytes)));
+}
+
+#else
+
+struct Lanes {
+    float v[4];
+};
+inline Lanes load(const float* p) { return {{p[0], p[1], p[2], p[3]}}; }
+inline Lanes splat(float x) { return {{x, x, x, x}}; }
+template<typename Op>
+inline Lanes apply(Lanes a, Lanes b, Op op) {
+    return {{op(a.v[0], b.v[0]), op(a.v[1], b.v[1]), op(a.v[2], b.v[2]), op(a.v[3], b.v[3])}};
+}
+inline Lanes add(Lanes a, Lanes b) { return apply(a, b, [](float x, float y) { return x + y; }); }
+inline Lanes sub(Lanes a, Lanes b) { return apply(a, b, [](float x, float y) { return x - y; }); }
+inline Lanes mul(Lanes a, Lanes b) { return apply(a, b, [](float x, float y) { return x * y; }); }
+inline Lanes min(Lanes a, Lanes b) { return apply(a, b, [](float x, float y) { return x < y ? x : y; }); }
+inline Lanes max(Lanes a, Lanes b) { return apply(a, b, [](float x, float y) { return x > y ? x : y; }); }
+inline int lessEqualMask(Lanes a, Lanes b) {
+    return (a.v[0] <= b.v[0]) | (a.v[1] <= b.v[1]) << 1 | (a.v[2] <= b.v[2]) << 2 | (a.v[3] <= b.v[3]) << 3;
+}
+inline void store(float* p, Lanes a) { std::memcpy(p, a.v, sizeof(a.v)); }
+inline Lanes loadBytes(const uint8_t* p) { return {{float(p[0]), float(p[1]), float(p[2]), float(p[3])}}; }
+
+#endif
+
+// ------------------------------------------
+// Ray setup
+// ------------------------------------------
+
+/**
+ * Ray prepared for the four-lane slab test. Per axis, the plane hit first
+ * (min for positive directions, max for negative ones) is the "near" plane.
+ * Widening boxes by the padding is folded into two shifted origins: near
+ * planes are measured from an origin moved towards them, far planes from
+ * one moved away.
+ */
+struct WideRay {
+    float originNear[3];
+    float originFar[3];
+    float invDirection[3];
+    int nearPlane[3];   // Index into bounds[6]: axis (min) or axis + 3 (max)
+    int farPlane[3];
+
+    WideRay(const Ray& ray, double coordinateMagnitude) {
+        const double origin[3] = {ray.origin.x, ray.origin.y, ray.origin.z};
+        const double direction[3] = {ray.direction.x, ray.direction.y, ray.direction.z};
+        double magnitude = coordinateMagnitude;
+        for (int a = 0; a < 3; ++a) {
+            magnitude = std::max(magnitude, std::abs(origin[a]));
+        }
+        const double padding = magnitude * BOX_PADDING + std::numeric_limits<float>::min();
+
+        for (int a = 0; a < 3; ++a) {
+            // Near-parallel axes keep their sign, which picks the near plane
+            invDirection[a] = std::abs(direction[a]) < 1e-8
+                ? static_cast<float>(std::copysign(PARALLEL_INVERSE, direction[a]))
+                : static_cast<float>(1.0 / direction[a]);
+            const bool positive = !std::signbit(invDirection[a]);
+            nearPlane[a] = positive ? a : a + 3;
+            farPlane[a] = positive ? a + 3 : a;
+            originNear[a] = static_cast<float>(positive ? origin[a] + padding : origin[a] - padding);
+            originFar[a] = static_cast<float>(positive ? origin[a] - padding : origin[a] + padding);
+        }
+    }
+};
+
+// Distance limit as a float that is never below the double one
+float limitAsFloat(double limit) {
+    if (limit >= std::numeric_limits<float>::max()) {
+        return std::numeric_limits<float>::infinity();
+    }
+    float value = static_cast<float>(limit);
+    return value < limit ? std::nextafter(value, std::numeric_limits<float>::infinity()) : value;
+}
+
+/**
+ * @brief Slab test of a ray against a node's four child boxes
+ * @return Bit mask of lanes whose box is entered before limit; entry distances in tNear
+ */
+int intersectLanes(const BVH4Node& node, const WideRay& ray, float limit, float tNear[4]) {
+    Lanes nearT = splat(0.0f);
+    Lanes farT = splat(limit);
+    for (int a = 0; a < 3; ++a) {
+        const Lanes inv = splat(ray.invDirection[a]);
+        nearT = max(nearT, mul(sub(load(node.bounds[ray.nearPlane[a]]), splat(ray.originNear[a])), inv));
+        farT = min(farT, mul(sub(load(node.bounds[ray.farPlane[a]]), splat(ray.originFar[a])), inv));
+    }
+    store(tNear, nearT);
+    return lessEqualMask(nearT, farT);
+}
+
+int intersectLanes(const BVH4QuantizedNode& node, const WideRay& ray, float limit, float tNear[4]) {
+    // Plane origin + q * step, measured from o and scaled by inv, is
+    // q * (step * inv) + (origin - o) * inv
+    Lanes nearT = splat(0.0f);
+    Lanes farT = splat(limit);
+    for (int a = 0; a < 3; ++a) {
+        const float inv = ray.invDirection[a];
+        const Lanes scale = splat(powerOfTwo(node.exponent[a]) * inv);
+        const Lanes nearBase = splat((node.origin[a] - ray.originNear[a]) * inv);
+        const Lanes farBase = splat((node.origin[a] - ray.originFar[a]) * inv);
+        nearT = max(nearT, add(mul(loadBytes(node.bounds[ray.nearPlane[a]]), scale), nearBase));
+        farT = min(farT, add(mul(loadBytes(node.bounds[ray.farPlane[a]]), scale), farBase));
+    }
+    store(tNear, nearT);
+    return lessEqualMask(nearT, farT);
+}
+
+// ------------------------------------------
+// Collapse
+// ------------------------------------------
+
+/**
+ * @brief Up to four binary nodes that become the children of one wide node
+ */
+int gatherChildren(const std::vector<BVHNode>& nodes, uint32_t parent, uint32_t slots[4]) {
+    int count = 0;
+    slots[count++] = parent + 1;
+    slots[count++] = nodes[parent].offset;
+    while (count < 4) {
+        int widest = -1;
+        double widestArea = -1.0;
+        for (int i = 0; i < count; ++i) {
+            const BVHNode& node = nodes[slots[i]];
+            if (!node.isLeaf() && node.bounds().surfaceArea() > widestArea) {
+                widestArea = node.bounds().surfaceArea();
+                widest = i;
+            }
+        }
+        if (widest < 0) {
+            break;
+        }
+        const uint32_t opened = slots[widest];
+        slots[widest] = opened + 1;
+        slots[count++] = nodes[opened].offset;
+    }
+    return count;
+}
+
+void setLane(BVH4Node& wide, int lane, const BVHNode& child) {
+    for (int a = 0; a < 3; ++a) {
+        wide.bounds[a][lane] = child.boundsMin[a];
+        wide.bounds[a + 3][lane] = child.boundsMax[a];
+    }
+}
+
+void clearLanes(BVH4Node& wide) {
+    for (int lane = 0; lane < 4; ++lane) {
+        for (int a = 0; a < 3; ++a) {
+            wide.bounds[a][lane] = std::numeric_limits<float>::infinity();
+            wide.bounds[a + 3][lane] = -std::numeric_limits<float>::infinity();
+        }
+        wide.children[lane] = BVH4Node::EMPTY;
+        wide.counts[lane] = 0;
+    }
+}
+
+void clearLanes(BVH4QuantizedNode& wide) {
+    std::memset(&wide, 0, sizeof(wide));
+    for (int lane = 0; lane < 4; ++lane) {
+        wide.children[lane] = BVH4Node::EMPTY;
+    }
+}
+
+/**
+ * @brief Frame quantized child planes within box; false if the step would be out of range
+ */
+bool setFrame(BVH4QuantizedNode& wide, const AABB& box) {
+    const double lo[3] = {box.min.x, box.min.y, box.min.z};
+    const double hi[3] = {box.max.x, box.max.y, box.max.z};
+    for (int a = 0; a < 3; ++a) {
+        wide.origin[a] = static_cast<float>(lo[a]);
+        if (wide.origin[a] > lo[a]) {
+            wide.origin[a] = std::nextafter(wide.origin[a], -std::numeric_limits<float>::infinity());
+        }
+        // Smallest power of two step with 255 steps covering the box
+        const double extent = hi[a] - static_cast<double>(wide.origin[a]);
+        int exponent = MIN_EXPONENT;
+        if (extent > 0.0) {
+            exponent = std::max(MIN_EXPONENT, static_cast<int>(std::ceil(std::log2(extent / 255.0))));
+            while (std::ldexp(255.0, exponent) < extent) {
+                ++exponent;
+            }
+        }
+        if (exponent > MAX_EXPONENT) {
+            return false;
+        }
+        wide.exponent[a] = static_cast<int8_t>(exponent);
+    }
+    return true;
+}
+
+void setLane(BVH4QuantizedNode& wide, int lane, const BVHNode& child) {
+    for (int a = 0; a < 3; ++a) {
+        const double step = std::ldexp(1.0, wide.exponent[a]);
+        const double lo = std::floor((child.boundsMin[a] - static_cast<double>(wide.origin[a])) / step);
+        const double hi = std::ceil((child.boundsMax[a] - static_cast<double>(wide.origin[a])) / step);
+        wide.bounds[a][lane] = static_cast<uint8_t>(std::clamp(lo, 0.0, 255.0));
+        wide.bounds[a + 3][lane] = static_cast<uint8_t>(std::clamp(hi, 0.0, 255.0));
+    }
+}
+
+bool setFrame(BVH4Node&, const AABB&) { return true; }
+
+template<typename Wide>
+class Collapser {
+public:
+    Collapser(const std::vector<BVHNode>& nodes, std::vector<Wide>& out) : nodes(nodes), out(out) {}
+
+    /**
+     * @brief Collapse the binary subtree at index; false if it cannot be encoded
+     */
+    bool collapse(uint32_t index) {
+        uint32_t slots[4];
+        int count = 1;
+        slots[0] = index;
+        if (!nodes[index].isLeaf()) {
+            count = gatherChildren(nodes, index, slots);
+        }
+
+        const size_t wideIndex = out.size();
+        out.emplace_back();
+        Wide wide;
+        clearLanes(wide);
+        if (!setFrame(wide, nodes[index].bounds())) {
+            return false;
+        }
+        for (int lane = 0; lane < count; ++lane) {
+            const BVHNode& child = nodes[slots[lane]];
+            setLane(wide, lane, child);
+            if (child.isLeaf()) {
+                using Count = std::remove_reference_t<decltype(wide.counts[0])>;
+                if (child.triangleCount > std::numeric_limits<Count>::max()) {
+                    return false;
+                }
+                wide.children[lane] = child.offset;
+                wide.counts[lane] = static_cast<Count>(child.triangleCount);
+            } else {
+                // out may reallocate, so the node is stored last
+                wide.children[lane] = static_cast<uint32_t>(out.size());
+                if (!collapse(slots[lane])) {
+                    return false;
+                }
+            }
+        }
+        out[wideIndex] = wide;
+        return true;
+    }
+
+private:
+    const std::vector<BVHNode>& nodes;
+    std::vector<Wide>& out;
+};
+
+struct StackEntry {
+    uint32_t child;
+    uint32_t count;   // Leaf triangle count, 0 for wide nodes
+    float tNear;
+};
+
+} // namespace
+
+void AABBTree::buildWideNodes(BVHNodeFormat format) {
+    wideNodes.clear();
+    quantizedNodes.clear();
+    nodeFormat = nodes.empty() ? BVHNodeFormat::Binary : format;
+
+    if (nodeFormat == BVHNodeFormat::Wide4Quantized) {
+        // The root is never a lane, so its box only frames its children
+        quantizedNodes.reserve(nodes.size() / 3 + 1);
+        if (Collapser<BVH4QuantizedNode>(nodes, quantizedNodes).collapse(0)) {
+            return;
+        }
+        quantizedNodes.clear();
+        quantizedNodes.shrink_to_fit();
+        nodeFormat = BVHNodeFormat::Wide4;
+    }
+    if (nodeFormat == BVHNodeFormat::Wide4) {
+        wideNodes.reserve(nodes.size() / 3 + 1);
+        Collapser<BVH4Node>(nodes, wideNodes).collapse(0);
+    }
+}
+
+namespace {
+
+template<typename Wide, typename LeafFn>
+void traverseWide(const std::vector<Wide>& wide, const BVHNode& root, const Ray& ray,
+                  double maxDistance, const RayHit& bestHit, LeafFn&& intersectLeaf) {
+    const AABB rootBounds = root.bounds();
+    const double magnitude = std::max({std::abs(rootBounds.min.x), std::abs(rootBounds.min.y),
+                                       std::abs(rootBounds.min.z), std::abs(rootBounds.max.x),
+                                       std::abs(rootBounds.max.y), std::abs(rootBounds.max.z)});
+    const WideRay wideRay(ray, magnitude);
+
+    StackEntry stack[STACK_SIZE];
+    int stackSize = 0;
+    StackEntry entry = {0, 0, 0.0f};
+
+    for (;;) {
+        if (entry.count > 0) {
+            intersectLeaf(entry.child, entry.count);
+        } else {
+            const Wide& node = wide[entry.child];
+            float tNear[4];
+            int mask = intersectLanes(node, wideRay, limitAsFloat(std::min(maxDistance, bestHit.distance)), tNear);
+
+            // Sort hit children farthest first; the nearest is visited next
+            // without a round trip through the stack
+            StackEntry hits[4];
+            int hitCount = 0;
+            for (int lane = 0; mask != 0; ++lane, mask >>= 1) {
+                if ((mask & 1) && node.children[lane] != BVH4Node::EMPTY) {
+                    StackEntry hit = {node.children[lane], node.counts[lane], tNear[lane]};
+                    int i = hitCount++;
+                    for (; i > 0 && hits[i - 1].tNear < hit.tNear; --i) {
+                        hits[i] = hits[i - 1];
+                    }
+                    hits[i] = hit;
+                }
+            }
+            if (hitCount > 0) {
+                for (int i = 0; i < hitCount - 1; ++i) {
+                    stack[stackSize++] = hits[i];
+                }
+                entry = hits[hitCount - 1];
+                continue;
+            }
+        }
+
+        do {
+            if (stackSize == 0) {
+                return;
+            }
+            entry = stack[--stackSize];
+        } while (entry.tNear > bestHit.distance);
+    }
+}
+
+} // namespace
+
+RayHit AABBTree::rayCastWide(const Ray& ray, double maxDistance) const {
+    RayHit bestHit;
+    traverseWide(wideNodes, nodes[0], ray, maxDistance, bestHit, [&](uint32_t first, uint32_t count) {
+        intersectLeaf(first, count, ray, maxDistance, bestHit);
+    });
+    return bestHit;
+}
+
+RayHit AABBTree::rayCastQuantized(const Ray& ray, double maxDistance) const {
+    RayHit bestHit;
+    traverseWide(quantizedNodes, nodes[0], ray, maxDistance, bestHit, [&](uint32_t first, uint32_t count) {
+        intersectLeaf(first, count, ray, maxDistance, bestHit);
+    });
+    return bestHit;
+}
+
+} // namespace madfam::geom
@@ -0,0 +1,165 @@
+#include "TessellationCache.hpp"
+#include "MappedFile.hpp"
+#include "Sha256.hpp"
+#include "geom-core/Mesh.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <functional>
+#include <iostream>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Set by the build from the project version; any change invalidates entries
+#ifndef GEOM_CORE_VERSION
+#define GEOM_CORE_VERSION "unknown"
+#endif
+
+namespace fs = std::filesystem;
+
+namespace madfam::geom {
+
+namespace {
+
+const char* ENTRY_EXTENSION = ".gcmesh";
+const char* TEMP_EXTENSION = ".tmp";
+
+// Temporary files this old were left behind by a crashed writer
+const std::chrono::hours STALE_TEMP_AGE(1);
+
+std::string hex(uint64_t value) {
+    static const char digits[] = "0123456789abcdef";
+    std::string text(16, '0');
+    for (int i = 15; i >= 0; --i, value >>= 4) {
+        text[i] = digits[value & 0xf];
+    }
+    return text;
+}
+
+} // namespace
+
+TessellationCache::TessellationCache(std::string directory, uint64_t maxBytes)
+    : directory(std::move(directory)), maxBytes(maxBytes) {}
+
+TessellationCache::Key TessellationCache::makeKey(const std::string& sourcePath, const std::string& settings) {
+    MappedFile file;
+    if (!file.open(sourcePath)) {
+        return Key();
+    }
+    file.adviseSequential();
+
+    Sha256 content;
+    content.update(file.data(), file.size());
+
+    // Fields are newline-separated and the settings come last, so bytes
+    // cannot shift between fields and produce the same identity
+    Key key;
+    key.source = "sha256=" + Sha256::hex(content.finish()) + "\nsize=" + std::to_string(file.size()) +
+                 "\ngeom-core=" GEOM_CORE_VERSION "\nsettings=" + settings;
+    Sha256 name;
+    name.update(key.source.data(), key.source.size());
+    key.name = Sha256::hex(name.finish());
+    return key;
+}
+
+std::string TessellationCache::entryPath(const Key& key) const {
+    return (fs::path(directory) / (key.name + ENTRY_EXTENSION)).string();
+}
+
+bool TessellationCache::load(const Key& key, Mesh& mesh) const {
+    const std::string path = entryPath(key);
+    std::error_code ec;
+    if (key.name.empty() || !fs::is_regular_file(path, ec)) {
+        return false;
+    }
+    if (!mesh.loadCache(path, nullptr, key.source)) {
+        return false;
+    }
+    fs::last_write_time(path, fs::file_time_type::clock::now(), ec);
+    return true;
+}
+
+bool TessellationCache::store(const Key& key, const Mesh& mesh) const {
+    if (key.name.empty()) {
+        return false;
+    }
+    std::error_code ec;
+    fs::create_directories(directory, ec);
+    if (ec) {
+        std::cerr << "Error: Could not create tessellation cache directory: " << directory << std::endl;
+        return false;
+    }
+
+    // Unique per writer, so concurrent stores of one key never share a file
+    static std::atomic<uint64_t> counter{0};
+    const uint64_t stamp = static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+    const std::string path = entryPath(key);
+    const std::string tempPath = path + "." +
+        hex(std::hash<std::thread::id>()(std::this_thread::get_id()) ^ stamp ^ counter.fetch_add(1)) + TEMP_EXTENSION;
+
+    if (!mesh.saveCache(tempPath, nullptr, key.source)) {
+        return false;
+    }
+    if (std::rename(tempPath.c_str(), path.c_str()) != 0) {
+        std::cerr << "Error: Could not move tessellation cache entry into place: " << path << std::endl;
+        std::remove(tempPath.c_str());
+        return false;
+    }
+
+    evict();
+    return fs::exists(path, ec);
+}
+
+void TessellationCache::evict() const {
+    struct Entry {
+        fs::file_time_type used;
+        uint64_t size;
+        fs::path path;
+    };
+
+    std::vector<Entry> entries;
+    uint64_t total = 0;
+    std::error_code ec;
+    const fs::file_time_type now = fs::file_time_type::clock::now();
+    for (fs::directory_iterator it(directory, ec), end; !ec && it != end; it.increment(ec)) {
+        std::error_code entryError;
+        const fs::path extension = it->path().extension();
+        if (extension == TEMP_EXTENSION) {
+            fs::file_time_type written = it->last_write_time(entryError);
+            if (!entryError && now - written > STALE_TEMP_AGE) {
+                fs::remove(it->path(), entryError);
+            }
+            continue;
+        }
+        if (extension != ENTRY_EXTENSION) {
+            continue;
+        }
+        uint64_t size = it->file_size(entryError);
+        fs::file_time_type used = it->last_write_time(entryError);
+        if (!entryError) {
+            entries.push_back({used, size, it->path()});
+            total += size;
+        }
+    }
+    if (total <= maxBytes) {
+        return;
+    }
+
+    // Oldest first; entries removed concurrently by another process are skipped
+    std::sort(entries.begin(), entries.end(),
+              [](const Entry& a, const Entry& b) { return a.used < b.used; });
+    for (const Entry& entry : entries) {
+        if (total <= maxBytes) {
+            break;
+        }
+        std::error_code removeError;
+        fs::remove(entry.path, removeError);
+        total -= entry.size;
+    }
+}
+
+} // namespace madfam::geom
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace madfam::geom {
+
+class Mesh;
+
+/**
+ * @brief Content-addressed on-disk cache of meshes derived from source files
+ *
+ * Used for STEP tessellation: the mesh produced from a file depends only on
+ * its bytes and the conversion settings, so repeat imports of the same
+ * revision can skip translation and meshing. Entries are .gcmesh files
+ * named after a SHA-256 of the file content, its size, the settings and the
+ * library version. The same identity is stored inside each entry and must
+ * match on load, so a renamed or colliding entry is a miss.
+ *
+ * The directory is bounded to maxBytes with least-recently-used eviction;
+ * hits refresh an entry's modification time, which serves as its LRU stamp.
+ * Entries are written under a unique name and renamed into place, so several
+ * processes can share one directory.
+ */
+class TessellationCache {
+public:
+    struct Key {
+        std::string name;    // Entry file name (without extension); empty = no key
+        std::string source;  // Content digest, size and settings, stored in the entry
+    };
+
+    /**
+     * @param directory Cache directory (created on first store)
+     * @param maxBytes Total size of entries kept after a store
+     */
+    TessellationCache(std::string directory, uint64_t maxBytes);
+
+    /**
+     * @brief Cache key for sourcePath converted with the given settings
+     * @param settings Everything besides the file content and library version
+     *        that changes the mesh (deflections, tessellator version)
+     * @return The key, with an empty name if the file cannot be read
+     */
+    static Key makeKey(const std::string& sourcePath, const std::string& settings);
+
+    /**
+     * @brief Load the entry for key into mesh and mark it recently used
+     * @return false on a miss, an unreadable entry or one stored for a
+     *         different source (mesh left empty)
+     */
+    bool load(const Key& key, Mesh& mesh) const;
+
+    /**
+     * @brief Store mesh under key, then evict old entries over the size bound
+     * @return true if the entry was written and kept
+     */
+    bool store(const Key& key, const Mesh& mesh) const;
+
+private:
+    std::string directory;
+    uint64_t maxBytes;
+
+    std::string entryPath(const Key& key) const;
+
+    /**
+     * @brief Remove least recently used entries until the total fits maxBytes
+     */
+    void evict() const;
+};
+
+} // namespace madfam::geom
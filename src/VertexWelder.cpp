@@ -0,0 +1,200 @@
+#include "geom-core/VertexWelder.hpp"
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+
+namespace madfam::geom {
+
+namespace {
+
+// Finalizer from MurmurHash3 - cheap and well distributed for integer keys
+inline uint64_t mix64(uint64_t h) {
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+inline uint64_t hashTriple(uint64_t a, uint64_t b, uint64_t c) {
+    uint64_t h = mix64(a + 0x9e3779b97f4a7c15ULL);
+    h = mix64(h ^ b);
+    return mix64(h ^ c);
+}
+
+inline uint64_t doubleBits(double value) {
+    // Fold -0.0 into +0.0 so both weld together (as they did with std::map)
+    value += 0.0;
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+inline int64_t cellCoord(double value, double invCellSize) {
+    const double limit = 4.0e18;
+    double c = std::floor(value * invCellSize);
+    if (!(c > -limit)) return static_cast<int64_t>(-limit);
+    if (!(c < limit)) return static_cast<int64_t>(limit);
+    return static_cast<int64_t>(c);
+}
+
+inline uint64_t cellHash(int64_t cx, int64_t cy, int64_t cz) {
+    return hashTriple(static_cast<uint64_t>(cx),
+                      static_cast<uint64_t>(cy),
+                      static_cast<uint64_t>(cz));
+}
+
+size_t capacityFor(size_t expectedVertices) {
+    // Keep the load factor at or below 0.5
+    size_t capacity = 16;
+    while (capacity < expectedVertices * 2) {
+        capacity <<= 1;
+    }
+    return capacity;
+}
+
+} // namespace
+
+VertexWelder::VertexWelder(double tol, size_t expectedVertices)
+    : tolerance(tol > 0.0 ? tol : 0.0)
+    , invCellSize(tol > 0.0 ? 1.0 / (2.0 * tol) : 0.0) {
+    rehash(capacityFor(expectedVertices));
+    vertices.reserve(expectedVertices);
+}
+
+uint64_t VertexWelder::hashOf(const Vector3& v) const {
+    if (tolerance == 0.0) {
+        return hashTriple(doubleBits(v.x), doubleBits(v.y), doubleBits(v.z));
+    }
+    return cellHash(cellCoord(v.x, invCellSize),
+                    cellCoord(v.y, invCellSize),
+                    cellCoord(v.z, invCellSize));
+}
+
+int VertexWelder::findExact(const Vector3& v, uint64_t hash) const {
+    const uint32_t tag = static_cast<uint32_t>(hash >> 32);
+    size_t pos = static_cast<size_t>(hash) & mask;
+
+    while (slots[pos].index >= 0) {
+        if (slots[pos].tag == tag) {
+            const Vector3& candidate = vertices[slots[pos].index];
+            if (candidate.x == v.x && candidate.y == v.y && candidate.z == v.z) {
+                return slots[pos].index;
+            }
+        }
+        pos = (pos + 1) & mask;
+    }
+    return -1;
+}
+
+int VertexWelder::findWithinTolerance(const Vector3& v) const {
+    const double fx = v.x * invCellSize;
+    const double fy = v.y * invCellSize;
+    const double fz = v.z * invCellSize;
+    const int64_t cx = cellCoord(v.x, invCellSize);
+    const int64_t cy = cellCoord(v.y, invCellSize);
+    const int64_t cz = cellCoord(v.z, invCellSize);
+
+    // A ball of radius tol spans at most two cells (of size 2*tol) per axis:
+    // the home cell and the neighbour on the side the point is closer to.
+    const int64_t dx = (fx - static_cast<double>(cx) < 0.5) ? -1 : 1;
+    const int64_t dy = (fy - static_cast<double>(cy) < 0.5) ? -1 : 1;
+    const int64_t dz = (fz - static_cast<double>(cz) < 0.5) ? -1 : 1;
+
+    const double tolSq = tolerance * tolerance;
+    int best = -1;
+
+    for (int corner = 0; corner < 8; ++corner) {
+        const int64_t qx = cx + ((corner & 1) ? dx : 0);
+        const int64_t qy = cy + ((corner & 2) ? dy : 0);
+        const int64_t qz = cz + ((corner & 4) ? dz : 0);
+
+        const uint64_t hash = cellHash(qx, qy, qz);
+        const uint32_t tag = static_cast<uint32_t>(hash >> 32);
+        size_t pos = static_cast<size_t>(hash) & mask;
+
+        while (slots[pos].index >= 0) {
+            const int32_t index = slots[pos].index;
+            if (slots[pos].tag == tag && (best < 0 || index < best)) {
+                const Vector3& candidate = vertices[index];
+                const Vector3 d = candidate - v;
+                if (d * d <= tolSq &&
+                    cellCoord(candidate.x, invCellSize) == qx &&
+                    cellCoord(candidate.y, invCellSize) == qy &&
+                    cellCoord(candidate.z, invCellSize) == qz) {
+                    best = index;
+                }
+            }
+            pos = (pos + 1) & mask;
+        }
+    }
+
+    return best;
+}
+
+int VertexWelder::find(const Vector3& vertex) const {
+    if (tolerance == 0.0) {
+        return findExact(vertex, hashOf(vertex));
+    }
+    return findWithinTolerance(vertex);
+}
+
+int VertexWelder::insert(const Vector3& vertex) {
+    const uint64_t hash = hashOf(vertex);
+
+    int existing = (tolerance == 0.0) ? findExact(vertex, hash)
+                                      : findWithinTolerance(vertex);
+    if (existing >= 0) {
+        return existing;
+    }
+
+    if ((vertices.size() + 1) * 2 > slots.size()) {
+        rehash(slots.size() * 2);
+    }
+
+    const int32_t index = static_cast<int32_t>(vertices.size());
+    vertices.push_back(vertex);
+    insertSlot(hash, index);
+    return index;
+}
+
+void VertexWelder::insertSlot(uint64_t hash, int32_t index) {
+    size_t pos = static_cast<size_t>(hash) & mask;
+    while (slots[pos].index >= 0) {
+        pos = (pos + 1) & mask;
+    }
+    slots[pos].tag = static_cast<uint32_t>(hash >> 32);
+    slots[pos].index = index;
+}
+
+void VertexWelder::rehash(size_t newCapacity) {
+    slots.assign(newCapacity, Slot{0, -1});
+    mask = newCapacity - 1;
+
+    for (size_t i = 0; i < vertices.size(); ++i) {
+        insertSlot(hashOf(vertices[i]), static_cast<int32_t>(i));
+    }
+}
+
+void VertexWelder::reserve(size_t expectedVertices) {
+    size_t capacity = capacityFor(expectedVertices);
+    if (capacity > slots.size()) {
+        rehash(capacity);
+    }
+    vertices.reserve(expectedVertices);
+}
+
+void VertexWelder::clear() {
+    std::fill(slots.begin(), slots.end(), Slot{0, -1});
+    vertices.clear();
+}
+
+std::vector<Vector3> VertexWelder::releaseVertices() {
+    std::vector<Vector3> out = std::move(vertices);
+    vertices = std::vector<Vector3>();
+    std::fill(slots.begin(), slots.end(), Slot{0, -1});
+    return out;
+}
+
+} // namespace madfam::geom
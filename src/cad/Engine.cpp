@@ -7,6 +7,8 @@
 
 #include "geom-core/cad/Engine.hpp"
 #include "geom-core/cad/ShapeRegistry.hpp"
+#include "geom-core/io/OBJIO.hpp"
+#include "geom-core/io/STLIO.hpp"
 
 #ifdef GC_USE_OCCT
 #include "OCCTShape.hpp"
@@ -218,6 +220,63 @@ Result<MeshData> Engine::tessellate(const std::string& shapeId, const Tessellate
     return result;
 }
 
+// =============================================================================
+// File I/O
+// =============================================================================
+
+Result<std::string> Engine::exportSTL(const std::string& shapeId, bool binary) {
+    auto start = std::chrono::high_resolution_clock::now();
+    
+    auto mesh = tessellate(shapeId);
+    if (!mesh.success) {
+        return Result<std::string>::error(mesh.errorCode, mesh.errorMessage);
+    }
+    
+    // Encoded straight into the returned string, records built in parallel
+    std::string data;
+    auto written = io::writeSTLToString(mesh.value, data, binary, 0);
+    if (!written.success) {
+        return Result<std::string>::error(written.errorCode, written.errorMessage);
+    }
+    
+    auto end = std::chrono::high_resolution_clock::now();
+    double durationMs = std::chrono::duration<double, std::milli>(end - start).count();
+    
+    size_t bytes = data.size();
+    auto result = Result<std::string>::ok(std::move(data));
+    result.durationMs = durationMs;
+    result.memoryUsedBytes = bytes;
+    
+    notifySlowOperation("exportSTL", durationMs);
+    return result;
+}
+
+Result<std::string> Engine::exportOBJ(const std::string& shapeId) {
+    auto start = std::chrono::high_resolution_clock::now();
+    
+    auto mesh = tessellate(shapeId);
+    if (!mesh.success) {
+        return Result<std::string>::error(mesh.errorCode, mesh.errorMessage);
+    }
+    
+    std::string data;
+    auto written = io::writeOBJToString(mesh.value, data, 0);
+    if (!written.success) {
+        return Result<std::string>::error(written.errorCode, written.errorMessage);
+    }
+    
+    auto end = std::chrono::high_resolution_clock::now();
+    double durationMs = std::chrono::duration<double, std::milli>(end - start).count();
+    
+    size_t bytes = data.size();
+    auto result = Result<std::string>::ok(std::move(data));
+    result.durationMs = durationMs;
+    result.memoryUsedBytes = bytes;
+    
+    notifySlowOperation("exportOBJ", durationMs);
+    return result;
+}
+
 // =============================================================================
 // Copy Operation
 // =============================================================================
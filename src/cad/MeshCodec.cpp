@@ -0,0 +1,499 @@
+/**
+ * MeshCodec.cpp - Compact MeshData wire encoding
+ *
+ * Stream layout (little-endian; every section padded to 4 bytes):
+ *   StreamHeader
+ *   positions  vertexCount * 3 grid coordinates (uint16, or uint32 above 16 bits)
+ *   normals    vertexCount * 2 octahedral components (int8, or int16 above 8 bits)
+ *   uvs        vertexCount * 2 float32
+ *   indices    indexCount varints
+ *
+ * Like the STL and .gcmesh codecs, fields are copied as native integers and
+ * floats, which assumes a little-endian host.
+ */
+
+#include "geom-core/cad/MeshCodec.hpp"
+#include "../Parallel.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace madfam::geom::cad {
+
+namespace {
+
+const char MESH_CODEC_MAGIC[4] = {'G', 'C', 'M', 'Q'};
+const uint16_t MESH_CODEC_VERSION = 1;
+
+const uint32_t FLAG_NORMALS = 1u << 0;
+const uint32_t FLAG_UVS = 1u << 1;
+
+// Post-transform cache size assumed by the triangle reordering
+const int VERTEX_CACHE_SIZE = 16;
+
+// Vertices per parallel (de)quantization work item (minimum)
+const size_t CODEC_BLOCK = 1 << 14;
+
+// Longest LEB128 encoding of a uint32
+const size_t MAX_VARINT_BYTES = 5;
+
+struct StreamHeader {
+    char magic[4];
+    uint16_t version;
+    uint8_t positionBits;
+    uint8_t normalBits;
+    uint32_t flags;
+    uint32_t vertexCount;
+    uint32_t indexCount;
+    uint32_t indexBytes;
+    float origin[3];      // Bounding box minimum
+    float step[3];        // Grid spacing per axis (0 for a flat axis)
+};
+static_assert(sizeof(StreamHeader) == 48, "StreamHeader must have no padding");
+
+inline size_t align4(size_t size) {
+    return (size + 3) & ~static_cast<size_t>(3);
+}
+
+struct SectionSizes {
+    size_t positions = 0;
+    size_t normals = 0;
+    size_t uvs = 0;
+};
+
+SectionSizes sectionSizes(size_t vertexCount, int positionBits, int normalBits, bool normals, bool uvs) {
+    SectionSizes sizes;
+    sizes.positions = align4(vertexCount * 3 * (positionBits > 16 ? 4 : 2));
+    sizes.normals = normals ? align4(vertexCount * 2 * (normalBits > 8 ? 2 : 1)) : 0;
+    sizes.uvs = uvs ? vertexCount * 2 * sizeof(float) : 0;
+    return sizes;
+}
+
+/**
+ * Triangle order for the post-transform vertex cache (Tipsify, Sander et al.
+ * 2007): fans around a cache-resident vertex, preferring vertices that will
+ * still be in the cache when their remaining triangles are emitted.
+ * Returns the reordered index list.
+ */
+std::vector<uint32_t> reorderForVertexCache(const std::vector<uint32_t>& indices, size_t vertexCount) {
+    const size_t triangleCount = indices.size() / 3;
+
+    // Triangles around each vertex (CSR)
+    std::vector<uint32_t> offsets(vertexCount + 1, 0);
+    for (uint32_t v : indices) {
+        ++offsets[v + 1];
+    }
+    for (size_t v = 0; v < vertexCount; ++v) {
+        offsets[v + 1] += offsets[v];
+    }
+    std::vector<uint32_t> triangles(indices.size());
+    std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+    for (size_t i = 0; i < indices.size(); ++i) {
+        triangles[fill[indices[i]]++] = static_cast<uint32_t>(i / 3);
+    }
+
+    std::vector<uint32_t> live(vertexCount);
+    for (size_t v = 0; v < vertexCount; ++v) {
+        live[v] = offsets[v + 1] - offsets[v];
+    }
+    std::vector<uint64_t> cacheTime(vertexCount, 0);
+    std::vector<char> emitted(triangleCount, 0);
+    std::vector<uint32_t> deadEnd;
+    std::vector<uint32_t> candidates;
+    std::vector<uint32_t> out;
+    out.reserve(indices.size());
+
+    const uint64_t cacheSize = VERTEX_CACHE_SIZE;
+    uint64_t time = cacheSize + 1;
+    size_t cursor = 0;
+    int64_t fan = indices.empty() ? -1 : static_cast<int64_t>(indices[0]);
+
+    while (fan >= 0) {
+        candidates.clear();
+        for (uint32_t k = offsets[fan]; k < offsets[fan + 1]; ++k) {
+            uint32_t t = triangles[k];
+            if (emitted[t]) continue;
+            emitted[t] = 1;
+            for (int c = 0; c < 3; ++c) {
+                uint32_t v = indices[3 * t + c];
+                out.push_back(v);
+                deadEnd.push_back(v);
+                candidates.push_back(v);
+                --live[v];
+                if (time - cacheTime[v] > cacheSize) {
+                    cacheTime[v] = time++;
+                }
+            }
+        }
+
+        // Next fan: a candidate still in cache after its remaining triangles
+        int64_t next = -1;
+        int64_t bestPriority = -1;
+        for (uint32_t v : candidates) {
+            if (live[v] == 0) continue;
+            int64_t priority = 0;
+            if (time - cacheTime[v] + 2 * live[v] <= cacheSize) {
+                priority = static_cast<int64_t>(time - cacheTime[v]);
+            }
+            if (priority > bestPriority) {
+                bestPriority = priority;
+                next = v;
+            }
+        }
+        while (next < 0 && !deadEnd.empty()) {
+            uint32_t v = deadEnd.back();
+            deadEnd.pop_back();
+            if (live[v] > 0) next = v;
+        }
+        while (next < 0 && cursor < vertexCount) {
+            if (live[cursor] > 0) next = static_cast<int64_t>(cursor);
+            ++cursor;
+        }
+        fan = next;
+    }
+    return out;
+}
+
+inline uint8_t* putVarint(uint8_t* p, uint32_t value) {
+    while (value >= 0x80) {
+        *p++ = static_cast<uint8_t>(value | 0x80);
+        value >>= 7;
+    }
+    *p++ = static_cast<uint8_t>(value);
+    return p;
+}
+
+/**
+ * Octahedral projection of a unit vector onto [-1, 1]^2
+ */
+inline void octEncode(float x, float y, float z, float& u, float& v) {
+    float l1 = std::fabs(x) + std::fabs(y) + std::fabs(z);
+    if (l1 == 0.0f) {
+        u = v = 0.0f;
+        return;
+    }
+    u = x / l1;
+    v = y / l1;
+    if (z < 0.0f) {
+        float fu = (1.0f - std::fabs(v)) * (u >= 0.0f ? 1.0f : -1.0f);
+        float fv = (1.0f - std::fabs(u)) * (v >= 0.0f ? 1.0f : -1.0f);
+        u = fu;
+        v = fv;
+    }
+}
+
+template<typename Q>
+void quantizePositions(const MeshData& mesh, const std::vector<uint32_t>& order, const double origin[3],
+                       const double scale[3], uint32_t gridMax, int numThreads, uint8_t* out) {
+    Q* q = reinterpret_cast<Q*>(out);
+    parallel::forEachBlock(order.size(), numThreads, CODEC_BLOCK, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            const float* p = &mesh.positions[3 * static_cast<size_t>(order[i])];
+            for (int a = 0; a < 3; ++a) {
+                double cell = std::round((p[a] - origin[a]) * scale[a]);
+                q[3 * i + a] = static_cast<Q>(std::min<double>(std::max(cell, 0.0), gridMax));
+            }
+        }
+    });
+}
+
+template<typename Q>
+void quantizeNormals(const MeshData& mesh, const std::vector<uint32_t>& order, int normalBits,
+                     int numThreads, uint8_t* out) {
+    Q* q = reinterpret_cast<Q*>(out);
+    const float maxValue = static_cast<float>((1 << (normalBits - 1)) - 1);
+    parallel::forEachBlock(order.size(), numThreads, CODEC_BLOCK, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            const float* n = &mesh.normals[3 * static_cast<size_t>(order[i])];
+            float u, v;
+            octEncode(n[0], n[1], n[2], u, v);
+            q[2 * i] = static_cast<Q>(std::lround(u * maxValue));
+            q[2 * i + 1] = static_cast<Q>(std::lround(v * maxValue));
+        }
+    });
+}
+
+template<typename Q>
+void dequantizePositions(const uint8_t* in, const StreamHeader& header, int numThreads, float* positions) {
+    parallel::forEachBlock(header.vertexCount, numThreads, CODEC_BLOCK, [&](size_t begin, size_t end) {
+        Q q[3 * 256];
+        // In double, so only the final rounding to float adds to the grid error
+        const double ox = header.origin[0], oy = header.origin[1], oz = header.origin[2];
+        const double sx = header.step[0], sy = header.step[1], sz = header.step[2];
+        for (size_t base = begin; base < end; base += 256) {
+            const size_t count = std::min<size_t>(256, end - base);
+            std::memcpy(q, in + 3 * base * sizeof(Q), 3 * count * sizeof(Q));
+            float* p = positions + 3 * base;
+            for (size_t i = 0; i < count; ++i) {
+                p[3 * i] = static_cast<float>(ox + static_cast<double>(q[3 * i]) * sx);
+                p[3 * i + 1] = static_cast<float>(oy + static_cast<double>(q[3 * i + 1]) * sy);
+                p[3 * i + 2] = static_cast<float>(oz + static_cast<double>(q[3 * i + 2]) * sz);
+            }
+        }
+    });
+}
+
+template<typename Q>
+void dequantizeNormals(const uint8_t* in, const StreamHeader& header, int numThreads, float* normals) {
+    const float scale = 1.0f / static_cast<float>((1 << (header.normalBits - 1)) - 1);
+    parallel::forEachBlock(header.vertexCount, numThreads, CODEC_BLOCK, [&](size_t begin, size_t end) {
+        Q q[2 * 256];
+        for (size_t base = begin; base < end; base += 256) {
+            const size_t count = std::min<size_t>(256, end - base);
+            std::memcpy(q, in + 2 * base * sizeof(Q), 2 * count * sizeof(Q));
+            float* n = normals + 3 * base;
+            // Branch-free unfolding of the octahedron so the loop vectorizes
+            for (size_t i = 0; i < count; ++i) {
+                float x = static_cast<float>(q[2 * i]) * scale;
+                float y = static_cast<float>(q[2 * i + 1]) * scale;
+                float z = 1.0f - std::fabs(x) - std::fabs(y);
+                float t = std::max(-z, 0.0f);
+                x -= std::copysign(t, x);
+                y -= std::copysign(t, y);
+                float inv = 1.0f / std::sqrt(x * x + y * y + z * z);
+                n[3 * i] = x * inv;
+                n[3 * i + 1] = y * inv;
+                n[3 * i + 2] = z * inv;
+            }
+        }
+    });
+}
+
+Result<MeshData> invalidStream(const std::string& message) {
+    return Result<MeshData>::error("INVALID_DATA", "Invalid mesh stream: " + message);
+}
+
+} // namespace
+
+size_t maxEncodedMeshSize(const MeshData& mesh, const MeshEncodeOptions& options) {
+    SectionSizes sizes = sectionSizes(mesh.vertexCount(), options.positionBits, options.normalBits,
+                                      !mesh.normals.empty(), !mesh.uvs.empty());
+    return sizeof(StreamHeader) + sizes.positions + sizes.normals + sizes.uvs +
+           mesh.indices.size() * MAX_VARINT_BYTES;
+}
+
+Result<std::vector<uint8_t>> encodeMeshData(const MeshData& mesh, const MeshEncodeOptions& options) {
+    using EncodeResult = Result<std::vector<uint8_t>>;
+    if (options.positionBits < 1 || options.positionBits > 24 ||
+        options.normalBits < 2 || options.normalBits > 16) {
+        return EncodeResult::error("INVALID_PARAMS", "positionBits must be 1-24 and normalBits 2-16");
+    }
+
+    const size_t vertexCount = mesh.vertexCount();
+    const bool hasNormals = !mesh.normals.empty();
+    const bool hasUVs = !mesh.uvs.empty();
+    if (mesh.positions.size() % 3 != 0 || mesh.indices.size() % 3 != 0 ||
+        (hasNormals && mesh.normals.size() != mesh.positions.size()) ||
+        (hasUVs && mesh.uvs.size() != vertexCount * 2)) {
+        return EncodeResult::error("INVALID_DATA", "Mesh arrays have inconsistent sizes");
+    }
+    if (vertexCount > std::numeric_limits<uint32_t>::max() ||
+        mesh.indices.size() > std::numeric_limits<uint32_t>::max()) {
+        return EncodeResult::error("INVALID_DATA", "Mesh too large to encode");
+    }
+    for (uint32_t index : mesh.indices) {
+        if (index >= vertexCount) {
+            return EncodeResult::error("INVALID_DATA", "Triangle index out of range");
+        }
+    }
+
+    std::vector<uint32_t> indices = options.optimizeVertexCache
+                                        ? reorderForVertexCache(mesh.indices, vertexCount)
+                                        : mesh.indices;
+
+    // Renumber vertices in first-use order; unreferenced vertices go last
+    const uint32_t unused = std::numeric_limits<uint32_t>::max();
+    std::vector<uint32_t> remap(vertexCount, unused);
+    std::vector<uint32_t> order;
+    order.reserve(vertexCount);
+    for (uint32_t& index : indices) {
+        if (remap[index] == unused) {
+            remap[index] = static_cast<uint32_t>(order.size());
+            order.push_back(index);
+        }
+        index = remap[index];
+    }
+    for (size_t v = 0; v < vertexCount; ++v) {
+        if (remap[v] == unused) {
+            order.push_back(static_cast<uint32_t>(v));
+        }
+    }
+
+    StreamHeader header;
+    std::memcpy(header.magic, MESH_CODEC_MAGIC, sizeof(header.magic));
+    header.version = MESH_CODEC_VERSION;
+    header.positionBits = static_cast<uint8_t>(options.positionBits);
+    header.normalBits = static_cast<uint8_t>(options.normalBits);
+    header.flags = (hasNormals ? FLAG_NORMALS : 0) | (hasUVs ? FLAG_UVS : 0);
+    header.vertexCount = static_cast<uint32_t>(vertexCount);
+    header.indexCount = static_cast<uint32_t>(indices.size());
+
+    // Grid over the bounding box
+    const uint32_t gridMax = (1u << options.positionBits) - 1;
+    double origin[3] = {0.0, 0.0, 0.0};
+    double scale[3] = {0.0, 0.0, 0.0};
+    if (vertexCount > 0) {
+        float lo[3] = {mesh.positions[0], mesh.positions[1], mesh.positions[2]};
+        float hi[3] = {lo[0], lo[1], lo[2]};
+        for (size_t i = 0; i < mesh.positions.size(); i += 3) {
+            for (int a = 0; a < 3; ++a) {
+                lo[a] = std::min(lo[a], mesh.positions[i + a]);
+                hi[a] = std::max(hi[a], mesh.positions[i + a]);
+            }
+        }
+        for (int a = 0; a < 3; ++a) {
+            header.origin[a] = lo[a];
+            // Rounded up if needed, so the grid reaches the maximum
+            const double extent = static_cast<double>(hi[a]) - lo[a];
+            header.step[a] = static_cast<float>(extent / gridMax);
+            if (static_cast<double>(header.step[a]) * gridMax < extent) {
+                header.step[a] = std::nextafter(header.step[a], std::numeric_limits<float>::infinity());
+            }
+            origin[a] = lo[a];
+            scale[a] = header.step[a] > 0.0f ? 1.0 / header.step[a] : 0.0;
+        }
+    } else {
+        std::fill(header.origin, header.origin + 3, 0.0f);
+        std::fill(header.step, header.step + 3, 0.0f);
+    }
+
+    const int threads = parallel::resolveThreadCount(options.numThreads);
+    SectionSizes sizes = sectionSizes(vertexCount, options.positionBits, options.normalBits, hasNormals, hasUVs);
+    std::vector<uint8_t> out(maxEncodedMeshSize(mesh, options), 0);
+    uint8_t* p = out.data() + sizeof(StreamHeader);
+
+    if (options.positionBits > 16) {
+        quantizePositions<uint32_t>(mesh, order, origin, scale, gridMax, threads, p);
+    } else {
+        quantizePositions<uint16_t>(mesh, order, origin, scale, gridMax, threads, p);
+    }
+    p += sizes.positions;
+
+    if (hasNormals) {
+        if (options.normalBits > 8) {
+            quantizeNormals<int16_t>(mesh, order, options.normalBits, threads, p);
+        } else {
+            quantizeNormals<int8_t>(mesh, order, options.normalBits, threads, p);
+        }
+        p += sizes.normals;
+    }
+
+    if (hasUVs) {
+        float* uv = reinterpret_cast<float*>(p);
+        for (size_t i = 0; i < vertexCount; ++i) {
+            uv[2 * i] = mesh.uvs[2 * static_cast<size_t>(order[i])];
+            uv[2 * i + 1] = mesh.uvs[2 * static_cast<size_t>(order[i]) + 1];
+        }
+        p += sizes.uvs;
+    }
+
+    // Each index as its distance back from the next unused vertex
+    uint8_t* indexStart = p;
+    uint32_t nextNew = 0;
+    for (uint32_t index : indices) {
+        p = putVarint(p, nextNew - index);
+        if (index == nextNew) {
+            ++nextNew;
+        }
+    }
+    header.indexBytes = static_cast<uint32_t>(p - indexStart);
+
+    std::memcpy(out.data(), &header, sizeof(header));
+    out.resize(static_cast<size_t>(p - out.data()));
+    out.shrink_to_fit();
+    return EncodeResult::ok(std::move(out));
+}
+
+Result<MeshData> decodeMeshData(const uint8_t* data, size_t size, int numThreads) {
+    StreamHeader header;
+    if (size < sizeof(header)) {
+        return invalidStream("truncated header");
+    }
+    std::memcpy(&header, data, sizeof(header));
+    if (std::memcmp(header.magic, MESH_CODEC_MAGIC, sizeof(header.magic)) != 0) {
+        return invalidStream("bad magic");
+    }
+    if (header.version != MESH_CODEC_VERSION) {
+        return invalidStream("unsupported version " + std::to_string(header.version));
+    }
+    if (header.positionBits < 1 || header.positionBits > 24 || header.normalBits < 2 ||
+        header.normalBits > 16 || header.indexCount % 3 != 0) {
+        return invalidStream("bad header fields");
+    }
+
+    const bool hasNormals = (header.flags & FLAG_NORMALS) != 0;
+    const bool hasUVs = (header.flags & FLAG_UVS) != 0;
+    const size_t vertexCount = header.vertexCount;
+    SectionSizes sizes = sectionSizes(vertexCount, header.positionBits, header.normalBits, hasNormals, hasUVs);
+    const size_t expected = sizeof(header) + sizes.positions + sizes.normals + sizes.uvs;
+    if (size < expected || size - expected != header.indexBytes) {
+        return invalidStream("section sizes do not match the stream length");
+    }
+    // Every index varint takes at least one byte; checked before sizing any output
+    if (header.indexBytes < header.indexCount ||
+        header.indexBytes > static_cast<size_t>(header.indexCount) * MAX_VARINT_BYTES) {
+        return invalidStream("index count does not match the index section");
+    }
+
+    MeshData mesh;
+    mesh.positions.resize(vertexCount * 3);
+    const int threads = parallel::resolveThreadCount(numThreads);
+    const uint8_t* p = data + sizeof(header);
+
+    if (header.positionBits > 16) {
+        dequantizePositions<uint32_t>(p, header, threads, mesh.positions.data());
+    } else {
+        dequantizePositions<uint16_t>(p, header, threads, mesh.positions.data());
+    }
+    p += sizes.positions;
+
+    if (hasNormals) {
+        mesh.normals.resize(vertexCount * 3);
+        if (header.normalBits > 8) {
+            dequantizeNormals<int16_t>(p, header, threads, mesh.normals.data());
+        } else {
+            dequantizeNormals<int8_t>(p, header, threads, mesh.normals.data());
+        }
+        p += sizes.normals;
+    }
+
+    if (hasUVs) {
+        mesh.uvs.resize(vertexCount * 2);
+        std::memcpy(mesh.uvs.data(), p, sizes.uvs);
+        p += sizes.uvs;
+    }
+
+    mesh.indices.resize(header.indexCount);
+    const uint8_t* end = data + size;
+    uint32_t nextNew = 0;
+    for (uint32_t& index : mesh.indices) {
+        uint32_t back;
+        if (p < end && *p < 0x80) {
+            back = *p++;
+        } else {
+            back = 0;
+            int shift = 0;
+            while (true) {
+                if (p == end || shift > 28) {
+                    return invalidStream("bad index varint");
+                }
+                uint8_t byte = *p++;
+                back |= static_cast<uint32_t>(byte & 0x7f) << shift;
+                if (byte < 0x80) break;
+                shift += 7;
+            }
+        }
+        if (back > nextNew || (back == 0 && nextNew == vertexCount)) {
+            return invalidStream("index out of range");
+        }
+        index = nextNew - back;
+        nextNew += back == 0;
+    }
+    if (p != end) {
+        return invalidStream("trailing index bytes");
+    }
+    return Result<MeshData>::ok(std::move(mesh));
+}
+
+} // namespace madfam::geom::cad
@@ -0,0 +1,281 @@
+#pragma once
+
+/**
+ * @file ASCIISTLParser.hpp
+ * @brief Tokenizer-based ASCII STL parser over a contiguous buffer
+ *
+ * Shared by io::readSTL/readSTLFromMemory (MeshData) and Mesh's STL loader,
+ * so both see exactly the same coordinates as the binary path. Numbers are
+ * parsed with std::from_chars; no streams or per-line allocations.
+ */
+
+#include <algorithm>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+namespace madfam::geom::io {
+
+/**
+ * @brief Minimal whitespace tokenizer for ASCII STL text
+ *
+ * Treats spaces, tabs, CR and LF uniformly, so CRLF files and irregular
+ * indentation parse the same as LF files. Stops at the first control byte
+ * (binary data behind a "solid" header) and reports it through binary().
+ */
+class ASCIISTLTokenizer {
+public:
+    ASCIISTLTokenizer(const char* data, size_t size)
+        : pos(data), end(data + size), begin(data) {}
+
+    /**
+     * @brief Next whitespace-delimited token (empty at end of input)
+     */
+    bool next(const char*& token, size_t& length) {
+        skipWhitespace();
+        if (pos == end) {
+            return false;
+        }
+        token = pos;
+        while (pos < end && !isSpace(*pos)) {
+            if (isControl(*pos)) {
+                sawBinary = true;
+                return false;
+            }
+            ++pos;
+        }
+        length = static_cast<size_t>(pos - token);
+        return true;
+    }
+
+    /**
+     * @brief Parse the next token as a float
+     */
+    bool nextFloat(float& value) {
+        const char* token;
+        size_t length;
+        if (!next(token, length)) {
+            return false;
+        }
+        // from_chars rejects a leading '+', which some exporters write
+        if (*token == '+') {
+            ++token;
+            --length;
+        }
+        auto result = std::from_chars(token, token + length, value);
+        return result.ec == std::errc() && result.ptr == token + length;
+    }
+
+    /**
+     * @brief Skip the rest of the current line (solid/endsolid names)
+     */
+    void skipLine() {
+        while (pos < end && *pos != '\n' && *pos != '\r') {
+            if (isControl(*pos)) {
+                sawBinary = true;
+                pos = end;
+                return;
+            }
+            ++pos;
+        }
+    }
+
+    size_t offset() const { return static_cast<size_t>(pos - begin); }
+
+    /**
+     * @brief True if tokenizing stopped at a byte that cannot occur in text
+     */
+    bool binary() const { return sawBinary; }
+
+    /**
+     * @brief Case-insensitive keyword comparison
+     */
+    static bool matches(const char* token, size_t length, const char* keyword) {
+        size_t keywordLength = std::strlen(keyword);
+        if (length != keywordLength) {
+            return false;
+        }
+        for (size_t i = 0; i < length; ++i) {
+            char c = token[i];
+            if (c >= 'A' && c <= 'Z') c = static_cast<char>(c - 'A' + 'a');
+            if (c != keyword[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+private:
+    const char* pos;
+    const char* end;
+    const char* begin;
+    bool sawBinary = false;
+
+    static bool isSpace(char c) {
+        return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' || c == '\v';
+    }
+
+    // NUL and other C0 controls; bytes >= 0x80 are allowed (UTF-8 solid names)
+    static bool isControl(char c) {
+        unsigned char u = static_cast<unsigned char>(c);
+        return (u < 0x20 && !isSpace(c)) || u == 0x7F;
+    }
+
+    void skipWhitespace() {
+        while (pos < end && isSpace(*pos)) {
+            ++pos;
+        }
+    }
+};
+
+/**
+ * @brief Check whether a buffer holds ASCII rather than binary STL
+ *
+ * Binary files may also start with "solid", so a buffer whose size matches
+ * the binary layout exactly is treated as binary. Other "solid" buffers are
+ * parsed as text first; callers fall back to binary when that fails and
+ * fitsBinarySTL() holds.
+ */
+inline bool isASCIISTL(const char* data, size_t size) {
+    size_t i = 0;
+    while (i < size && (data[i] == ' ' || data[i] == '\t' || data[i] == '\r' || data[i] == '\n')) {
+        ++i;
+    }
+    if (size - i < 5 || !ASCIISTLTokenizer::matches(data + i, 5, "solid")) {
+        return false;
+    }
+    if (size >= 84) {
+        uint32_t numTriangles;
+        std::memcpy(&numTriangles, data + 80, 4);
+        if (size == 84 + static_cast<size_t>(numTriangles) * 50) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Check whether a buffer is large enough for the binary STL it claims to be
+ *
+ * Trailing bytes after the last record are allowed, as many writers add them.
+ */
+inline bool fitsBinarySTL(const char* data, size_t size) {
+    if (size < 84) {
+        return false;
+    }
+    uint32_t numTriangles;
+    std::memcpy(&numTriangles, data + 80, 4);
+    return size >= 84 + static_cast<size_t>(numTriangles) * 50;
+}
+
+/**
+ * @brief Parse ASCII STL text, calling onFacet for every triangle
+ *
+ * @param data, size Text to parse
+ * @param onFacet Called as onFacet(const float normal[3], const float vertices[9])
+ * @param error Set to a description on failure
+ * @param solidCount Optional output: number of solid ... endsolid blocks
+ * @return true if successful, false otherwise
+ *
+ * Multi-solid files are handled by walking solid/endsolid boundaries; solid
+ * names (which may contain spaces) are skipped. Facets with more than three
+ * vertices are fan-triangulated. Control bytes and a missing final endsolid
+ * are errors, so binary data behind a "solid" header is never accepted.
+ */
+template<typename Callback>
+bool parseASCIISTL(const char* data, size_t size, Callback&& onFacet,
+                   std::string& error, size_t* solidCount = nullptr) {
+    ASCIISTLTokenizer tokens(data, size);
+    const char* token;
+    size_t length;
+    size_t solids = 0;
+    bool inSolid = false;
+
+    auto fail = [&](const std::string& message) {
+        error = (tokens.binary() ? std::string("non-text byte") : message) +
+                " at byte " + std::to_string(tokens.offset());
+        return false;
+    };
+
+    auto expect = [&](const char* keyword) {
+        return tokens.next(token, length) && ASCIISTLTokenizer::matches(token, length, keyword);
+    };
+
+    while (tokens.next(token, length)) {
+        if (ASCIISTLTokenizer::matches(token, length, "solid")) {
+            tokens.skipLine();
+            inSolid = true;
+            ++solids;
+        } else if (ASCIISTLTokenizer::matches(token, length, "endsolid")) {
+            tokens.skipLine();
+            inSolid = false;
+        } else if (ASCIISTLTokenizer::matches(token, length, "facet")) {
+            if (!inSolid) {
+                return fail("facet outside of solid");
+            }
+
+            float normal[3] = {0.0f, 0.0f, 0.0f};
+            if (expect("normal")) {
+                if (!tokens.nextFloat(normal[0]) || !tokens.nextFloat(normal[1]) ||
+                    !tokens.nextFloat(normal[2])) {
+                    return fail("invalid facet normal");
+                }
+                if (!expect("outer")) {
+                    return fail("expected 'outer loop'");
+                }
+            } else if (!ASCIISTLTokenizer::matches(token, length, "outer")) {
+                return fail("expected 'normal'");
+            }
+
+            if (!expect("loop")) {
+                return fail("expected 'loop'");
+            }
+
+            // First vertex, previous vertex, current vertex (fan triangulation)
+            float vertices[9];
+            int count = 0;
+            while (tokens.next(token, length) &&
+                   ASCIISTLTokenizer::matches(token, length, "vertex")) {
+                float* v = (count < 3) ? &vertices[count * 3] : &vertices[6];
+                if (count >= 3) {
+                    std::memcpy(&vertices[3], &vertices[6], 3 * sizeof(float));
+                }
+                if (!tokens.nextFloat(v[0]) || !tokens.nextFloat(v[1]) || !tokens.nextFloat(v[2])) {
+                    return fail("invalid vertex coordinates");
+                }
+                ++count;
+                if (count >= 3) {
+                    onFacet(normal, vertices);
+                }
+            }
+
+            if (!ASCIISTLTokenizer::matches(token, length, "endloop")) {
+                return fail("expected 'endloop'");
+            }
+            if (count < 3) {
+                return fail("facet with fewer than 3 vertices");
+            }
+            if (!expect("endfacet")) {
+                return fail("expected 'endfacet'");
+            }
+        } else {
+            return fail("unexpected token '" + std::string(token, std::min<size_t>(length, 32)) + "'");
+        }
+    }
+
+    if (tokens.binary()) {
+        return fail("non-text byte");
+    }
+    if (inSolid || solids == 0) {
+        return fail("missing 'endsolid'");
+    }
+
+    if (solidCount) {
+        *solidCount = solids;
+    }
+    return true;
+}
+
+} // namespace madfam::geom::io
@@ -0,0 +1,975 @@
+/**
+ * @file Deflate.cpp
+ * @brief DEFLATE encoder/decoder and CRC-32 (see Deflate.hpp)
+ */
+
+#include "Deflate.hpp"
+#include "../Parallel.hpp"
+#include <algorithm>
+#include <cstring>
+
+// x86 CRC-32 by carry-less multiplication, selected at run time
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define GC_CRC32_CLMUL 1
+#include <immintrin.h>
+#endif
+
+namespace madfam::geom::io {
+
+namespace {
+
+// Decoder output: 32 KB of history plus one chunk of fresh output
+const size_t INFLATE_HISTORY = 32768;
+const size_t INFLATE_CHUNK = 1 << 20;
+const size_t INFLATE_MAX_MATCH = 258;
+const size_t INFLATE_COPY_SLACK = 8;  // Matches are copied 8 bytes at a time
+
+const int FAST_BITS = 10;
+
+// Encoder: independent pieces (parallel), hash chains over a 32 KB window
+const size_t DEFLATE_PIECE = 1 << 20;
+const size_t DEFLATE_BLOCK_SYMBOLS = 1 << 16;
+const int DEFLATE_HASH_BITS = 15;
+const size_t DEFLATE_WINDOW = 32768;
+const int DEFLATE_MAX_CHAIN = 16;
+const size_t DEFLATE_NICE_MATCH = 128;
+const size_t DEFLATE_MIN_MATCH = 3;
+const size_t DEFLATE_MAX_MATCH = 258;
+
+const uint16_t LENGTH_BASE[29] = {3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+                                  35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+const uint8_t LENGTH_EXTRA[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+                                  3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+const uint16_t DIST_BASE[30] = {1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+                                257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145,
+                                8193, 12289, 16385, 24577};
+const uint8_t DIST_EXTRA[30] = {0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+                                7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+const uint8_t CODE_LENGTH_ORDER[19] = {16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15};
+
+inline uint64_t loadLE64(const uint8_t* p) {
+    uint64_t value = 0;
+    for (int i = 7; i >= 0; --i) {
+        value = (value << 8) | p[i];
+    }
+    return value;
+}
+
+inline uint32_t loadLE32(const uint8_t* p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+inline uint32_t reverseBits(uint32_t code, int length) {
+    uint32_t reversed = 0;
+    for (int i = 0; i < length; ++i) {
+        reversed = (reversed << 1) | (code & 1);
+        code >>= 1;
+    }
+    return reversed;
+}
+
+// Slicing-by-8 tables for the reflected ZIP polynomial
+struct CRCTables {
+    uint32_t table[8][256];
+
+    CRCTables() {
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t crc = i;
+            for (int k = 0; k < 8; ++k) {
+                crc = (crc & 1) ? (crc >> 1) ^ 0xEDB88320u : crc >> 1;
+            }
+            table[0][i] = crc;
+        }
+        for (int t = 1; t < 8; ++t) {
+            for (uint32_t i = 0; i < 256; ++i) {
+                table[t][i] = (table[t - 1][i] >> 8) ^ table[0][table[t - 1][i] & 0xFF];
+            }
+        }
+    }
+};
+
+const CRCTables& crcTables() {
+    static const CRCTables tables;
+    return tables;
+}
+
+#ifdef GC_CRC32_CLMUL
+// Folding constants for the reflected ZIP polynomial (Gopal et al., "Fast
+// CRC Computation for Generic Polynomials Using PCLMULQDQ", Intel 2009)
+alignas(16) const uint64_t CLMUL_FOLD4[2] = {0x0154442bd4, 0x01c6e41596};
+alignas(16) const uint64_t CLMUL_FOLD1[2] = {0x01751997d0, 0x00ccaa009e};
+alignas(16) const uint64_t CLMUL_FOLD64[2] = {0x0163cd6124, 0};
+alignas(16) const uint64_t CLMUL_BARRETT[2] = {0x01db710641, 0x01f7011641};
+
+const size_t CLMUL_MIN_BYTES = 64;
+
+bool clmulSupported() {
+    static const bool supported = __builtin_cpu_supports("pclmul") && __builtin_cpu_supports("sse4.1");
+    return supported;
+}
+
+inline __attribute__((target("pclmul,sse4.1"))) __m128i fold(__m128i value, __m128i constants, __m128i next) {
+    __m128i low = _mm_clmulepi64_si128(value, constants, 0x00);
+    __m128i high = _mm_clmulepi64_si128(value, constants, 0x11);
+    return _mm_xor_si128(_mm_xor_si128(low, high), next);
+}
+
+/**
+ * @brief CRC register (not inverted) over size bytes; size >= 64, a multiple of 16
+ */
+__attribute__((target("pclmul,sse4.1")))
+uint32_t crc32Clmul(uint32_t crc, const uint8_t* data, size_t size) {
+    __m128i x1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+    __m128i x2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 16));
+    __m128i x3 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 32));
+    __m128i x4 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 48));
+    x1 = _mm_xor_si128(x1, _mm_cvtsi32_si128(static_cast<int>(crc)));
+    data += 64;
+    size -= 64;
+
+    // Four independent 128-bit lanes, folded forward 64 bytes at a time
+    __m128i k = _mm_load_si128(reinterpret_cast<const __m128i*>(CLMUL_FOLD4));
+    for (; size >= 64; data += 64, size -= 64) {
+        x1 = fold(x1, k, _mm_loadu_si128(reinterpret_cast<const __m128i*>(data)));
+        x2 = fold(x2, k, _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 16)));
+        x3 = fold(x3, k, _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 32)));
+        x4 = fold(x4, k, _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 48)));
+    }
+
+    k = _mm_load_si128(reinterpret_cast<const __m128i*>(CLMUL_FOLD1));
+    x1 = fold(x1, k, x2);
+    x1 = fold(x1, k, x3);
+    x1 = fold(x1, k, x4);
+    for (; size >= 16; data += 16, size -= 16) {
+        x1 = fold(x1, k, _mm_loadu_si128(reinterpret_cast<const __m128i*>(data)));
+    }
+
+    // 128 -> 64 -> 32 bits, then Barrett reduction
+    const __m128i low32 = _mm_setr_epi32(-1, 0, -1, 0);
+    __m128i x2r = _mm_clmulepi64_si128(x1, k, 0x10);
+    x1 = _mm_xor_si128(_mm_srli_si128(x1, 8), x2r);
+
+    k = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(CLMUL_FOLD64));
+    x2r = _mm_srli_si128(x1, 4);
+    x1 = _mm_xor_si128(_mm_clmulepi64_si128(_mm_and_si128(x1, low32), k, 0x00), x2r);
+
+    k = _mm_load_si128(reinterpret_cast<const __m128i*>(CLMUL_BARRETT));
+    __m128i t = _mm_clmulepi64_si128(_mm_and_si128(x1, low32), k, 0x10);
+    t = _mm_clmulepi64_si128(_mm_and_si128(t, low32), k, 0x00);
+    x1 = _mm_xor_si128(x1, t);
+    return static_cast<uint32_t>(_mm_extract_epi32(x1, 1));
+}
+#endif
+
+} // namespace
+
+uint32_t crc32Update(uint32_t crc, const uint8_t* data, size_t size) {
+    const auto& t = crcTables().table;
+    crc = ~crc;
+#ifdef GC_CRC32_CLMUL
+    if (size >= CLMUL_MIN_BYTES && clmulSupported()) {
+        const size_t folded = size & ~static_cast<size_t>(15);
+        crc = crc32Clmul(crc, data, folded);
+        data += folded;
+        size -= folded;
+    }
+#endif
+    while (size >= 8) {
+        uint32_t one = loadLE32(data) ^ crc;
+        uint32_t two = loadLE32(data + 4);
+        crc = t[7][one & 0xFF] ^ t[6][(one >> 8) & 0xFF] ^ t[5][(one >> 16) & 0xFF] ^ t[4][one >> 24] ^
+              t[3][two & 0xFF] ^ t[2][(two >> 8) & 0xFF] ^ t[1][(two >> 16) & 0xFF] ^ t[0][two >> 24];
+        data += 8;
+        size -= 8;
+    }
+    while (size-- > 0) {
+        crc = (crc >> 8) ^ t[0][(crc ^ *data++) & 0xFF];
+    }
+    return ~crc;
+}
+
+// ===========================================================================
+// Inflater
+// ===========================================================================
+
+Inflater::Inflater(const uint8_t* input, size_t size)
+    : in(input), inEnd(input + size), inStart(input),
+      window(INFLATE_HISTORY + INFLATE_CHUNK + INFLATE_MAX_MATCH + INFLATE_COPY_SLACK) {}
+
+size_t Inflater::consumed() const {
+    size_t buffered = static_cast<size_t>(bitCount / 8);
+    return static_cast<size_t>(in - inStart) - (buffered - std::min(buffered, overrunBytes));
+}
+
+bool Inflater::fail(const char* message) {
+    errorMessage = message;
+    state = State::Done;
+    return false;
+}
+
+// Top up the bit buffer to at least 56 bits; past the end, zeros are
+// shifted in and counted so truncation is detected when they are consumed
+void Inflater::refill() {
+    if (inEnd - in >= 8) {
+        bitBuffer |= loadLE64(in) << bitCount;
+        in += (63 - bitCount) >> 3;
+        bitCount |= 56;
+        return;
+    }
+    while (bitCount <= 56) {
+        uint64_t byte = 0;
+        if (in < inEnd) {
+            byte = *in++;
+        } else {
+            ++overrunBytes;
+        }
+        bitBuffer |= byte << bitCount;
+        bitCount += 8;
+    }
+}
+
+bool Inflater::readBits(int count, uint32_t& value) {
+    if (bitCount < count) {
+        refill();
+    }
+    value = static_cast<uint32_t>(bitBuffer & ((uint64_t(1) << count) - 1));
+    bitBuffer >>= count;
+    bitCount -= count;
+    if (static_cast<size_t>(bitCount) < overrunBytes * 8) {
+        return fail("truncated deflate stream");
+    }
+    return true;
+}
+
+bool Inflater::build(HuffmanTable& table, const uint8_t* lengths, int count) {
+    std::memset(table.counts, 0, sizeof(table.counts));
+    for (int i = 0; i < count; ++i) {
+        table.counts[lengths[i]]++;
+    }
+    table.counts[0] = 0;
+
+    // Over-subscribed codes are invalid; incomplete ones fail when an unused code is read
+    int left = 1;
+    for (int len = 1; len <= 15; ++len) {
+        left = (left << 1) - table.counts[len];
+        if (left < 0) {
+            return fail("over-subscribed Huffman code");
+        }
+    }
+
+    uint16_t offsets[16];
+    offsets[1] = 0;
+    for (int len = 1; len < 15; ++len) {
+        offsets[len + 1] = static_cast<uint16_t>(offsets[len] + table.counts[len]);
+    }
+    for (int symbol = 0; symbol < count; ++symbol) {
+        if (lengths[symbol] != 0) {
+            table.symbols[offsets[lengths[symbol]]++] = static_cast<uint16_t>(symbol);
+        }
+    }
+
+    // Direct lookup for codes up to FAST_BITS long (bit-reversed, as read)
+    std::memset(table.fast, 0, sizeof(table.fast));
+    uint32_t code = 0;
+    int index = 0;
+    for (int len = 1; len <= 15; ++len) {
+        for (int k = 0; k < table.counts[len]; ++k, ++code, ++index) {
+            if (len <= FAST_BITS) {
+                uint16_t entry = static_cast<uint16_t>((table.symbols[index] << 4) | len);
+                for (uint32_t r = reverseBits(code, len); r < (1u << FAST_BITS); r += 1u << len) {
+                    table.fast[r] = entry;
+                }
+            }
+        }
+        code <<= 1;
+    }
+    return true;
+}
+
+// Requires at least 15 buffered bits; symbol is -1 on failure
+inline bool Inflater::decodeSymbol(const HuffmanTable& table, int& symbol) {
+    symbol = -1;
+    uint16_t entry = table.fast[bitBuffer & ((1u << FAST_BITS) - 1)];
+    if (entry != 0) {
+        int length = entry & 15;
+        bitBuffer >>= length;
+        bitCount -= length;
+        symbol = entry >> 4;
+        return true;
+    }
+
+    // Canonical decode one bit at a time for long codes
+    uint64_t bits = bitBuffer;
+    int code = 0, first = 0, index = 0;
+    for (int len = 1; len <= 15; ++len) {
+        code |= static_cast<int>(bits & 1);
+        bits >>= 1;
+        int count = table.counts[len];
+        if (code - count < first) {
+            symbol = table.symbols[index + (code - first)];
+            bitBuffer >>= len;
+            bitCount -= len;
+            return true;
+        }
+        index += count;
+        first = (first + count) << 1;
+        code <<= 1;
+    }
+    return fail("invalid Huffman code");
+}
+
+bool Inflater::readDynamicTables() {
+    uint32_t hlit, hdist, hclen;
+    if (!readBits(5, hlit) || !readBits(5, hdist) || !readBits(4, hclen)) {
+        return false;
+    }
+    hlit += 257;
+    hdist += 1;
+    hclen += 4;
+    if (hlit > 286 || hdist > 30) {
+        return fail("too many length or distance codes");
+    }
+
+    uint8_t codeLengthLengths[19] = {};
+    for (uint32_t i = 0; i < hclen; ++i) {
+        uint32_t value;
+        if (!readBits(3, value)) {
+            return false;
+        }
+        codeLengthLengths[CODE_LENGTH_ORDER[i]] = static_cast<uint8_t>(value);
+    }
+    HuffmanTable codeLengthTable;
+    if (!build(codeLengthTable, codeLengthLengths, 19)) {
+        return false;
+    }
+
+    uint8_t lengths[286 + 30] = {};
+    uint32_t total = hlit + hdist;
+    for (uint32_t i = 0; i < total;) {
+        if (bitCount < 15) {
+            refill();
+        }
+        int symbol = -1;
+        if (!decodeSymbol(codeLengthTable, symbol)) {
+            return false;
+        }
+        if (symbol < 16) {
+            lengths[i++] = static_cast<uint8_t>(symbol);
+            continue;
+        }
+
+        uint32_t repeat;
+        uint8_t value = 0;
+        if (symbol == 16) {
+            if (i == 0) {
+                return fail("length repeat with no previous length");
+            }
+            value = lengths[i - 1];
+            if (!readBits(2, repeat)) return false;
+            repeat += 3;
+        } else if (symbol == 17) {
+            if (!readBits(3, repeat)) return false;
+            repeat += 3;
+        } else {
+            if (!readBits(7, repeat)) return false;
+            repeat += 11;
+        }
+        if (i + repeat > total) {
+            return fail("code lengths overflow the table");
+        }
+        std::memset(lengths + i, value, repeat);
+        i += repeat;
+    }
+
+    if (lengths[256] == 0) {
+        return fail("missing end-of-block code");
+    }
+    return build(literalTable, lengths, static_cast<int>(hlit)) &&
+           build(distanceTable, lengths + hlit, static_cast<int>(hdist));
+}
+
+bool Inflater::next(const uint8_t*& data, size_t& size) {
+    data = nullptr;
+    size = 0;
+    if (!errorMessage.empty()) {
+        return false;
+    }
+
+    // Keep the last 32 KB as match history for the next chunk
+    if (outPos > INFLATE_HISTORY) {
+        std::memmove(window.data(), window.data() + outPos - INFLATE_HISTORY, INFLATE_HISTORY);
+        outPos = INFLATE_HISTORY;
+    }
+    const size_t start = outPos;
+    const size_t limit = INFLATE_HISTORY + INFLATE_CHUNK;
+    uint8_t* const out = window.data();
+
+    while (outPos < limit && state != State::Done) {
+        if (state == State::BlockHeader) {
+            if (finalBlock) {
+                state = State::Done;
+                break;
+            }
+            uint32_t header;
+            if (!readBits(3, header)) {
+                return false;
+            }
+            finalBlock = (header & 1) != 0;
+            uint32_t type = header >> 1;
+
+            if (type == 0) {
+                // Stored: byte-align, then LEN and its one's complement
+                uint32_t discard, len, nlen;
+                if (!readBits(bitCount & 7, discard) || !readBits(16, len) || !readBits(16, nlen)) {
+                    return false;
+                }
+                if ((len ^ 0xFFFF) != nlen) {
+                    return fail("stored block length mismatch");
+                }
+                storedRemaining = len;
+                state = State::Stored;
+            } else if (type == 1) {
+                uint8_t lengths[288 + 30];
+                std::memset(lengths, 8, 144);
+                std::memset(lengths + 144, 9, 112);
+                std::memset(lengths + 256, 7, 24);
+                std::memset(lengths + 280, 8, 8);
+                std::memset(lengths + 288, 5, 30);
+                if (!build(literalTable, lengths, 288) || !build(distanceTable, lengths + 288, 30)) {
+                    return false;
+                }
+                state = State::Huffman;
+            } else if (type == 2) {
+                if (!readDynamicTables()) {
+                    return false;
+                }
+                state = State::Huffman;
+            } else {
+                return fail("invalid block type");
+            }
+        } else if (state == State::Stored) {
+            size_t count = std::min(storedRemaining, limit - outPos);
+            storedRemaining -= count;
+
+            // Whole bytes still in the bit buffer come first
+            while (count > 0 && bitCount >= 8) {
+                if (static_cast<size_t>(bitCount) <= overrunBytes * 8) {
+                    return fail("truncated deflate stream");
+                }
+                out[outPos++] = static_cast<uint8_t>(bitBuffer);
+                bitBuffer >>= 8;
+                bitCount -= 8;
+                --count;
+            }
+            if (count > 0) {
+                // Buffer is empty; drop bytes preloaded past the counted bits
+                bitBuffer = 0;
+                if (static_cast<size_t>(inEnd - in) < count) {
+                    return fail("truncated deflate stream");
+                }
+                std::memcpy(out + outPos, in, count);
+                in += count;
+                outPos += count;
+            }
+            if (storedRemaining == 0) {
+                state = State::BlockHeader;
+            }
+        } else {
+            while (outPos < limit) {
+                // One refill covers the longest symbol + extra + distance + extra (48 bits)
+                if (bitCount < 48) {
+                    refill();
+                }
+                int symbol = -1;
+                if (!decodeSymbol(literalTable, symbol)) {
+                    return false;
+                }
+                if (symbol < 256) {
+                    out[outPos++] = static_cast<uint8_t>(symbol);
+                } else if (symbol == 256) {
+                    state = State::BlockHeader;
+                    break;
+                } else {
+                    symbol -= 257;
+                    if (symbol >= 29) {
+                        return fail("invalid length code");
+                    }
+                    int extra = LENGTH_EXTRA[symbol];
+                    size_t length = LENGTH_BASE[symbol] + (bitBuffer & ((1u << extra) - 1));
+                    bitBuffer >>= extra;
+                    bitCount -= extra;
+
+                    int distSymbol = -1;
+                    if (!decodeSymbol(distanceTable, distSymbol)) {
+                        return false;
+                    }
+                    if (distSymbol >= 30) {
+                        return fail("invalid distance code");
+                    }
+                    extra = DIST_EXTRA[distSymbol];
+                    size_t distance = DIST_BASE[distSymbol] + (bitBuffer & ((1u << extra) - 1));
+                    bitBuffer >>= extra;
+                    bitCount -= extra;
+
+                    if (distance > outPos) {
+                        return fail("match distance beyond start of output");
+                    }
+                    uint8_t* dst = out + outPos;
+                    const uint8_t* src = dst - distance;
+                    if (distance >= 8) {
+                        for (size_t i = 0; i < length; i += 8) {
+                            std::memcpy(dst + i, src + i, 8);
+                        }
+                    } else if (distance == 1) {
+                        std::memset(dst, *src, length);
+                    } else {
+                        for (size_t i = 0; i < length; ++i) {
+                            dst[i] = src[i];
+                        }
+                    }
+                    outPos += length;
+                }
+                if (static_cast<size_t>(bitCount) < overrunBytes * 8) {
+                    return fail("truncated deflate stream");
+                }
+            }
+        }
+    }
+
+    data = out + start;
+    size = outPos - start;
+    return true;
+}
+
+// ===========================================================================
+// Deflater
+// ===========================================================================
+
+namespace {
+
+class BitWriter {
+public:
+    explicit BitWriter(std::vector<uint8_t>& output) : out(output) {}
+
+    void put(uint32_t bits, int count) {
+        accumulator |= static_cast<uint64_t>(bits) << bitCount;
+        bitCount += count;
+        if (bitCount >= 32) {
+            uint8_t bytes[4] = {static_cast<uint8_t>(accumulator), static_cast<uint8_t>(accumulator >> 8),
+                                static_cast<uint8_t>(accumulator >> 16), static_cast<uint8_t>(accumulator >> 24)};
+            out.insert(out.end(), bytes, bytes + 4);
+            accumulator >>= 32;
+            bitCount -= 32;
+        }
+    }
+
+    // Pad with zero bits to a byte boundary and flush
+    void align() {
+        while (bitCount > 0) {
+            out.push_back(static_cast<uint8_t>(accumulator));
+            accumulator >>= 8;
+            bitCount = std::max(0, bitCount - 8);
+        }
+        accumulator = 0;
+    }
+
+private:
+    std::vector<uint8_t>& out;
+    uint64_t accumulator = 0;
+    int bitCount = 0;
+};
+
+/**
+ * Huffman code lengths for freqs, limited to maxLength. Frequencies are
+ * halved until the tree fits, which converges to a balanced tree.
+ */
+void buildLengths(const uint32_t* freqs, int count, int maxLength, uint8_t* lengths) {
+    std::fill(lengths, lengths + count, uint8_t(0));
+    std::vector<int> used;
+    for (int i = 0; i < count; ++i) {
+        if (freqs[i] > 0) used.push_back(i);
+    }
+    if (used.empty()) {
+        return;
+    }
+    if (used.size() == 1) {
+        lengths[used[0]] = 1;
+        return;
+    }
+
+    std::vector<uint64_t> weight(used.size());
+    for (size_t i = 0; i < used.size(); ++i) {
+        weight[i] = freqs[used[i]];
+    }
+
+    const size_t leaves = used.size();
+    std::vector<uint64_t> nodeWeight(2 * leaves);
+    std::vector<int> parent(2 * leaves);
+    std::vector<int> order(leaves);
+    std::vector<int> depth(2 * leaves);
+
+    while (true) {
+        // Two-queue Huffman construction over leaves sorted by weight
+        for (size_t i = 0; i < leaves; ++i) {
+            order[i] = static_cast<int>(i);
+            nodeWeight[i] = weight[i];
+        }
+        std::stable_sort(order.begin(), order.end(), [&](int a, int b) { return weight[a] < weight[b]; });
+
+        size_t leafNext = 0, internalNext = leaves, internalEnd = leaves;
+        auto takeSmallest = [&]() {
+            if (leafNext < leaves &&
+                (internalNext == internalEnd || nodeWeight[order[leafNext]] <= nodeWeight[internalNext])) {
+                return order[leafNext++];
+            }
+            return static_cast<int>(internalNext++);
+        };
+        for (size_t k = 0; k + 1 < leaves; ++k) {
+            int a = takeSmallest();
+            int b = takeSmallest();
+            nodeWeight[internalEnd] = nodeWeight[a] + nodeWeight[b];
+            parent[a] = parent[b] = static_cast<int>(internalEnd);
+            ++internalEnd;
+        }
+
+        // Root is the last internal node; children always precede parents
+        depth[internalEnd - 1] = 0;
+        int deepest = 0;
+        for (size_t n = internalEnd - 1; n-- > 0;) {
+            depth[n] = depth[parent[n]] + 1;
+            if (n < leaves) deepest = std::max(deepest, depth[n]);
+        }
+        if (deepest <= maxLength) {
+            for (size_t i = 0; i < leaves; ++i) {
+                lengths[used[i]] = static_cast<uint8_t>(depth[i]);
+            }
+            return;
+        }
+        for (auto& w : weight) {
+            w = (w + 1) / 2;
+        }
+    }
+}
+
+// Canonical codes for lengths, bit-reversed for LSB-first output
+void buildCodes(const uint8_t* lengths, int count, uint16_t* codes) {
+    uint16_t lengthCount[16] = {};
+    for (int i = 0; i < count; ++i) lengthCount[lengths[i]]++;
+    lengthCount[0] = 0;
+    uint32_t next[16] = {};
+    uint32_t code = 0;
+    for (int len = 1; len <= 15; ++len) {
+        code = (code + lengthCount[len - 1]) << 1;
+        next[len] = code;
+    }
+    for (int i = 0; i < count; ++i) {
+        if (lengths[i] != 0) {
+            codes[i] = static_cast<uint16_t>(reverseBits(next[lengths[i]]++, lengths[i]));
+        }
+    }
+}
+
+inline int lengthSymbol(size_t length) {
+    int symbol = 28;
+    while (LENGTH_BASE[symbol] > length) --symbol;
+    return symbol;
+}
+
+inline int distanceSymbol(size_t distance) {
+    int symbol = 29;
+    while (DIST_BASE[symbol] > distance) --symbol;
+    return symbol;
+}
+
+struct LZSymbol {
+    uint16_t length;    // 0 = literal
+    uint16_t value;     // Literal byte, or match distance
+};
+
+// Lookup tables for the length/distance symbol of each value
+struct SymbolTables {
+    uint8_t lengthSymbols[DEFLATE_MAX_MATCH + 1];
+    uint8_t distanceSymbolsLow[512];     // distance - 1 < 512
+    uint8_t distanceSymbolsHigh[256];    // (distance - 1) >> 7 otherwise
+
+    SymbolTables() {
+        for (size_t len = DEFLATE_MIN_MATCH; len <= DEFLATE_MAX_MATCH; ++len) {
+            lengthSymbols[len] = static_cast<uint8_t>(lengthSymbol(len));
+        }
+        for (size_t d = 0; d < 512; ++d) {
+            distanceSymbolsLow[d] = static_cast<uint8_t>(distanceSymbol(d + 1));
+        }
+        for (size_t d = 0; d < 256; ++d) {
+            distanceSymbolsHigh[d] = static_cast<uint8_t>(distanceSymbol((d << 7) + 1));
+        }
+    }
+
+    int distance(size_t value) const {
+        size_t d = value - 1;
+        return d < 512 ? distanceSymbolsLow[d] : distanceSymbolsHigh[d >> 7];
+    }
+};
+
+const SymbolTables& symbolTables() {
+    static const SymbolTables tables;
+    return tables;
+}
+
+/**
+ * Emit one non-final block for symbols (covering source bytes
+ * [blockBegin, blockEnd)), as dynamic Huffman or stored, whichever is smaller.
+ */
+void emitBlock(BitWriter& writer, const std::vector<LZSymbol>& symbols,
+               const uint8_t* blockBegin, const uint8_t* blockEnd) {
+    const SymbolTables& tables = symbolTables();
+
+    uint32_t litFreq[286] = {};
+    uint32_t distFreq[30] = {};
+    for (const LZSymbol& s : symbols) {
+        if (s.length == 0) {
+            litFreq[s.value]++;
+        } else {
+            litFreq[257 + tables.lengthSymbols[s.length]]++;
+            distFreq[tables.distance(s.value)]++;
+        }
+    }
+    litFreq[256] = 1;
+
+    uint8_t litLengths[286];
+    uint8_t distLengths[30];
+    buildLengths(litFreq, 286, 15, litLengths);
+    buildLengths(distFreq, 30, 15, distLengths);
+    bool anyDistance = std::any_of(distLengths, distLengths + 30, [](uint8_t l) { return l != 0; });
+    if (!anyDistance) {
+        distLengths[0] = 1;  // At least one distance code must be present
+    }
+
+    int hlit = 286;
+    while (hlit > 257 && litLengths[hlit - 1] == 0) --hlit;
+    int hdist = 30;
+    while (hdist > 1 && distLengths[hdist - 1] == 0) --hdist;
+    uint8_t lengths[286 + 30];
+    std::memcpy(lengths, litLengths, hlit);
+    std::memcpy(lengths + hlit, distLengths, hdist);
+    const int total = hlit + hdist;
+
+    // Run-length encode the code lengths (symbols 16/17/18)
+    struct RLE { uint8_t symbol; uint8_t extra; };
+    std::vector<RLE> rle;
+    uint32_t clFreq[19] = {};
+    for (int i = 0; i < total;) {
+        uint8_t value = lengths[i];
+        int run = 1;
+        while (i + run < total && lengths[i + run] == value) ++run;
+        int remaining = run;
+        if (value == 0) {
+            while (remaining >= 11) {
+                int n = std::min(remaining, 138);
+                rle.push_back({18, static_cast<uint8_t>(n - 11)});
+                remaining -= n;
+            }
+            if (remaining >= 3) {
+                rle.push_back({17, static_cast<uint8_t>(remaining - 3)});
+                remaining = 0;
+            }
+        } else {
+            rle.push_back({value, 0});
+            --remaining;
+            while (remaining >= 3) {
+                int n = std::min(remaining, 6);
+                rle.push_back({16, static_cast<uint8_t>(n - 3)});
+                remaining -= n;
+            }
+        }
+        while (remaining-- > 0) {
+            rle.push_back({value, 0});
+        }
+        i += run;
+    }
+    for (const RLE& r : rle) clFreq[r.symbol]++;
+
+    uint8_t clLengths[19];
+    buildLengths(clFreq, 19, 7, clLengths);
+    int hclen = 19;
+    while (hclen > 4 && clLengths[CODE_LENGTH_ORDER[hclen - 1]] == 0) --hclen;
+
+    // Compare the dynamic encoding with stored blocks
+    uint64_t dynamicBits = 3 + 5 + 5 + 4 + 3 * static_cast<uint64_t>(hclen);
+    for (const RLE& r : rle) {
+        dynamicBits += clLengths[r.symbol] + (r.symbol == 16 ? 2 : r.symbol == 17 ? 3 : r.symbol == 18 ? 7 : 0);
+    }
+    for (int s = 0; s < 286; ++s) {
+        dynamicBits += static_cast<uint64_t>(litFreq[s]) * litLengths[s];
+        if (s >= 257) dynamicBits += static_cast<uint64_t>(litFreq[s]) * LENGTH_EXTRA[s - 257];
+    }
+    for (int s = 0; s < 30; ++s) {
+        dynamicBits += static_cast<uint64_t>(distFreq[s]) * (distLengths[s] + DIST_EXTRA[s]);
+    }
+    const size_t rawBytes = static_cast<size_t>(blockEnd - blockBegin);
+    const uint64_t storedBits = (rawBytes + 5 * (rawBytes / 65535 + 1)) * 8 + 7;
+
+    if (storedBits < dynamicBits) {
+        const uint8_t* p = blockBegin;
+        do {
+            uint32_t n = static_cast<uint32_t>(std::min<size_t>(static_cast<size_t>(blockEnd - p), 65535));
+            writer.put(0, 3);  // Not final, stored
+            writer.align();
+            writer.put(n, 16);
+            writer.put(n ^ 0xFFFF, 16);
+            for (uint32_t k = 0; k < n; ++k) writer.put(p[k], 8);
+            p += n;
+        } while (p < blockEnd);
+        return;
+    }
+
+    uint16_t litCodes[286] = {};
+    uint16_t distCodes[30] = {};
+    uint16_t clCodes[19] = {};
+    buildCodes(litLengths, 286, litCodes);
+    buildCodes(distLengths, 30, distCodes);
+    buildCodes(clLengths, 19, clCodes);
+
+    writer.put(2 << 1, 3);  // Not final, dynamic Huffman
+    writer.put(static_cast<uint32_t>(hlit - 257), 5);
+    writer.put(static_cast<uint32_t>(hdist - 1), 5);
+    writer.put(static_cast<uint32_t>(hclen - 4), 4);
+    for (int i = 0; i < hclen; ++i) {
+        writer.put(clLengths[CODE_LENGTH_ORDER[i]], 3);
+    }
+    for (const RLE& r : rle) {
+        writer.put(clCodes[r.symbol], clLengths[r.symbol]);
+        if (r.symbol == 16) writer.put(r.extra, 2);
+        else if (r.symbol == 17) writer.put(r.extra, 3);
+        else if (r.symbol == 18) writer.put(r.extra, 7);
+    }
+
+    for (const LZSymbol& s : symbols) {
+        if (s.length == 0) {
+            writer.put(litCodes[s.value], litLengths[s.value]);
+            continue;
+        }
+        int ls = tables.lengthSymbols[s.length];
+        writer.put(litCodes[257 + ls], litLengths[257 + ls]);
+        writer.put(s.length - LENGTH_BASE[ls], LENGTH_EXTRA[ls]);
+        int ds = tables.distance(s.value);
+        writer.put(distCodes[ds], distLengths[ds]);
+        writer.put(s.value - DIST_BASE[ds], DIST_EXTRA[ds]);
+    }
+    writer.put(litCodes[256], litLengths[256]);
+}
+
+/**
+ * Compress one independent piece. Pieces end byte-aligned (an empty stored
+ * block), or with a final empty block for the last piece, so they can be
+ * concatenated into one valid stream.
+ */
+std::vector<uint8_t> compressPiece(const uint8_t* data, size_t size, bool last) {
+    std::vector<uint8_t> out;
+    out.reserve(size / 4 + 64);
+    BitWriter writer(out);
+
+    const uint32_t hashMask = (1u << DEFLATE_HASH_BITS) - 1;
+    std::vector<int32_t> head(size_t(1) << DEFLATE_HASH_BITS, -1);
+    std::vector<int32_t> prev(DEFLATE_WINDOW, -1);
+    auto hashAt = [&](size_t pos) {
+        uint32_t v = static_cast<uint32_t>(data[pos]) | (static_cast<uint32_t>(data[pos + 1]) << 8) |
+                     (static_cast<uint32_t>(data[pos + 2]) << 16);
+        return (v * 2654435761u) >> (32 - DEFLATE_HASH_BITS) & hashMask;
+    };
+    auto insert = [&](size_t pos) {
+        uint32_t h = hashAt(pos);
+        prev[pos & (DEFLATE_WINDOW - 1)] = head[h];
+        head[h] = static_cast<int32_t>(pos);
+    };
+
+    std::vector<LZSymbol> symbols;
+    symbols.reserve(DEFLATE_BLOCK_SYMBOLS);
+    size_t blockStart = 0;
+
+    size_t pos = 0;
+    while (pos < size) {
+        size_t bestLength = 0;
+        size_t bestDistance = 0;
+
+        if (pos + DEFLATE_MIN_MATCH <= size) {
+            insert(pos);
+            const size_t maxLength = std::min(DEFLATE_MAX_MATCH, size - pos);
+            int32_t candidate = prev[pos & (DEFLATE_WINDOW - 1)];
+            int chain = DEFLATE_MAX_CHAIN;
+            // Distances stay below the window so prev[] entries are never stale
+            while (candidate >= 0 && pos - static_cast<size_t>(candidate) < DEFLATE_WINDOW && chain-- > 0) {
+                const uint8_t* a = data + candidate;
+                const uint8_t* b = data + pos;
+                if (a[bestLength] == b[bestLength]) {
+                    size_t length = 0;
+                    while (length < maxLength && a[length] == b[length]) ++length;
+                    if (length > bestLength) {
+                        bestLength = length;
+                        bestDistance = pos - static_cast<size_t>(candidate);
+                        if (length >= DEFLATE_NICE_MATCH || length == maxLength) break;
+                    }
+                }
+                candidate = prev[static_cast<size_t>(candidate) & (DEFLATE_WINDOW - 1)];
+            }
+        }
+
+        if (bestLength >= DEFLATE_MIN_MATCH) {
+            symbols.push_back({static_cast<uint16_t>(bestLength), static_cast<uint16_t>(bestDistance)});
+            for (size_t k = 1; k < bestLength && pos + k + DEFLATE_MIN_MATCH <= size; ++k) {
+                insert(pos + k);
+            }
+            pos += bestLength;
+        } else {
+            symbols.push_back({0, data[pos]});
+            ++pos;
+        }
+
+        if (symbols.size() == DEFLATE_BLOCK_SYMBOLS) {
+            emitBlock(writer, symbols, data + blockStart, data + pos);
+            symbols.clear();
+            blockStart = pos;
+        }
+    }
+    if (!symbols.empty()) {
+        emitBlock(writer, symbols, data + blockStart, data + pos);
+    }
+
+    if (last) {
+        writer.put(1 | (1 << 1), 3);  // Final, fixed Huffman
+        writer.put(0, 7);             // End of block (code 256 is seven zero bits)
+        writer.align();
+    } else {
+        writer.put(0, 3);  // Empty stored block: byte-aligns the piece
+        writer.align();
+        writer.put(0x0000, 16);
+        writer.put(0xFFFF, 16);
+        writer.align();
+    }
+    return out;
+}
+
+} // namespace
+
+std::vector<uint8_t> deflateBytes(const uint8_t* data, size_t size, int numThreads) {
+    const size_t pieceCount = std::max<size_t>(1, (size + DEFLATE_PIECE - 1) / DEFLATE_PIECE);
+    std::vector<std::vector<uint8_t>> pieces(pieceCount);
+
+    parallel::forEachIndex(pieceCount, parallel::resolveThreadCount(numThreads), [&](size_t p) {
+        const size_t begin = p * DEFLATE_PIECE;
+        const size_t end = std::min(begin + DEFLATE_PIECE, size);
+        pieces[p] = compressPiece(data + begin, end - begin, p + 1 == pieceCount);
+    });
+
+    if (pieceCount == 1) {
+        return std::move(pieces[0]);
+    }
+    size_t total = 0;
+    for (const auto& piece : pieces) total += piece.size();
+    std::vector<uint8_t> out;
+    out.reserve(total);
+    for (const auto& piece : pieces) out.insert(out.end(), piece.begin(), piece.end());
+    return out;
+}
+
+} // namespace madfam::geom::io
@@ -0,0 +1,90 @@
+#pragma once
+
+/**
+ * @file Deflate.hpp
+ * @brief Self-contained DEFLATE (RFC 1951) codec and CRC-32 for ZIP containers
+ *
+ * Inflater decodes a raw deflate stream held in memory into a sliding output
+ * window, one chunk at a time, so arbitrarily large entries can be consumed
+ * with bounded memory. deflateBytes compresses with hash-chain LZ77 and
+ * per-block dynamic Huffman codes; large inputs are split into independent
+ * pieces that are compressed in parallel and joined at byte boundaries.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace madfam::geom::io {
+
+/**
+ * @brief Update a CRC-32 (ZIP polynomial) with more data; start from 0
+ */
+uint32_t crc32Update(uint32_t crc, const uint8_t* data, size_t size);
+
+/**
+ * @brief Streaming raw-deflate decoder over an in-memory input
+ */
+class Inflater {
+public:
+    Inflater(const uint8_t* input, size_t size);
+
+    /**
+     * @brief Decode the next chunk of output
+     * @param data Set to the decoded bytes (valid until the next call)
+     * @param size Set to the number of decoded bytes; 0 at end of stream
+     * @return false on corrupt or truncated input (see error())
+     */
+    bool next(const uint8_t*& data, size_t& size);
+
+    /**
+     * @brief Compressed bytes consumed so far (exact once the stream ended)
+     */
+    size_t consumed() const;
+
+    const std::string& error() const { return errorMessage; }
+
+private:
+    struct HuffmanTable {
+        uint16_t fast[1 << 10];   // (symbol << 4) | length, 0 = use slow path
+        uint16_t counts[16];      // Codes per length
+        uint16_t symbols[320];    // Symbols in canonical order
+    };
+
+    bool build(HuffmanTable& table, const uint8_t* lengths, int count);
+    bool decodeSymbol(const HuffmanTable& table, int& symbol);
+    bool readDynamicTables();
+    bool readBits(int count, uint32_t& value);
+    void refill();
+    bool fail(const char* message);
+
+    const uint8_t* in;
+    const uint8_t* inEnd;
+    const uint8_t* inStart;
+    uint64_t bitBuffer = 0;
+    int bitCount = 0;
+    size_t overrunBytes = 0;  // Zero bytes appended past the end of input
+
+    std::vector<uint8_t> window;
+    size_t outPos = 0;
+
+    enum class State { BlockHeader, Stored, Huffman, Done };
+    State state = State::BlockHeader;
+    bool finalBlock = false;
+    size_t storedRemaining = 0;
+
+    HuffmanTable literalTable;
+    HuffmanTable distanceTable;
+    std::string errorMessage;
+};
+
+/**
+ * @brief Compress into a raw deflate stream
+ * @param numThreads Threads for inputs larger than one piece (<= 0 = all cores)
+ *
+ * The output does not depend on numThreads.
+ */
+std::vector<uint8_t> deflateBytes(const uint8_t* data, size_t size, int numThreads = 1);
+
+} // namespace madfam::geom::io
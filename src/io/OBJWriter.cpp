@@ -0,0 +1,223 @@
+/**
+ * @file OBJWriter.cpp
+ * @brief Wavefront OBJ writer
+ *
+ * Lines are formatted with std::to_chars into per-block buffers sized for
+ * the worst case, a window of blocks at a time in parallel. Each finished
+ * window is handed to a sink (file or string) in order, so memory stays
+ * bounded by the window rather than the whole file.
+ */
+
+#include "geom-core/io/OBJIO.hpp"
+#include "../Parallel.hpp"
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <fstream>
+#include <functional>
+
+namespace madfam::geom::io {
+
+using namespace madfam::geom::cad;
+
+namespace {
+
+// Vertices or triangles per parallel work item
+const size_t OBJ_WRITE_BLOCK = 8192;
+
+// Blocks encoded per thread before the window is flushed to the sink
+const size_t OBJ_BLOCKS_PER_THREAD = 4;
+
+// Worst-case line lengths: shortest float is <= 15 chars, index <= 10 digits
+const size_t OBJ_MAX_VERTEX_LINE = 3 + 3 * 16 + 1;
+const size_t OBJ_MAX_FACE_LINE = 1 + 3 * (1 + 3 * 11) + 1;
+
+const char OBJ_HEADER_TEXT[] = "# OBJ generated by geom-core\n";
+
+struct OBJLayout {
+    size_t vertexCount = 0;
+    size_t triangleCount = 0;
+    bool hasNormals = false;
+    bool hasUVs = false;
+    size_t vertexBlocks = 0;
+    size_t faceBlocks = 0;
+};
+
+Result<OBJLayout> layoutOf(const MeshData& mesh) {
+    if (mesh.indices.size() % 3 != 0 || mesh.positions.size() % 3 != 0) {
+        return Result<OBJLayout>::error("INVALID_DATA", "Mesh arrays are not multiples of 3");
+    }
+    OBJLayout layout;
+    layout.vertexCount = mesh.vertexCount();
+    layout.triangleCount = mesh.triangleCount();
+    if (layout.vertexCount >= UINT32_MAX) {
+        return Result<OBJLayout>::error("INVALID_DATA", "Too many vertices for OBJ export");
+    }
+    // Checked up front so a bad mesh never leaves a partial file behind
+    if (!mesh.indices.empty() &&
+        *std::max_element(mesh.indices.begin(), mesh.indices.end()) >= layout.vertexCount) {
+        return Result<OBJLayout>::error("INVALID_DATA", "Triangle index out of range");
+    }
+    layout.hasNormals = layout.vertexCount > 0 && mesh.normals.size() == mesh.positions.size();
+    layout.hasUVs = layout.vertexCount > 0 && mesh.uvs.size() == layout.vertexCount * 2;
+    layout.vertexBlocks = (layout.vertexCount + OBJ_WRITE_BLOCK - 1) / OBJ_WRITE_BLOCK;
+    layout.faceBlocks = (layout.triangleCount + OBJ_WRITE_BLOCK - 1) / OBJ_WRITE_BLOCK;
+    return Result<OBJLayout>::ok(std::move(layout));
+}
+
+char* putFloats(char* ptr, char* limit, const float* values, int count) {
+    for (int k = 0; k < count; ++k) {
+        *ptr++ = ' ';
+        ptr = std::to_chars(ptr, limit, values[k]).ptr;
+    }
+    *ptr++ = '\n';
+    return ptr;
+}
+
+// "v", "vt" and "vn" lines for vertices [begin, end)
+void encodeVertices(const MeshData& mesh, const OBJLayout& layout, size_t begin, size_t end,
+                    std::string& text) {
+    const size_t linesPerVertex = 1 + (layout.hasNormals ? 1 : 0) + (layout.hasUVs ? 1 : 0);
+    text.resize((end - begin) * linesPerVertex * OBJ_MAX_VERTEX_LINE);
+    char* ptr = text.data();
+    char* const limit = ptr + text.size();
+
+    for (size_t i = begin; i < end; ++i) {
+        *ptr++ = 'v';
+        ptr = putFloats(ptr, limit, &mesh.positions[i * 3], 3);
+    }
+    if (layout.hasUVs) {
+        for (size_t i = begin; i < end; ++i) {
+            std::memcpy(ptr, "vt", 2);
+            ptr = putFloats(ptr + 2, limit, &mesh.uvs[i * 2], 2);
+        }
+    }
+    if (layout.hasNormals) {
+        for (size_t i = begin; i < end; ++i) {
+            std::memcpy(ptr, "vn", 2);
+            ptr = putFloats(ptr + 2, limit, &mesh.normals[i * 3], 3);
+        }
+    }
+    text.resize(static_cast<size_t>(ptr - text.data()));
+}
+
+// "f" lines for triangles [begin, end); indices were validated by layoutOf
+void encodeFaces(const MeshData& mesh, const OBJLayout& layout, size_t begin, size_t end,
+                 std::string& text) {
+    text.resize((end - begin) * OBJ_MAX_FACE_LINE);
+    char* ptr = text.data();
+
+    for (size_t i = begin; i < end; ++i) {
+        *ptr++ = 'f';
+        for (int j = 0; j < 3; ++j) {
+            // OBJ indices are 1-based; uv/normal indices match the position
+            char number[11];
+            char* numberEnd = std::to_chars(number, number + sizeof(number),
+                                            mesh.indices[i * 3 + j] + 1).ptr;
+            const size_t digits = static_cast<size_t>(numberEnd - number);
+
+            *ptr++ = ' ';
+            std::memcpy(ptr, number, digits);
+            ptr += digits;
+            if (layout.hasUVs || layout.hasNormals) {
+                *ptr++ = '/';
+                if (layout.hasUVs) {
+                    std::memcpy(ptr, number, digits);
+                    ptr += digits;
+                }
+                if (layout.hasNormals) {
+                    *ptr++ = '/';
+                    std::memcpy(ptr, number, digits);
+                    ptr += digits;
+                }
+            }
+        }
+        *ptr++ = '\n';
+    }
+    text.resize(static_cast<size_t>(ptr - text.data()));
+}
+
+/**
+ * Encode the mesh window by window, passing each finished block to sink in
+ * file order. Stops early if the sink fails.
+ */
+Result<bool> encodeOBJ(const MeshData& mesh, int numThreads,
+                       const std::function<bool(const std::string&)>& sink) {
+    auto layout = layoutOf(mesh);
+    if (!layout.success) {
+        return Result<bool>::error(layout.errorCode, layout.errorMessage);
+    }
+    const OBJLayout& l = layout.value;
+
+    if (!sink(OBJ_HEADER_TEXT)) {
+        return Result<bool>::error("IO_ERROR", "Failed to write OBJ data");
+    }
+
+    const int threads = parallel::resolveThreadCount(numThreads);
+    const size_t totalBlocks = l.vertexBlocks + l.faceBlocks;
+    const size_t window = static_cast<size_t>(threads) * OBJ_BLOCKS_PER_THREAD;
+    std::vector<std::string> blocks(std::min(window, totalBlocks));
+
+    for (size_t first = 0; first < totalBlocks; first += window) {
+        const size_t count = std::min(window, totalBlocks - first);
+        parallel::forEachIndex(count, threads, [&](size_t k) {
+            const size_t b = first + k;
+            if (b < l.vertexBlocks) {
+                size_t begin = b * OBJ_WRITE_BLOCK;
+                encodeVertices(mesh, l, begin, std::min(begin + OBJ_WRITE_BLOCK, l.vertexCount), blocks[k]);
+            } else {
+                size_t begin = (b - l.vertexBlocks) * OBJ_WRITE_BLOCK;
+                encodeFaces(mesh, l, begin, std::min(begin + OBJ_WRITE_BLOCK, l.triangleCount), blocks[k]);
+            }
+        });
+        for (size_t k = 0; k < count; ++k) {
+            if (!sink(blocks[k])) {
+                return Result<bool>::error("IO_ERROR", "Failed to write OBJ data");
+            }
+        }
+    }
+    return Result<bool>::ok(true);
+}
+
+}  // namespace
+
+/**
+ * @brief Encode OBJ text into a string
+ */
+Result<bool> writeOBJToString(const MeshData& mesh, std::string& out, int numThreads) {
+    out.clear();
+    auto encoded = encodeOBJ(mesh, numThreads, [&](const std::string& block) {
+        out += block;
+        return true;
+    });
+    if (!encoded.success) {
+        out.clear();
+    }
+    return encoded;
+}
+
+/**
+ * @brief Write mesh to OBJ file
+ */
+Result<bool> writeOBJ(const MeshData& mesh, const std::string& filepath, int numThreads) {
+    std::ofstream file(filepath, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        return Result<bool>::error("IO_ERROR", "Failed to create file: " + filepath);
+    }
+
+    auto encoded = encodeOBJ(mesh, numThreads, [&](const std::string& block) {
+        file.write(block.data(), static_cast<std::streamsize>(block.size()));
+        return static_cast<bool>(file);
+    });
+    if (!encoded.success) {
+        return encoded;
+    }
+
+    file.close();
+    if (!file) {
+        return Result<bool>::error("IO_ERROR", "Failed to write file: " + filepath);
+    }
+    return Result<bool>::ok(true);
+}
+
+}  // namespace madfam::geom::io
@@ -3,11 +3,12 @@
  * @brief STL file reader (binary and ASCII)
  */
 
-#include "geom-core/cad/Types.hpp"
-#include <fstream>
-#include <sstream>
+#include "geom-core/io/STLIO.hpp"
+#include "ASCIISTLParser.hpp"
+#include "../MappedFile.hpp"
 #include <cstring>
 #include <algorithm>
+#include <string>
 
 namespace madfam::geom::io {
 
@@ -15,117 +16,108 @@ using namespace madfam::geom::cad;
 
 namespace {
 
-// Check if file is binary STL
-bool isBinarySTL(std::ifstream& file) {
-    char header[80];
-    file.read(header, 80);
+// Binary STL: 80-byte header + 4-byte count + 50 bytes per triangle
+const size_t STL_HEADER_BYTES = 84;
+const size_t STL_RECORD_BYTES = 50;
 
-    uint32_t numTriangles;
-    file.read(reinterpret_cast<char*>(&numTriangles), 4);
-
-    // Check if file size matches expected binary size
-    file.seekg(0, std::ios::end);
-    auto fileSize = file.tellg();
-    file.seekg(0, std::ios::beg);
-
-    // Binary STL: 80 byte header + 4 byte count + (50 bytes * triangles)
-    auto expectedSize = 84 + (numTriangles * 50);
-    return static_cast<size_t>(fileSize) == expectedSize;
-}
+// Triangles decoded per block; a block's records and outputs stay in L1/L2
+const size_t STL_DECODE_BLOCK = 256;
 
-Result<MeshData> readBinarySTL(std::ifstream& file) {
-    MeshData mesh;
-
-    // Skip header
-    file.seekg(80);
+Result<MeshData> readBinarySTL(const char* data, size_t size) {
+    if (size < STL_HEADER_BYTES) {
+        return Result<MeshData>::error("INVALID_DATA", "STL data too small");
+    }
 
-    // Read triangle count
     uint32_t numTriangles;
-    file.read(reinterpret_cast<char*>(&numTriangles), 4);
-
-    // Pre-allocate
-    mesh.reserve(numTriangles * 3, numTriangles);
-
-    // Read triangles
-    for (uint32_t i = 0; i < numTriangles; ++i) {
-        // Normal (we'll recompute)
-        float normal[3];
-        file.read(reinterpret_cast<char*>(normal), 12);
-
-        // Vertices
-        for (int v = 0; v < 3; ++v) {
-            float vertex[3];
-            file.read(reinterpret_cast<char*>(vertex), 12);
-
-            mesh.positions.push_back(vertex[0]);
-            mesh.positions.push_back(vertex[1]);
-            mesh.positions.push_back(vertex[2]);
-
-            mesh.normals.push_back(normal[0]);
-            mesh.normals.push_back(normal[1]);
-            mesh.normals.push_back(normal[2]);
+    std::memcpy(&numTriangles, data + 80, 4);
+
+    // 64-bit arithmetic: numTriangles * 50 overflows 32 bits past ~86M triangles
+    const size_t triangleCount = numTriangles;
+    const size_t expectedSize = STL_HEADER_BYTES + triangleCount * STL_RECORD_BYTES;
+    if (size < expectedSize) {
+        return Result<MeshData>::error("INVALID_DATA",
+            "STL data truncated: expected " + std::to_string(expectedSize) +
+            " bytes, got " + std::to_string(size));
+    }
 
-            mesh.indices.push_back(i * 3 + v);
+    // Exact-size outputs, written through raw pointers (no push_back)
+    MeshData mesh;
+    mesh.positions.resize(triangleCount * 9);
+    mesh.normals.resize(triangleCount * 9);
+    mesh.indices.resize(triangleCount * 3);
+
+    const char* records = data + STL_HEADER_BYTES;
+    float* positions = mesh.positions.data();
+    float* normals = mesh.normals.data();
+    uint32_t* indices = mesh.indices.data();
+
+    for (size_t first = 0; first < triangleCount; first += STL_DECODE_BLOCK) {
+        const size_t last = std::min(first + STL_DECODE_BLOCK, triangleCount);
+
+        // Records are packed (50 bytes, unaligned): normal[3], vertices[9], attribute
+        for (size_t i = first; i < last; ++i) {
+            const char* record = records + i * STL_RECORD_BYTES;
+            std::memcpy(positions + i * 9, record + 12, 36);
+
+            float normal[3];
+            std::memcpy(normal, record, 12);
+            float* out = normals + i * 9;
+            for (int v = 0; v < 3; ++v) {
+                out[v * 3 + 0] = normal[0];
+                out[v * 3 + 1] = normal[1];
+                out[v * 3 + 2] = normal[2];
+            }
         }
 
-        // Attribute byte count (ignored)
-        uint16_t attr;
-        file.read(reinterpret_cast<char*>(&attr), 2);
+        for (size_t k = first * 3; k < last * 3; ++k) {
+            indices[k] = static_cast<uint32_t>(k);
+        }
     }
 
-    mesh.vertexCount = numTriangles * 3;
-    mesh.triangleCount = numTriangles;
-    mesh.computeByteSize();
-
     return Result<MeshData>::ok(std::move(mesh));
 }
 
-Result<MeshData> readASCIISTL(std::ifstream& file) {
+Result<MeshData> readASCIISTL(const char* data, size_t size, bool& empty) {
     MeshData mesh;
-    std::string line;
-
-    while (std::getline(file, line)) {
-        std::istringstream iss(line);
-        std::string keyword;
-        iss >> keyword;
-
-        if (keyword == "facet") {
-            // Read normal
-            std::string normalKeyword;
-            float nx, ny, nz;
-            iss >> normalKeyword >> nx >> ny >> nz;
-
-            // Read vertices
-            std::getline(file, line); // outer loop
 
-            for (int v = 0; v < 3; ++v) {
-                std::getline(file, line);
-                std::istringstream viss(line);
-                std::string vertexKeyword;
-                float x, y, z;
-                viss >> vertexKeyword >> x >> y >> z;
+    // ~250 bytes of text per facet in typical exporters
+    size_t estimate = size / 250 + 1;
+    mesh.positions.reserve(estimate * 9);
+    mesh.normals.reserve(estimate * 9);
+    mesh.indices.reserve(estimate * 3);
 
-                mesh.positions.push_back(x);
-                mesh.positions.push_back(y);
-                mesh.positions.push_back(z);
+    std::string error;
+    bool ok = parseASCIISTL(data, size, [&](const float* normal, const float* vertices) {
+        for (int v = 0; v < 3; ++v) {
+            mesh.positions.insert(mesh.positions.end(), vertices + v * 3, vertices + v * 3 + 3);
+            mesh.normals.insert(mesh.normals.end(), normal, normal + 3);
+            mesh.indices.push_back(static_cast<uint32_t>(mesh.indices.size()));
+        }
+    }, error);
 
-                mesh.normals.push_back(nx);
-                mesh.normals.push_back(ny);
-                mesh.normals.push_back(nz);
+    empty = mesh.indices.empty();
+    if (!ok) {
+        return Result<MeshData>::error("PARSE_ERROR", "Invalid ASCII STL: " + error);
+    }
 
-                mesh.indices.push_back(static_cast<uint32_t>(mesh.indices.size()));
-            }
+    return Result<MeshData>::ok(std::move(mesh));
+}
 
-            std::getline(file, line); // endloop
-            std::getline(file, line); // endfacet
+/**
+ * @brief Text first for "solid" buffers, binary when that fails or finds no facets
+ *
+ * Binary files may carry "solid" headers and trailing bytes, so a failed or
+ * empty text parse of a buffer that fits its binary count is read as binary.
+ */
+Result<MeshData> readAnySTL(const char* data, size_t size) {
+    if (isASCIISTL(data, size)) {
+        bool empty = true;
+        Result<MeshData> text = readASCIISTL(data, size, empty);
+        if (!fitsBinarySTL(data, size) || (text.success && !empty)) {
+            return text;
         }
     }
-
-    mesh.vertexCount = static_cast<uint32_t>(mesh.positions.size() / 3);
-    mesh.triangleCount = mesh.vertexCount / 3;
-    mesh.computeByteSize();
-
-    return Result<MeshData>::ok(std::move(mesh));
+    return readBinarySTL(data, size);
 }
 
 }  // namespace
@@ -134,85 +126,21 @@ Result<MeshData> readASCIISTL(std::ifstream& file) {
  * @brief Read STL file (auto-detects binary vs ASCII)
  */
 Result<MeshData> readSTL(const std::string& filepath) {
-    std::ifstream file(filepath, std::ios::binary);
-    if (!file.is_open()) {
-        return Result<MeshData>::fail("IO_ERROR", "Failed to open file: " + filepath);
+    // One mapping (or one bulk read where mmap is unavailable) for either format
+    MappedFile file;
+    if (!file.open(filepath)) {
+        return Result<MeshData>::error("IO_ERROR", "Failed to open file: " + filepath);
     }
+    file.adviseSequential();
 
-    if (isBinarySTL(file)) {
-        file.seekg(0);
-        return readBinarySTL(file);
-    } else {
-        file.close();
-        file.open(filepath);
-        return readASCIISTL(file);
-    }
+    return readAnySTL(file.data(), file.size());
 }
 
 /**
  * @brief Read STL from memory buffer
  */
 Result<MeshData> readSTLFromMemory(const uint8_t* data, size_t size) {
-    if (size < 84) {
-        return Result<MeshData>::fail("INVALID_DATA", "STL data too small");
-    }
-
-    // Check for ASCII
-    const char* header = reinterpret_cast<const char*>(data);
-    if (strncmp(header, "solid", 5) == 0) {
-        // Might be ASCII, but could also be binary with "solid" in header
-        uint32_t numTriangles;
-        memcpy(&numTriangles, data + 80, 4);
-        auto expectedSize = 84 + (numTriangles * 50);
-
-        if (size != expectedSize) {
-            // Treat as ASCII
-            std::string str(reinterpret_cast<const char*>(data), size);
-            std::istringstream stream(str);
-            // Parse ASCII... (simplified, use file version for production)
-            return Result<MeshData>::fail("NOT_IMPLEMENTED", "ASCII STL from memory not yet implemented");
-        }
-    }
-
-    // Binary STL
-    MeshData mesh;
-
-    uint32_t numTriangles;
-    memcpy(&numTriangles, data + 80, 4);
-
-    mesh.reserve(numTriangles * 3, numTriangles);
-
-    const uint8_t* ptr = data + 84;
-
-    for (uint32_t i = 0; i < numTriangles; ++i) {
-        float normal[3];
-        memcpy(normal, ptr, 12);
-        ptr += 12;
-
-        for (int v = 0; v < 3; ++v) {
-            float vertex[3];
-            memcpy(vertex, ptr, 12);
-            ptr += 12;
-
-            mesh.positions.push_back(vertex[0]);
-            mesh.positions.push_back(vertex[1]);
-            mesh.positions.push_back(vertex[2]);
-
-            mesh.normals.push_back(normal[0]);
-            mesh.normals.push_back(normal[1]);
-            mesh.normals.push_back(normal[2]);
-
-            mesh.indices.push_back(i * 3 + v);
-        }
-
-        ptr += 2; // Skip attribute
-    }
-
-    mesh.vertexCount = numTriangles * 3;
-    mesh.triangleCount = numTriangles;
-    mesh.computeByteSize();
-
-    return Result<MeshData>::ok(std::move(mesh));
+    return readAnySTL(reinterpret_cast<const char*>(data), size);
 }
 
 }  // namespace madfam::geom::io
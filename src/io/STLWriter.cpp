@@ -1,12 +1,28 @@
 /**
  * @file STLWriter.cpp
  * @brief STL file writer (binary and ASCII)
+ *
+ * Output is built in memory in parallel blocks (face normals included) and
+ * handed to the OS in a single write()/writev(), instead of one stream
+ * write per float.
  */
 
-#include "geom-core/cad/Types.hpp"
-#include <fstream>
-#include <cstring>
+#include "geom-core/io/STLIO.hpp"
+#include "../Parallel.hpp"
+#include <atomic>
+#include <charconv>
 #include <cmath>
+#include <cstring>
+#include <fstream>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define GC_HAVE_POSIX_IO 1
+#include <cerrno>
+#include <climits>
+#include <fcntl.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
 
 namespace madfam::geom::io {
 
@@ -14,6 +30,14 @@ using namespace madfam::geom::cad;
 
 namespace {
 
+const size_t STL_HEADER_BYTES = 84;
+const size_t STL_RECORD_BYTES = 50;
+
+// Triangles per parallel work item
+const size_t STL_WRITE_BLOCK = 4096;
+
+const char STL_HEADER_TEXT[] = "Binary STL generated by geom-core";
+
 // Compute face normal from triangle vertices
 void computeFaceNormal(const float* v0, const float* v1, const float* v2,
                         float& nx, float& ny, float& nz) {
@@ -40,171 +64,343 @@ void computeFaceNormal(const float* v0, const float* v1, const float* v2,
     }
 }
 
-}  // namespace
+// Fetch a triangle's corner positions; false if an index is out of range
+bool triangleCorners(const MeshData& mesh, size_t triangle, const float* corners[3]) {
+    const size_t vertexCount = mesh.vertexCount();
+    for (int j = 0; j < 3; ++j) {
+        uint32_t index = mesh.indices[triangle * 3 + j];
+        if (index >= vertexCount) {
+            return false;
+        }
+        corners[j] = &mesh.positions[static_cast<size_t>(index) * 3];
+    }
+    return true;
+}
+
+Result<bool> validateMesh(const MeshData& mesh) {
+    if (mesh.indices.size() % 3 != 0 || mesh.positions.size() % 3 != 0) {
+        return Result<bool>::error("INVALID_DATA", "Mesh arrays are not multiples of 3");
+    }
+    if (mesh.triangleCount() > UINT32_MAX) {
+        return Result<bool>::error("INVALID_DATA", "Too many triangles for binary STL");
+    }
+    return Result<bool>::ok(true);
+}
 
 /**
- * @brief Write mesh to binary STL file
+ * Encode the whole binary STL image into out (binarySTLSize bytes).
+ * Each block writes its own fixed-offset records, so no merge step.
  */
-Result<bool> writeSTL(const MeshData& mesh, const std::string& filepath, bool binary) {
-    if (binary) {
-        std::ofstream file(filepath, std::ios::binary);
-        if (!file.is_open()) {
-            return Result<bool>::fail("IO_ERROR", "Failed to create file: " + filepath);
-        }
+Result<bool> encodeBinary(const MeshData& mesh, char* out, int numThreads) {
+    auto valid = validateMesh(mesh);
+    if (!valid.success) {
+        return valid;
+    }
 
-        // Header (80 bytes)
-        char header[80] = {};
-        strncpy(header, "Binary STL generated by geom-core", 79);
-        file.write(header, 80);
-
-        // Triangle count
-        uint32_t numTriangles = mesh.triangleCount;
-        file.write(reinterpret_cast<const char*>(&numTriangles), 4);
-
-        // Write triangles
-        for (uint32_t i = 0; i < mesh.triangleCount; ++i) {
-            uint32_t i0 = mesh.indices[i * 3 + 0];
-            uint32_t i1 = mesh.indices[i * 3 + 1];
-            uint32_t i2 = mesh.indices[i * 3 + 2];
-
-            const float* v0 = &mesh.positions[i0 * 3];
-            const float* v1 = &mesh.positions[i1 * 3];
-            const float* v2 = &mesh.positions[i2 * 3];
-
-            // Compute face normal
-            float nx, ny, nz;
-            computeFaceNormal(v0, v1, v2, nx, ny, nz);
-
-            // Write normal
-            file.write(reinterpret_cast<const char*>(&nx), 4);
-            file.write(reinterpret_cast<const char*>(&ny), 4);
-            file.write(reinterpret_cast<const char*>(&nz), 4);
-
-            // Write vertices
-            file.write(reinterpret_cast<const char*>(v0), 12);
-            file.write(reinterpret_cast<const char*>(v1), 12);
-            file.write(reinterpret_cast<const char*>(v2), 12);
-
-            // Attribute byte count
-            uint16_t attr = 0;
-            file.write(reinterpret_cast<const char*>(&attr), 2);
-        }
+    const size_t triangleCount = mesh.triangleCount();
 
-        return Result<bool>::ok(true);
-    } else {
-        // ASCII STL
-        std::ofstream file(filepath);
-        if (!file.is_open()) {
-            return Result<bool>::fail("IO_ERROR", "Failed to create file: " + filepath);
-        }
+    std::memset(out, 0, 80);
+    std::memcpy(out, STL_HEADER_TEXT, sizeof(STL_HEADER_TEXT) - 1);
+    uint32_t count = static_cast<uint32_t>(triangleCount);
+    std::memcpy(out + 80, &count, 4);
 
-        file << "solid geom-core\n";
+    std::atomic<bool> badIndex{false};
+    char* records = out + STL_HEADER_BYTES;
 
-        for (uint32_t i = 0; i < mesh.triangleCount; ++i) {
-            uint32_t i0 = mesh.indices[i * 3 + 0];
-            uint32_t i1 = mesh.indices[i * 3 + 1];
-            uint32_t i2 = mesh.indices[i * 3 + 2];
+    parallel::forEachBlock(triangleCount, parallel::resolveThreadCount(numThreads), STL_WRITE_BLOCK,
+                           [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            char* record = records + i * STL_RECORD_BYTES;
 
-            const float* v0 = &mesh.positions[i0 * 3];
-            const float* v1 = &mesh.positions[i1 * 3];
-            const float* v2 = &mesh.positions[i2 * 3];
+            const float* v[3];
+            if (!triangleCorners(mesh, i, v)) {
+                badIndex.store(true, std::memory_order_relaxed);
+                std::memset(record, 0, STL_RECORD_BYTES);
+                continue;
+            }
 
-            float nx, ny, nz;
-            computeFaceNormal(v0, v1, v2, nx, ny, nz);
+            float normal[3];
+            computeFaceNormal(v[0], v[1], v[2], normal[0], normal[1], normal[2]);
 
-            file << "  facet normal " << nx << " " << ny << " " << nz << "\n";
-            file << "    outer loop\n";
-            file << "      vertex " << v0[0] << " " << v0[1] << " " << v0[2] << "\n";
-            file << "      vertex " << v1[0] << " " << v1[1] << " " << v1[2] << "\n";
-            file << "      vertex " << v2[0] << " " << v2[1] << " " << v2[2] << "\n";
-            file << "    endloop\n";
-            file << "  endfacet\n";
+            std::memcpy(record, normal, 12);
+            std::memcpy(record + 12, v[0], 12);
+            std::memcpy(record + 24, v[1], 12);
+            std::memcpy(record + 36, v[2], 12);
+            std::memset(record + 48, 0, 2);  // Attribute byte count
         }
+    });
 
-        file << "endsolid geom-core\n";
-
-        return Result<bool>::ok(true);
+    if (badIndex.load()) {
+        return Result<bool>::error("INVALID_DATA", "Triangle index out of range");
     }
+    return Result<bool>::ok(true);
 }
 
 /**
- * @brief Write mesh to STL in memory buffer
+ * Format ASCII STL into one string per block (in parallel). Floats use the
+ * shortest representation that reads back to the same value.
  */
-Result<std::vector<uint8_t>> writeSTLToMemory(const MeshData& mesh, bool binary) {
-    std::vector<uint8_t> buffer;
+Result<std::vector<std::string>> encodeASCII(const MeshData& mesh, int numThreads) {
+    auto valid = validateMesh(mesh);
+    if (!valid.success) {
+        return Result<std::vector<std::string>>::error(valid.errorCode, valid.errorMessage);
+    }
 
-    if (binary) {
-        // Calculate size: 80 header + 4 count + 50 per triangle
-        size_t size = 84 + mesh.triangleCount * 50;
-        buffer.resize(size);
+    const size_t triangleCount = mesh.triangleCount();
+    const size_t blockCount = (triangleCount + STL_WRITE_BLOCK - 1) / STL_WRITE_BLOCK;
+
+    // Header and footer travel as the first and last block
+    std::vector<std::string> blocks(blockCount + 2);
+    blocks.front() = "solid geom-core\n";
+    blocks.back() = "endsolid geom-core\n";
+
+    std::atomic<bool> badIndex{false};
+
+    parallel::forEachIndex(blockCount, parallel::resolveThreadCount(numThreads), [&](size_t b) {
+        const size_t begin = b * STL_WRITE_BLOCK;
+        const size_t end = std::min(begin + STL_WRITE_BLOCK, triangleCount);
+
+        // Worst case per facet: 12 floats of <= 16 chars plus keywords
+        std::string& text = blocks[b + 1];
+        text.resize((end - begin) * 320);
+        char* ptr = text.data();
+        char* const limit = ptr + text.size();
+
+        auto put = [&](const char* literal, size_t length) {
+            std::memcpy(ptr, literal, length);
+            ptr += length;
+        };
+        auto putFloats = [&](const float* values) {
+            for (int k = 0; k < 3; ++k) {
+                *ptr++ = ' ';
+                ptr = std::to_chars(ptr, limit, values[k]).ptr;
+            }
+            *ptr++ = '\n';
+        };
+
+        for (size_t i = begin; i < end; ++i) {
+            const float* v[3];
+            if (!triangleCorners(mesh, i, v)) {
+                badIndex.store(true, std::memory_order_relaxed);
+                continue;
+            }
+
+            float normal[3];
+            computeFaceNormal(v[0], v[1], v[2], normal[0], normal[1], normal[2]);
+
+            put("  facet normal", 14);
+            putFloats(normal);
+            put("    outer loop\n", 15);
+            for (int j = 0; j < 3; ++j) {
+                put("      vertex", 12);
+                putFloats(v[j]);
+            }
+            put("    endloop\n  endfacet\n", 23);
+        }
 
-        uint8_t* ptr = buffer.data();
+        text.resize(static_cast<size_t>(ptr - text.data()));
+    });
 
-        // Header
-        memset(ptr, 0, 80);
-        strncpy(reinterpret_cast<char*>(ptr), "Binary STL generated by geom-core", 79);
-        ptr += 80;
+    if (badIndex.load()) {
+        return Result<std::vector<std::string>>::error("INVALID_DATA", "Triangle index out of range");
+    }
+    return Result<std::vector<std::string>>::ok(std::move(blocks));
+}
 
-        // Triangle count
-        memcpy(ptr, &mesh.triangleCount, 4);
-        ptr += 4;
+#ifdef GC_HAVE_POSIX_IO
+// write() until everything is out (handles short writes and EINTR)
+bool writeAll(int fd, const char* data, size_t size) {
+    while (size > 0) {
+        ssize_t written = ::write(fd, data, size);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        data += written;
+        size -= static_cast<size_t>(written);
+    }
+    return true;
+}
 
-        // Triangles
-        for (uint32_t i = 0; i < mesh.triangleCount; ++i) {
-            uint32_t i0 = mesh.indices[i * 3 + 0];
-            uint32_t i1 = mesh.indices[i * 3 + 1];
-            uint32_t i2 = mesh.indices[i * 3 + 2];
+// writev() the blocks, at most IOV_MAX at a time, resuming after short writes
+bool writeAllBlocks(int fd, const std::vector<std::string>& blocks) {
+    std::vector<struct iovec> iov;
+    iov.reserve(blocks.size());
+    for (const auto& block : blocks) {
+        if (!block.empty()) {
+            iov.push_back({const_cast<char*>(block.data()), block.size()});
+        }
+    }
 
-            const float* v0 = &mesh.positions[i0 * 3];
-            const float* v1 = &mesh.positions[i1 * 3];
-            const float* v2 = &mesh.positions[i2 * 3];
+    size_t next = 0;
+    while (next < iov.size()) {
+        int batch = static_cast<int>(std::min<size_t>(iov.size() - next, IOV_MAX));
+        ssize_t written = ::writev(fd, &iov[next], batch);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
 
-            float nx, ny, nz;
-            computeFaceNormal(v0, v1, v2, nx, ny, nz);
+        // Skip fully written vectors; trim a partially written one
+        size_t remaining = static_cast<size_t>(written);
+        while (next < iov.size() && remaining >= iov[next].iov_len) {
+            remaining -= iov[next].iov_len;
+            ++next;
+        }
+        if (remaining > 0) {
+            iov[next].iov_base = static_cast<char*>(iov[next].iov_base) + remaining;
+            iov[next].iov_len -= remaining;
+        }
+    }
+    return true;
+}
+#endif
 
-            memcpy(ptr, &nx, 4); ptr += 4;
-            memcpy(ptr, &ny, 4); ptr += 4;
-            memcpy(ptr, &nz, 4); ptr += 4;
+}  // namespace
 
-            memcpy(ptr, v0, 12); ptr += 12;
-            memcpy(ptr, v1, 12); ptr += 12;
-            memcpy(ptr, v2, 12); ptr += 12;
+/**
+ * @brief Exact size of the binary STL encoding of mesh
+ */
+size_t binarySTLSize(const MeshData& mesh) {
+    return STL_HEADER_BYTES + mesh.triangleCount() * STL_RECORD_BYTES;
+}
 
-            uint16_t attr = 0;
-            memcpy(ptr, &attr, 2); ptr += 2;
+/**
+ * @brief Encode binary STL into a caller-provided buffer
+ */
+Result<size_t> writeBinarySTLToBuffer(const MeshData& mesh, char* out, size_t capacity, int numThreads) {
+    size_t size = binarySTLSize(mesh);
+    if (capacity < size) {
+        return Result<size_t>::error("BUFFER_TOO_SMALL",
+            "Binary STL needs " + std::to_string(size) + " bytes, buffer has " + std::to_string(capacity));
+    }
+
+    auto encoded = encodeBinary(mesh, out, numThreads);
+    if (!encoded.success) {
+        return Result<size_t>::error(encoded.errorCode, encoded.errorMessage);
+    }
+    return Result<size_t>::ok(std::move(size));
+}
+
+/**
+ * @brief Encode STL into a string (binary or ASCII)
+ */
+Result<bool> writeSTLToString(const MeshData& mesh, std::string& out, bool binary, int numThreads) {
+    if (binary) {
+        out.resize(binarySTLSize(mesh));
+        auto encoded = encodeBinary(mesh, out.data(), numThreads);
+        if (!encoded.success) {
+            out.clear();
         }
-    } else {
-        // ASCII - use string stream
-        std::ostringstream ss;
-        ss << "solid geom-core\n";
-
-        for (uint32_t i = 0; i < mesh.triangleCount; ++i) {
-            uint32_t i0 = mesh.indices[i * 3 + 0];
-            uint32_t i1 = mesh.indices[i * 3 + 1];
-            uint32_t i2 = mesh.indices[i * 3 + 2];
-
-            const float* v0 = &mesh.positions[i0 * 3];
-            const float* v1 = &mesh.positions[i1 * 3];
-            const float* v2 = &mesh.positions[i2 * 3];
-
-            float nx, ny, nz;
-            computeFaceNormal(v0, v1, v2, nx, ny, nz);
-
-            ss << "  facet normal " << nx << " " << ny << " " << nz << "\n";
-            ss << "    outer loop\n";
-            ss << "      vertex " << v0[0] << " " << v0[1] << " " << v0[2] << "\n";
-            ss << "      vertex " << v1[0] << " " << v1[1] << " " << v1[2] << "\n";
-            ss << "      vertex " << v2[0] << " " << v2[1] << " " << v2[2] << "\n";
-            ss << "    endloop\n";
-            ss << "  endfacet\n";
+        return encoded;
+    }
+
+    auto blocks = encodeASCII(mesh, numThreads);
+    if (!blocks.success) {
+        return Result<bool>::error(blocks.errorCode, blocks.errorMessage);
+    }
+
+    size_t total = 0;
+    for (const auto& block : blocks.value) {
+        total += block.size();
+    }
+    out.clear();
+    out.reserve(total);
+    for (const auto& block : blocks.value) {
+        out += block;
+    }
+    return Result<bool>::ok(true);
+}
+
+/**
+ * @brief Write STL to an open file descriptor in one write()/writev()
+ */
+Result<bool> writeSTLToFd(const MeshData& mesh, int fd, bool binary, int numThreads) {
+#ifdef GC_HAVE_POSIX_IO
+    if (binary) {
+        std::string buffer;
+        auto encoded = writeSTLToString(mesh, buffer, true, numThreads);
+        if (!encoded.success) {
+            return encoded;
+        }
+        if (!writeAll(fd, buffer.data(), buffer.size())) {
+            return Result<bool>::error("IO_ERROR", std::string("write failed: ") + std::strerror(errno));
         }
+        return Result<bool>::ok(true);
+    }
 
-        ss << "endsolid geom-core\n";
+    // ASCII blocks go out with writev, skipping the concatenation copy
+    auto blocks = encodeASCII(mesh, numThreads);
+    if (!blocks.success) {
+        return Result<bool>::error(blocks.errorCode, blocks.errorMessage);
+    }
+    if (!writeAllBlocks(fd, blocks.value)) {
+        return Result<bool>::error("IO_ERROR", std::string("writev failed: ") + std::strerror(errno));
+    }
+    return Result<bool>::ok(true);
+#else
+    (void)mesh;
+    (void)fd;
+    (void)binary;
+    (void)numThreads;
+    return Result<bool>::error("NOT_SUPPORTED", "File descriptor output requires POSIX");
+#endif
+}
+
+/**
+ * @brief Write mesh to STL file (binary or ASCII)
+ */
+Result<bool> writeSTL(const MeshData& mesh, const std::string& filepath, bool binary, int numThreads) {
+#ifdef GC_HAVE_POSIX_IO
+    int fd = ::open(filepath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        return Result<bool>::error("IO_ERROR", "Failed to create file: " + filepath);
+    }
+
+    auto result = writeSTLToFd(mesh, fd, binary, numThreads);
+    if (::close(fd) != 0 && result.success) {
+        return Result<bool>::error("IO_ERROR", "Failed to close file: " + filepath);
+    }
+    return result;
+#else
+    std::string buffer;
+    auto encoded = writeSTLToString(mesh, buffer, binary, numThreads);
+    if (!encoded.success) {
+        return encoded;
+    }
+
+    std::ofstream file(filepath, std::ios::binary);
+    if (!file.is_open()) {
+        return Result<bool>::error("IO_ERROR", "Failed to create file: " + filepath);
+    }
+    if (!file.write(buffer.data(), static_cast<std::streamsize>(buffer.size()))) {
+        return Result<bool>::error("IO_ERROR", "Failed to write file: " + filepath);
+    }
+    return Result<bool>::ok(true);
+#endif
+}
 
-        std::string str = ss.str();
-        buffer.assign(str.begin(), str.end());
+/**
+ * @brief Write mesh to STL in memory buffer
+ */
+Result<std::vector<uint8_t>> writeSTLToMemory(const MeshData& mesh, bool binary, int numThreads) {
+    std::vector<uint8_t> buffer;
+
+    if (binary) {
+        buffer.resize(binarySTLSize(mesh));
+        auto encoded = encodeBinary(mesh, reinterpret_cast<char*>(buffer.data()), numThreads);
+        if (!encoded.success) {
+            return Result<std::vector<uint8_t>>::error(encoded.errorCode, encoded.errorMessage);
+        }
+        return Result<std::vector<uint8_t>>::ok(std::move(buffer));
     }
 
+    std::string text;
+    auto encoded = writeSTLToString(mesh, text, false, numThreads);
+    if (!encoded.success) {
+        return Result<std::vector<uint8_t>>::error(encoded.errorCode, encoded.errorMessage);
+    }
+    buffer.assign(text.begin(), text.end());
     return Result<std::vector<uint8_t>>::ok(std::move(buffer));
 }
 
@@ -0,0 +1,96 @@
+#pragma once
+
+/**
+ * @file ThreeMFModel.hpp
+ * @brief 3MF package decoding shared by io::read3MF and Mesh::loadFrom3MF
+ *
+ * The root model part is inflated chunk by chunk and fed to a streaming XML
+ * scanner that appends <vertex>/<triangle> elements straight into each
+ * object's Vector3/Triangle arrays; no DOM is built. Build items and
+ * components are resolved afterwards by flatten3MFModel.
+ */
+
+#include "geom-core/Mesh.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace madfam::geom::io {
+
+/**
+ * @brief 3MF affine transform "m00 m01 m02 m10 m11 m12 m20 m21 m22 m30 m31 m32"
+ *
+ * Row-vector convention: p' = p * M, with the translation in the last row.
+ */
+struct ThreeMFTransform {
+    double m[12] = {1, 0, 0, 0, 1, 0, 0, 0, 1, 0, 0, 0};
+
+    bool isIdentity() const;
+
+    Vector3 apply(const Vector3& p) const {
+        return Vector3(p.x * m[0] + p.y * m[3] + p.z * m[6] + m[9],
+                       p.x * m[1] + p.y * m[4] + p.z * m[7] + m[10],
+                       p.x * m[2] + p.y * m[5] + p.z * m[8] + m[11]);
+    }
+
+    /**
+     * @brief Determinant of the 3x3 part (negative for mirroring transforms)
+     */
+    double determinant() const {
+        return m[0] * (m[4] * m[8] - m[5] * m[7]) -
+               m[1] * (m[3] * m[8] - m[5] * m[6]) +
+               m[2] * (m[3] * m[7] - m[4] * m[6]);
+    }
+
+    /**
+     * @brief Transform applying this one first, then outer
+     */
+    ThreeMFTransform then(const ThreeMFTransform& outer) const;
+};
+
+struct ThreeMFComponent {
+    uint32_t objectId = 0;
+    ThreeMFTransform transform;
+};
+
+struct ThreeMFObject {
+    uint32_t id = 0;
+    bool isModel = true;                 // type="model" (supports etc. are skipped)
+    std::vector<Vector3> vertices;
+    std::vector<Triangle> triangles;     // Indices into this object's vertices
+    std::vector<ThreeMFComponent> components;
+};
+
+struct ThreeMFBuildItem {
+    uint32_t objectId = 0;
+    ThreeMFTransform transform;
+};
+
+struct ThreeMFModel {
+    double unitScale = 1.0;              // Model units to millimeters
+    std::vector<ThreeMFObject> objects;
+    std::vector<ThreeMFBuildItem> items;
+};
+
+/**
+ * @brief Decode the root model part of a 3MF package held in memory
+ * @param numThreads With more than one (<= 0 = all cores), the model part
+ *        is inflated on a second thread while the XML is scanned
+ * @return false with error set if the package or model is malformed
+ */
+bool read3MFModel(const uint8_t* data, size_t size, ThreeMFModel& model, std::string& error,
+                  int numThreads = 1);
+
+/**
+ * @brief Instantiate the build into one vertex/triangle list (millimeters)
+ *
+ * Each build item (with nested components) is placed with its transform;
+ * objects are not welded to each other. Without build items every model
+ * object not used as a component is emitted. A single untransformed object
+ * is moved, not copied.
+ */
+bool flatten3MFModel(ThreeMFModel&& model, std::vector<Vector3>& vertices,
+                     std::vector<Triangle>& faces, std::string& error);
+
+} // namespace madfam::geom::io
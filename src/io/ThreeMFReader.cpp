@@ -0,0 +1,870 @@
+/**
+ * @file ThreeMFReader.cpp
+ * @brief 3MF reader: ZIP package, streaming model XML scanner, build flattening
+ */
+
+#include "geom-core/io/ThreeMFIO.hpp"
+#include "ThreeMFModel.hpp"
+#include "ZipArchive.hpp"
+#include "../MappedFile.hpp"
+#include <cfloat>
+#include <charconv>
+#include <climits>
+#include <cstring>
+#include <functional>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace madfam::geom::io {
+
+using namespace madfam::geom::cad;
+
+namespace {
+
+const char THREEMF_DEFAULT_MODEL[] = "3D/3dmodel.model";
+const char THREEMF_RELS[] = "_rels/.rels";
+const char THREEMF_MODEL_REL_SUFFIX[] = "/3dmodel";
+
+// Attributes kept per element; further ones are skipped
+const int XML_MAX_ATTRIBUTES = 16;
+
+// Nesting limit for components (also stops reference cycles)
+const int THREEMF_MAX_COMPONENT_DEPTH = 32;
+
+struct XMLAttribute {
+    const char* name;
+    size_t nameLength;
+    const char* value;
+    size_t valueLength;
+};
+
+inline bool isXMLSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+// Drop a namespace prefix ("p:path" -> "path")
+inline void stripPrefix(const char*& name, size_t& length) {
+    const void* colon = std::memchr(name, ':', length);
+    if (colon) {
+        size_t skip = static_cast<size_t>(static_cast<const char*>(colon) - name) + 1;
+        name += skip;
+        length -= skip;
+    }
+}
+
+template<size_t N>
+inline bool nameIs(const char* name, size_t length, const char (&literal)[N]) {
+    return length == N - 1 && std::memcmp(name, literal, N - 1) == 0;
+}
+
+inline void trim(const char*& begin, const char*& end) {
+    while (begin < end && isXMLSpace(*begin)) ++begin;
+    while (end > begin && isXMLSpace(end[-1])) --end;
+}
+
+/**
+ * Plain decimals ("-12.5", "0.031415876") as writers emit them: up to 2^53 in
+ * the digits and 22 fraction digits divide exactly once in double, and that
+ * double rounds to the same float as the text unless it lands on a float
+ * tie. Returns nullptr for anything else (exponents, '+', ties, subnormals)
+ * so the caller falls back to std::from_chars.
+ */
+const char* parseDecimalFloat(const char* p, const char* end, float& value) {
+    static const double POW10[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+                                   1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+    bool negative = p < end && *p == '-';
+    if (negative) ++p;
+    uint64_t mantissa = 0;
+    int digits = 0;
+    int point = -1;
+    for (; p < end; ++p) {
+        unsigned digit = static_cast<unsigned>(*p - '0');
+        if (digit < 10) {
+            mantissa = mantissa * 10 + digit;
+            ++digits;
+        } else if (*p == '.' && point < 0) {
+            point = digits;
+        } else {
+            break;
+        }
+    }
+    int scale = point < 0 ? 0 : digits - point;
+    if (digits == 0 || digits > 19 || mantissa > (uint64_t(1) << 53) || scale > 22 ||
+        (p < end && (*p == 'e' || *p == 'E'))) {
+        return nullptr;
+    }
+    double exact = static_cast<double>(mantissa) / POW10[scale];
+    uint64_t bits;
+    std::memcpy(&bits, &exact, sizeof(bits));
+    // Low 29 bits are what double -> float rounds away; 1 << 28 is a tie
+    if ((exact != 0.0 && exact < FLT_MIN) || (bits & 0x1FFFFFFF) == 0x10000000) {
+        return nullptr;
+    }
+    value = static_cast<float>(negative ? -exact : exact);
+    return p;
+}
+
+// Coordinates are read at single precision, as STL and MeshData store them
+bool parseCoordinate(const XMLAttribute& attribute, float& value) {
+    const char* begin = attribute.value;
+    const char* end = begin + attribute.valueLength;
+    trim(begin, end);
+    if (begin < end && *begin == '+') ++begin;
+    auto result = std::from_chars(begin, end, value);
+    return result.ec == std::errc() && result.ptr == end;
+}
+
+bool parseIndex(const XMLAttribute& attribute, uint32_t& value) {
+    const char* begin = attribute.value;
+    const char* end = begin + attribute.valueLength;
+    trim(begin, end);
+    auto result = std::from_chars(begin, end, value);
+    return result.ec == std::errc() && result.ptr == end;
+}
+
+bool parseTransform(const XMLAttribute& attribute, ThreeMFTransform& transform) {
+    const char* p = attribute.value;
+    const char* end = p + attribute.valueLength;
+    for (double& value : transform.m) {
+        while (p < end && isXMLSpace(*p)) ++p;
+        if (p < end && *p == '+') ++p;
+        auto result = std::from_chars(p, end, value);
+        if (result.ec != std::errc()) {
+            return false;
+        }
+        p = result.ptr;
+    }
+    while (p < end && isXMLSpace(*p)) ++p;
+    return p == end;
+}
+
+bool unitScale(const std::string& unit, double& scale) {
+    static const std::pair<const char*, double> UNITS[] = {
+        {"micron", 0.001}, {"millimeter", 1.0}, {"centimeter", 10.0},
+        {"inch", 25.4}, {"foot", 304.8}, {"meter", 1000.0}};
+    for (const auto& entry : UNITS) {
+        if (unit == entry.first) {
+            scale = entry.second;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Streaming scanner for 3MF model and OPC relationship XML.
+ *
+ * feed() accepts arbitrary chunk boundaries: markup cut off at the end of a
+ * chunk is carried over and completed from the next one. Only the elements
+ * needed for geometry are interpreted; everything else is skipped.
+ */
+class ModelScanner {
+public:
+    // model may be null when scanning a relationships part
+    explicit ModelScanner(ThreeMFModel* target) : model(target) {}
+
+    bool feed(const char* data, size_t size) {
+        const char* p = data;
+        const char* end = data + size;
+
+        // Complete carried-over markup one '>' at a time, then scan in place
+        while (!pending.empty()) {
+            const void* close = std::memchr(p, '>', static_cast<size_t>(end - p));
+            const char* stop = close ? static_cast<const char*>(close) + 1 : end;
+            pending.insert(pending.end(), p, stop);
+            p = stop;
+
+            size_t used = scan(pending.data(), pending.data() + pending.size());
+            if (used == SCAN_FAILED) {
+                return false;
+            }
+            pending.erase(pending.begin(), pending.begin() + static_cast<ptrdiff_t>(used));
+            if (p == end) {
+                return true;
+            }
+        }
+
+        size_t used = scan(p, end);
+        if (used == SCAN_FAILED) {
+            return false;
+        }
+        pending.assign(p + used, end);
+        return true;
+    }
+
+    bool finish() {
+        for (char c : pending) {
+            if (!isXMLSpace(c)) {
+                error = "unexpected end of XML";
+                return false;
+            }
+        }
+        return true;
+    }
+
+    std::string error;
+    std::string modelPath;  // Target of the 3D model relationship (.rels only)
+
+private:
+    static const size_t SCAN_FAILED = static_cast<size_t>(-1);
+
+    /**
+     * Process complete markup in [begin, end). Returns the number of bytes
+     * consumed (stopping before incomplete markup) or SCAN_FAILED.
+     */
+    size_t scan(const char* begin, const char* end) {
+        const char* p = begin;
+        XMLAttribute attributes[XML_MAX_ATTRIBUTES];
+
+        while (true) {
+            const void* open = std::memchr(p, '<', static_cast<size_t>(end - p));
+            if (!open) {
+                return static_cast<size_t>(end - begin);  // Character data is ignored
+            }
+            p = static_cast<const char*>(open);
+            const char* markup = p;
+            if (end - p < 2) {
+                return static_cast<size_t>(markup - begin);
+            }
+
+            if (currentObject && (p[1] == 'v' || p[1] == 't')) {
+                const char* after = p[1] == 'v' ? fastVertex(p, end) : fastTriangle(p, end);
+                if (after) {
+                    p = after;
+                    continue;
+                }
+                if (!error.empty()) {
+                    return SCAN_FAILED;
+                }
+            }
+
+            if (p[1] == '?' || p[1] == '!') {
+                // Declarations, comments, CDATA and DOCTYPE carry no geometry
+                const char* terminator = ">";
+                size_t terminatorLength = 1;
+                if (p[1] == '?') {
+                    terminator = "?>";
+                    terminatorLength = 2;
+                } else if (end - p >= 4 && std::memcmp(p, "<!--", 4) == 0) {
+                    terminator = "-->";
+                    terminatorLength = 3;
+                } else if (end - p < 9) {
+                    return static_cast<size_t>(markup - begin);
+                } else if (std::memcmp(p, "<![CDATA[", 9) == 0) {
+                    terminator = "]]>";
+                    terminatorLength = 3;
+                }
+                const char* found = findText(p + 2, end, terminator, terminatorLength);
+                if (!found) {
+                    return static_cast<size_t>(markup - begin);
+                }
+                p = found + terminatorLength;
+                continue;
+            }
+
+            if (p[1] == '/') {
+                const void* close = std::memchr(p, '>', static_cast<size_t>(end - p));
+                if (!close) {
+                    return static_cast<size_t>(markup - begin);
+                }
+                const char* name = p + 2;
+                const char* nameEnd = name;
+                while (nameEnd < static_cast<const char*>(close) && !isXMLSpace(*nameEnd)) ++nameEnd;
+                size_t length = static_cast<size_t>(nameEnd - name);
+                stripPrefix(name, length);
+                endElement(name, length);
+                p = static_cast<const char*>(close) + 1;
+                continue;
+            }
+
+            // Start tag: name, then quoted attributes, then '>' or '/>'
+            const char* q = p + 1;
+            const char* name = q;
+            while (q < end && !isXMLSpace(*q) && *q != '/' && *q != '>') ++q;
+            if (q == end) {
+                return static_cast<size_t>(markup - begin);
+            }
+            size_t nameLength = static_cast<size_t>(q - name);
+
+            int count = 0;
+            bool selfClosing = false;
+            while (true) {
+                while (q < end && isXMLSpace(*q)) ++q;
+                if (q == end) {
+                    return static_cast<size_t>(markup - begin);
+                }
+                if (*q == '>') {
+                    ++q;
+                    break;
+                }
+                if (*q == '/') {
+                    if (q + 1 == end) {
+                        return static_cast<size_t>(markup - begin);
+                    }
+                    if (q[1] != '>') {
+                        return fail("malformed tag");
+                    }
+                    q += 2;
+                    selfClosing = true;
+                    break;
+                }
+
+                const char* attributeName = q;
+                while (q < end && *q != '=' && !isXMLSpace(*q) && *q != '>' && *q != '/') ++q;
+                const char* attributeNameEnd = q;
+                while (q < end && isXMLSpace(*q)) ++q;
+                if (q == end) {
+                    return static_cast<size_t>(markup - begin);
+                }
+                if (*q != '=') {
+                    return fail("malformed attribute");
+                }
+                ++q;
+                while (q < end && isXMLSpace(*q)) ++q;
+                if (q == end) {
+                    return static_cast<size_t>(markup - begin);
+                }
+                char quote = *q;
+                if (quote != '"' && quote != '\'') {
+                    return fail("unquoted attribute value");
+                }
+                ++q;
+                const void* close = std::memchr(q, quote, static_cast<size_t>(end - q));
+                if (!close) {
+                    return static_cast<size_t>(markup - begin);
+                }
+                if (count < XML_MAX_ATTRIBUTES) {
+                    XMLAttribute& attribute = attributes[count++];
+                    attribute.name = attributeName;
+                    attribute.nameLength = static_cast<size_t>(attributeNameEnd - attributeName);
+                    stripPrefix(attribute.name, attribute.nameLength);
+                    attribute.value = q;
+                    attribute.valueLength = static_cast<size_t>(static_cast<const char*>(close) - q);
+                }
+                q = static_cast<const char*>(close) + 1;
+            }
+
+            stripPrefix(name, nameLength);
+            if (!startElement(name, nameLength, attributes, count, selfClosing)) {
+                return SCAN_FAILED;
+            }
+            p = q;
+        }
+    }
+
+    /**
+     * Fast path for <vertex x="" y="" z=""/> in canonical form (attribute
+     * order, no extra attributes or padding). Returns the end of the element,
+     * or nullptr to fall back to the general parser (including when the
+     * element is cut off at the end of the buffer).
+     */
+    const char* fastVertex(const char* p, const char* end) {
+        if (end - p < 8 || std::memcmp(p, "<vertex", 7) != 0 || !isXMLSpace(p[7])) {
+            return nullptr;
+        }
+        const char* q = p + 8;
+        float c[3];
+        for (int k = 0; k < 3; ++k) {
+            while (q < end && isXMLSpace(*q)) ++q;
+            if (end - q < 3 || q[0] != 'x' + k || q[1] != '=' || q[2] != '"') {
+                return nullptr;
+            }
+            q += 3;
+            const char* parsed = parseDecimalFloat(q, end, c[k]);
+            if (!parsed) {
+                auto result = std::from_chars(q, end, c[k]);
+                parsed = result.ec == std::errc() ? result.ptr : nullptr;
+            }
+            if (!parsed || parsed == end || *parsed != '"') {
+                return nullptr;
+            }
+            q = parsed + 1;
+        }
+        while (q < end && isXMLSpace(*q)) ++q;
+        if (end - q < 2 || q[0] != '/' || q[1] != '>') {
+            return nullptr;
+        }
+        currentObject->vertices.emplace_back(c[0], c[1], c[2]);
+        return q + 2;
+    }
+
+    // Fast path for <triangle v1="" v2="" v3=""/>; see fastVertex
+    const char* fastTriangle(const char* p, const char* end) {
+        if (end - p < 10 || std::memcmp(p, "<triangle", 9) != 0 || !isXMLSpace(p[9])) {
+            return nullptr;
+        }
+        const char* q = p + 10;
+        uint32_t v[3];
+        for (int k = 0; k < 3; ++k) {
+            while (q < end && isXMLSpace(*q)) ++q;
+            if (end - q < 4 || q[0] != 'v' || q[1] != '1' + k || q[2] != '=' || q[3] != '"') {
+                return nullptr;
+            }
+            q += 4;
+            const char* digits = q;
+            uint64_t value = 0;
+            while (q < end && static_cast<unsigned>(*q - '0') < 10 && q - digits < 10) {
+                value = value * 10 + static_cast<unsigned>(*q - '0');
+                ++q;
+            }
+            if (q == digits || q == end || *q != '"' || value > UINT32_MAX) {
+                return nullptr;
+            }
+            v[k] = static_cast<uint32_t>(value);
+            ++q;
+        }
+        while (q < end && isXMLSpace(*q)) ++q;
+        if (end - q < 2 || q[0] != '/' || q[1] != '>') {
+            return nullptr;
+        }
+        return addTriangle(v) ? q + 2 : nullptr;
+    }
+
+    static const char* findText(const char* p, const char* end, const char* text, size_t length) {
+        while (static_cast<size_t>(end - p) >= length) {
+            const void* hit = std::memchr(p, text[0], static_cast<size_t>(end - p) - length + 1);
+            if (!hit) {
+                return nullptr;
+            }
+            p = static_cast<const char*>(hit);
+            if (std::memcmp(p, text, length) == 0) {
+                return p;
+            }
+            ++p;
+        }
+        return nullptr;
+    }
+
+    size_t fail(const std::string& message) {
+        error = message;
+        return SCAN_FAILED;
+    }
+
+    bool failElement(const std::string& message) {
+        error = message;
+        return false;
+    }
+
+    bool startElement(const char* name, size_t length, const XMLAttribute* attributes, int count,
+                      bool selfClosing) {
+        if (!model) {
+            if (nameIs(name, length, "Relationship")) {
+                return relationship(attributes, count);
+            }
+            return true;
+        }
+
+        // Hot path first: one element per vertex and per triangle
+        if (nameIs(name, length, "vertex")) {
+            return vertex(attributes, count);
+        }
+        if (nameIs(name, length, "triangle")) {
+            return triangle(attributes, count);
+        }
+        if (nameIs(name, length, "object")) {
+            return object(attributes, count, selfClosing);
+        }
+        if (nameIs(name, length, "component")) {
+            return component(attributes, count);
+        }
+        if (nameIs(name, length, "item")) {
+            return item(attributes, count);
+        }
+        if (nameIs(name, length, "model")) {
+            return modelElement(attributes, count);
+        }
+        return true;
+    }
+
+    void endElement(const char* name, size_t length) {
+        if (nameIs(name, length, "object")) {
+            currentObject = nullptr;
+        }
+    }
+
+    bool vertex(const XMLAttribute* attributes, int count) {
+        if (!currentObject) {
+            return true;
+        }
+        float c[3];
+        int found = 0;
+        for (int i = 0; i < count; ++i) {
+            const XMLAttribute& a = attributes[i];
+            if (a.nameLength != 1 || a.name[0] < 'x' || a.name[0] > 'z') continue;
+            int k = a.name[0] - 'x';
+            if (!parseCoordinate(a, c[k])) {
+                return failElement("invalid vertex coordinate");
+            }
+            found |= 1 << k;
+        }
+        if (found != 7) {
+            return failElement("vertex without x, y and z");
+        }
+        currentObject->vertices.emplace_back(c[0], c[1], c[2]);
+        return true;
+    }
+
+    bool triangle(const XMLAttribute* attributes, int count) {
+        if (!currentObject) {
+            return true;
+        }
+        uint32_t v[3];
+        int found = 0;
+        for (int i = 0; i < count; ++i) {
+            const XMLAttribute& a = attributes[i];
+            if (a.nameLength != 2 || a.name[0] != 'v' || a.name[1] < '1' || a.name[1] > '3') continue;
+            int k = a.name[1] - '1';
+            if (!parseIndex(a, v[k])) {
+                return failElement("invalid triangle index");
+            }
+            found |= 1 << k;
+        }
+        if (found != 7) {
+            return failElement("triangle without v1, v2 and v3");
+        }
+        return addTriangle(v);
+    }
+
+    bool addTriangle(const uint32_t v[3]) {
+        // Vertices precede triangles within a mesh, so indices can be checked now
+        const size_t vertexCount = currentObject->vertices.size();
+        if (v[0] >= vertexCount || v[1] >= vertexCount || v[2] >= vertexCount) {
+            return failElement("triangle references a missing vertex in object " +
+                               std::to_string(currentObject->id));
+        }
+        currentObject->triangles.emplace_back(static_cast<int>(v[0]), static_cast<int>(v[1]),
+                                              static_cast<int>(v[2]));
+        return true;
+    }
+
+    bool object(const XMLAttribute* attributes, int count, bool selfClosing) {
+        ThreeMFObject object;
+        bool hasId = false;
+        for (int i = 0; i < count; ++i) {
+            const XMLAttribute& a = attributes[i];
+            if (nameIs(a.name, a.nameLength, "id")) {
+                if (!parseIndex(a, object.id)) {
+                    return failElement("invalid object id");
+                }
+                hasId = true;
+            } else if (nameIs(a.name, a.nameLength, "type")) {
+                object.isModel = std::string(a.value, a.valueLength) == "model";
+            }
+        }
+        if (!hasId) {
+            return failElement("object without id");
+        }
+        model->objects.push_back(std::move(object));
+        currentObject = selfClosing ? nullptr : &model->objects.back();
+        return true;
+    }
+
+    // Shared by <component> and <item>: objectid plus optional transform
+    bool reference(const XMLAttribute* attributes, int count, uint32_t& objectId,
+                   ThreeMFTransform& transform, const char* element) {
+        bool hasObject = false;
+        for (int i = 0; i < count; ++i) {
+            const XMLAttribute& a = attributes[i];
+            if (nameIs(a.name, a.nameLength, "objectid")) {
+                if (!parseIndex(a, objectId)) {
+                    return failElement(std::string("invalid objectid in ") + element);
+                }
+                hasObject = true;
+            } else if (nameIs(a.name, a.nameLength, "transform")) {
+                if (!parseTransform(a, transform)) {
+                    return failElement(std::string("invalid transform in ") + element);
+                }
+            } else if (nameIs(a.name, a.nameLength, "path")) {
+                return failElement(std::string("3MF production extension (") + element +
+                                   " in another model part) is not supported");
+            }
+        }
+        if (!hasObject) {
+            return failElement(std::string(element) + " without objectid");
+        }
+        return true;
+    }
+
+    bool component(const XMLAttribute* attributes, int count) {
+        if (!currentObject) {
+            return true;
+        }
+        ThreeMFComponent component;
+        if (!reference(attributes, count, component.objectId, component.transform, "component")) {
+            return false;
+        }
+        currentObject->components.push_back(component);
+        return true;
+    }
+
+    bool item(const XMLAttribute* attributes, int count) {
+        ThreeMFBuildItem item;
+        if (!reference(attributes, count, item.objectId, item.transform, "item")) {
+            return false;
+        }
+        model->items.push_back(item);
+        return true;
+    }
+
+    bool modelElement(const XMLAttribute* attributes, int count) {
+        for (int i = 0; i < count; ++i) {
+            const XMLAttribute& a = attributes[i];
+            if (nameIs(a.name, a.nameLength, "unit")) {
+                std::string unit(a.value, a.valueLength);
+                if (!unitScale(unit, model->unitScale)) {
+                    return failElement("unknown model unit: " + unit);
+                }
+            }
+        }
+        return true;
+    }
+
+    bool relationship(const XMLAttribute* attributes, int count) {
+        std::string type, target;
+        for (int i = 0; i < count; ++i) {
+            const XMLAttribute& a = attributes[i];
+            if (nameIs(a.name, a.nameLength, "Type")) {
+                type.assign(a.value, a.valueLength);
+            } else if (nameIs(a.name, a.nameLength, "Target")) {
+                target.assign(a.value, a.valueLength);
+            }
+        }
+        const size_t suffixLength = sizeof(THREEMF_MODEL_REL_SUFFIX) - 1;
+        if (modelPath.empty() && type.size() >= suffixLength &&
+            type.compare(type.size() - suffixLength, suffixLength, THREEMF_MODEL_REL_SUFFIX) == 0) {
+            modelPath = target;
+        }
+        return true;
+    }
+
+    ThreeMFModel* model;
+    // Open <object>; only a new <object> grows model->objects, and it resets this
+    ThreeMFObject* currentObject = nullptr;
+    std::vector<char> pending;
+};
+
+} // namespace
+
+// ===========================================================================
+// ThreeMFTransform
+// ===========================================================================
+
+bool ThreeMFTransform::isIdentity() const {
+    static const ThreeMFTransform identity;
+    return std::memcmp(m, identity.m, sizeof(m)) == 0;
+}
+
+ThreeMFTransform ThreeMFTransform::then(const ThreeMFTransform& outer) const {
+    // [R t; 0 1] products in row-vector form: rows 0-2 rotate, row 3 translates
+    ThreeMFTransform result;
+    for (int row = 0; row < 4; ++row) {
+        for (int col = 0; col < 3; ++col) {
+            double sum = row == 3 ? outer.m[9 + col] : 0.0;
+            for (int k = 0; k < 3; ++k) {
+                sum += m[row * 3 + k] * outer.m[k * 3 + col];
+            }
+            result.m[row * 3 + col] = sum;
+        }
+    }
+    return result;
+}
+
+// ===========================================================================
+// Package and model decoding
+// ===========================================================================
+
+bool read3MFModel(const uint8_t* data, size_t size, ThreeMFModel& model, std::string& error,
+                  int numThreads) {
+    model = ThreeMFModel();
+
+    ZipReader zip;
+    if (!zip.open(data, size, error)) {
+        return false;
+    }
+
+    // The package relationships name the root model part
+    std::string modelPath = THREEMF_DEFAULT_MODEL;
+    if (const ZipEntry* rels = zip.find(THREEMF_RELS)) {
+        std::string text;
+        if (!zip.readAll(*rels, text, error)) {
+            return false;
+        }
+        ModelScanner relationships(nullptr);
+        if (!relationships.feed(text.data(), text.size()) || !relationships.finish()) {
+            error = "invalid package relationships: " + relationships.error;
+            return false;
+        }
+        if (!relationships.modelPath.empty()) {
+            modelPath = relationships.modelPath;
+        }
+    }
+
+    const ZipEntry* entry = zip.find(modelPath);
+    if (!entry) {
+        error = "3MF package has no model part: " + modelPath;
+        return false;
+    }
+
+    ModelScanner scanner(&model);
+    bool read = zip.read(*entry, [&](const uint8_t* chunk, size_t length) {
+        return scanner.feed(reinterpret_cast<const char*>(chunk), length);
+    }, error, numThreads);
+    if (!read || !scanner.finish()) {
+        if (error.empty()) {
+            error = "invalid 3MF model XML: " + scanner.error;
+        }
+        return false;
+    }
+    return true;
+}
+
+bool flatten3MFModel(ThreeMFModel&& model, std::vector<Vector3>& vertices,
+                     std::vector<Triangle>& faces, std::string& error) {
+    vertices.clear();
+    faces.clear();
+
+    std::unordered_map<uint32_t, size_t> byId;
+    for (size_t i = 0; i < model.objects.size(); ++i) {
+        if (!byId.emplace(model.objects[i].id, i).second) {
+            error = "duplicate object id " + std::to_string(model.objects[i].id);
+            return false;
+        }
+    }
+
+    // Without build items, place every model object that is not a component
+    std::vector<ThreeMFBuildItem> items = model.items;
+    if (items.empty()) {
+        std::unordered_set<uint32_t> used;
+        for (const auto& object : model.objects) {
+            for (const auto& component : object.components) {
+                used.insert(component.objectId);
+            }
+        }
+        for (const auto& object : model.objects) {
+            if (object.isModel && !used.count(object.id)) {
+                ThreeMFBuildItem item;
+                item.objectId = object.id;
+                items.push_back(item);
+            }
+        }
+    }
+
+    ThreeMFTransform units;
+    units.m[0] = units.m[4] = units.m[8] = model.unitScale;
+
+    // Common case: one plain object in millimeters is moved, not copied
+    if (items.size() == 1) {
+        auto found = byId.find(items[0].objectId);
+        if (found != byId.end()) {
+            ThreeMFObject& object = model.objects[found->second];
+            if (object.isModel && object.components.empty() &&
+                items[0].transform.then(units).isIdentity()) {
+                vertices = std::move(object.vertices);
+                faces = std::move(object.triangles);
+                return true;
+            }
+        }
+    }
+
+    std::function<bool(uint32_t, const ThreeMFTransform&, int)> place =
+        [&](uint32_t id, const ThreeMFTransform& placement, int depth) {
+        auto found = byId.find(id);
+        if (found == byId.end()) {
+            error = "reference to unknown object " + std::to_string(id);
+            return false;
+        }
+        if (depth > THREEMF_MAX_COMPONENT_DEPTH) {
+            error = "components nested too deeply (or cyclic) at object " + std::to_string(id);
+            return false;
+        }
+        const ThreeMFObject& object = model.objects[found->second];
+
+        if (vertices.size() + object.vertices.size() > static_cast<size_t>(INT_MAX)) {
+            error = "3MF build has too many vertices";
+            return false;
+        }
+        const int base = static_cast<int>(vertices.size());
+        if (placement.isIdentity()) {
+            vertices.insert(vertices.end(), object.vertices.begin(), object.vertices.end());
+        } else {
+            for (const Vector3& v : object.vertices) {
+                vertices.push_back(placement.apply(v));
+            }
+        }
+        // A mirroring placement turns the surface inside out; reverse the
+        // winding so normals and signed volume stay outward
+        if (placement.determinant() < 0.0) {
+            for (const Triangle& t : object.triangles) {
+                faces.emplace_back(t.v0 + base, t.v2 + base, t.v1 + base);
+            }
+        } else {
+            for (const Triangle& t : object.triangles) {
+                faces.emplace_back(t.v0 + base, t.v1 + base, t.v2 + base);
+            }
+        }
+
+        for (const auto& component : object.components) {
+            if (!place(component.objectId, component.transform.then(placement), depth + 1)) {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    for (const auto& item : items) {
+        auto found = byId.find(item.objectId);
+        if (found != byId.end() && !model.objects[found->second].isModel) {
+            continue;  // Support and other non-model objects are not printed parts
+        }
+        if (!place(item.objectId, item.transform.then(units), 0)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// ===========================================================================
+// Public MeshData API
+// ===========================================================================
+
+/**
+ * @brief Read 3MF from memory buffer
+ */
+Result<MeshData> read3MFFromMemory(const uint8_t* data, size_t size, int numThreads) {
+    ThreeMFModel model;
+    std::vector<Vector3> vertices;
+    std::vector<Triangle> faces;
+    std::string error;
+    if (!read3MFModel(data, size, model, error, numThreads) ||
+        !flatten3MFModel(std::move(model), vertices, faces, error)) {
+        return Result<MeshData>::error("INVALID_DATA", error);
+    }
+
+    MeshData mesh;
+    mesh.positions.resize(vertices.size() * 3);
+    for (size_t i = 0; i < vertices.size(); ++i) {
+        mesh.positions[i * 3 + 0] = static_cast<float>(vertices[i].x);
+        mesh.positions[i * 3 + 1] = static_cast<float>(vertices[i].y);
+        mesh.positions[i * 3 + 2] = static_cast<float>(vertices[i].z);
+    }
+    mesh.indices.resize(faces.size() * 3);
+    for (size_t i = 0; i < faces.size(); ++i) {
+        mesh.indices[i * 3 + 0] = static_cast<uint32_t>(faces[i].v0);
+        mesh.indices[i * 3 + 1] = static_cast<uint32_t>(faces[i].v1);
+        mesh.indices[i * 3 + 2] = static_cast<uint32_t>(faces[i].v2);
+    }
+    return Result<MeshData>::ok(std::move(mesh));
+}
+
+/**
+ * @brief Read 3MF file
+ */
+Result<MeshData> read3MF(const std::string& filepath, int numThreads) {
+    MappedFile file;
+    if (!file.open(filepath)) {
+        return Result<MeshData>::error("IO_ERROR", "Failed to open file: " + filepath);
+    }
+    return read3MFFromMemory(reinterpret_cast<const uint8_t*>(file.data()), file.size(), numThreads);
+}
+
+}  // namespace madfam::geom::io
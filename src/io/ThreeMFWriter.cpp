@@ -0,0 +1,195 @@
+/**
+ * @file ThreeMFWriter.cpp
+ * @brief 3MF writer: model XML formatted in parallel, packaged with ZipWriter
+ */
+
+#include "geom-core/io/ThreeMFIO.hpp"
+#include "ZipArchive.hpp"
+#include "../Parallel.hpp"
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <fstream>
+
+namespace madfam::geom::io {
+
+using namespace madfam::geom::cad;
+
+namespace {
+
+// Vertices or triangles per parallel work item
+const size_t THREEMF_WRITE_BLOCK = 8192;
+
+// Worst-case element lengths: markup plus 3 floats (<= 15 chars) or indices (<= 10 digits)
+const size_t THREEMF_MAX_VERTEX_LINE = 30 + 3 * 16;
+const size_t THREEMF_MAX_TRIANGLE_LINE = 35 + 3 * 11;
+
+const char THREEMF_CONTENT_TYPES[] =
+    "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+    "<Types xmlns=\"http://schemas.openxmlformats.org/package/2006/content-types\">"
+    "<Default Extension=\"rels\" ContentType=\"application/vnd.openxmlformats-package.relationships+xml\"/>"
+    "<Default Extension=\"model\" ContentType=\"application/vnd.ms-package.3dmanufacturing-3dmodel+xml\"/>"
+    "</Types>\n";
+
+const char THREEMF_RELATIONSHIPS[] =
+    "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+    "<Relationships xmlns=\"http://schemas.openxmlformats.org/package/2006/relationships\">"
+    "<Relationship Target=\"/3D/3dmodel.model\" Id=\"rel0\" "
+    "Type=\"http://schemas.microsoft.com/3dmanufacturing/2013/01/3dmodel\"/>"
+    "</Relationships>\n";
+
+const char THREEMF_MODEL_HEAD[] =
+    "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+    "<model unit=\"millimeter\" xml:lang=\"en-US\" "
+    "xmlns=\"http://schemas.microsoft.com/3dmanufacturing/core/2015/02\">\n"
+    " <metadata name=\"Application\">geom-core</metadata>\n"
+    " <resources>\n"
+    "  <object id=\"1\" type=\"model\">\n"
+    "   <mesh>\n"
+    "    <vertices>\n";
+
+const char THREEMF_MODEL_MIDDLE[] =
+    "    </vertices>\n"
+    "    <triangles>\n";
+
+const char THREEMF_MODEL_TAIL[] =
+    "    </triangles>\n"
+    "   </mesh>\n"
+    "  </object>\n"
+    " </resources>\n"
+    " <build>\n"
+    "  <item objectid=\"1\"/>\n"
+    " </build>\n"
+    "</model>\n";
+
+inline char* put(char* ptr, const char* literal, size_t length) {
+    std::memcpy(ptr, literal, length);
+    return ptr + length;
+}
+
+void encodeVertices(const MeshData& mesh, size_t begin, size_t end, std::string& text) {
+    text.resize((end - begin) * THREEMF_MAX_VERTEX_LINE);
+    char* ptr = text.data();
+    char* const limit = ptr + text.size();
+    for (size_t i = begin; i < end; ++i) {
+        const float* v = &mesh.positions[i * 3];
+        ptr = put(ptr, "     <vertex x=\"", 16);
+        ptr = std::to_chars(ptr, limit, v[0]).ptr;
+        ptr = put(ptr, "\" y=\"", 5);
+        ptr = std::to_chars(ptr, limit, v[1]).ptr;
+        ptr = put(ptr, "\" z=\"", 5);
+        ptr = std::to_chars(ptr, limit, v[2]).ptr;
+        ptr = put(ptr, "\"/>\n", 4);
+    }
+    text.resize(static_cast<size_t>(ptr - text.data()));
+}
+
+void encodeTriangles(const MeshData& mesh, size_t begin, size_t end, std::string& text) {
+    text.resize((end - begin) * THREEMF_MAX_TRIANGLE_LINE);
+    char* ptr = text.data();
+    char* const limit = ptr + text.size();
+    for (size_t i = begin; i < end; ++i) {
+        const uint32_t* t = &mesh.indices[i * 3];
+        ptr = put(ptr, "     <triangle v1=\"", 19);
+        ptr = std::to_chars(ptr, limit, t[0]).ptr;
+        ptr = put(ptr, "\" v2=\"", 6);
+        ptr = std::to_chars(ptr, limit, t[1]).ptr;
+        ptr = put(ptr, "\" v3=\"", 6);
+        ptr = std::to_chars(ptr, limit, t[2]).ptr;
+        ptr = put(ptr, "\"/>\n", 4);
+    }
+    text.resize(static_cast<size_t>(ptr - text.data()));
+}
+
+Result<std::string> encodeModel(const MeshData& mesh, int numThreads) {
+    if (mesh.indices.size() % 3 != 0 || mesh.positions.size() % 3 != 0) {
+        return Result<std::string>::error("INVALID_DATA", "Mesh arrays are not multiples of 3");
+    }
+    const size_t vertexCount = mesh.vertexCount();
+    const size_t triangleCount = mesh.triangleCount();
+    if (!mesh.indices.empty() &&
+        *std::max_element(mesh.indices.begin(), mesh.indices.end()) >= vertexCount) {
+        return Result<std::string>::error("INVALID_DATA", "Triangle index out of range");
+    }
+
+    const size_t vertexBlocks = (vertexCount + THREEMF_WRITE_BLOCK - 1) / THREEMF_WRITE_BLOCK;
+    const size_t triangleBlocks = (triangleCount + THREEMF_WRITE_BLOCK - 1) / THREEMF_WRITE_BLOCK;
+    std::vector<std::string> blocks(vertexBlocks + triangleBlocks);
+
+    parallel::forEachIndex(blocks.size(), parallel::resolveThreadCount(numThreads), [&](size_t b) {
+        if (b < vertexBlocks) {
+            size_t begin = b * THREEMF_WRITE_BLOCK;
+            encodeVertices(mesh, begin, std::min(begin + THREEMF_WRITE_BLOCK, vertexCount), blocks[b]);
+        } else {
+            size_t begin = (b - vertexBlocks) * THREEMF_WRITE_BLOCK;
+            encodeTriangles(mesh, begin, std::min(begin + THREEMF_WRITE_BLOCK, triangleCount), blocks[b]);
+        }
+    });
+
+    size_t total = sizeof(THREEMF_MODEL_HEAD) + sizeof(THREEMF_MODEL_MIDDLE) + sizeof(THREEMF_MODEL_TAIL);
+    for (const auto& block : blocks) {
+        total += block.size();
+    }
+    std::string xml;
+    xml.reserve(total);
+    xml += THREEMF_MODEL_HEAD;
+    for (size_t b = 0; b < blocks.size(); ++b) {
+        if (b == vertexBlocks) {
+            xml += THREEMF_MODEL_MIDDLE;
+        }
+        xml += blocks[b];
+        std::string().swap(blocks[b]);
+    }
+    if (triangleBlocks == 0) {
+        xml += THREEMF_MODEL_MIDDLE;
+    }
+    xml += THREEMF_MODEL_TAIL;
+    return Result<std::string>::ok(std::move(xml));
+}
+
+inline const uint8_t* bytes(const char* text) {
+    return reinterpret_cast<const uint8_t*>(text);
+}
+
+}  // namespace
+
+/**
+ * @brief Encode mesh as a 3MF package in memory
+ */
+Result<std::vector<uint8_t>> write3MFToMemory(const MeshData& mesh, int numThreads) {
+    auto model = encodeModel(mesh, numThreads);
+    if (!model.success) {
+        return Result<std::vector<uint8_t>>::error(model.errorCode, model.errorMessage);
+    }
+
+    ZipWriter zip;
+    bool added = zip.add("[Content_Types].xml", bytes(THREEMF_CONTENT_TYPES), sizeof(THREEMF_CONTENT_TYPES) - 1) &&
+                 zip.add("_rels/.rels", bytes(THREEMF_RELATIONSHIPS), sizeof(THREEMF_RELATIONSHIPS) - 1) &&
+                 zip.add("3D/3dmodel.model", bytes(model.value.data()), model.value.size(), numThreads);
+    if (!added) {
+        return Result<std::vector<uint8_t>>::error("INVALID_DATA", "Mesh too large for a 3MF package without ZIP64");
+    }
+    return Result<std::vector<uint8_t>>::ok(zip.finish());
+}
+
+/**
+ * @brief Write mesh to 3MF file
+ */
+Result<bool> write3MF(const MeshData& mesh, const std::string& filepath, int numThreads) {
+    auto package = write3MFToMemory(mesh, numThreads);
+    if (!package.success) {
+        return Result<bool>::error(package.errorCode, package.errorMessage);
+    }
+
+    std::ofstream file(filepath, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        return Result<bool>::error("IO_ERROR", "Failed to create file: " + filepath);
+    }
+    if (!file.write(reinterpret_cast<const char*>(package.value.data()),
+                    static_cast<std::streamsize>(package.value.size()))) {
+        return Result<bool>::error("IO_ERROR", "Failed to write file: " + filepath);
+    }
+    return Result<bool>::ok(true);
+}
+
+}  // namespace madfam::geom::io
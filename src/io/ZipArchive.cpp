@@ -0,0 +1,472 @@
+/**
+ * @file ZipArchive.cpp
+ * @brief ZIP container reader/writer (see ZipArchive.hpp)
+ */
+
+#include "ZipArchive.hpp"
+#include "Deflate.hpp"
+#include "../Parallel.hpp"
+#include <algorithm>
+#include <cctype>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <thread>
+
+namespace madfam::geom::io {
+
+namespace {
+
+const uint32_t ZIP_LOCAL_SIGNATURE = 0x04034b50;
+const uint32_t ZIP_CENTRAL_SIGNATURE = 0x02014b50;
+const uint32_t ZIP_END_SIGNATURE = 0x06054b50;
+const uint32_t ZIP64_LOCATOR_SIGNATURE = 0x07064b50;
+const uint32_t ZIP64_END_SIGNATURE = 0x06064b50;
+
+const size_t ZIP_LOCAL_HEADER_BYTES = 30;
+const size_t ZIP_CENTRAL_HEADER_BYTES = 46;
+const size_t ZIP_END_BYTES = 22;
+const size_t ZIP64_LOCATOR_BYTES = 20;
+const size_t ZIP64_END_BYTES = 56;
+const size_t ZIP_MAX_COMMENT = 65535;
+
+const uint16_t ZIP_METHOD_STORED = 0;
+const uint16_t ZIP_METHOD_DEFLATED = 8;
+const uint16_t ZIP_VERSION = 20;
+const uint16_t ZIP_DOS_DATE = (0 << 9) | (1 << 5) | 1;  // 1980-01-01, reproducible output
+
+// Stored entries are handed to the sink in pieces of this size
+const size_t ZIP_STORED_CHUNK = 1 << 20;
+
+// Inflated chunks buffered between the inflating thread and the sink
+const size_t ZIP_PIPELINE_DEPTH = 4;
+
+using ZipSink = std::function<bool(const uint8_t*, size_t)>;
+
+enum class InflateStatus { Done, Corrupt, TooLarge, Stopped };
+
+/**
+ * Inflate into sink on the calling thread, updating crc and total.
+ */
+InflateStatus inflateInline(Inflater& inflater, uint64_t limit, const ZipSink& sink,
+                            uint32_t& crc, uint64_t& total) {
+    while (true) {
+        const uint8_t* chunk;
+        size_t size;
+        if (!inflater.next(chunk, size)) {
+            return InflateStatus::Corrupt;
+        }
+        if (size == 0) {
+            return InflateStatus::Done;
+        }
+        if (total + size > limit) {
+            return InflateStatus::TooLarge;
+        }
+        crc = crc32Update(crc, chunk, size);
+        total += size;
+        if (!sink(chunk, size)) {
+            return InflateStatus::Stopped;
+        }
+    }
+}
+
+/**
+ * Same as inflateInline, with inflation and the CRC on a second thread.
+ *
+ * Chunks are copied out of the inflater's window into a ring of
+ * ZIP_PIPELINE_DEPTH buffers; sink runs on the calling thread, in order,
+ * while the next chunks are being inflated.
+ */
+InflateStatus inflatePipelined(Inflater& inflater, uint64_t limit, const ZipSink& sink,
+                               uint32_t& crc, uint64_t& total) {
+    std::vector<uint8_t> slots[ZIP_PIPELINE_DEPTH];
+    std::mutex mutex;
+    std::condition_variable filled, drained;
+    size_t produced = 0;   // Chunks published; slot = count % depth
+    size_t consumed = 0;   // Chunks handed to sink
+    bool finished = false;
+    bool stopped = false;
+    InflateStatus status = InflateStatus::Done;
+
+    std::thread inflating([&]() {
+        InflateStatus result = InflateStatus::Done;
+        uint32_t runningCrc = crc;
+        uint64_t runningTotal = total;
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                drained.wait(lock, [&]() { return stopped || produced - consumed < ZIP_PIPELINE_DEPTH; });
+                if (stopped) {
+                    break;
+                }
+            }
+            const uint8_t* chunk;
+            size_t size;
+            if (!inflater.next(chunk, size)) {
+                result = InflateStatus::Corrupt;
+                break;
+            }
+            if (size == 0) {
+                break;
+            }
+            if (runningTotal + size > limit) {
+                result = InflateStatus::TooLarge;
+                break;
+            }
+            runningCrc = crc32Update(runningCrc, chunk, size);
+            runningTotal += size;
+            // Not visible to the sink until produced is advanced
+            slots[produced % ZIP_PIPELINE_DEPTH].assign(chunk, chunk + size);
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                ++produced;
+            }
+            filled.notify_one();
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            finished = true;
+            status = result;
+            crc = runningCrc;
+            total = runningTotal;
+        }
+        filled.notify_one();
+    });
+
+    auto stop = [&]() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopped = true;
+        }
+        drained.notify_one();
+    };
+
+    try {
+        while (true) {
+            const std::vector<uint8_t>* slot;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                filled.wait(lock, [&]() { return consumed < produced || finished; });
+                if (consumed == produced) {
+                    break;
+                }
+                slot = &slots[consumed % ZIP_PIPELINE_DEPTH];
+            }
+            if (!sink(slot->data(), slot->size())) {
+                stop();
+                break;
+            }
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                ++consumed;
+            }
+            drained.notify_one();
+        }
+    } catch (...) {
+        stop();
+        inflating.join();
+        throw;
+    }
+
+    inflating.join();
+    return stopped ? InflateStatus::Stopped : status;
+}
+
+inline uint16_t get16(const uint8_t* p) {
+    return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+inline uint32_t get32(const uint8_t* p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+inline uint64_t get64(const uint8_t* p) {
+    return static_cast<uint64_t>(get32(p)) | (static_cast<uint64_t>(get32(p + 4)) << 32);
+}
+
+inline void put16(std::vector<uint8_t>& out, uint32_t value) {
+    out.push_back(static_cast<uint8_t>(value));
+    out.push_back(static_cast<uint8_t>(value >> 8));
+}
+
+inline void put32(std::vector<uint8_t>& out, uint32_t value) {
+    put16(out, value & 0xFFFF);
+    put16(out, value >> 16);
+}
+
+// OPC part names compare ASCII case-insensitively
+bool sameName(const std::string& a, const std::string& b) {
+    return a.size() == b.size() &&
+           std::equal(a.begin(), a.end(), b.begin(), [](char x, char y) {
+               return std::tolower(static_cast<unsigned char>(x)) == std::tolower(static_cast<unsigned char>(y));
+           });
+}
+
+} // namespace
+
+bool ZipReader::open(const uint8_t* data, size_t size, std::string& error) {
+    archive = data;
+    archiveSize = size;
+    entryList.clear();
+
+    // End of central directory: scan back over a possible archive comment
+    if (size < ZIP_END_BYTES) {
+        error = "not a ZIP archive (too small)";
+        return false;
+    }
+    size_t end = size - ZIP_END_BYTES;
+    const size_t stop = end > ZIP_MAX_COMMENT ? end - ZIP_MAX_COMMENT : 0;
+    while (get32(data + end) != ZIP_END_SIGNATURE) {
+        if (end == stop) {
+            error = "not a ZIP archive (no end of central directory)";
+            return false;
+        }
+        --end;
+    }
+
+    const uint8_t* eocd = data + end;
+    uint64_t entryCount = get16(eocd + 10);
+    uint64_t directorySize = get32(eocd + 12);
+    uint64_t directoryOffset = get32(eocd + 16);
+    if (get16(eocd + 4) != 0 || get16(eocd + 6) != 0) {
+        error = "multi-disk ZIP archives are not supported";
+        return false;
+    }
+
+    // ZIP64 end record, referenced by a locator directly before the classic one
+    if (end >= ZIP64_LOCATOR_BYTES && get32(eocd - ZIP64_LOCATOR_BYTES) == ZIP64_LOCATOR_SIGNATURE) {
+        uint64_t zip64Offset = get64(eocd - ZIP64_LOCATOR_BYTES + 8);
+        if (size < ZIP64_END_BYTES || zip64Offset > size - ZIP64_END_BYTES ||
+            get32(data + zip64Offset) != ZIP64_END_SIGNATURE) {
+            error = "corrupt ZIP64 end of central directory";
+            return false;
+        }
+        const uint8_t* record = data + zip64Offset;
+        entryCount = get64(record + 32);
+        directorySize = get64(record + 40);
+        directoryOffset = get64(record + 48);
+    }
+
+    if (directoryOffset > size || directorySize > size - directoryOffset) {
+        error = "central directory lies outside the archive";
+        return false;
+    }
+
+    const uint8_t* p = data + directoryOffset;
+    const uint8_t* directoryEnd = p + directorySize;
+    entryList.reserve(static_cast<size_t>(std::min<uint64_t>(entryCount, directorySize / ZIP_CENTRAL_HEADER_BYTES)));
+    for (uint64_t i = 0; i < entryCount; ++i) {
+        if (directoryEnd - p < static_cast<ptrdiff_t>(ZIP_CENTRAL_HEADER_BYTES) ||
+            get32(p) != ZIP_CENTRAL_SIGNATURE) {
+            error = "corrupt central directory";
+            return false;
+        }
+        const size_t nameLength = get16(p + 28);
+        const size_t extraLength = get16(p + 30);
+        const size_t commentLength = get16(p + 32);
+        if (static_cast<size_t>(directoryEnd - p) < ZIP_CENTRAL_HEADER_BYTES + nameLength + extraLength + commentLength) {
+            error = "corrupt central directory";
+            return false;
+        }
+
+        ZipEntry entry;
+        entry.flags = get16(p + 8);
+        entry.method = get16(p + 10);
+        entry.crc32 = get32(p + 16);
+        entry.compressedSize = get32(p + 20);
+        entry.uncompressedSize = get32(p + 24);
+        entry.localHeaderOffset = get32(p + 42);
+        entry.name.assign(reinterpret_cast<const char*>(p + ZIP_CENTRAL_HEADER_BYTES), nameLength);
+
+        // ZIP64 extra field: only the saturated 32-bit fields are present, in order
+        const uint8_t* extra = p + ZIP_CENTRAL_HEADER_BYTES + nameLength;
+        const uint8_t* extraEnd = extra + extraLength;
+        while (extraEnd - extra >= 4) {
+            uint16_t id = get16(extra);
+            uint16_t length = get16(extra + 2);
+            const uint8_t* field = extra + 4;
+            if (extraEnd - field < length) {
+                break;
+            }
+            if (id == 0x0001) {
+                const uint8_t* fieldEnd = field + length;
+                for (uint64_t* value : {&entry.uncompressedSize, &entry.compressedSize, &entry.localHeaderOffset}) {
+                    if (*value == 0xFFFFFFFFu && fieldEnd - field >= 8) {
+                        *value = get64(field);
+                        field += 8;
+                    }
+                }
+            }
+            extra += 4 + length;
+        }
+
+        entryList.push_back(std::move(entry));
+        p += ZIP_CENTRAL_HEADER_BYTES + nameLength + extraLength + commentLength;
+    }
+    return true;
+}
+
+const ZipEntry* ZipReader::find(const std::string& name) const {
+    std::string wanted = !name.empty() && name[0] == '/' ? name.substr(1) : name;
+    for (const auto& entry : entryList) {
+        if (sameName(entry.name, wanted)) {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+bool ZipReader::read(const ZipEntry& entry, const std::function<bool(const uint8_t*, size_t)>& sink,
+                     std::string& error, int numThreads) const {
+    if (entry.flags & 1) {
+        error = "encrypted ZIP entries are not supported: " + entry.name;
+        return false;
+    }
+    const uint64_t offset = entry.localHeaderOffset;
+    if (offset > archiveSize || archiveSize - offset < ZIP_LOCAL_HEADER_BYTES ||
+        get32(archive + offset) != ZIP_LOCAL_SIGNATURE) {
+        error = "corrupt local header: " + entry.name;
+        return false;
+    }
+    const uint64_t dataOffset = offset + ZIP_LOCAL_HEADER_BYTES +
+                                get16(archive + offset + 26) + get16(archive + offset + 28);
+    if (dataOffset > archiveSize || entry.compressedSize > archiveSize - dataOffset) {
+        error = "entry data lies outside the archive: " + entry.name;
+        return false;
+    }
+    const uint8_t* data = archive + dataOffset;
+
+    uint32_t crc = 0;
+    uint64_t total = 0;
+    auto deliver = [&](const uint8_t* chunk, size_t size) {
+        crc = crc32Update(crc, chunk, size);
+        total += size;
+        return sink(chunk, size);
+    };
+
+    if (entry.method == ZIP_METHOD_STORED) {
+        if (entry.compressedSize != entry.uncompressedSize) {
+            error = "stored entry size mismatch: " + entry.name;
+            return false;
+        }
+        for (uint64_t pos = 0; pos < entry.compressedSize; pos += ZIP_STORED_CHUNK) {
+            size_t count = static_cast<size_t>(std::min<uint64_t>(ZIP_STORED_CHUNK, entry.compressedSize - pos));
+            if (!deliver(data + pos, count)) {
+                return false;
+            }
+        }
+    } else if (entry.method == ZIP_METHOD_DEFLATED) {
+        Inflater inflater(data, static_cast<size_t>(entry.compressedSize));
+        InflateStatus status = parallel::resolveThreadCount(numThreads) > 1
+            ? inflatePipelined(inflater, entry.uncompressedSize, sink, crc, total)
+            : inflateInline(inflater, entry.uncompressedSize, sink, crc, total);
+        if (status == InflateStatus::Corrupt) {
+            error = "corrupt deflate data in " + entry.name + ": " + inflater.error();
+            return false;
+        }
+        if (status == InflateStatus::TooLarge) {
+            error = "entry inflates past its declared size: " + entry.name;
+            return false;
+        }
+        if (status == InflateStatus::Stopped) {
+            return false;
+        }
+    } else {
+        error = "unsupported ZIP compression method " + std::to_string(entry.method) + ": " + entry.name;
+        return false;
+    }
+
+    if (total != entry.uncompressedSize || crc != entry.crc32) {
+        error = "CRC or size mismatch: " + entry.name;
+        return false;
+    }
+    return true;
+}
+
+bool ZipReader::readAll(const ZipEntry& entry, std::string& out, std::string& error) const {
+    out.clear();
+    return read(entry, [&](const uint8_t* chunk, size_t size) {
+        out.append(reinterpret_cast<const char*>(chunk), size);
+        return true;
+    }, error);
+}
+
+bool ZipWriter::add(const std::string& name, const uint8_t* data, size_t size, int numThreads) {
+    std::vector<uint8_t> compressed = deflateBytes(data, size, numThreads);
+    const bool store = compressed.size() >= size;
+    const uint8_t* payload = store ? data : compressed.data();
+    const size_t payloadSize = store ? size : compressed.size();
+
+    const uint64_t headerBytes = ZIP_LOCAL_HEADER_BYTES + name.size();
+    if (size > 0xFFFFFFFFu || out.size() + headerBytes + payloadSize > 0xFFFFFFFFu ||
+        entryList.size() >= 0xFFFF || name.size() > 0xFFFF) {
+        return false;
+    }
+
+    ZipEntry entry;
+    entry.name = name;
+    entry.method = store ? ZIP_METHOD_STORED : ZIP_METHOD_DEFLATED;
+    entry.crc32 = crc32Update(0, data, size);
+    entry.compressedSize = payloadSize;
+    entry.uncompressedSize = size;
+    entry.localHeaderOffset = out.size();
+
+    put32(out, ZIP_LOCAL_SIGNATURE);
+    put16(out, ZIP_VERSION);
+    put16(out, 0);  // Flags
+    put16(out, entry.method);
+    put16(out, 0);  // Time
+    put16(out, ZIP_DOS_DATE);
+    put32(out, entry.crc32);
+    put32(out, static_cast<uint32_t>(entry.compressedSize));
+    put32(out, static_cast<uint32_t>(entry.uncompressedSize));
+    put16(out, static_cast<uint32_t>(name.size()));
+    put16(out, 0);  // Extra length
+    out.insert(out.end(), name.begin(), name.end());
+    out.insert(out.end(), payload, payload + payloadSize);
+
+    entryList.push_back(std::move(entry));
+    return true;
+}
+
+std::vector<uint8_t> ZipWriter::finish() {
+    const size_t directoryOffset = out.size();
+    for (const auto& entry : entryList) {
+        put32(out, ZIP_CENTRAL_SIGNATURE);
+        put16(out, ZIP_VERSION);  // Made by (MS-DOS)
+        put16(out, ZIP_VERSION);
+        put16(out, 0);
+        put16(out, entry.method);
+        put16(out, 0);
+        put16(out, ZIP_DOS_DATE);
+        put32(out, entry.crc32);
+        put32(out, static_cast<uint32_t>(entry.compressedSize));
+        put32(out, static_cast<uint32_t>(entry.uncompressedSize));
+        put16(out, static_cast<uint32_t>(entry.name.size()));
+        put16(out, 0);  // Extra length
+        put16(out, 0);  // Comment length
+        put16(out, 0);  // Disk
+        put16(out, 0);  // Internal attributes
+        put32(out, 0);  // External attributes
+        put32(out, static_cast<uint32_t>(entry.localHeaderOffset));
+        out.insert(out.end(), entry.name.begin(), entry.name.end());
+    }
+    const size_t directorySize = out.size() - directoryOffset;
+
+    put32(out, ZIP_END_SIGNATURE);
+    put16(out, 0);
+    put16(out, 0);
+    put16(out, static_cast<uint32_t>(entryList.size()));
+    put16(out, static_cast<uint32_t>(entryList.size()));
+    put32(out, static_cast<uint32_t>(directorySize));
+    put32(out, static_cast<uint32_t>(directoryOffset));
+    put16(out, 0);  // Comment length
+
+    entryList.clear();
+    std::vector<uint8_t> archive;
+    archive.swap(out);
+    return archive;
+}
+
+} // namespace madfam::geom::io
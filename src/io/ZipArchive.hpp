@@ -0,0 +1,91 @@
+#pragma once
+
+/**
+ * @file ZipArchive.hpp
+ * @brief Minimal ZIP container reader/writer for OPC packages (3MF)
+ *
+ * The reader works over an in-memory image (usually a MappedFile) and
+ * streams entry contents chunk by chunk, so large entries never need to be
+ * extracted whole. Stored and deflated entries and ZIP64 sizes are
+ * supported; encryption and multi-disk archives are not.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace madfam::geom::io {
+
+struct ZipEntry {
+    std::string name;
+    uint16_t method = 0;          // 0 = stored, 8 = deflated
+    uint16_t flags = 0;
+    uint32_t crc32 = 0;
+    uint64_t compressedSize = 0;
+    uint64_t uncompressedSize = 0;
+    uint64_t localHeaderOffset = 0;
+};
+
+class ZipReader {
+public:
+    /**
+     * @brief Parse the central directory of a ZIP image
+     * @return false (with error set) if the archive is malformed
+     */
+    bool open(const uint8_t* data, size_t size, std::string& error);
+
+    const std::vector<ZipEntry>& entries() const { return entryList; }
+
+    /**
+     * @brief Find an entry by name (ASCII case-insensitive, leading '/' ignored)
+     */
+    const ZipEntry* find(const std::string& name) const;
+
+    /**
+     * @brief Stream an entry's uncompressed bytes to sink in order
+     * @param numThreads With more than one (<= 0 = all cores), a deflated
+     *        entry is inflated and checksummed on a second thread while sink
+     *        consumes earlier chunks on the calling thread
+     *
+     * The CRC and size are verified at the end. sink may return false to
+     * stop early; read then returns false and leaves error untouched.
+     */
+    bool read(const ZipEntry& entry, const std::function<bool(const uint8_t*, size_t)>& sink,
+              std::string& error, int numThreads = 1) const;
+
+    /**
+     * @brief Read a (small) entry completely into out
+     */
+    bool readAll(const ZipEntry& entry, std::string& out, std::string& error) const;
+
+private:
+    const uint8_t* archive = nullptr;
+    size_t archiveSize = 0;
+    std::vector<ZipEntry> entryList;
+};
+
+/**
+ * @brief Builds a ZIP image in memory, one complete entry at a time
+ */
+class ZipWriter {
+public:
+    /**
+     * @brief Append an entry, deflated unless compression does not help
+     * @param numThreads Threads for deflate (<= 0 = all cores)
+     * @return false if the archive would need ZIP64 (over 4 GB)
+     */
+    bool add(const std::string& name, const uint8_t* data, size_t size, int numThreads = 1);
+
+    /**
+     * @brief Append the central directory and return the finished archive
+     */
+    std::vector<uint8_t> finish();
+
+private:
+    std::vector<uint8_t> out;
+    std::vector<ZipEntry> entryList;
+};
+
+} // namespace madfam::geom::io
@@ -9,6 +9,7 @@ import sys
 import os
 import struct
 import tempfile
+import weakref
 
 # Add the build directory to Python path if not already set
 build_dir = os.path.join(os.path.dirname(os.path.dirname(__file__)), 'build', 'python')
@@ -104,6 +105,39 @@ def write_binary_stl_cube(filepath, size=10.0):
             f.write(struct.pack('<H', 0))
 
 
+def write_ascii_stl_from_binary(binary_path, ascii_path, solids=2):
+    """
+    Re-encode a binary STL as ASCII STL with CRLF line endings.
+
+    The facets are split across several solid ... endsolid blocks to exercise
+    multi-solid parsing. Coordinates use 9 significant digits so they read
+    back as the same 32-bit floats.
+    """
+    with open(binary_path, 'rb') as f:
+        data = f.read()
+
+    count = struct.unpack_from('<I', data, 80)[0]
+    per_solid = (count + solids - 1) // solids
+
+    lines = []
+    for i in range(count):
+        if i % per_solid == 0:
+            if i > 0:
+                lines.append('endsolid part')
+            lines.append(f'solid part {i // per_solid}')
+        values = struct.unpack_from('<12f', data, 84 + i * 50)
+        lines.append('  facet normal {:.9g} {:.9g} {:.9g}'.format(*values[0:3]))
+        lines.append('    outer loop')
+        for v in range(3):
+            lines.append('\tvertex {:.9g} {:.9g} {:.9g}'.format(*values[3 + v * 3:6 + v * 3]))
+        lines.append('    endloop')
+        lines.append('  endfacet')
+    lines.append('endsolid part')
+
+    with open(ascii_path, 'w', newline='') as f:
+        f.write('\r\n'.join(lines) + '\r\n')
+
+
 def test_vector3():
     """Test Vector3 class."""
     print("Testing Vector3...")
@@ -248,6 +282,384 @@ def test_bounding_box():
             os.remove(temp_file)
 
 
+def test_threaded_load():
+    """Test that multi-threaded STL loading matches the single-threaded result."""
+    print("\nTesting multi-threaded STL loading...")
+
+    with tempfile.NamedTemporaryFile(suffix='.stl', delete=False) as f:
+        temp_file = f.name
+
+    try:
+        write_binary_stl_cube(temp_file, size=10.0)
+
+        serial = geom_core_py.Analyzer()
+        assert serial.load_stl(temp_file, num_threads=1)
+
+        for threads in (2, 4, 0):
+            threaded = geom_core_py.Analyzer()
+            assert threaded.load_stl(temp_file, num_threads=threads), \
+                f"Failed to load STL with {threads} threads"
+            assert threaded.get_vertex_count() == serial.get_vertex_count()
+            assert threaded.get_triangle_count() == serial.get_triangle_count()
+            assert abs(threaded.get_volume() - serial.get_volume()) < 1e-9
+            assert threaded.is_watertight()
+            print(f"  ✓ num_threads={threads}: {threaded.get_vertex_count()} vertices")
+
+    finally:
+        if os.path.exists(temp_file):
+            os.remove(temp_file)
+
+
+def test_ascii_load():
+    """Test that an ASCII STL (CRLF, multiple solids) welds like the binary file."""
+    print("\nTesting ASCII STL loading...")
+
+    with tempfile.NamedTemporaryFile(suffix='.stl', delete=False) as f:
+        binary_file = f.name
+    with tempfile.NamedTemporaryFile(suffix='.stl', delete=False) as f:
+        ascii_file = f.name
+
+    try:
+        write_binary_stl_cube(binary_file, size=10.0)
+        write_ascii_stl_from_binary(binary_file, ascii_file, solids=2)
+
+        binary = geom_core_py.Analyzer()
+        assert binary.load_stl(binary_file)
+
+        text = geom_core_py.Analyzer()
+        assert text.load_stl(ascii_file), "Failed to load ASCII STL"
+        assert text.get_vertex_count() == binary.get_vertex_count() == 8
+        assert text.get_triangle_count() == binary.get_triangle_count() == 12
+        assert abs(text.get_volume() - binary.get_volume()) < 1e-9
+        assert text.is_watertight()
+        print(f"  ✓ ASCII: {text.get_vertex_count()} vertices, volume={text.get_volume():.2f}")
+
+        # Binary file with a "solid" header and a trailing byte is still binary
+        with open(binary_file, 'rb') as f:
+            data = f.read()
+        with open(binary_file, 'wb') as f:
+            f.write(b'solid part exported by CAD'.ljust(80, b' ') + data[80:] + b'\0')
+
+        headed = geom_core_py.Analyzer()
+        assert headed.load_stl(binary_file), "Failed to load binary STL with a 'solid' header"
+        assert headed.get_triangle_count() == 12
+        assert abs(headed.get_volume() - binary.get_volume()) < 1e-9
+        print(f"  ✓ Binary with 'solid' header: {headed.get_triangle_count()} triangles")
+
+    finally:
+        for path in (binary_file, ascii_file):
+            if os.path.exists(path):
+                os.remove(path)
+
+
+def test_streaming_load():
+    """Test that the streaming pass matches a regular load, with and without spilling."""
+    print("\nTesting streaming STL analysis...")
+
+    with tempfile.NamedTemporaryFile(suffix='.stl', delete=False) as f:
+        temp_file = f.name
+
+    try:
+        write_binary_stl_cube(temp_file, size=10.0)
+
+        regular = geom_core_py.Analyzer()
+        assert regular.load_stl(temp_file)
+
+        # A 3000-byte limit leaves too little room for the tables, forcing a spill
+        for limit in (256 * 1024 * 1024, 3000):
+            streamed = geom_core_py.Analyzer()
+            assert streamed.load_stl_streaming(temp_file, memory_limit_bytes=limit, spill_directory=tempfile.gettempdir())
+
+            assert streamed.get_vertex_count() == regular.get_vertex_count()
+            assert streamed.get_triangle_count() == regular.get_triangle_count()
+            assert abs(streamed.get_volume() - regular.get_volume()) < 1e-9
+            assert streamed.is_watertight() == regular.is_watertight()
+
+            bbox = streamed.get_bounding_box()
+            assert abs(bbox.x - 10.0) < 0.01 and abs(bbox.y - 10.0) < 0.01 and abs(bbox.z - 10.0) < 0.01
+            print(f"  ✓ memory_limit_bytes={limit}: volume={streamed.get_volume():.2f}, watertight={streamed.is_watertight()}")
+
+        # 4 bytes left after the window would need hundreds of spill files; rejected up front
+        streamed = geom_core_py.Analyzer()
+        assert not streamed.load_stl_streaming(temp_file, memory_limit_bytes=2404, spill_directory=tempfile.gettempdir())
+        print("  ✓ Limits needing too many spill partitions are rejected")
+
+    finally:
+        if os.path.exists(temp_file):
+            os.remove(temp_file)
+
+
+def test_obj_load():
+    """Test that an OBJ cube (quads, negative indices, vt/vn corners) matches the STL cube."""
+    print("\nTesting OBJ loading...")
+
+    with tempfile.NamedTemporaryFile(suffix='.stl', delete=False) as f:
+        stl_file = f.name
+    with tempfile.NamedTemporaryFile(suffix='.obj', delete=False, mode='w') as f:
+        obj_file = f.name
+        f.write("# cube\no cube\n")
+        for x, y, z in [(0, 0, 0), (10, 0, 0), (10, 10, 0), (0, 10, 0),
+                        (0, 0, 10), (10, 0, 10), (10, 10, 10), (0, 10, 10)]:
+            f.write(f"v {x} {y} {z}\r\n")
+        f.write("vt 0 0\nvn 0 0 1\n")
+        f.write("f 1 4 3 2\n")            # bottom
+        f.write("f 5/1 6/1 7/1 8/1\n")    # top
+        f.write("f 1//1 2//1 6//1 5//1\n")
+        f.write("f -5/1/1 -1 -2 -6\n")   # 4 8 7 3 via relative indices
+        f.write("f 1 5 8 4\n")
+        f.write("f 2 3 7 6\n")
+
+    try:
+        write_binary_stl_cube(stl_file, size=10.0)
+
+        stl = geom_core_py.Analyzer()
+        assert stl.load_stl(stl_file)
+
+        for threads in (1, 4):
+            obj = geom_core_py.Analyzer()
+            assert obj.load_obj(obj_file, num_threads=threads), "Failed to load OBJ"
+            assert obj.get_vertex_count() == 8
+            assert obj.get_triangle_count() == 12
+            assert abs(obj.get_volume() - stl.get_volume()) < 1e-9
+            assert obj.is_watertight()
+        print(f"  ✓ OBJ: {obj.get_triangle_count()} triangles, volume={obj.get_volume():.2f}")
+
+        assert not geom_core_py.Analyzer().load_obj("/nonexistent/model.obj")
+
+    finally:
+        for path in (stl_file, obj_file):
+            if os.path.exists(path):
+                os.remove(path)
+
+
+def test_3mf_load():
+    """Test that a 3MF cube (centimeters, placed through a component) matches the STL cube."""
+    print("\nTesting 3MF loading...")
+    import zipfile
+
+    corners = [(0, 0, 0), (1, 0, 0), (1, 1, 0), (0, 1, 0),
+               (0, 0, 1), (1, 0, 1), (1, 1, 1), (0, 1, 1)]
+    triangles = [(0, 2, 1), (0, 3, 2), (4, 5, 6), (4, 6, 7), (0, 1, 5), (0, 5, 4),
+                 (1, 2, 6), (1, 6, 5), (2, 3, 7), (2, 7, 6), (3, 0, 4), (3, 4, 7)]
+    model = ('<?xml version="1.0" encoding="UTF-8"?>\r\n'
+             '<model unit="centimeter" xmlns="http://schemas.microsoft.com/3dmanufacturing/core/2015/02">'
+             '<resources><object id="1" type="model"><mesh><vertices>')
+    model += "".join(f'<vertex x="{x - 5}" y="{y}" z="{z}"/>' for x, y, z in corners)
+    model += '</vertices><!-- faces --><triangles>'
+    model += "".join(f'<triangle v1="{a}" v2="{b}" v3="{c}"/>' for a, b, c in triangles)
+    model += ('</triangles></mesh></object>'
+              '<object id="2"><components><component objectid="1" transform="{transform}"/>'
+              '</components></object></resources><build><item objectid="2"/></build></model>')
+
+    def write_package(path, transform):
+        with zipfile.ZipFile(path, 'w', zipfile.ZIP_DEFLATED) as z:
+            z.writestr('[Content_Types].xml',
+                       '<?xml version="1.0" encoding="UTF-8"?>'
+                       '<Types xmlns="http://schemas.openxmlformats.org/package/2006/content-types">'
+                       '<Default Extension="model" ContentType="application/vnd.ms-package.3dmanufacturing-3dmodel+xml"/>'
+                       '</Types>')
+            z.writestr('_rels/.rels',
+                       '<?xml version="1.0" encoding="UTF-8"?>'
+                       '<Relationships xmlns="http://schemas.openxmlformats.org/package/2006/relationships">'
+                       '<Relationship Target="/3D/3dmodel.model" Id="rel0" '
+                       'Type="http://schemas.microsoft.com/3dmanufacturing/2013/01/3dmodel"/></Relationships>')
+            z.writestr('3D/3dmodel.model', model.replace('{transform}', transform))
+
+    with tempfile.NamedTemporaryFile(suffix='.stl', delete=False) as f:
+        stl_file = f.name
+    with tempfile.NamedTemporaryFile(suffix='.3mf', delete=False) as f:
+        package_file = f.name
+    with tempfile.NamedTemporaryFile(suffix='.3mf', delete=False) as f:
+        mirrored_file = f.name
+    write_package(package_file, "1 0 0 0 1 0 0 0 1 5 0 0")
+    # Mirrored in x: the winding must be reversed to keep the volume positive
+    write_package(mirrored_file, "-1 0 0 0 1 0 0 0 1 5 0 0")
+
+    try:
+        write_binary_stl_cube(stl_file, size=10.0)
+
+        stl = geom_core_py.Analyzer()
+        assert stl.load_stl(stl_file)
+
+        mf = geom_core_py.Analyzer()
+        assert mf.load_3mf(package_file), "Failed to load 3MF"
+        assert mf.get_vertex_count() == 8
+        assert mf.get_triangle_count() == 12
+        assert abs(mf.get_volume() - stl.get_volume()) < 1e-6
+        assert mf.is_watertight()
+        print(f"  ✓ 3MF: {mf.get_triangle_count()} triangles, volume={mf.get_volume():.2f}")
+
+        mirrored = geom_core_py.Analyzer()
+        assert mirrored.load_3mf(mirrored_file), "Failed to load mirrored 3MF"
+        assert abs(mirrored.get_volume() - stl.get_volume()) < 1e-6
+        assert mirrored.is_watertight()
+        print(f"  ✓ Mirrored 3MF component: volume={mirrored.get_volume():.2f}")
+
+        assert not geom_core_py.Analyzer().load_3mf(stl_file)
+
+    finally:
+        for path in (stl_file, package_file, mirrored_file):
+            if os.path.exists(path):
+                os.remove(path)
+
+
+def test_ply_load():
+    """Test that binary (quads, extra properties) and ASCII PLY cubes match the STL cube."""
+    print("\nTesting PLY loading...")
+
+    corners = [(0, 0, 0), (10, 0, 0), (10, 10, 0), (0, 10, 0),
+               (0, 0, 10), (10, 0, 10), (10, 10, 10), (0, 10, 10)]
+    quads = [(0, 3, 2, 1), (4, 5, 6, 7), (0, 1, 5, 4), (1, 2, 6, 5), (2, 3, 7, 6), (3, 0, 4, 7)]
+
+    with tempfile.NamedTemporaryFile(suffix='.stl', delete=False) as f:
+        stl_file = f.name
+    with tempfile.NamedTemporaryFile(suffix='.ply', delete=False) as f:
+        binary_file = f.name
+        f.write(b"ply\nformat binary_big_endian 1.0\ncomment cube\n"
+                b"element vertex 8\nproperty float x\nproperty float y\nproperty float z\n"
+                b"property uchar red\n"
+                b"element face 6\nproperty list uchar uint vertex_indices\nproperty int flags\n"
+                b"end_header\n")
+        for x, y, z in corners:
+            f.write(struct.pack('>fffB', x, y, z, 255))
+        for quad in quads:
+            f.write(struct.pack('>B4Ii', 4, *quad, 0))
+    with tempfile.NamedTemporaryFile(suffix='.ply', delete=False, mode='w') as f:
+        ascii_file = f.name
+        f.write("ply\r\nformat ascii 1.0\r\nelement vertex 8\r\nproperty double x\r\n"
+                "property double y\r\nproperty double z\r\nelement face 12\r\n"
+                "property list uchar int vertex_index\r\nend_header\r\n")
+        for x, y, z in corners:
+            f.write(f"{x} {y} {z}\r\n")
+        for a, b, c, d in quads:
+            f.write(f"3 {a} {b} {c}\r\n3 {a} {c} {d}\r\n")
+
+    try:
+        write_binary_stl_cube(stl_file, size=10.0)
+
+        stl = geom_core_py.Analyzer()
+        assert stl.load_stl(stl_file)
+
+        for path in (binary_file, ascii_file):
+            for threads in (1, 4):
+                ply = geom_core_py.Analyzer()
+                assert ply.load_ply(path, num_threads=threads), "Failed to load PLY"
+                assert ply.get_vertex_count() == 8
+                assert ply.get_triangle_count() == 12
+                assert abs(ply.get_volume() - stl.get_volume()) < 1e-9
+                assert ply.is_watertight()
+        print(f"  ✓ PLY: {ply.get_triangle_count()} triangles, volume={ply.get_volume():.2f}")
+
+        assert not geom_core_py.Analyzer().load_ply(stl_file)
+
+    finally:
+        for path in (stl_file, binary_file, ascii_file):
+            if os.path.exists(path):
+                os.remove(path)
+
+
+def test_numpy_arrays():
+    """Test zero-copy NumPy mesh ingest and array views."""
+    print("\nTesting NumPy array exchange...")
+    import numpy as np
+
+    with tempfile.NamedTemporaryFile(suffix='.stl', delete=False) as f:
+        stl_file = f.name
+    try:
+        write_binary_stl_cube(stl_file, size=10.0)
+        stl = geom_core_py.Analyzer()
+        assert stl.load_stl(stl_file)
+
+        vertices = stl.get_vertices()
+        faces = stl.get_faces()
+        assert vertices.shape == (8, 3) and vertices.dtype == np.float64
+        assert faces.shape == (12, 3) and faces.dtype == np.int32
+        assert not vertices.flags.writeable
+        assert np.array_equal(vertices.min(axis=0), [-5.0, -5.0, -5.0])
+
+        # Ingest in place: the analyzer reads the caller's float64/int32 buffers
+        points = np.array(vertices)
+        triangles = np.array(faces)
+        analyzer = geom_core_py.Analyzer()
+        assert analyzer.load_mesh_arrays(points, triangles)
+        assert analyzer.get_vertices().ctypes.data == points.ctypes.data
+        assert abs(analyzer.get_volume() - stl.get_volume()) < 1e-9
+        assert analyzer.is_watertight()
+
+        # Other dtypes are converted once and kept alive by the analyzer
+        converted = geom_core_py.Analyzer()
+        assert converted.load_mesh_arrays(points.astype(np.float32), triangles.astype(np.int64))
+        assert abs(converted.get_volume() - stl.get_volume()) < 1e-6
+
+        overhang = analyzer.calculate_overhang_map(45.0)
+        assert overhang.shape == (12,) and overhang.dtype == np.uint8
+        assert np.count_nonzero(overhang == 2) == 2, "Bottom face should be ground-facing"
+
+        analyzer.build_spatial_index()
+        thickness = analyzer.calculate_wall_thickness_map(20.0)
+        assert thickness.shape == (8,) and thickness.dtype == np.float32
+        assert np.all(thickness >= 0.0)
+        expected = thickness.copy()
+        assert np.array_equal(analyzer.calculate_wall_thickness_map(20.0, num_threads=4), expected)
+
+        # Distances to the cube (faces at +-5): centre, outside a face, off a corner, inside near a face
+        queries = np.array([[0, 0, 0], [8, 0, 0], [6, 6, 6], [0, 4.5, 0]], dtype=np.float64)
+        distances = analyzer.distance_to_surface(queries)
+        assert np.allclose(distances, [5.0, 3.0, np.sqrt(3.0), 0.5])
+        assert np.array_equal(analyzer.distance_to_surface(queries, num_threads=4), distances)
+        assert np.allclose(analyzer.distance_to_surface(queries, max_distance_mm=2.0), [2.0, 2.0, np.sqrt(3.0), 0.5])
+
+        # Views keep the analyzer alive
+        view = geom_core_py.Analyzer()
+        assert view.load_mesh_arrays(points, triangles)
+        faces_view = view.get_faces()
+        del view
+        assert faces_view.sum() == triangles.sum()
+
+        # Arrays handed out earlier survive reloads and recomputed maps
+        overhang = analyzer.calculate_overhang_map(45.0)
+        overhang_before = overhang.copy()
+        arrays_vertices = analyzer.get_vertices()
+        write_binary_stl_cube(stl_file, size=20.0)
+        assert stl.load_stl(stl_file)
+        assert analyzer.load_stl(stl_file)
+        assert stl.get_vertices().min() == -10.0
+        assert np.array_equal(vertices.min(axis=0), [-5.0, -5.0, -5.0])
+        assert np.array_equal(arrays_vertices, points)
+        analyzer.build_spatial_index()
+        assert analyzer.calculate_wall_thickness_map(30.0).max() > expected.max()
+        assert analyzer.calculate_overhang_map(45.0).shape == overhang.shape
+        assert np.array_equal(thickness, expected)
+        assert np.array_equal(overhang, overhang_before)
+
+        # A later load releases the caller's arrays, unless a view of that mesh still reads them
+        holder = geom_core_py.Analyzer()
+        for keep_view in (False, True):
+            held = points.copy()
+            held_ref = weakref.ref(held)
+            assert holder.load_mesh_arrays(held, triangles)
+            held_view = holder.get_vertices() if keep_view else None
+            del held
+            assert held_ref() is not None
+            assert holder.load_stl(stl_file)
+            assert (held_ref() is not None) == keep_view
+            del held_view
+            assert held_ref() is None
+
+        bad = np.array([[0, 1, 8]], dtype=np.int32)
+        assert not geom_core_py.Analyzer().load_mesh_arrays(points, bad)
+        try:
+            geom_core_py.Analyzer().load_mesh_arrays(points.ravel(), triangles)
+            assert False, "Expected ValueError for a flat vertex array"
+        except ValueError:
+            pass
+        print(f"  ✓ NumPy: {analyzer.get_triangle_count()} triangles, volume={analyzer.get_volume():.2f}")
+
+    finally:
+        if os.path.exists(stl_file):
+            os.remove(stl_file)
+
+
 def test_legacy_methods():
     """Test that legacy methods still work (backward compatibility)."""
     print("\nTesting legacy methods (backward compatibility)...")
@@ -283,6 +695,13 @@ def main():
         test_cube_volume()
         test_watertight()
         test_bounding_box()
+        test_threaded_load()
+        test_ascii_load()
+        test_streaming_load()
+        test_obj_load()
+        test_3mf_load()
+        test_ply_load()
+        test_numpy_arrays()
         test_legacy_methods()
 
         print("\n" + "=" * 60)
@@ -266,6 +266,148 @@ def test_printability_report_structure():
     print(f"  ✓ Default score: {report.score}")
 
 
+def test_mesh_cache():
+    """Test that a .gcmesh cache restores the mesh and spatial index."""
+    print("\nTesting .gcmesh cache round trip...")
+
+    with tempfile.NamedTemporaryFile(suffix='.stl', delete=False) as f:
+        stl_file = f.name
+    with tempfile.NamedTemporaryFile(suffix='.gcmesh', delete=False) as f:
+        cache_file = f.name
+
+    try:
+        write_binary_stl_thin_plate(stl_file, width=10.0, length=10.0, thickness=0.1)
+
+        original = geom_core_py.Analyzer()
+        assert original.load_stl(stl_file)
+        original.build_spatial_index()
+        assert original.save_mesh_cache(cache_file), "Failed to save mesh cache"
+
+        cached = geom_core_py.Analyzer()
+        assert cached.load_mesh_cache(cache_file), "Failed to load mesh cache"
+        assert cached.get_vertex_count() == original.get_vertex_count()
+        assert cached.get_triangle_count() == original.get_triangle_count()
+        assert abs(cached.get_volume() - original.get_volume()) < 1e-12
+
+        # No build_spatial_index() call: the cached BVH is used directly
+        expected = original.get_printability_report(45.0, 0.2)
+        report = cached.get_printability_report(45.0, 0.2)
+        assert report.thin_wall_vertex_count == expected.thin_wall_vertex_count > 0
+        assert abs(report.score - expected.score) < 1e-12
+        print(f"  ✓ Cached mesh: {cached.get_vertex_count()} vertices, "
+              f"{report.thin_wall_vertex_count} thin-wall vertices")
+
+        # A file that is not a .gcmesh is rejected
+        assert not cached.load_mesh_cache(stl_file)
+        print("  ✓ Non-cache file rejected")
+
+    finally:
+        for path in (stl_file, cache_file):
+            if os.path.exists(path):
+                os.remove(path)
+
+
+def test_analyze_many():
+    """Test batch analysis on C++ worker threads and GIL-free calls from Python threads."""
+    print("\nTesting batch and threaded analysis...")
+    import threading
+
+    paths = []
+    try:
+        for thickness in (0.1, 0.5, 2.0):
+            with tempfile.NamedTemporaryFile(suffix='.stl', delete=False) as f:
+                paths.append(f.name)
+            write_binary_stl_thin_plate(paths[-1], thickness=thickness)
+        missing = paths[0] + '.missing.stl'
+
+        options = geom_core_py.BatchOptions()
+        options.min_wall_thickness_mm = 0.8
+        results = geom_core_py.analyze_many(paths + [missing], options, threads=4)
+        assert [r.filepath for r in results] == paths + [missing]
+        assert not results[-1].success
+
+        for path, result in zip(paths, results):
+            single = geom_core_py.Analyzer()
+            assert single.load_stl(path)
+            single.build_spatial_index()
+            report = single.get_printability_report(45.0, 0.8)
+            assert result.success
+            assert result.triangle_count == single.get_triangle_count()
+            assert abs(result.volume - single.get_volume()) < 1e-12
+            assert result.report.thin_wall_vertex_count == report.thin_wall_vertex_count
+            assert abs(result.report.score - report.score) < 1e-12
+        print(f"  ✓ analyze_many: {len(paths)} files, scores "
+              f"{[round(r.report.score, 1) for r in results[:-1]]}")
+
+        # Separate Analyzers used concurrently from Python threads
+        scores = [None] * len(paths)
+
+        def work(i):
+            analyzer = geom_core_py.Analyzer()
+            analyzer.load_stl(paths[i])
+            analyzer.build_spatial_index()
+            scores[i] = analyzer.get_printability_report(45.0, 0.8).score
+
+        threads = [threading.Thread(target=work, args=(i,)) for i in range(len(paths))]
+        for t in threads:
+            t.start()
+        for t in threads:
+            t.join()
+        assert all(abs(a - r.report.score) < 1e-12 for a, r in zip(scores, results))
+        print("  ✓ Concurrent Analyzers from Python threads match")
+
+    finally:
+        for path in paths:
+            if os.path.exists(path):
+                os.remove(path)
+
+
+def test_bvh_builders():
+    """Test that the BVH builders and node formats give the same analysis."""
+    print("\nTesting BVH builders...")
+
+    with tempfile.NamedTemporaryFile(suffix='.stl', delete=False) as f:
+        temp_file = f.name
+
+    try:
+        write_binary_stl_thin_plate(temp_file, thickness=0.1)
+
+        reports = []
+        for builder, max_leaf in ((geom_core_py.BVHBuilder.MEDIAN, 10),
+                                  (geom_core_py.BVHBuilder.BINNED_SAH, 10),
+                                  (geom_core_py.BVHBuilder.BINNED_SAH, 1),
+                                  (geom_core_py.BVHBuilder.LINEAR, 10)):
+            analyzer = geom_core_py.Analyzer()
+            assert analyzer.load_stl(temp_file)
+            analyzer.build_spatial_index(builder=builder, max_leaf_triangles=max_leaf)
+            reports.append(analyzer.get_printability_report(45.0, 0.2))
+
+        analyzer = geom_core_py.Analyzer()
+        assert analyzer.load_stl(temp_file)
+        analyzer.build_spatial_index(num_threads=4)
+        reports.append(analyzer.get_printability_report(45.0, 0.2))
+
+        analyzer = geom_core_py.Analyzer()
+        assert analyzer.load_stl(temp_file)
+        analyzer.build_spatial_index(builder=geom_core_py.BVHBuilder.LINEAR, treelet_passes=2, num_threads=4)
+        reports.append(analyzer.get_printability_report(45.0, 0.2))
+
+        for node_format in (geom_core_py.BVHNodeFormat.WIDE4, geom_core_py.BVHNodeFormat.WIDE4_QUANTIZED):
+            analyzer = geom_core_py.Analyzer()
+            assert analyzer.load_stl(temp_file)
+            analyzer.build_spatial_index(node_format=node_format)
+            reports.append(analyzer.get_printability_report(45.0, 0.2))
+
+        for report in reports[1:]:
+            assert report.thin_wall_vertex_count == reports[0].thin_wall_vertex_count
+            assert abs(report.score - reports[0].score) < 1e-12
+        print(f"  ✓ BVH builders and node formats agree: {reports[0].thin_wall_vertex_count} thin wall vertices")
+
+    finally:
+        if os.path.exists(temp_file):
+            os.remove(temp_file)
+
+
 def main():
     """Run all printability tests."""
     print("=" * 70)
@@ -276,6 +418,9 @@ def main():
         test_printability_report_structure()
         test_overhang_detection()
         test_thin_wall_detection()
+        test_mesh_cache()
+        test_analyze_many()
+        test_bvh_builders()
 
         print("\n" + "=" * 70)
         print("✓ All Milestone 4 printability tests passed!")
@@ -9,6 +9,8 @@ When OCCT is available, it should successfully load a STEP file.
 
 import sys
 import os
+import shutil
+import tempfile
 
 # Import the compiled module
 try:
@@ -64,6 +66,33 @@ def test_step_api():
         print("    This is expected when OCCT is not installed.")
     print()
 
+    # Test 4: Tessellation cache
+    print("Testing STEP tessellation cache...")
+    with tempfile.TemporaryDirectory() as cache_dir:
+        cached = gc.Analyzer()
+        cached.set_step_cache(cache_dir, max_bytes=64 * 1024 * 1024)
+        if success:
+            assert cached.load_step(test_file), "First cached load failed"
+            entries = [name for name in os.listdir(cache_dir) if name.endswith('.gcmesh')]
+            assert len(entries) == 1, f"Expected one cache entry, found {entries}"
+            assert cached.load_step(test_file), "Load from cache failed"
+            assert cached.get_triangle_count() == analyzer.get_triangle_count()
+            assert abs(cached.get_volume() - analyzer.get_volume()) < 1e-9
+            # Different settings must not hit the existing entry
+            assert cached.load_step(test_file, linear_deflection=0.05)
+            fine_entries = [n for n in os.listdir(cache_dir) if n.endswith('.gcmesh')]
+            assert len(fine_entries) == 2
+            # An entry stored for other settings is a miss even under this key
+            fine_entry = next(n for n in fine_entries if n not in entries)
+            shutil.copyfile(os.path.join(cache_dir, fine_entry), os.path.join(cache_dir, entries[0]))
+            assert cached.load_step(test_file), "Load after replacing the entry failed"
+            assert cached.get_triangle_count() == analyzer.get_triangle_count()
+            print("  ✓ Repeat import served from the cache")
+        else:
+            assert not cached.load_step(test_file)
+            print("  ✓ set_step_cache() available (cache unused without OCCT)")
+    print()
+
     print("=" * 70)
     print("✓ All STEP API tests passed!")
     print("=" * 70)